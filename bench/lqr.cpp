@@ -7,6 +7,8 @@
 #include "aligator/modelling/quad-costs.hpp"
 
 #include "aligator/modelling/linear-discrete-dynamics.hpp"
+#include "aligator/modelling/quad-costs-fixed.hpp"
+#include "aligator/modelling/linear-discrete-dynamics-fixed.hpp"
 
 #include <benchmark/benchmark.h>
 
@@ -56,6 +58,54 @@ TrajOptProblem define_problem(const std::size_t nsteps, const int dim = 20,
   return problem;
 }
 
+/// Dimensions of the small system, to compare the dynamic-size and fixed-size
+/// code paths.
+constexpr int NX_SMALL = 12;
+constexpr int NU_SMALL = 4;
+
+template <bool FixedSize>
+TrajOptProblem define_small_problem(const std::size_t nsteps) {
+  constexpr int dim = NX_SMALL;
+  constexpr int nu = NU_SMALL;
+  MatrixXd A(dim, dim);
+  MatrixXd B(dim, nu);
+  VectorXd c_(dim);
+  A.setIdentity();
+  A.topRightCorner(nu, nu).diagonal().setConstant(0.1);
+  B.setIdentity();
+  c_.setConstant(0.1);
+
+  MatrixXd w_x(dim, dim), w_u(nu, nu);
+  w_x.setIdentity();
+  w_x(0, 0) = 2.;
+  w_u.setIdentity();
+  w_u *= 1e-2;
+
+  shared_ptr<ExplicitDynamicsModelTpl<T>> dynptr;
+  shared_ptr<CostAbstractTpl<T>> rcost;
+  if (FixedSize) {
+    using Dynamics = dynamics::LinearDiscreteDynamicsFixedTpl<T, dim, nu>;
+    using QuadCost = QuadraticCostFixedTpl<T, dim, nu>;
+    dynptr = allocate_shared_eigen_aligned<Dynamics>(A, B, c_);
+    rcost = allocate_shared_eigen_aligned<QuadCost>(w_x, w_u);
+  } else {
+    using Dynamics = dynamics::LinearDiscreteDynamicsTpl<T>;
+    using QuadCost = QuadraticCostTpl<T>;
+    dynptr = std::make_shared<Dynamics>(A, B, c_);
+    rcost = std::make_shared<QuadCost>(w_x, w_u);
+  }
+  auto stage = std::make_shared<StageModel>(rcost, dynptr);
+
+  VectorXd x0(dim);
+  x0.setRandom();
+
+  TrajOptProblem problem(x0, nu, dynptr->space_next_, rcost);
+  for (std::size_t i = 0; i < nsteps; i++) {
+    problem.addStage(stage);
+  }
+  return problem;
+}
+
 #define SETUP_PROBLEM_VARS(state)                                              \
   auto problem = define_problem((std::size_t)state.range(0));                  \
   const auto &dynamics = problem.stages_[0] -> dyn_model();                    \
@@ -95,6 +145,23 @@ static void BM_lqr_fddp(benchmark::State &state) {
   state.SetComplexityN(state.range(0));
 }
 
+template <bool FixedSize>
+static void BM_lqr_fddp_small(benchmark::State &state) {
+  using Solver = std::conditional_t<
+      FixedSize, SolverFDDP<T, NX_SMALL, NU_SMALL>, SolverFDDP<T>>;
+  auto problem = define_small_problem<FixedSize>((std::size_t)state.range(0));
+  Solver fddp(TOL, verbose);
+  fddp.max_iters = max_iters;
+  fddp.setup(problem);
+
+  for (auto _ : state) {
+    bool conv = fddp.run(problem);
+    if (!conv)
+      state.SkipWithError("solver did not converge.");
+  }
+  state.SetComplexityN(state.range(0));
+}
+
 int main(int argc, char **argv) {
   constexpr auto unit = benchmark::kMillisecond;
 
@@ -109,6 +176,8 @@ int main(int argc, char **argv) {
   };
 
   registerOpts("FDDP", &BM_lqr_fddp);
+  registerOpts("FDDP_SMALL_DYNAMIC", &BM_lqr_fddp_small<false>);
+  registerOpts("FDDP_SMALL_FIXED", &BM_lqr_fddp_small<true>);
   registerOpts("ALIGATOR_BLOCKED", &BM_lqr_prox<LDLTChoice::BLOCKSPARSE>);
   registerOpts("ALIGATOR_BUNCHKAUFMAN", &BM_lqr_prox<LDLTChoice::BUNCHKAUFMAN>);
   registerOpts("ALIGATOR_DENSE", &BM_lqr_prox<LDLTChoice::DENSE>);
@@ -5,6 +5,7 @@
 #include <boost/python.hpp>
 #include <boost/python/class.hpp>
 #include <boost/python/return_value_policy.hpp>
+#include <boost/python/object/life_support.hpp>
 
 #include <fmt/ostream.h>
 
@@ -35,6 +36,31 @@ private:
   MatrixType Class::*m_which;
 };
 
+/// @brief Functor which wraps a pointer to a MatrixArenaTpl data member, and
+/// returns a list of Eigen::Ref on its elements.
+template <typename Arena, typename Class> struct arena_member {
+public:
+  typedef Eigen::Ref<typename Arena::PlainType> RefType;
+
+  arena_member(Arena Class::*which) : m_which(which) {}
+
+  bp::list operator()(bp::object self) const {
+    Arena &arena = bp::extract<Class &>(self)().*m_which;
+    bp::list out;
+    for (std::size_t i = 0; i < arena.size(); i++) {
+      bp::object view{RefType(arena[i])};
+      // each view keeps the owner of the arena alive
+      if (bp::objects::make_nurse_and_patient(view.ptr(), self.ptr()) == 0)
+        bp::throw_error_already_set();
+      out.append(view);
+    }
+    return out;
+  }
+
+private:
+  Arena Class::*m_which;
+};
+
 } // namespace internal
 
 /// @brief    Create a getter for Eigen::Matrix type objects which returns an
@@ -51,6 +77,15 @@ bp::object make_getter_eigen_matrix(MatrixType C::*v) {
       boost::mpl::vector2<RefType, C &>());
 }
 
+/// @brief    Create a getter for a MatrixArenaTpl data member, which returns a
+/// list of views (Eigen::Ref) on the elements of the arena.
+template <class C, class Arena>
+bp::object make_getter_matrix_arena(Arena C::*v) {
+  return bp::make_function(internal::arena_member<Arena, C>(v),
+                           bp::default_call_policies(),
+                           boost::mpl::vector2<bp::list, bp::object>());
+}
+
 template <class C, class MatrixType, class Policies>
 bp::object make_setter_eigen_matrix(MatrixType C::*v,
                                     Policies const &policies) {
@@ -17,5 +17,22 @@ struct FrameAPIVisitor : bp::def_visitor<FrameAPIVisitor<Class>> {
   }
 };
 
+/// Expose the pinocchio data of the kinematics cache of a function data.
+template <typename Data>
+struct KinematicsCacheDataVisitor
+    : bp::def_visitor<KinematicsCacheDataVisitor<Data>> {
+  static const context::PinData &getPinData(const Data &data) {
+    return data.kinematics_->pin_data;
+  }
+
+  template <class PyClass> void visit(PyClass &cl) const {
+    cl.add_property("pin_data",
+                    bp::make_function(&getPinData,
+                                      bp::return_internal_reference<>()),
+                    "Pinocchio data struct, shared with the other multibody "
+                    "functions of the stage.");
+  }
+};
+
 } // namespace python
 } // namespace aligator
@@ -1,6 +1,7 @@
 /// @copyright Copyright (C) 2022-2023 LAAS-CNRS, INRIA
 #include "aligator/python/callbacks.hpp"
 #include "aligator/helpers/history-callback.hpp"
+#include "aligator/helpers/trace-callback.hpp"
 
 namespace aligator {
 namespace python {
@@ -33,6 +34,30 @@ void exposeHistoryCallback() {
       .def_readonly("dual_tols", &history_storage_t::dual_tols);
 }
 
+void exposeTraceCallback() {
+  using TraceCallback = TraceCallbackTpl<Scalar>;
+
+  bp::class_<TraceCallback, bp::bases<CallbackBase>, boost::noncopyable>(
+      "TraceCallback",
+      "Record a per-thread timeline of the solver run (stage evaluations and "
+      "derivatives, backward-pass knots, linesearch trials), and write it to "
+      "a Chrome trace file which can be opened in Perfetto.",
+      bp::init<const std::string &, std::size_t>(
+          (bp::arg("self"), bp::arg("filename"),
+           bp::arg("capacity") = std::size_t(1) << 16)))
+      .def_readwrite("filename", &TraceCallback::filename)
+      .add_property(
+          "num_events",
+          +[](const TraceCallback &self) { return self.buffer.size(); },
+          "Number of events recorded during the last run.")
+      .add_property(
+          "num_dropped",
+          +[](const TraceCallback &self) { return self.buffer.numDropped(); },
+          "Number of events dropped because the buffer was full.")
+      .def("write", &TraceCallback::write, bp::args("self", "filename"),
+           "Write the trace of the last run to a file.");
+}
+
 void exposeCallbacks() {
   bp::register_ptr_to_python<shared_ptr<CallbackBase>>();
 
@@ -43,6 +68,7 @@ void exposeCallbacks() {
            bp::args("self", "workspace", "results"));
 
   exposeHistoryCallback();
+  exposeTraceCallback();
 }
 } // namespace python
 } // namespace aligator
@@ -49,13 +49,23 @@ void exposeQuadCost() {
       .def(bp::init<ConstMatrixRef, ConstMatrixRef, ConstMatrixRef>(
           "Constructor with just weights (with cross-term).",
           bp::args("self", "w_x", "w_u", "w_cross")))
-      .def_readwrite("w_x", &QuadraticCost::weights_x, "Weights on the state.")
-      .def_readwrite("w_u", &QuadraticCost::weights_u,
-                     "Weights on the control.")
+      .add_property("w_x",
+                    bp::make_function(
+                        &QuadraticCost::getWeightsX,
+                        bp::return_value_policy<bp::return_by_value>()),
+                    &QuadraticCost::setWeightsX, "Weights on the state.")
+      .add_property("w_u",
+                    bp::make_function(
+                        &QuadraticCost::getWeightsU,
+                        bp::return_value_policy<bp::return_by_value>()),
+                    &QuadraticCost::setWeightsU, "Weights on the control.")
       .def_readwrite("interp_x", &QuadraticCost::interp_x)
       .def_readwrite("interp_u", &QuadraticCost::interp_u)
       .add_property("has_cross_term", &QuadraticCost::hasCrossTerm,
                     "Whether there is a cross term.")
+      .add_property("has_diagonal_weights",
+                    &QuadraticCost::hasDiagonalWeights,
+                    "Whether the state and control weights are diagonal.")
       .add_property("weights_cross", &QuadraticCost::getCrossWeights,
                     &QuadraticCost::setCrossWeight, "Cross term weight.")
       .def(CopyableVisitor<QuadraticCostTpl<Scalar>>());
@@ -96,6 +106,12 @@ void exposeCostStack() {
 void exposeCostBase() {
   bp::register_ptr_to_python<CostPtr>();
 
+  bp::enum_<HessianStructure>("HessianStructure",
+                              "Sparsity structure of a cost Hessian.")
+      .value("DIAGONAL", HessianStructure::DIAGONAL)
+      .value("BLOCK_DIAGONAL", HessianStructure::BLOCK_DIAGONAL)
+      .value("DENSE", HessianStructure::DENSE);
+
   bp::class_<PyCostFunction<>, boost::noncopyable>(
       "CostAbstract", "Base class for cost functions.", bp::no_init)
       .def(bp::init<shared_ptr<Manifold>, const int>(
@@ -108,6 +124,11 @@ void exposeCostBase() {
       .def("computeHessians", bp::pure_virtual(&CostBase::computeHessians),
            bp::args("self", "x", "u", "data"),
            "Compute the cost function hessians.")
+      .def("evaluateWithDerivatives", &CostBase::evaluateWithDerivatives,
+           bp::args("self", "x", "u", "data"),
+           "Evaluate the cost function, its gradients and hessians.")
+      .def("hasConstantHessians", &CostBase::hasConstantHessians,
+           bp::args("self"), "Whether the cost hessians are constant.")
       .def_readonly("space", &CostBase::space)
       .add_property("nx", &CostBase::nx)
       .add_property("ndx", &CostBase::ndx)
@@ -122,6 +143,7 @@ void exposeCostBase() {
       .def_readwrite("value", &CostData::value_)
       .def_readwrite("grad", &CostData::grad_)
       .def_readwrite("hess", &CostData::hess_)
+      .def_readonly("hess_structure", &CostData::hess_structure_)
       .add_property(
           "Lx", bp::make_getter(&CostData::Lx_,
                                 bp::return_value_policy<bp::return_by_value>()))
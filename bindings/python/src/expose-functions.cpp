@@ -53,6 +53,12 @@ void exposeFunctionBase() {
       .def("computeVectorHessianProducts",
            &StageFunction::computeVectorHessianProducts,
            bp::args("self", "x", "u", "y", "lbda", "data"))
+      .def("evaluateWithJacobians", &StageFunction::evaluateWithJacobians,
+           bp::args("self", "x", "u", "y", "data"),
+           "Evaluate the function and its Jacobians.")
+      .def("hasConstantJacobians", &StageFunction::hasConstantJacobians,
+           bp::args("self"),
+           "Whether the Jacobians of the function are constant.")
       .def_readonly("ndx1", &StageFunction::ndx1, "Current state space.")
       .def_readonly("ndx2", &StageFunction::ndx2, "Next state space.")
       .def_readonly("nu", &StageFunction::nu, "Control dimension.")
@@ -15,6 +15,7 @@ void exposeProblem() {
   using context::TrajOptData;
   using context::TrajOptProblem;
   using context::UnaryFunction;
+  using context::VectorXs;
 
   bp::class_<TrajOptProblem>("TrajOptProblem", "Define a shooting problem.",
                              bp::no_init)
@@ -63,9 +64,24 @@ void exposeProblem() {
       .def("evaluate", &TrajOptProblem::evaluate,
            bp::args("self", "xs", "us", "prob_data"),
            "Evaluate the problem costs, dynamics, and constraints.")
-      .def("computeDerivatives", &TrajOptProblem::computeDerivatives,
+      .def("evaluateWithDerivatives",
+           &TrajOptProblem::evaluateWithDerivatives,
            bp::args("self", "xs", "us", "prob_data"),
-           "Evaluate the problem derivatives. Call `evaluate()` first.")
+           "Evaluate the problem costs, dynamics, constraints and their "
+           "derivatives.")
+      .def<void (TrajOptProblem::*)(const std::vector<VectorXs> &,
+                                    const std::vector<VectorXs> &,
+                                    TrajOptData &) const>(
+          "computeDerivatives", &TrajOptProblem::computeDerivatives,
+          bp::args("self", "xs", "us", "prob_data"),
+          "Evaluate the problem derivatives. Call `evaluate()` first.")
+      .def<void (TrajOptProblem::*)(
+          const std::vector<VectorXs> &, const std::vector<VectorXs> &,
+          const std::vector<VectorXs> &, TrajOptData &) const>(
+          "computeDerivatives", &TrajOptProblem::computeDerivatives,
+          bp::args("self", "xs", "us", "lams", "prob_data"),
+          "Evaluate the problem derivatives, and the vector-Hessian products "
+          "of the constraints with the multipliers `lams`.")
       .def("replaceStageCircular", &TrajOptProblem::replaceStageCircular,
            bp::args("self", "model"),
            "Circularly replace the last stage in the problem, dropping the "
@@ -82,7 +98,11 @@ void exposeProblem() {
       .def_readwrite("term_constraint", &TrajOptData::term_cstr_data,
                      "Terminal constraint data.")
       .def_readonly("stage_data", &TrajOptData::stage_data,
-                    "Data for each stage.");
+                    "Data for each stage.")
+      .def("invalidateEvaluations", &TrajOptData::invalidateEvaluations,
+           bp::args("self"),
+           "Forget the evaluations of all stage data, including their "
+           "constant derivatives.");
 }
 
 } // namespace python
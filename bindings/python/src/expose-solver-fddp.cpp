@@ -33,6 +33,7 @@ void exposeFDDP() {
       .def_readwrite("reg_max", &SolverType::reg_max_)
       .def_readwrite("xreg", &SolverType::xreg_)
       .def_readwrite("ureg", &SolverType::ureg_)
+      .def_readwrite("pin_threads", &SolverType::pin_threads)
       .def(SolverVisitor<SolverType>())
       .def("run", &SolverType::run,
            (bp::arg("self"), bp::arg("problem"), bp::arg("xs_init"),
@@ -1,12 +1,16 @@
 #include "aligator/python/fwd.hpp"
 #include "aligator/python/utils.hpp"
+#include "aligator/python/eigen-member.hpp"
 
 #include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/solvers/proxddp/solver-batch.hpp"
 
 namespace aligator {
 namespace python {
 
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(prox_run_overloads, run, 1, 4)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(prox_cycle_overloads, cycleProblem, 2,
+                                       3)
 
 void exposeProxDDP() {
   using context::ConstVectorRef;
@@ -71,13 +75,16 @@ void exposeProxDDP() {
           },
           bp::args("self", "j"), bp::return_internal_reference<>(),
           "Scalers of the constraints in the proximal algorithm.")
-      .def_readonly("kkt_mat", &Workspace::kkt_mats_)
-      .def_readonly("kkt_rhs", &Workspace::kkt_rhs_)
-      .def_readonly("kkt_residuals", &Workspace::kkt_resdls_,
+      .add_property("kkt_mat", make_getter_matrix_arena(&Workspace::kkt_mats_),
+                    "KKT matrices.")
+      .add_property("kkt_rhs", make_getter_matrix_arena(&Workspace::kkt_rhs_),
+                    "KKT system right-hand sides.")
+      .add_property("kkt_residuals",
+                    make_getter_matrix_arena(&Workspace::kkt_resdls_),
                     "KKT system residuals.")
-      .def_readonly("Lxs", &Workspace::Lxs_)
-      .def_readonly("Lus", &Workspace::Lus_)
-      .def_readonly("Lds", &Workspace::Lds_)
+      .add_property("Lxs", make_getter_matrix_arena(&Workspace::Lxs_))
+      .add_property("Lus", make_getter_matrix_arena(&Workspace::Lus_))
+      .add_property("Lds", make_getter_matrix_arena(&Workspace::Lds_))
       .def_readonly("dxs", &Workspace::dxs)
       .def_readonly("dus", &Workspace::dus)
       .def_readonly("dlams", &Workspace::dlams)
@@ -85,7 +92,9 @@ void exposeProxDDP() {
       .def_readonly("lams_plus", &Workspace::lams_plus)
       .def_readonly("lams_pdal", &Workspace::lams_pdal)
       .def_readonly("shifted_constraints", &Workspace::shifted_constraints)
-      .def_readonly("proj_jacobians", &Workspace::proj_jacobians)
+      .add_property("proj_jacobians",
+                    make_getter_matrix_arena(&Workspace::proj_jacobians),
+                    "Projected constraint Jacobians.")
       .def_readonly("inner_crit", &Workspace::inner_criterion)
       .def_readonly("active_constraints", &Workspace::active_constraints)
       // .def(
@@ -113,6 +122,8 @@ void exposeProxDDP() {
       "Results", "Results struct for proxDDP.",
       bp::init<const TrajOptProblem &>())
       .def_readonly("al_iter", &Results::al_iter)
+      .def_readonly("timed_out", &Results::timed_out,
+                    "Whether the last run stopped on the time budget.")
       .def(PrintableVisitor<Results>());
 
   using SolverType = SolverProxDDP<Scalar>;
@@ -134,6 +145,12 @@ void exposeProxDDP() {
       .def_readwrite("refinement_threshold", &SolverType::refinement_threshold_)
       .def_readwrite("ldlt_algo_choice", &SolverType::ldlt_algo_choice_,
                      "Choice of LDLT algorithm.")
+      .def_readwrite("kkt_solver_choice", &SolverType::kkt_solver_choice,
+                     "Choice of factorization for the stage KKT systems "
+                     "(takes effect in setup()).")
+      .def_readwrite("linear_solver_choice", &SolverType::linear_solver_choice,
+                     "Choice of linear-quadratic solver for the backward pass "
+                     "(takes effect in setup()).")
       .def_readwrite("multiplier_update_mode",
                      &SolverType::multiplier_update_mode)
       .def_readwrite("mu_init", &SolverType::mu_init,
@@ -147,9 +164,19 @@ void exposeProxDDP() {
           "Maximum number of iterations when solving the forward dynamics.")
       .def_readwrite("max_al_iters", &SolverType::max_al_iters,
                      "Maximum number of AL iterations.")
+      .def_readwrite("time_budget", &SolverType::time_budget,
+                     "Wall-clock time budget of run(), in seconds (zero or "
+                     "negative for no limit).")
       .def_readwrite("ls_mode", &SolverType::ls_mode, "Linesearch mode.")
       .def_readwrite("rollout_type", &SolverType::rollout_type_,
                      "Rollout type.")
+      .def_readwrite("ls_batch_size", &SolverType::ls_batch_size,
+                     "Number of step sizes evaluated concurrently by the "
+                     "linesearch (linear rollout only, takes effect in "
+                     "setup()).")
+      .def_readwrite("pin_threads", &SolverType::pin_threads,
+                     "Pin the threads of the pool created by setup() to "
+                     "distinct cores.")
       .def_readwrite("dual_weight", &SolverType::dual_weight,
                      "Dual penalty weight.")
       .def_readwrite("reg_min", &SolverType::reg_min,
@@ -164,6 +191,18 @@ void exposeProxDDP() {
            bp::args("self", "problem"), "Compute problem stationarity.")
       .def("computeInfeasibilities", &SolverType::computeInfeasibilities,
            bp::args("self", "problem"), "Compute problem infeasibilities.")
+      .def("prepareRTI", &SolverType::prepareRTI, bp::args("self", "problem"),
+           "Real-time iteration: linearize the problem around the current "
+           "iterate and compute the gains.")
+      .def("feedbackRTI", &SolverType::feedbackRTI, bp::args("self", "problem"),
+           "Real-time iteration: take a full step from the current initial "
+           "condition of the problem, using the gains from prepareRTI().")
+      .def("cycleProblem", &SolverType::cycleProblem,
+           prox_cycle_overloads(
+               (bp::arg("self"), bp::arg("problem"), bp::arg("stage"),
+                bp::arg("data")),
+               "Shift the horizon of the problem, workspace and results by "
+               "one stage: drop the first stage and append the given one."))
       .def(SolverVisitor<SolverType>())
       .def("run", &SolverType::run,
            prox_run_overloads(
@@ -172,6 +211,28 @@ void exposeProxDDP() {
                "Run the algorithm. Can receive initial guess for "
                "multiplier trajectory."));
 
+  using BatchType = SolverProxDDPBatch<Scalar>;
+  std::size_t (BatchType::*batch_run)() = &BatchType::run;
+  std::size_t (BatchType::*batch_run_x0s)(const context::VectorOfVectors &) =
+      &BatchType::run;
+  bp::class_<BatchType, boost::noncopyable>(
+      "SolverProxDDPBatch",
+      "Solve many instances of a problem in parallel, with one SolverProxDDP "
+      "per instance.",
+      bp::init<const SolverType &, const TrajOptProblem &, std::size_t>(
+          bp::args("self", "solver", "problem", "num_instances")))
+      .def_readwrite("num_threads", &BatchType::num_threads)
+      .def_readwrite("pin_threads", &BatchType::pin_threads)
+      .def("__len__", &BatchType::size, bp::args("self"))
+      .def("setup", &BatchType::setup, bp::args("self"),
+           "Allocate the workspace and results of each instance.")
+      .def("run", batch_run, bp::args("self"),
+           "Solve all the instances; returns the number which converged.")
+      .def("run", batch_run_x0s, bp::args("self", "x0s"),
+           "Set the initial state of each instance, then solve them all.")
+      .def("results", &BatchType::results, bp::args("self", "i"),
+           bp::return_internal_reference<>(), "Results of instance i.");
+
   bp::def("computeLagrangianDerivatives", computeLagrangianDerivatives<Scalar>,
           bp::args("problem", "workspace", "lams"),
           "Compute the derivatives of the problem Lagrangian.");
@@ -1,4 +1,5 @@
 #include "aligator/python/fwd.hpp"
+#include "aligator/python/eigen-member.hpp"
 
 #include "aligator/solvers/proxddp/results.hpp"
 #include "aligator/core/workspace-base.hpp"
@@ -18,6 +19,8 @@ template <>
 struct has_operator_equal<::aligator::python::QParams> : boost::false_type {};
 template <>
 struct has_operator_equal<::aligator::python::VParams> : boost::false_type {};
+template <>
+struct has_operator_equal<::aligator::PhaseTimings> : boost::false_type {};
 
 } // namespace internal
 } // namespace eigenpy
@@ -93,12 +96,96 @@ void exposeSolverCommon() {
            "workspace left (using `cycleLeft()`) and insert the allocated data "
            "(useful for MPC).");
 
+  bp::enum_<SolverPhase>("SolverPhase", "Phases of a solver iteration.")
+      .value("EVALUATE", SolverPhase::EVALUATE)
+      .value("DERIVATIVES", SolverPhase::DERIVATIVES)
+      .value("LAGRANGIAN_DERIVATIVES", SolverPhase::LAGRANGIAN_DERIVATIVES)
+      .value("MULTIPLIERS", SolverPhase::MULTIPLIERS)
+      .value("BACKWARD_PASS", SolverPhase::BACKWARD_PASS)
+      .value("KKT_ASSEMBLY", SolverPhase::KKT_ASSEMBLY)
+      .value("FACTORIZATION", SolverPhase::FACTORIZATION)
+      .value("INERTIA_RETRY", SolverPhase::INERTIA_RETRY)
+      .value("LINESEARCH_TRIAL", SolverPhase::LINESEARCH_TRIAL)
+      .value("CALLBACKS", SolverPhase::CALLBACKS);
+
+  bp::class_<PhaseTimings>(
+      "PhaseTimings",
+      "Wall time (in seconds) and number of calls of each solver phase.",
+      bp::init<>(bp::args("self")))
+      .def("time", &PhaseTimings::time, bp::args("self", "phase"))
+      .def("num_calls", &PhaseTimings::numCalls, bp::args("self", "phase"))
+      .def(
+          "to_dict",
+          +[](const PhaseTimings &t) {
+            bp::dict out;
+            for (std::size_t k = 0; k < NUM_SOLVER_PHASES; k++) {
+              out[phase_name(static_cast<SolverPhase>(k))] =
+                  bp::make_tuple(t.seconds[k], t.calls[k]);
+            }
+            return out;
+          },
+          bp::args("self"),
+          "Dictionary of (time, number of calls) tuples, by phase name.")
+      .def(PrintableVisitor<PhaseTimings>());
+  StdVectorPythonVisitor<std::vector<PhaseTimings>, true>::expose(
+      "StdVec_PhaseTimings");
+
+  bp::class_<AllocationReport>(
+      "AllocationReport",
+      "Heap allocations made during a solver run, by phase and by site "
+      "(requires building with ENABLE_ALLOCATION_AUDIT).",
+      bp::init<>(bp::args("self")))
+      .add_property(
+          "num_allocations",
+          +[](const AllocationReport &r) { return r.total.count; })
+      .add_property(
+          "num_bytes", +[](const AllocationReport &r) { return r.total.bytes; })
+      .def_readonly("truncated", &AllocationReport::truncated)
+      .def("allocationFree", &AllocationReport::allocationFree,
+           bp::args("self"), "Whether the run did not allocate at all.")
+      .def(
+          "by_phase",
+          +[](const AllocationReport &r) {
+            bp::dict out;
+            for (std::size_t k = 0; k < NUM_SOLVER_PHASES; k++) {
+              const AllocationCount &c = r.by_phase[k];
+              out[phase_name(static_cast<SolverPhase>(k))] =
+                  bp::make_tuple(c.count, c.bytes);
+            }
+            const AllocationCount &c = r.by_phase[NUM_SOLVER_PHASES];
+            out[bp::object()] = bp::make_tuple(c.count, c.bytes);
+            return out;
+          },
+          bp::args("self"),
+          "Dictionary of (count, bytes) tuples, by phase name (None for the "
+          "allocations made outside of any phase).")
+      .def(
+          "sites",
+          +[](const AllocationReport &r) {
+            bp::list out;
+            for (const AllocationReport::Entry &e : r.sites) {
+              bp::object phase, stage;
+              if (e.phase < NUM_SOLVER_PHASES)
+                phase = bp::object(phase_name(static_cast<SolverPhase>(e.phase)));
+              if (e.stage != AllocationSite::npos)
+                stage = bp::object(e.stage);
+              out.append(bp::make_tuple(phase, stage, e.function,
+                                        e.allocs.count, e.allocs.bytes));
+            }
+            return out;
+          },
+          bp::args("self"),
+          "List of (phase, stage, function, count, bytes) tuples, by "
+          "decreasing count.")
+      .def(PrintableVisitor<AllocationReport>());
+
   using ResultsBase = ResultsBaseTpl<Scalar>;
   bp::class_<ResultsBase>("ResultsBase", "Base results struct.", bp::no_init)
       .def_readonly("num_iters", &ResultsBase::num_iters,
                     "Number of solver iterations.")
       .def_readonly("conv", &ResultsBase::conv)
-      .def_readonly("gains", &ResultsBase::gains_)
+      .add_property("gains", make_getter_matrix_arena(&ResultsBase::gains_),
+                    "Riccati gains.")
       .def_readonly("xs", &ResultsBase::xs)
       .def_readonly("us", &ResultsBase::us)
       .def_readonly("lams", &ResultsBase::lams)
@@ -107,6 +194,14 @@ void exposeSolverCommon() {
       .def_readonly("traj_cost", &ResultsBase::traj_cost_, "Trajectory cost.")
       .def_readonly("merit_value", &ResultsBase::merit_value_,
                     "Merit function value.")
+      .def_readonly("timings", &ResultsBase::timings,
+                    "Time spent in each solver phase during the last run "
+                    "(requires building with ENABLE_SOLVER_TIMINGS).")
+      .def_readonly("iter_timings", &ResultsBase::iter_timings,
+                    "Time spent in each solver phase, per iteration.")
+      .def_readonly("allocations", &ResultsBase::allocations,
+                    "Heap allocations made during the last run (requires "
+                    "building with ENABLE_ALLOCATION_AUDIT).")
       .def("controlFeedbacks", &ResultsBase::getCtrlFeedbacks, bp::args("self"),
            "Get the control feedback matrices.")
       .def("controlFeedforwards", &ResultsBase::getCtrlFeedforwards,
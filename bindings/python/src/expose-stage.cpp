@@ -65,6 +65,15 @@ void exposeStage() {
       .def("computeDerivatives", &StageModel::computeDerivatives,
            bp::args("self", "x", "u", "y", "data"),
            "Compute derivatives of the stage cost, dynamics, and constraints.")
+      .def("evaluateWithDerivatives", &StageModel::evaluateWithDerivatives,
+           bp::args("self", "x", "u", "y", "data"),
+           "Evaluate the stage cost, dynamics, constraints and their "
+           "derivatives.")
+      .def("computeVectorHessianProducts",
+           &StageModel::computeVectorHessianProducts,
+           bp::args("self", "x", "u", "y", "lams", "data"),
+           "Compute the vector-Hessian products of the dynamics and "
+           "constraints with their multipliers.")
       .add_property("ndx1", &StageModel::ndx1)
       .add_property("ndx2", &StageModel::ndx2)
       .add_property("nu", &StageModel::nu, "Control space dimension.")
@@ -84,6 +93,10 @@ void exposeStage() {
                         bp::init<const StageModel &>())
       .def_readonly("cost_data", &StageData::cost_data)
       .def_readwrite("constraint_data", &StageData::constraint_data)
+      .def("invalidateEvaluation", &StageData::invalidateEvaluation,
+           bp::args("self"),
+           "Forget the evaluation point and the constant derivatives, e.g. "
+           "when the parameters of the stage model changed.")
       .def(ClonePythonVisitor<StageData>());
 }
 
@@ -1,10 +1,36 @@
 #include "aligator/python/fwd.hpp"
 
 #include "aligator/modelling/autodiff/finite-difference.hpp"
+#include "aligator/utils/exceptions.hpp"
 
 namespace aligator {
 namespace python {
 
+namespace {
+/// The threads of the finite-difference helpers call the wrapped model
+/// without holding the GIL: refuse them for models implemented in Python.
+template <typename Model>
+void check_num_threads(const Model &model, std::size_t num_threads) {
+  if ((num_threads > 1) && bp::detail::wrapper_base_::owner(&model)) {
+    ALIGATOR_RUNTIME_ERROR("Models implemented in Python cannot be "
+                           "differentiated on several threads.");
+  }
+}
+
+template <typename FiniteDiffType>
+void fd_set_num_threads(FiniteDiffType &self, std::size_t num_threads) {
+  check_num_threads(*self.func_, num_threads);
+  self.setNumThreads(num_threads);
+}
+
+void cost_fd_set_num_threads(
+    autodiff::CostFiniteDifferenceHelper<context::Scalar> &self,
+    std::size_t num_threads) {
+  check_num_threads(*self.cost_, num_threads);
+  self.setNumThreads(num_threads);
+}
+} // namespace
+
 /// Expose finite difference helpers.
 void exposeAutodiff() {
   using namespace autodiff;
@@ -16,14 +42,26 @@ void exposeAutodiff() {
   using context::StageFunction;
   using context::StageFunctionData;
 
+  bp::enum_<FiniteDifferenceScheme>("FiniteDifferenceScheme",
+                                    "Finite-difference formula.")
+      .value("FORWARD", FiniteDifferenceScheme::FORWARD)
+      .value("CENTRAL", FiniteDifferenceScheme::CENTRAL)
+      .value("RICHARDSON", FiniteDifferenceScheme::RICHARDSON);
+
   {
     using FiniteDiffType = FiniteDifferenceHelper<Scalar>;
     bp::scope _ = bp::class_<FiniteDiffType, bp::bases<StageFunction>>(
         "FiniteDifferenceHelper",
         "Make a function into a differentiable function/dynamics using"
         " finite differences.",
-        bp::init<shared_ptr<Manifold>, shared_ptr<StageFunction>, const Scalar>(
-            bp::args("self", "space", "func", "eps")));
+        bp::init<shared_ptr<Manifold>, shared_ptr<StageFunction>, const Scalar,
+                 bp::optional<FiniteDifferenceScheme>>(
+            bp::args("self", "space", "func", "eps", "scheme")))
+        .def_readwrite("scheme", &FiniteDiffType::scheme)
+        .def("setNumThreads", &fd_set_num_threads<FiniteDiffType>,
+             bp::args("self", "num_threads"),
+             "Evaluate the columns of the Jacobians in parallel (not "
+             "available if the function is implemented in Python).");
     bp::class_<FiniteDiffType::Data, bp::bases<StageFunctionData>>("Data",
                                                                    bp::no_init);
   }
@@ -32,8 +70,14 @@ void exposeAutodiff() {
     using DynFiniteDiffType = DynamicsFiniteDifferenceHelper<Scalar>;
     bp::scope _ = bp::class_<DynFiniteDiffType, bp::bases<DynamicsModel>>(
         "DynamicsFiniteDifferenceHelper",
-        bp::init<shared_ptr<Manifold>, shared_ptr<DynamicsModel>, const Scalar>(
-            bp::args("self", "space", "dyn", "eps")));
+        bp::init<shared_ptr<Manifold>, shared_ptr<DynamicsModel>, const Scalar,
+                 bp::optional<FiniteDifferenceScheme>>(
+            bp::args("self", "space", "dyn", "eps", "scheme")))
+        .def_readwrite("scheme", &DynFiniteDiffType::scheme)
+        .def("setNumThreads", &fd_set_num_threads<DynFiniteDiffType>,
+             bp::args("self", "num_threads"),
+             "Evaluate the columns of the Jacobians in parallel (not "
+             "available if the dynamics are implemented in Python).");
     bp::class_<DynFiniteDiffType::Data>("Data", bp::no_init);
   }
 
@@ -44,8 +88,14 @@ void exposeAutodiff() {
             "CostFiniteDifference",
             "Define a cost function's derivatives using finite differences.",
             bp::no_init)
-            .def(bp::init<shared_ptr<CostBase>, Scalar>(
-                bp::args("self", "cost", "fd_eps")));
+            .def(bp::init<shared_ptr<CostBase>, Scalar,
+                          bp::optional<FiniteDifferenceScheme>>(
+                bp::args("self", "cost", "fd_eps", "scheme")))
+            .def_readwrite("scheme", &CostFiniteDiffType::scheme)
+            .def("setNumThreads", &cost_fd_set_num_threads,
+                 bp::args("self", "num_threads"),
+                 "Evaluate the columns of the derivatives in parallel (not "
+                 "available if the cost is implemented in Python).");
     bp::class_<CostFiniteDiffType::Data, bp::bases<CostData>>("Data",
                                                               bp::no_init)
         .def_readonly("c1", &CostFiniteDiffType::Data::c1)
@@ -44,8 +44,7 @@ void exposeCenterOfMassFunctions() {
   bp::class_<CenterOfMassTranslationData, bp::bases<StageFunctionData>>(
       "CenterOfMassTranslationResidualData",
       "Data Structure for CenterOfMassTranslation", bp::no_init)
-      .def_readonly("pin_data", &CenterOfMassTranslationData::pin_data_,
-                    "Pinocchio data struct.");
+      .def(KinematicsCacheDataVisitor<CenterOfMassTranslationData>());
 
   bp::class_<CenterOfMassVelocity, bp::bases<UnaryFunction>>(
       "CenterOfMassVelocityResidual",
@@ -66,8 +65,7 @@ void exposeCenterOfMassFunctions() {
   bp::class_<CenterOfMassVelocityData, bp::bases<StageFunctionData>>(
       "CenterOfMassVelocityResidualData",
       "Data Structure for CenterOfMassVelocity", bp::no_init)
-      .def_readonly("pin_data", &CenterOfMassVelocityData::pin_data_,
-                    "Pinocchio data struct.");
+      .def(KinematicsCacheDataVisitor<CenterOfMassVelocityData>());
 }
 
 } // namespace python
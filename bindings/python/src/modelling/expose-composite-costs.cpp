@@ -28,7 +28,12 @@ void exposeComposites() {
       bp::init<ManifoldPtr, FunctionPtr, const MatrixXs &>(
           bp::args("self", "space", "function", "weights")))
       .def_readwrite("residual", &QuadResCost::residual_)
-      .def_readwrite("weights", &QuadResCost::weights_)
+      .add_property("weights",
+                    bp::make_function(
+                        &QuadResCost::getWeights,
+                        bp::return_value_policy<bp::return_by_value>()),
+                    &QuadResCost::setWeights, "Weight matrix.")
+      .add_property("has_diagonal_weights", &QuadResCost::hasDiagonalWeights)
       .def(CopyableVisitor<QuadResCost>());
 
   using LogResCost = LogResidualCostTpl<Scalar>;
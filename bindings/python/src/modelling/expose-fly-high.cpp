@@ -31,7 +31,7 @@ void exposeFlyHigh() {
   bp::class_<FlyHighResidual::Data, bp::bases<StageFunctionData>>(
       "FlyHighResidualData", bp::no_init)
       .def_readonly("ez", &FlyHighResidual::Data::ez)
-      .def_readonly("pin_data", &FlyHighResidual::Data::pdata_);
+      .def(KinematicsCacheDataVisitor<FlyHighResidual::Data>());
 }
 
 } // namespace python
@@ -1,5 +1,6 @@
 /// @copyright Copyright (C) 2022 LAAS-CNRS, INRIA
 #include "aligator/python/fwd.hpp"
+#include "aligator/python/modelling/multibody-utils.hpp"
 
 #include "aligator/modelling/dynamics/multibody-free-fwd.hpp"
 
@@ -44,7 +45,7 @@ void exposeFreeFwdDynamics() {
       .def_readwrite("tau", &MultibodyFreeFwdData::tau_)
       .def_readwrite("dtau_dx", &MultibodyFreeFwdData::dtau_dx_)
       .def_readwrite("dtau_du", &MultibodyFreeFwdData::dtau_du_)
-      .def_readwrite("pin_data", &MultibodyFreeFwdData::pin_data_);
+      .def(KinematicsCacheDataVisitor<MultibodyFreeFwdData>());
 }
 } // namespace python
 } // namespace aligator
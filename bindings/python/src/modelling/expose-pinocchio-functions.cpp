@@ -60,8 +60,7 @@ void exposeFrameFunctions() {
       .def_readonly("rMf", &FramePlacementData::rMf_, "Frame placement error.")
       .def_readonly("rJf", &FramePlacementData::rJf_)
       .def_readonly("fJf", &FramePlacementData::fJf_)
-      .def_readonly("pin_data", &FramePlacementData::pin_data_,
-                    "Pinocchio data struct.");
+      .def(KinematicsCacheDataVisitor<FramePlacementData>());
 
   bp::class_<FrameVelocity, bp::bases<UnaryFunction>>(
       "FrameVelocityResidual", "Frame velocity residual function.",
@@ -79,8 +78,7 @@ void exposeFrameFunctions() {
   bp::class_<FrameVelocityData, bp::bases<context::StageFunctionData>>(
       "FrameVelocityData", "Data struct for FrameVelocityResidual.",
       bp::no_init)
-      .def_readonly("pin_data", &FrameVelocityData::pin_data_,
-                    "Pinocchio data struct.");
+      .def(KinematicsCacheDataVisitor<FrameVelocityData>());
 
   bp::class_<FrameTranslation, bp::bases<UnaryFunction>>(
       "FrameTranslationResidual", "Frame placement residual function.",
@@ -100,8 +98,7 @@ void exposeFrameFunctions() {
       "FrameTranslationData", "Data struct for FrameTranslationResidual.",
       bp::no_init)
       .def_readonly("fJf", &FrameTranslationData::fJf_)
-      .def_readonly("pin_data", &FrameTranslationData::pin_data_,
-                    "Pinocchio data struct.");
+      .def(KinematicsCacheDataVisitor<FrameTranslationData>());
 }
 
 #ifdef ALIGATOR_PINOCCHIO_V3
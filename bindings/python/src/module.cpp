@@ -35,6 +35,21 @@ void exposeEnums() {
       .value("HESSIAN_EXACT", HessianApprox::EXACT)
       .value("HESSIAN_GAUSS_NEWTON", HessianApprox::GAUSS_NEWTON)
       .export_values();
+
+  bp::enum_<KktSolverChoice>("KktSolverChoice",
+                             "Choice of factorization for the stage KKT "
+                             "systems.")
+      .value("KKT_SOLVER_FULL_LDLT", KktSolverChoice::FULL_LDLT)
+      .value("KKT_SOLVER_SCHUR", KktSolverChoice::SCHUR)
+      .value("KKT_SOLVER_MIXED_PRECISION", KktSolverChoice::MIXED_PRECISION)
+      .export_values();
+
+  bp::enum_<LQSolverChoice>("LQSolverChoice",
+                            "Choice of solver for the linear-quadratic "
+                            "subproblems.")
+      .value("LQ_SOLVER_SERIAL", LQSolverChoice::SERIAL)
+      .value("LQ_SOLVER_PARALLEL", LQSolverChoice::PARALLEL)
+      .export_values();
 }
 
 } // namespace python
@@ -104,11 +104,11 @@ class CustomCallback(aligator.BaseCallback):
             return max([np.linalg.norm(x, np.inf) for x in xs])
 
         print("Lxs: ", end="")
-        Lxs = workspace.Lxs.tolist()
+        Lxs = workspace.Lxs
         if solver.force_initial_condition:
             Lxs = Lxs[1:]
         print("norm = {}".format(infNorm(Lxs)))
-        Lus = workspace.Lus.tolist()
+        Lus = workspace.Lus
         print("Lus: ", end="")
         print("norm = {}".format(infNorm(Lus)))
 
@@ -22,11 +22,12 @@ struct extract_kkt_matrix_callback : aligator::CallbackBaseTpl<double> {
   void call(const Workspace &ws_, const Results &) {
     const auto &ws = static_cast<const aligator::context::Workspace &>(ws_);
     for (std::size_t t = 0; t < ws.kkt_mats_.size(); t++) {
-      MatrixXd const &w = ws.kkt_mats_[t];
+      const MatrixXd w = ws.kkt_mats_[t];
       auto fname = fmt::format(KKTFILEFORMAT, filepath, t);
       cnpy::npy_save_mat(fname, w);
       auto fp2 = fmt::format(KKTFILEFORMAT, "kkt_vecs", t);
-      cnpy::npy_save_mat(fp2, ws.kkt_rhs_[t]);
+      const MatrixXd rhs = ws.kkt_rhs_[t];
+      cnpy::npy_save_mat(fp2, rhs);
     }
   }
 };
@@ -48,6 +48,9 @@ struct ActionModelWrapperTpl : StageModelTpl<Scalar> {
   void computeDerivatives(const ConstVectorRef &x, const ConstVectorRef &u,
                           const ConstVectorRef &y, Data &data) const;
 
+  void evaluateWithDerivatives(const ConstVectorRef &x, const ConstVectorRef &u,
+                               const ConstVectorRef &y, Data &data) const;
+
   shared_ptr<Data> createData() const;
 };
 
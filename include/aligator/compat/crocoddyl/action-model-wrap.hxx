@@ -62,6 +62,14 @@ void ActionModelWrapperTpl<Scalar>::computeDerivatives(const ConstVectorRef &x,
   ALIGATOR_NOMALLOC_END;
 }
 
+template <typename Scalar>
+void ActionModelWrapperTpl<Scalar>::evaluateWithDerivatives(
+    const ConstVectorRef &x, const ConstVectorRef &u, const ConstVectorRef &y,
+    Data &data) const {
+  evaluate(x, u, y, data);
+  computeDerivatives(x, u, y, data);
+}
+
 template <typename Scalar>
 auto ActionModelWrapperTpl<Scalar>::createData() const -> shared_ptr<Data> {
   return std::make_shared<ActionDataWrap>(action_model_);
@@ -78,6 +86,9 @@ ActionDataWrapperTpl<Scalar>::ActionDataWrapperTpl(
   this->constraint_data = {dynamics_data};
   this->cost_data =
       std::make_shared<CrocCostDataWrapperTpl<Scalar>>(croc_action_data);
+  this->x_eval.resize(croc_action_model->get_state()->get_nx());
+  this->u_eval.resize(croc_action_model->get_nu());
+  this->y_eval.resize(croc_action_model->get_state()->get_nx());
   checkData();
 }
 
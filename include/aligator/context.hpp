@@ -6,7 +6,11 @@
 namespace aligator {
 namespace context {
 
+#ifdef ALIGATOR_FLOAT_SCALAR
+using Scalar = float;
+#else
 using Scalar = double;
+#endif
 static constexpr int Options = 0;
 
 ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
@@ -50,6 +50,16 @@ public:
 
   const VectorXs &diagMatrix() const { return scaleMatDiag_; }
 
+  /// @brief Point the scaler to another constraint stack with the same
+  /// dimensions, keeping the weights. Used when the problem is cycled, see
+  /// SolverProxDDP::cycleProblem().
+  void rebind(const ConstraintStack &constraints) {
+    assert(constraints.size() == constraints_->size());
+    assert(constraints.totalDim() == constraints_->totalDim());
+    constraints_ = &constraints;
+    initMatrix();
+  }
+
 private:
   /// Initialize the penalty weight matrix
   void initMatrix();
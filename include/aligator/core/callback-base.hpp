@@ -12,6 +12,11 @@ template <typename Scalar> struct CallbackBaseTpl {
   virtual void call(const Workspace &, const Results &) = 0;
   /// Call this after linesearch.
   virtual void post_linesearch_call(boost::any) {}
+  /// Call this at the start of the solver run, before the first evaluation.
+  /// The callback may attach resources to the workspace (e.g. a TraceBuffer).
+  virtual void pre_run_call(Workspace &) {}
+  /// Call this at the end of the solver run.
+  virtual void post_run_call(const Workspace &, const Results &) {}
   virtual ~CallbackBaseTpl() = default;
 };
 
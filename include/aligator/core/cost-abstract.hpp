@@ -8,6 +8,18 @@
 #include <proxsuite-nlp/manifold-base.hpp>
 
 namespace aligator {
+
+/// @brief Sparsity structure of the Hessian of a cost, from the most to the
+/// least structured.
+enum class HessianStructure {
+  /// Only the diagonal is nonzero.
+  DIAGONAL,
+  /// The cross blocks \f$\ell_{xu}, \ell_{ux}\f$ are zero.
+  BLOCK_DIAGONAL,
+  /// No known structure.
+  DENSE
+};
+
 /** @brief Stage costs \f$ \ell(x, u) \f$ for control problems.
  */
 template <typename _Scalar> struct CostAbstractTpl {
@@ -40,6 +52,22 @@ template <typename _Scalar> struct CostAbstractTpl {
   virtual void computeHessians(const ConstVectorRef &x, const ConstVectorRef &u,
                                CostData &data) const = 0;
 
+  /// @brief Evaluate the cost, its gradients and Hessians at the same point.
+  /// @details The default implementation calls evaluate(), computeGradients()
+  /// then computeHessians(); override it to share intermediate results.
+  virtual void evaluateWithDerivatives(const ConstVectorRef &x,
+                                       const ConstVectorRef &u,
+                                       CostData &data) const {
+    this->evaluate(x, u, data);
+    this->computeGradients(x, u, data);
+    this->computeHessians(x, u, data);
+  }
+
+  /// @brief Whether the cost Hessians do not depend on \f$(x,u)\f$, e.g. for
+  /// quadratic costs. StageModelTpl::computeDerivatives() then computes them
+  /// once per data; the gradients are always recomputed.
+  virtual bool hasConstantHessians() const { return false; }
+
   virtual shared_ptr<CostData> createData() const {
     return std::make_shared<CostData>(ndx(), nu);
   }
@@ -68,6 +96,9 @@ template <typename _Scalar> struct CostDataAbstractTpl {
   MatrixRef Lux_;
   /// @brief Hessian \f$\ell_{uu}\f$
   MatrixRef Luu_;
+  /// @brief Structure of hess_, set by the cost in createData(). The entries
+  /// outside of the structure are zero and never written to.
+  HessianStructure hess_structure_;
 
   CostDataAbstractTpl(const int ndx, const int nu)
       : ndx_(ndx), nu_(nu), value_(0.), grad_(ndx + nu),
@@ -75,7 +106,8 @@ template <typename _Scalar> struct CostDataAbstractTpl {
         Lxx_(hess_.topLeftCorner(ndx, ndx)),
         Lxu_(hess_.topRightCorner(ndx, nu)),
         Lux_(hess_.bottomLeftCorner(nu, ndx)),
-        Luu_(hess_.bottomRightCorner(nu, nu)) {
+        Luu_(hess_.bottomRightCorner(nu, nu)),
+        hess_structure_(HessianStructure::DENSE) {
     grad_.setZero();
     hess_.setZero();
   }
@@ -21,4 +21,25 @@ enum struct MultiplierUpdateMode { NEWTON, PRIMAL, PRIMAL_DUAL };
 /// Whether to use merit functions in primal or primal-dual mode.
 enum struct LinesearchMode { PRIMAL = 0, PRIMAL_DUAL = 1 };
 
+/// Choice of factorization for the stage KKT systems.
+enum struct KktSolverChoice {
+  /// Factorize the full KKT matrix, with the routine given by LDLTChoice.
+  FULL_LDLT,
+  /// Block elimination exploiting the stage structure: only the Schur
+  /// complement on the controls is factorized.
+  SCHUR,
+  /// Factorize the full KKT matrix in single precision, and recover the
+  /// working precision by iterative refinement, with at least one step even
+  /// if SolverProxDDP::max_refinement_steps_ is zero.
+  MIXED_PRECISION
+};
+
+/// Choice of algorithm for solving the linear-quadratic subproblems.
+enum struct LQSolverChoice {
+  /// Sequential Riccati recursion.
+  SERIAL,
+  /// Parallel-in-time Riccati recursion, over legs of the horizon.
+  PARALLEL
+};
+
 } // namespace aligator
@@ -5,6 +5,7 @@
 #include "aligator/core/dynamics.hpp"
 
 #include <proxsuite-nlp/manifold-base.hpp>
+#include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
 
 #include <fmt/core.h>
 
@@ -41,13 +42,29 @@ public:
   void virtual dForward(const ConstVectorRef &x, const ConstVectorRef &u,
                         Data &data) const = 0;
 
+  /// @brief Evaluate the forward dynamics and their Jacobians.
+  /// @details The default implementation calls forward() then dForward().
+  virtual void forwardWithDerivatives(const ConstVectorRef &x,
+                                      const ConstVectorRef &u,
+                                      Data &data) const;
+
   void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
                 const ConstVectorRef &y, BaseData &data) const;
 
   void computeJacobians(const ConstVectorRef &x, const ConstVectorRef &u,
                         const ConstVectorRef &y, BaseData &data) const;
 
+  /// @brief Evaluate the residual and its Jacobians, through
+  /// forwardWithDerivatives().
+  void evaluateWithJacobians(const ConstVectorRef &x, const ConstVectorRef &u,
+                             const ConstVectorRef &y,
+                             BaseData &data) const override;
+
   virtual shared_ptr<BaseData> createData() const;
+
+private:
+  /// Compose the Jacobians of forward() with those of the difference to @p y.
+  void composeJacobians(const ConstVectorRef &y, Data &data) const;
 };
 
 /// @brief    Specific data struct for explicit dynamics
@@ -9,6 +9,13 @@ ExplicitDynamicsModelTpl<Scalar>::ExplicitDynamicsModelTpl(
     ManifoldPtr next_state, const int nu)
     : Base(next_state, nu, next_state) {}
 
+template <typename Scalar>
+void ExplicitDynamicsModelTpl<Scalar>::forwardWithDerivatives(
+    const ConstVectorRef &x, const ConstVectorRef &u, Data &data) const {
+  this->forward(x, u, data);
+  this->dForward(x, u, data);
+}
+
 template <typename Scalar>
 void ExplicitDynamicsModelTpl<Scalar>::evaluate(const ConstVectorRef &x,
                                                 const ConstVectorRef &u,
@@ -28,17 +35,39 @@ void ExplicitDynamicsModelTpl<Scalar>::computeJacobians(const ConstVectorRef &x,
                                                         BaseData &data) const {
   Data &data_ = static_cast<Data &>(data);
   this->dForward(x, u, data_);
+  composeJacobians(y, data_);
+}
+
+template <typename Scalar>
+void ExplicitDynamicsModelTpl<Scalar>::evaluateWithJacobians(
+    const ConstVectorRef &x, const ConstVectorRef &u, const ConstVectorRef &y,
+    BaseData &data) const {
+  Data &d = static_cast<Data &>(data);
+  this->forwardWithDerivatives(x, u, d);
+  this->space_next_->difference(y, d.xnext_, d.value_);
+  composeJacobians(y, d);
+}
+
+template <typename Scalar>
+void ExplicitDynamicsModelTpl<Scalar>::composeJacobians(const ConstVectorRef &y,
+                                                        Data &data) const {
   // compose by jacobians of log (xout - y)
-  this->space_next_->Jdifference(y, data_.xnext_, data_.Jy_, 0);
-  this->space_next_->Jdifference(y, data_.xnext_, data_.Jtmp_xnext, 1);
-  data_.Jx_ = data_.Jtmp_xnext * data_.Jx_;
-  data_.Ju_ = data_.Jtmp_xnext * data_.Ju_;
+  this->space_next_->Jdifference(y, data.xnext_, data.Jy_, 0);
+  this->space_next_->Jdifference(y, data.xnext_, data.Jtmp_xnext, 1);
+  data.Jx_ = data.Jtmp_xnext * data.Jx_;
+  data.Ju_ = data.Jtmp_xnext * data.Ju_;
 }
 
 template <typename Scalar>
 shared_ptr<DynamicsDataTpl<Scalar>>
 ExplicitDynamicsModelTpl<Scalar>::createData() const {
-  return std::make_shared<Data>(this->ndx1, this->nu, this->nx2(), this->ndx2);
+  using VectorSpace = proxsuite::nlp::VectorSpaceTpl<Scalar, Eigen::Dynamic>;
+  auto data =
+      std::make_shared<Data>(this->ndx1, this->nu, this->nx2(), this->ndx2);
+  // on a vector space, Jy = -I
+  if (dynamic_cast<const VectorSpace *>(this->space_next_.get()))
+    data->Jy_structure_ = JacobianStructure::DIAGONAL;
+  return data;
 }
 
 template <typename Scalar>
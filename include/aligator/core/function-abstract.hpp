@@ -5,6 +5,7 @@
 
 #include "aligator/fwd.hpp"
 #include "aligator/core/clone.hpp"
+#include "aligator/core/jacobian-structure.hpp"
 
 #include <fmt/format.h>
 #include <ostream>
@@ -62,6 +63,28 @@ public:
                                 const ConstVectorRef &u,
                                 const ConstVectorRef &y, Data &data) const = 0;
 
+  /** @brief    Evaluate the function and compute its Jacobians at the same
+   * point.
+   *
+   * @details   The default implementation calls evaluate() then
+   * computeJacobians(). Override it when the Jacobians share intermediate
+   * results with the value, to compute them in a single pass.
+   */
+  virtual void evaluateWithJacobians(const ConstVectorRef &x,
+                                     const ConstVectorRef &u,
+                                     const ConstVectorRef &y,
+                                     Data &data) const;
+
+  /** @brief    Whether the Jacobians of this function do not depend on the
+   * point \f$(x,u,y)\f$, e.g. when the function is linear or affine.
+   *
+   * @details   StageModelTpl::computeDerivatives() then computes them once per
+   * data, and the solvers may cache the blocks of their KKT systems built from
+   * them. If the parameters of the function change, the stage data must be
+   * invalidated (see StageDataTpl::invalidateEvaluation()).
+   */
+  virtual bool hasConstantJacobians() const { return false; }
+
   /** @brief    Compute the vector-hessian products of this function.
    *
    *  @param x     Current state.
@@ -110,6 +133,14 @@ struct StageFunctionDataTpl : Cloneable<StageFunctionDataTpl<_Scalar>> {
   /// Jacobian with respect to \f$y\f$.
   MatrixRef Jy_;
 
+  /// @name Structure of the Jacobian blocks
+  /// Set by the function in createData(), see JacobianStructure.
+  /// @{
+  JacobianStructure Jx_structure_;
+  JacobianStructure Ju_structure_;
+  JacobianStructure Jy_structure_;
+  /// @}
+
   /* Vector-Hessian product buffers */
 
   MatrixRef Hxx_;
@@ -15,6 +15,15 @@ StageFunctionTpl<Scalar>::StageFunctionTpl(const int ndx, const int nu,
                                            const int nr)
     : StageFunctionTpl(ndx, nu, ndx, nr) {}
 
+template <typename Scalar>
+void StageFunctionTpl<Scalar>::evaluateWithJacobians(const ConstVectorRef &x,
+                                                     const ConstVectorRef &u,
+                                                     const ConstVectorRef &y,
+                                                     Data &data) const {
+  this->evaluate(x, u, y, data);
+  this->computeJacobians(x, u, y, data);
+}
+
 template <typename Scalar>
 void StageFunctionTpl<Scalar>::computeVectorHessianProducts(
     const ConstVectorRef &, const ConstVectorRef &, const ConstVectorRef &,
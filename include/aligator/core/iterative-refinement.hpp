@@ -26,7 +26,7 @@ template <typename Scalar> struct IterativeRefinementVisitor {
       err = -rhs;
       err.noalias() -= mat * Xout;
 
-      if (math::infty_norm(err) > refinement_threshold)
+      if (math::infty_norm(err) <= refinement_threshold)
         return true;
 
       ldlt.solveInPlace(err);
@@ -36,10 +36,10 @@ template <typename Scalar> struct IterativeRefinementVisitor {
     }
   }
 
-  const MatrixXs &mat;
-  const MatrixXs &rhs;
-  MatrixXs &err;
-  Eigen::Ref<MatrixXs> Xout;
+  ConstMatrixRef mat;
+  ConstMatrixRef rhs;
+  MatrixRef err;
+  MatrixRef Xout;
   const Scalar refinement_threshold;
   const std::size_t max_refinement_steps;
 };
@@ -0,0 +1,96 @@
+/// @file
+/// @brief Sparsity structure of the Jacobian blocks of stage functions.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/fwd.hpp"
+
+#include <vector>
+
+namespace aligator {
+
+/// @brief Sparsity structure of a Jacobian block of StageFunctionDataTpl.
+///
+/// @details The values of a block are always stored in the dense buffers of
+/// the data; the structure only lets the solvers use cheaper kernels, e.g.
+/// addJacobianTransposeProduct(). Functions set the structure of their blocks
+/// in createData(); the default is DENSE.
+struct JacobianStructure {
+  enum Type {
+    /// No known structure.
+    DENSE,
+    /// The block is zero.
+    ZERO,
+    /// Square block, zero outside of its diagonal (e.g. \f$\pm I\f$).
+    DIAGONAL,
+    /// At most one nonzero entry per row, in the column given by cols (e.g.
+    /// for bounds or slices).
+    SELECTION
+  };
+
+  Type type;
+  /// For SELECTION blocks: column of the nonzero entry of each row, or -1 if
+  /// the row is zero.
+  Eigen::VectorXi cols;
+
+  JacobianStructure(Type type = DENSE) : type(type) {}
+
+  /// Structure of a block with the nonzero entry of row @p i in column
+  /// `cols[i]`.
+  static JacobianStructure selection(const Eigen::VectorXi &cols) {
+    JacobianStructure s(SELECTION);
+    s.cols = cols;
+    return s;
+  }
+
+  bool isZero() const { return type == ZERO; }
+
+  /// @brief Structure of the rows @p indices of the block, e.g. for a slice
+  /// of the function.
+  JacobianStructure sliceRows(const std::vector<int> &indices) const {
+    const Eigen::Index n = (Eigen::Index)indices.size();
+    switch (type) {
+    case DIAGONAL:
+      return selection(Eigen::Map<const Eigen::VectorXi>(indices.data(), n));
+    case SELECTION: {
+      JacobianStructure s(SELECTION);
+      s.cols.resize(n);
+      for (Eigen::Index i = 0; i < n; i++)
+        s.cols[i] = cols[indices[(std::size_t)i]];
+      return s;
+    }
+    default:
+      return *this;
+    }
+  }
+};
+
+/// @brief Add the product \f$J^\top v\f$ to @p out, for a Jacobian block
+/// @p J with structure @p structure. This costs \f$O(n_r)\f$ operations for
+/// the diagonal and selection blocks, and nothing for the zero blocks.
+template <typename Scalar>
+void addJacobianTransposeProduct(
+    const JacobianStructure &structure,
+    const typename math_types<Scalar>::ConstMatrixRef &J,
+    const typename math_types<Scalar>::ConstVectorRef &v,
+    typename math_types<Scalar>::VectorRef out) {
+  switch (structure.type) {
+  case JacobianStructure::ZERO:
+    break;
+  case JacobianStructure::DIAGONAL:
+    out.array() += J.diagonal().array() * v.array();
+    break;
+  case JacobianStructure::SELECTION:
+    for (Eigen::Index i = 0; i < J.rows(); i++) {
+      const int c = structure.cols[i];
+      if (c >= 0)
+        out[c] += J(i, c) * v[i];
+    }
+    break;
+  default:
+    out.noalias() += J.transpose() * v;
+    break;
+  }
+}
+
+} // namespace aligator
@@ -3,6 +3,9 @@
 #pragma once
 
 #include "aligator/fwd.hpp"
+#include "aligator/utils/timings.hpp"
+#include "aligator/utils/allocation-audit.hpp"
+#include "aligator/utils/matrix-arena.hpp"
 
 namespace aligator {
 
@@ -25,8 +28,8 @@ public:
   /// Overall dual infeasibility measure.
   Scalar dual_infeas = 0.;
 
-  /// Riccati gains
-  std::vector<MatrixXs> gains_;
+  /// Riccati gains, stored in one buffer.
+  MatrixArenaTpl<Scalar> gains_;
   /// States
   std::vector<VectorXs> xs;
   /// Controls
@@ -34,6 +37,15 @@ public:
   /// Problem Lagrange multipliers
   std::vector<VectorXs> lams;
 
+  /// Time spent in each phase of the solver during the last run. Only recorded
+  /// if aligator was compiled with ALIGATOR_ENABLE_TIMINGS.
+  PhaseTimings timings;
+  /// Time spent in each phase, per iteration of the last run.
+  std::vector<PhaseTimings> iter_timings;
+  /// Heap allocations made during the last run. Only recorded if aligator was
+  /// compiled with ALIGATOR_ENABLE_ALLOCATION_AUDIT.
+  AllocationReport allocations;
+
   ResultsBaseTpl() : m_isInitialized(false) {}
   bool isInitialized() const { return m_isInitialized; }
 
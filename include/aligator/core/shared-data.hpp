@@ -0,0 +1,64 @@
+/// @file
+/// @brief Sharing of data objects between the functions of a stage.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/fwd.hpp"
+
+#include <typeindex>
+#include <vector>
+
+namespace aligator {
+
+/// @brief Scope in which the data of several functions can share objects.
+///
+/// @details While a scope is alive, calls to get() on the same thread for the
+/// same type @p T and equal keys return the same object. Stage models open a
+/// scope around the creation of their data, so that e.g. the multibody
+/// functions of a stage share their kinematics. Scopes nest: the innermost
+/// scope of the thread is used, and opening a scope hides the objects of the
+/// enclosing ones. Without a scope, get() always makes a new object.
+class SharedDataScope {
+public:
+  SharedDataScope() : previous_(current()) { current() = this; }
+  ~SharedDataScope() { current() = previous_; }
+  SharedDataScope(const SharedDataScope &) = delete;
+  SharedDataScope &operator=(const SharedDataScope &) = delete;
+
+  /// @brief Object of type @p T for @p key in the current scope, made by
+  /// `make()` if there is none.
+  /// @details Keys are compared by address, then with `operator==`: they
+  /// must outlive the scope, and @p T must always be used with the same key
+  /// type.
+  template <typename T, typename Key, typename Make>
+  static shared_ptr<T> get(const Key &key, Make &&make) {
+    SharedDataScope *scope = current();
+    if (!scope)
+      return make();
+    for (const Entry &e : scope->entries_) {
+      if (e.type == std::type_index(typeid(T)) &&
+          (e.key == &key || *static_cast<const Key *>(e.key) == key))
+        return std::static_pointer_cast<T>(e.value);
+    }
+    shared_ptr<T> value = make();
+    scope->entries_.push_back({std::type_index(typeid(T)), &key, value});
+    return value;
+  }
+
+private:
+  struct Entry {
+    std::type_index type;
+    const void *key;
+    shared_ptr<void> value;
+  };
+
+  static SharedDataScope *&current() {
+    static thread_local SharedDataScope *scope = nullptr;
+    return scope;
+  }
+
+  SharedDataScope *previous_;
+  std::vector<Entry> entries_;
+};
+
+} // namespace aligator
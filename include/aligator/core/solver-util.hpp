@@ -77,6 +77,8 @@ void check_trajectory_and_assign(
 }
 
 /// @brief  Compute the derivatives of the problem Lagrangian.
+/// @details The products with the constraint Jacobians use the structure of
+/// their blocks (see JacobianStructure).
 template <typename Scalar>
 void computeLagrangianDerivatives(
     const TrajOptProblemTpl<Scalar> &problem, WorkspaceTpl<Scalar> &workspace,
@@ -91,16 +93,17 @@ void computeLagrangianDerivatives(
   using ConstVectorRef = typename math_types<Scalar>::ConstVectorRef;
 
   TrajOptData const &pd = workspace.problem_data;
-  std::vector<VectorXs> &Lxs = workspace.Lxs_;
-  std::vector<VectorXs> &Lus = workspace.Lus_;
+  auto &Lxs = workspace.Lxs_;
+  auto &Lus = workspace.Lus_;
 
   std::size_t nsteps = workspace.nsteps;
 
-  math::setZero(Lxs);
-  math::setZero(Lus);
+  Lxs.setZero();
+  Lus.setZero();
   {
     StageFunctionData const &ind = pd.getInitData();
-    Lxs[0] += ind.Jx_.transpose() * lams[0];
+    addJacobianTransposeProduct<Scalar>(ind.Jx_structure_, ind.Jx_, lams[0],
+                                        Lxs[0]);
   }
 
   {
@@ -110,8 +113,9 @@ void computeLagrangianDerivatives(
     VectorXs const &lamN = lams.back();
     for (std::size_t j = 0; j < stack.size(); j++) {
       StageFunctionData const &cstr_data = *pd.term_cstr_data[j];
-      auto lam_j = stack.constSegmentByConstraint(lamN, j);
-      Lxs[nsteps] += cstr_data.Jx_.transpose() * lam_j;
+      ConstVectorRef lam_j = stack.constSegmentByConstraint(lamN, j);
+      addJacobianTransposeProduct<Scalar>(cstr_data.Jx_structure_,
+                                          cstr_data.Jx_, lam_j, Lxs[nsteps]);
     }
   }
 
@@ -127,12 +131,15 @@ void computeLagrangianDerivatives(
     for (std::size_t j = 0; j < stack.size(); j++) {
       StageFunctionData const &cstr_data = *sd.constraint_data[j];
       ConstVectorRef lam_j = stack.constSegmentByConstraint(lams[i + 1], j);
-      Lxs[i] += cstr_data.Jx_.transpose() * lam_j;
-      Lus[i] += cstr_data.Ju_.transpose() * lam_j;
+      addJacobianTransposeProduct<Scalar>(cstr_data.Jx_structure_,
+                                          cstr_data.Jx_, lam_j, Lxs[i]);
+      addJacobianTransposeProduct<Scalar>(cstr_data.Ju_structure_,
+                                          cstr_data.Ju_, lam_j, Lus[i]);
 
       assert((i + 1) <= nsteps);
       // add contribution to the next node
-      Lxs[i + 1] += cstr_data.Jy_.transpose() * lam_j;
+      addJacobianTransposeProduct<Scalar>(cstr_data.Jy_structure_,
+                                          cstr_data.Jy_, lam_j, Lxs[i + 1]);
     }
   }
 }
@@ -23,6 +23,26 @@ struct StageDataTpl : Cloneable<StageDataTpl<_Scalar>> {
   /// Data for the running costs.
   shared_ptr<CostDataAbstract> cost_data;
 
+  /// @name Evaluation point
+  /// Point \f$(x,u,y)\f$ at which the data was last evaluated, see
+  /// StageModelTpl::evaluate(). StageModelTpl::computeDerivatives() reuses the
+  /// intermediate results of the evaluation at this point.
+  /// @{
+  VectorXs x_eval;
+  VectorXs u_eval;
+  VectorXs y_eval;
+  bool has_eval = false;
+  /// Whether the first- and second-order derivatives were also computed at
+  /// the evaluation point.
+  bool has_derivatives = false;
+  /// @}
+
+  /// Whether the derivatives declared constant by the functions and cost of
+  /// the stage (see StageFunctionTpl::hasConstantJacobians() and
+  /// CostAbstractTpl::hasConstantHessians()) were computed; they are not
+  /// computed again.
+  bool has_constant_derivatives = false;
+
   /// @brief    Constructor.
   ///
   /// @details  The constructor initializes or fills in the data members using
@@ -33,6 +53,30 @@ struct StageDataTpl : Cloneable<StageDataTpl<_Scalar>> {
 
   DynamicsData &dyn_data() { return *dynamics_data; }
 
+  /// @brief Record the point the data was evaluated at.
+  void setEvaluationPoint(const ConstVectorRef &x, const ConstVectorRef &u,
+                          const ConstVectorRef &y) {
+    x_eval = x;
+    u_eval = u;
+    y_eval = y;
+    has_eval = true;
+    has_derivatives = false;
+  }
+
+  /// @brief Whether the data was evaluated at the point \f$(x,u,y)\f$.
+  bool isEvaluatedAt(const ConstVectorRef &x, const ConstVectorRef &u,
+                     const ConstVectorRef &y) const {
+    return has_eval && (x_eval == x) && (u_eval == u) && (y_eval == y);
+  }
+
+  /// @brief Forget the evaluation point, e.g. when the parameters of the stage
+  /// model changed.
+  void invalidateEvaluation() {
+    has_eval = false;
+    has_derivatives = false;
+    has_constant_derivatives = false;
+  }
+
   const DynamicsData &dyn_data() const { return *dynamics_data; }
 
   /// @brief Check data integrity.
@@ -13,7 +13,9 @@ namespace aligator {
 template <typename Scalar>
 StageDataTpl<Scalar>::StageDataTpl(const StageModel &stage_model)
     : constraint_data(stage_model.numConstraints()),
-      cost_data(stage_model.cost_->createData()) {
+      cost_data(stage_model.cost_->createData()),
+      x_eval(stage_model.nx1()), u_eval(stage_model.uspace_->nx()),
+      y_eval(stage_model.nx2()) {
   using Function = StageFunctionTpl<Scalar>;
   const std::size_t nc = stage_model.numConstraints();
   constraint_data.reserve(nc);
@@ -95,11 +95,43 @@ public:
   virtual void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
                         const ConstVectorRef &y, Data &data) const;
 
+  /// @brief    Evaluate the constraints other than the dynamics at the next
+  /// state @p y, after a rollout moved it following evaluate().
+  /// @details  The cost and dynamics data are left as they are: the caller sets
+  /// the dynamics residual at @p y. The data is then recorded as evaluated at
+  /// \f$(x,u,y)\f$.
+  void evaluateAtNextState(const ConstVectorRef &x, const ConstVectorRef &u,
+                           const ConstVectorRef &y, Data &data) const;
+
   /// @brief    Compute the derivatives of the StageModelTpl.
+  /// @details  If @p data was not evaluated at this point, this calls
+  /// evaluateWithDerivatives(). If the derivatives were already computed at
+  /// this point, this does nothing.
   virtual void computeDerivatives(const ConstVectorRef &x,
                                   const ConstVectorRef &u,
                                   const ConstVectorRef &y, Data &data) const;
 
+  /// @brief    Evaluate all the functions and their derivatives at this node,
+  /// with the combined calls StageFunctionTpl::evaluateWithJacobians() and
+  /// CostAbstractTpl::evaluateWithDerivatives().
+  virtual void evaluateWithDerivatives(const ConstVectorRef &x,
+                                       const ConstVectorRef &u,
+                                       const ConstVectorRef &y,
+                                       Data &data) const;
+
+  /// @brief    Compute the vector-Hessian products of the constraints (including
+  /// the dynamics) with their multipliers, for the exact Hessian of the
+  /// Lagrangian.
+  /// @details  Call computeDerivatives() first. Constraints whose multipliers
+  /// are all zero (e.g. inactive inequality constraints) are skipped, and
+  /// their products set to zero.
+  /// @param lams Multipliers of the stacked constraints.
+  virtual void computeVectorHessianProducts(const ConstVectorRef &x,
+                                            const ConstVectorRef &u,
+                                            const ConstVectorRef &y,
+                                            const ConstVectorRef &lams,
+                                            Data &data) const;
+
   /// @brief    Create a Data object.
   virtual shared_ptr<Data> createData() const;
 
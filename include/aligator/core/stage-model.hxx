@@ -3,7 +3,9 @@
 #pragma once
 
 #include "aligator/core/stage-model.hpp"
+#include "aligator/core/shared-data.hpp"
 #include "aligator/utils/exceptions.hpp"
+#include "aligator/utils/allocation-audit.hpp"
 
 #include <proxsuite-nlp/modelling/constraints/equality-constraint.hpp>
 #include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
@@ -80,9 +82,27 @@ void StageModelTpl<Scalar>::evaluate(const ConstVectorRef &x,
                                      Data &data) const {
   for (std::size_t j = 0; j < numConstraints(); j++) {
     const Constraint &cstr = constraints_[j];
+    ScopedAllocationFunction site(*cstr.func);
     cstr.func->evaluate(x, u, y, *data.constraint_data[j]);
   }
-  cost_->evaluate(x, u, *data.cost_data);
+  {
+    ScopedAllocationFunction site(*cost_);
+    cost_->evaluate(x, u, *data.cost_data);
+  }
+  data.setEvaluationPoint(x, u, y);
+}
+
+template <typename Scalar>
+void StageModelTpl<Scalar>::evaluateAtNextState(const ConstVectorRef &x,
+                                                const ConstVectorRef &u,
+                                                const ConstVectorRef &y,
+                                                Data &data) const {
+  for (std::size_t j = 1; j < numConstraints(); j++) {
+    const Constraint &cstr = constraints_[j];
+    ScopedAllocationFunction site(*cstr.func);
+    cstr.func->evaluate(x, u, y, *data.constraint_data[j]);
+  }
+  data.setEvaluationPoint(x, u, y);
 }
 
 template <typename Scalar>
@@ -90,16 +110,80 @@ void StageModelTpl<Scalar>::computeDerivatives(const ConstVectorRef &x,
                                                const ConstVectorRef &u,
                                                const ConstVectorRef &y,
                                                Data &data) const {
+  // the derivatives reuse intermediate results of the evaluation
+  if (data.isEvaluatedAt(x, u, y)) {
+    if (data.has_derivatives)
+      return;
+    const bool skip_constant = data.has_constant_derivatives;
+    for (std::size_t j = 0; j < numConstraints(); j++) {
+      const Constraint &cstr = constraints_[j];
+      if (skip_constant && cstr.func->hasConstantJacobians())
+        continue;
+      ScopedAllocationFunction site(*cstr.func);
+      cstr.func->computeJacobians(x, u, y, *data.constraint_data[j]);
+    }
+    ScopedAllocationFunction site(*cost_);
+    cost_->computeGradients(x, u, *data.cost_data);
+    if (!(skip_constant && cost_->hasConstantHessians()))
+      cost_->computeHessians(x, u, *data.cost_data);
+  } else {
+    evaluateWithDerivatives(x, u, y, data);
+  }
+  data.has_derivatives = true;
+  data.has_constant_derivatives = true;
+}
+
+template <typename Scalar>
+void StageModelTpl<Scalar>::evaluateWithDerivatives(const ConstVectorRef &x,
+                                                    const ConstVectorRef &u,
+                                                    const ConstVectorRef &y,
+                                                    Data &data) const {
+  // constant derivatives were computed along a previous evaluation
+  const bool skip_constant = data.has_constant_derivatives;
+  for (std::size_t j = 0; j < numConstraints(); j++) {
+    const Constraint &cstr = constraints_[j];
+    StageFunctionDataTpl<Scalar> &cd = *data.constraint_data[j];
+    ScopedAllocationFunction site(*cstr.func);
+    if (skip_constant && cstr.func->hasConstantJacobians())
+      cstr.func->evaluate(x, u, y, cd);
+    else
+      cstr.func->evaluateWithJacobians(x, u, y, cd);
+  }
+  {
+    ScopedAllocationFunction site(*cost_);
+    if (skip_constant && cost_->hasConstantHessians()) {
+      cost_->evaluate(x, u, *data.cost_data);
+      cost_->computeGradients(x, u, *data.cost_data);
+    } else {
+      cost_->evaluateWithDerivatives(x, u, *data.cost_data);
+    }
+  }
+  data.setEvaluationPoint(x, u, y);
+  data.has_derivatives = true;
+  data.has_constant_derivatives = true;
+}
+
+template <typename Scalar>
+void StageModelTpl<Scalar>::computeVectorHessianProducts(
+    const ConstVectorRef &x, const ConstVectorRef &u, const ConstVectorRef &y,
+    const ConstVectorRef &lams, Data &data) const {
   for (std::size_t j = 0; j < numConstraints(); j++) {
     const Constraint &cstr = constraints_[j];
-    cstr.func->computeJacobians(x, u, y, *data.constraint_data[j]);
+    StageFunctionDataTpl<Scalar> &cstr_data = *data.constraint_data[j];
+    auto lam_j = constraints_.constSegmentByConstraint(lams, j);
+    if (lam_j.isZero(0)) {
+      cstr_data.vhp_buffer_.setZero();
+      continue;
+    }
+    ScopedAllocationFunction site(*cstr.func);
+    cstr.func->computeVectorHessianProducts(x, u, y, lam_j, cstr_data);
   }
-  cost_->computeGradients(x, u, *data.cost_data);
-  cost_->computeHessians(x, u, *data.cost_data);
 }
 
 template <typename Scalar>
 auto StageModelTpl<Scalar>::createData() const -> shared_ptr<Data> {
+  // the functions of the stage can share e.g. their multibody kinematics
+  SharedDataScope scope;
   return std::make_shared<Data>(*this);
 }
 
@@ -4,6 +4,9 @@
 
 #include "aligator/core/stage-model.hpp"
 #include "aligator/modelling/state-error.hpp"
+#include "aligator/utils/thread-pool.hpp"
+#include "aligator/utils/trace.hpp"
+#include "aligator/utils/allocation-audit.hpp"
 
 namespace aligator {
 
@@ -153,11 +156,24 @@ template <typename _Scalar> struct TrajOptProblemTpl {
   std::size_t numSteps() const;
 
   /// @brief Rollout the problem costs, constraints, dynamics, stage per stage.
+  /// @details The stages are evaluated in parallel on the thread pool of
+  /// @p prob_data, if any. The returned trajectory cost is summed in stage
+  /// order, and does not depend on the number of threads.
   Scalar evaluate(const std::vector<VectorXs> &xs,
                   const std::vector<VectorXs> &us, Data &prob_data) const;
 
+  /// @brief Rollout the problem costs, constraints, dynamics and their
+  /// derivatives, with the combined calls of StageModelTpl::
+  /// evaluateWithDerivatives(). A following computeDerivatives() at the same
+  /// point does not recompute the stage derivatives.
+  Scalar evaluateWithDerivatives(const std::vector<VectorXs> &xs,
+                                 const std::vector<VectorXs> &us,
+                                 Data &prob_data) const;
+
   /**
    * @brief Rollout the problem derivatives, stage per stage.
+   * @details The stages are processed in parallel on the thread pool of
+   * @p prob_data, if any.
    *
    * @param xs State sequence
    * @param us Control sequence
@@ -166,8 +182,22 @@ template <typename _Scalar> struct TrajOptProblemTpl {
                           const std::vector<VectorXs> &us,
                           Data &prob_data) const;
 
-  /// @brief Pop out the first StageModel and replace by the supplied one;
-  /// updates the supplied problem data (TrajOptDataTpl) object.
+  /**
+   * @brief Rollout the problem derivatives, and the vector-Hessian products of
+   * the constraints with their multipliers @p lams.
+   * @details The products are computed in the same parallel loop as the
+   * derivatives of each stage. Constraints with zero multipliers are skipped.
+   *
+   * @param lams Multipliers: initial condition, one vector per stage, then the
+   * terminal constraints (if any).
+   */
+  void computeDerivatives(const std::vector<VectorXs> &xs,
+                          const std::vector<VectorXs> &us,
+                          const std::vector<VectorXs> &lams,
+                          Data &prob_data) const;
+
+  /// @brief Pop out the first StageModel and append the supplied one. This
+  /// does not allocate.
   void replaceStageCircular(const shared_ptr<StageModel> &model);
 
   /// @brief Helper for computing the trajectory cost (from pre-computed problem
@@ -176,6 +206,8 @@ template <typename _Scalar> struct TrajOptProblemTpl {
   Scalar computeTrajectoryCost(const Data &problem_data) const;
 
   /// @brief  Set the number of threads for multithreaded evaluation.
+  /// @details This is the size of the thread pool the solvers create in their
+  /// setup().
   void setNumThreads(std::size_t num_threads) {
 #ifndef ALIGATOR_MULTITHREADING
     fmt::print("{} does nothing: aligator was not compiled with multithreading "
@@ -195,6 +227,15 @@ protected:
   void checkStages() const;
 
 private:
+  Scalar evaluateImpl(const std::vector<VectorXs> &xs,
+                      const std::vector<VectorXs> &us, bool with_derivatives,
+                      Data &prob_data) const;
+
+  void computeDerivativesImpl(const std::vector<VectorXs> &xs,
+                              const std::vector<VectorXs> &us,
+                              const std::vector<VectorXs> *lams,
+                              Data &prob_data) const;
+
   static auto createStateError(const ConstVectorRef &x0,
                                const shared_ptr<Manifold> &space,
                                const int nu) {
@@ -225,6 +266,12 @@ template <typename _Scalar> struct TrajOptDataTpl {
 
   /// Copy of xs to fill in (for data parallelism)
   std::vector<VectorXs> xs_copy;
+  /// Thread pool the stages are evaluated on, set by the solvers. If null,
+  /// the stages are evaluated sequentially.
+  ThreadPool *thread_pool = nullptr;
+  /// Buffer the stage evaluations and derivatives are traced to, set by a
+  /// TraceCallbackTpl. If null, nothing is traced.
+  TraceBuffer *trace = nullptr;
 
   TrajOptDataTpl() = default;
   TrajOptDataTpl(const TrajOptProblemTpl<Scalar> &problem);
@@ -238,6 +285,14 @@ template <typename _Scalar> struct TrajOptDataTpl {
   StageFunctionData &getInitData() { return *init_data; }
   /// @copydoc getInitData()
   const StageFunctionData &getInitData() const { return *init_data; }
+
+  /// @brief Forget the evaluations of all stage datas, including their
+  /// constant derivatives (see StageDataTpl::invalidateEvaluation()), e.g.
+  /// when the parameters of the problem changed.
+  void invalidateEvaluations() {
+    for (const shared_ptr<StageData> &sd : stage_data)
+      sd->invalidateEvaluation();
+  }
 };
 
 } // namespace aligator
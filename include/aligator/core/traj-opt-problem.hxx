@@ -2,6 +2,7 @@
 
 #include "aligator/core/traj-opt-problem.hpp"
 #include "aligator/core/stage-data.hpp"
+#include "aligator/core/shared-data.hpp"
 #include "aligator/utils/exceptions.hpp"
 #include "aligator/utils/mpc-util.hpp"
 #include "aligator/threads.hpp"
@@ -59,6 +60,21 @@ template <typename Scalar>
 Scalar TrajOptProblemTpl<Scalar>::evaluate(const std::vector<VectorXs> &xs,
                                            const std::vector<VectorXs> &us,
                                            Data &prob_data) const {
+  return evaluateImpl(xs, us, false, prob_data);
+}
+
+template <typename Scalar>
+Scalar TrajOptProblemTpl<Scalar>::evaluateWithDerivatives(
+    const std::vector<VectorXs> &xs, const std::vector<VectorXs> &us,
+    Data &prob_data) const {
+  return evaluateImpl(xs, us, true, prob_data);
+}
+
+template <typename Scalar>
+Scalar TrajOptProblemTpl<Scalar>::evaluateImpl(const std::vector<VectorXs> &xs,
+                                               const std::vector<VectorXs> &us,
+                                               bool with_derivatives,
+                                               Data &prob_data) const {
   const std::size_t nsteps = numSteps();
   const bool sizes_correct = (xs.size() == nsteps + 1) && (us.size() == nsteps);
   if (!sizes_correct) {
@@ -67,18 +83,33 @@ Scalar TrajOptProblemTpl<Scalar>::evaluate(const std::vector<VectorXs> &xs,
   }
 
   init_condition_->evaluate(xs[0], prob_data.getInitData());
+  if (with_derivatives)
+    init_condition_->computeJacobians(xs[0], prob_data.getInitData());
 
   auto &sds = prob_data.stage_data;
-  for (std::size_t i = 0; i < nsteps; i++) {
-    stages_[i]->evaluate(xs[i], us[i], xs[i + 1], *sds[i]);
-  }
-
-  term_cost_->evaluate(xs[nsteps], unone_, *prob_data.term_cost_data);
+  const AllocationSite alloc_site = AllocationAudit::currentSite();
+  parallel_for(prob_data.thread_pool, 0, nsteps, [&](std::size_t i) {
+    ScopedTrace span(prob_data.trace, "evaluate", i);
+    ScopedAllocationStage stage_site(alloc_site, i);
+    if (with_derivatives)
+      stages_[i]->evaluateWithDerivatives(xs[i], us[i], xs[i + 1], *sds[i]);
+    else
+      stages_[i]->evaluate(xs[i], us[i], xs[i + 1], *sds[i]);
+  });
+
+  if (with_derivatives)
+    term_cost_->evaluateWithDerivatives(xs[nsteps], unone_,
+                                        *prob_data.term_cost_data);
+  else
+    term_cost_->evaluate(xs[nsteps], unone_, *prob_data.term_cost_data);
 
   for (std::size_t k = 0; k < term_cstrs_.size(); ++k) {
     const ConstraintType &tc = term_cstrs_[k];
     auto &td = prob_data.term_cstr_data[k];
-    tc.func->evaluate(xs[nsteps], unone_, xs[nsteps], *td);
+    if (with_derivatives)
+      tc.func->evaluateWithJacobians(xs[nsteps], unone_, xs[nsteps], *td);
+    else
+      tc.func->evaluate(xs[nsteps], unone_, xs[nsteps], *td);
   }
   prob_data.cost_ = computeTrajectoryCost(prob_data);
   return prob_data.cost_;
@@ -88,6 +119,25 @@ template <typename Scalar>
 void TrajOptProblemTpl<Scalar>::computeDerivatives(
     const std::vector<VectorXs> &xs, const std::vector<VectorXs> &us,
     Data &prob_data) const {
+  computeDerivativesImpl(xs, us, nullptr, prob_data);
+}
+
+template <typename Scalar>
+void TrajOptProblemTpl<Scalar>::computeDerivatives(
+    const std::vector<VectorXs> &xs, const std::vector<VectorXs> &us,
+    const std::vector<VectorXs> &lams, Data &prob_data) const {
+  const std::size_t nlams = numSteps() + 1 + !term_cstrs_.empty();
+  if (lams.size() != nlams) {
+    ALIGATOR_RUNTIME_ERROR(
+        fmt::format("Wrong size for lams, expected {:d}", nlams));
+  }
+  computeDerivativesImpl(xs, us, &lams, prob_data);
+}
+
+template <typename Scalar>
+void TrajOptProblemTpl<Scalar>::computeDerivativesImpl(
+    const std::vector<VectorXs> &xs, const std::vector<VectorXs> &us,
+    const std::vector<VectorXs> *lams, Data &prob_data) const {
   const std::size_t nsteps = numSteps();
   const bool sizes_correct = (xs.size() == nsteps + 1) && (us.size() == nsteps);
   if (!sizes_correct) {
@@ -100,11 +150,16 @@ void TrajOptProblemTpl<Scalar>::computeDerivatives(
   prob_data.xs_copy = xs;
   auto &sds = prob_data.stage_data;
 
-#pragma omp parallel for num_threads(num_threads_)
-  for (std::size_t i = 0; i < nsteps; i++) {
+  const AllocationSite alloc_site = AllocationAudit::currentSite();
+  parallel_for(prob_data.thread_pool, 0, nsteps, [&](std::size_t i) {
+    ScopedTrace span(prob_data.trace, "derivatives", i);
+    ScopedAllocationStage stage_site(alloc_site, i);
     stages_[i]->computeDerivatives(xs[i], us[i], prob_data.xs_copy[i + 1],
                                    *sds[i]);
-  }
+    if (lams)
+      stages_[i]->computeVectorHessianProducts(
+          xs[i], us[i], prob_data.xs_copy[i + 1], (*lams)[i + 1], *sds[i]);
+  });
 
   if (term_cost_) {
     term_cost_->computeGradients(xs[nsteps], unone_, *prob_data.term_cost_data);
@@ -115,6 +170,15 @@ void TrajOptProblemTpl<Scalar>::computeDerivatives(
     const ConstraintType &tc = term_cstrs_[k];
     auto &td = prob_data.term_cstr_data[k];
     tc.func->computeJacobians(xs[nsteps], unone_, xs[nsteps], *td);
+    if (!lams)
+      continue;
+    auto lam_k = term_cstrs_.constSegmentByConstraint(lams->back(), k);
+    if (lam_k.isZero(0)) {
+      td->vhp_buffer_.setZero();
+    } else {
+      tc.func->computeVectorHessianProducts(xs[nsteps], unone_, xs[nsteps],
+                                            lam_k, *td);
+    }
   }
 }
 
@@ -148,9 +212,12 @@ inline std::size_t TrajOptProblemTpl<Scalar>::numSteps() const {
 template <typename Scalar>
 void TrajOptProblemTpl<Scalar>::replaceStageCircular(
     const shared_ptr<StageModel> &model) {
-  addStage(model);
+  if (model == nullptr)
+    ALIGATOR_RUNTIME_ERROR("Input stage is null.");
+  if (stages_.empty())
+    return;
   rotate_vec_left(stages_);
-  stages_.pop_back();
+  stages_.back() = model;
 }
 
 template <typename Scalar>
@@ -162,7 +229,8 @@ Scalar TrajOptProblemTpl<Scalar>::computeTrajectoryCost(
   const std::size_t nsteps = numSteps();
   const auto &sds = problem_data.stage_data;
 
-#pragma omp simd reduction(+ : traj_cost)
+  // Sum in stage order, outside of any parallel region: the result does not
+  // depend on the number of threads used for evaluate().
   for (std::size_t i = 0; i < nsteps; i++) {
     traj_cost += sds[i]->cost_data->value_;
   }
@@ -183,6 +251,8 @@ TrajOptDataTpl<Scalar>::TrajOptDataTpl(const TrajOptProblemTpl<Scalar> &problem)
     stage_data[i]->checkData();
   }
 
+  // the terminal cost and constraints are evaluated at the same point
+  SharedDataScope scope;
   if (problem.term_cost_) {
     term_cost_data = problem.term_cost_->createData();
   }
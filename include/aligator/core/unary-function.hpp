@@ -40,6 +40,15 @@ struct UnaryFunctionTpl : StageFunctionTpl<_Scalar> {
                                     Data &data) const override {
     this->computeVectorHessianProducts(x, lbda, data);
   }
+
+  /// @copybrief Base::createData()
+  /// @details The Jacobians with respect to \f$u\f$ and \f$y\f$ are zero.
+  shared_ptr<Data> createData() const override {
+    auto data = Base::createData();
+    data->Ju_structure_ = JacobianStructure::ZERO;
+    data->Jy_structure_ = JacobianStructure::ZERO;
+    return data;
+  }
 };
 
 #define ALIGATOR_UNARY_FUNCTION_INTERFACE(Scalar)                              \
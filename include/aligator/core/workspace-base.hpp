@@ -50,12 +50,11 @@ public:
   virtual void cycleLeft();
 
   /// @brief Same as cycleLeft(), but add a StageDataTpl to problem_data.
-  /// @details The implementation pushes back on top of the vector of
-  /// StageDataTpl, rotates left, then pops the first element back out.
+  /// @details The implementation rotates left, then replaces the data of the
+  /// first stage (now at the back) with @p data. This does not allocate.
   void cycleAppend(shared_ptr<StageDataTpl<Scalar>> data) {
-    problem_data.stage_data.emplace_back(data);
     this->cycleLeft();
-    problem_data.stage_data.pop_back();
+    problem_data.stage_data.back() = data;
   }
 };
 
@@ -95,7 +95,8 @@ template <typename Scalar> struct TrajOptDataTpl;
 template <typename Scalar> struct SolverProxDDP;
 
 // fwd SolverFDDP
-template <typename Scalar> struct SolverFDDP;
+template <typename Scalar, int NX = Eigen::Dynamic, int NU = Eigen::Dynamic>
+struct SolverFDDP;
 
 // fwd WorkspaceBaseTpl
 template <typename Scalar> struct WorkspaceBaseTpl;
@@ -0,0 +1,58 @@
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/core/callback-base.hpp"
+#include "aligator/core/workspace-base.hpp"
+#include "aligator/core/results-base.hpp"
+#include "aligator/utils/trace.hpp"
+
+#include <fstream>
+
+namespace aligator {
+
+/// @brief  Record a timeline of the solver run, per thread, and write it to a
+/// Chrome trace (JSON) file which can be opened in Perfetto.
+/// @details The stage evaluations, stage derivatives, backward-pass knots and
+/// linesearch trials of each run() are recorded to a TraceBuffer. The buffer
+/// is cleared at the start of the run, and written to #filename at the end.
+template <typename Scalar> struct TraceCallbackTpl : CallbackBaseTpl<Scalar> {
+  using Workspace = WorkspaceBaseTpl<Scalar>;
+  using Results = ResultsBaseTpl<Scalar>;
+
+  /// @param filename Output file, overwritten by each run. If empty, the trace
+  ///                 is only kept in #buffer.
+  /// @param capacity Maximum number of events kept; older events are dropped.
+  TraceCallbackTpl(const std::string &filename,
+                   std::size_t capacity = 1 << 16)
+      : buffer(capacity), filename(filename) {}
+
+  void call(const Workspace &, const Results &) {}
+
+  void pre_run_call(Workspace &workspace) {
+    buffer.clear();
+    workspace.problem_data.trace = &buffer;
+  }
+
+  void post_run_call(const Workspace &, const Results &) {
+    if (!filename.empty())
+      write(filename);
+  }
+
+  /// Write the events of the last run to a Chrome trace file.
+  void write(const std::string &fname) const {
+    std::ofstream ofs(fname);
+    if (!ofs)
+      ALIGATOR_RUNTIME_ERROR(
+          fmt::format("Could not open trace file {} for writing.", fname));
+    buffer.writeChromeTrace(ofs);
+  }
+
+  TraceBuffer buffer;
+  std::string filename;
+};
+
+} // namespace aligator
+
+#ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
+#include "./trace-callback.txx"
+#endif
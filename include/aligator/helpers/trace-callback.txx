@@ -0,0 +1,10 @@
+#pragma once
+
+#include "aligator/context.hpp"
+#include "./trace-callback.hpp"
+
+namespace aligator {
+
+extern template struct TraceCallbackTpl<context::Scalar>;
+
+} // namespace aligator
@@ -0,0 +1,277 @@
+/// @file   Helper structs to define the derivatives of a function through
+///         generated and compiled code.
+#pragma once
+
+#include "aligator/core/function-abstract.hpp"
+#include "aligator/core/cost-abstract.hpp"
+#include "aligator/utils/codegen.hpp"
+#include "aligator/utils/exceptions.hpp"
+
+#include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
+
+#include <cctype>
+#include <sstream>
+
+namespace aligator {
+namespace autodiff {
+
+namespace internal {
+
+inline void check_c_identifier(const std::string &name) {
+  bool valid = !name.empty() && !std::isdigit(int((unsigned char)name[0]));
+  for (char c : name)
+    valid = valid && (std::isalnum(int((unsigned char)c)) || c == '_');
+  if (!valid) {
+    ALIGATOR_RUNTIME_ERROR(fmt::format(
+        "Name of generated functions \"{}\" is not a C identifier.", name));
+  }
+}
+
+/// Variables [offset, offset + size) of @p tape.
+inline Eigen::Matrix<codegen::SymbolicScalar, Eigen::Dynamic, 1>
+symbolic_variables(codegen::Tape &tape, int offset, int size) {
+  Eigen::Matrix<codegen::SymbolicScalar, Eigen::Dynamic, 1> v(size);
+  for (int i = 0; i < size; i++)
+    v[i] = codegen::SymbolicScalar::variable(tape, offset + i);
+  return v;
+}
+
+} // namespace internal
+
+/** @brief    Define a function \f$r(x,u,y)\f$ and its derivatives from a
+ * templated functor, through generated code.
+ *
+ * @details   The functor, with the same signature as for
+ * ForwardDiffFunctionTpl, is traced once with codegen::SymbolicScalar. The
+ * value, the Jacobian and (if @p second_order is true) the vector-Hessian
+ * product are then emitted as C functions `<name>_value`, `<name>_jacobian`
+ * and `<name>_vhp`, compiled to a shared library and loaded. The library is
+ * cached on disk (see codegen::CompileOptions), so that constructing the same
+ * function again does not recompile it.
+ *
+ * The functor must not branch on the values of its arguments.
+ *
+ * @warning   The functor is traced with the self-contained
+ * codegen::SymbolicScalar, which only supports the elementary operations of
+ * codegen::OpCode on Eigen matrices. Pinocchio algorithms (e.g. the
+ * multibody or ABA dynamics) cannot be traced with it: these need Pinocchio's
+ * code generation support, which a CppAD-backed path would use.
+ */
+template <typename _Scalar, typename Functor>
+struct CodeGenFunctionTpl : StageFunctionTpl<_Scalar> {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Base = StageFunctionTpl<Scalar>;
+  using BaseData = typename Base::Data;
+  using Symbolic = codegen::SymbolicScalar;
+  using GeneratedFunction = codegen::CompiledLibrary::Function<Scalar>;
+
+  struct Data : BaseData {
+    /// Inputs of the generated functions: \f$(x, u, y, \lambda)\f$.
+    VectorXs in;
+
+    Data(CodeGenFunctionTpl const &model)
+        : BaseData(model.ndx1, model.nu, model.ndx2, model.nr),
+          in(model.ndx1 + model.nu + model.ndx2 + model.nr) {}
+  };
+
+  Functor functor;
+  bool second_order;
+
+  CodeGenFunctionTpl(const int ndx1, const int nu, const int ndx2,
+                     const int nr, const std::string &name,
+                     const Functor &functor = Functor(),
+                     bool second_order = false,
+                     const codegen::CompileOptions &options = {})
+      : Base(ndx1, nu, ndx2, nr), functor(functor),
+        second_order(second_order), vhp_(nullptr) {
+    internal::check_c_identifier(name);
+    library_ =
+        std::make_shared<codegen::CompiledLibrary>(generateSource(name), options);
+    value_ = library_->function<Scalar>((name + "_value").c_str());
+    jacobian_ = library_->function<Scalar>((name + "_jacobian").c_str());
+    if (second_order)
+      vhp_ = library_->function<Scalar>((name + "_vhp").c_str());
+  }
+
+  /// C source of the generated functions.
+  std::string generateSource(const std::string &name) const {
+    const int nvar = this->ndx1 + this->nu + this->ndx2;
+    codegen::Tape tape;
+    auto x = internal::symbolic_variables(tape, 0, this->ndx1);
+    auto u = internal::symbolic_variables(tape, this->ndx1, this->nu);
+    auto y = internal::symbolic_variables(tape, this->ndx1 + this->nu,
+                                          this->ndx2);
+    Eigen::Matrix<Symbolic, Eigen::Dynamic, 1> r(this->nr);
+    functor(x, u, y, r);
+    std::vector<int> outputs(std::size_t(this->nr));
+    for (int k = 0; k < this->nr; k++)
+      outputs[std::size_t(k)] = r[k].node(tape);
+
+    std::ostringstream os;
+    codegen::Tape::emitHeader(os, codegen::c_type_name<Scalar>());
+    tape.emitFunction(os, name + "_value", outputs);
+    tape.emitFunction(os, name + "_jacobian", tape.jacobian(outputs, nvar));
+    if (second_order) {
+      std::vector<int> lbda(std::size_t(this->nr));
+      for (int k = 0; k < this->nr; k++)
+        lbda[std::size_t(k)] = tape.variable(nvar + k);
+      tape.emitFunction(os, name + "_vhp",
+                        tape.weightedHessian(outputs, lbda, nvar));
+    }
+    return os.str();
+  }
+
+  void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
+                const ConstVectorRef &y, BaseData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    setInputs(x, u, y, d);
+    value_(d.in.data(), d.value_.data());
+  }
+
+  void computeJacobians(const ConstVectorRef &x, const ConstVectorRef &u,
+                        const ConstVectorRef &y,
+                        BaseData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    setInputs(x, u, y, d);
+    jacobian_(d.in.data(), d.jac_buffer_.data());
+  }
+
+  void computeVectorHessianProducts(const ConstVectorRef &x,
+                                    const ConstVectorRef &u,
+                                    const ConstVectorRef &y,
+                                    const ConstVectorRef &lbda,
+                                    BaseData &data) const override {
+    if (!second_order)
+      return;
+    Data &d = static_cast<Data &>(data);
+    setInputs(x, u, y, d);
+    d.in.tail(this->nr) = lbda;
+    vhp_(d.in.data(), d.vhp_buffer_.data());
+  }
+
+  shared_ptr<BaseData> createData() const override {
+    return std::make_shared<Data>(*this);
+  }
+
+  const codegen::CompiledLibrary &library() const { return *library_; }
+
+private:
+  void setInputs(const ConstVectorRef &x, const ConstVectorRef &u,
+                 const ConstVectorRef &y, Data &d) const {
+    d.in.head(this->ndx1) = x;
+    d.in.segment(this->ndx1, this->nu) = u;
+    d.in.segment(this->ndx1 + this->nu, this->ndx2) = y;
+  }
+
+  shared_ptr<codegen::CompiledLibrary> library_;
+  GeneratedFunction value_;
+  GeneratedFunction jacobian_;
+  GeneratedFunction vhp_;
+};
+
+/** @brief    Define a cost \f$\ell(x,u)\f$ and its derivatives through
+ * generated code.
+ *
+ * @details   Same as CodeGenFunctionTpl, for a Euclidean state space and a
+ * functor of signature
+ * @code
+ * template <typename T>
+ * T operator()(const VectorX<T> &x, const VectorX<T> &u) const;
+ * @endcode
+ * The generated functions are `<name>_value`, `<name>_gradient` and
+ * `<name>_hessian`. Pinocchio algorithms cannot be traced either (see
+ * CodeGenFunctionTpl).
+ */
+template <typename _Scalar, typename Functor>
+struct CodeGenCostTpl : CostAbstractTpl<_Scalar> {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Base = CostAbstractTpl<Scalar>;
+  using CostData = CostDataAbstractTpl<Scalar>;
+  using VectorSpace = proxsuite::nlp::VectorSpaceTpl<Scalar, Eigen::Dynamic>;
+  using Symbolic = codegen::SymbolicScalar;
+  using GeneratedFunction = codegen::CompiledLibrary::Function<Scalar>;
+
+  struct Data : CostData {
+    /// Inputs of the generated functions: \f$(x, u)\f$.
+    VectorXs in;
+
+    Data(CodeGenCostTpl const &model)
+        : CostData(model.ndx(), model.nu), in(model.ndx() + model.nu) {}
+  };
+
+  Functor functor;
+
+  CodeGenCostTpl(const int ndx, const int nu, const std::string &name,
+                 const Functor &functor = Functor(),
+                 const codegen::CompileOptions &options = {})
+      : Base(std::make_shared<VectorSpace>(ndx), nu), functor(functor) {
+    internal::check_c_identifier(name);
+    library_ =
+        std::make_shared<codegen::CompiledLibrary>(generateSource(name), options);
+    value_ = library_->function<Scalar>((name + "_value").c_str());
+    gradient_ = library_->function<Scalar>((name + "_gradient").c_str());
+    hessian_ = library_->function<Scalar>((name + "_hessian").c_str());
+  }
+
+  /// C source of the generated functions.
+  std::string generateSource(const std::string &name) const {
+    const int ndx = this->ndx();
+    const int nvar = ndx + this->nu;
+    codegen::Tape tape;
+    auto x = internal::symbolic_variables(tape, 0, ndx);
+    auto u = internal::symbolic_variables(tape, ndx, this->nu);
+    const std::vector<int> output{functor(x, u).node(tape)};
+
+    std::ostringstream os;
+    codegen::Tape::emitHeader(os, codegen::c_type_name<Scalar>());
+    tape.emitFunction(os, name + "_value", output);
+    tape.emitFunction(os, name + "_gradient", tape.gradient(output[0], nvar));
+    tape.emitFunction(os, name + "_hessian",
+                      tape.weightedHessian(output, {tape.constant(1.)}, nvar));
+    return os.str();
+  }
+
+  void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
+                CostData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    setInputs(x, u, d);
+    value_(d.in.data(), &d.value_);
+  }
+
+  void computeGradients(const ConstVectorRef &x, const ConstVectorRef &u,
+                        CostData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    setInputs(x, u, d);
+    gradient_(d.in.data(), d.grad_.data());
+  }
+
+  void computeHessians(const ConstVectorRef &x, const ConstVectorRef &u,
+                       CostData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    setInputs(x, u, d);
+    hessian_(d.in.data(), d.hess_.data());
+  }
+
+  shared_ptr<CostData> createData() const override {
+    return std::make_shared<Data>(*this);
+  }
+
+  const codegen::CompiledLibrary &library() const { return *library_; }
+
+private:
+  void setInputs(const ConstVectorRef &x, const ConstVectorRef &u,
+                 Data &d) const {
+    d.in.head(this->ndx()) = x;
+    d.in.tail(this->nu) = u;
+  }
+
+  shared_ptr<codegen::CompiledLibrary> library_;
+  GeneratedFunction value_;
+  GeneratedFunction gradient_;
+  GeneratedFunction hessian_;
+};
+
+} // namespace autodiff
+} // namespace aligator
@@ -4,14 +4,86 @@
 
 #include "aligator/core/dynamics.hpp"
 #include "aligator/core/cost-abstract.hpp"
+#include "aligator/core/shared-data.hpp"
+#include "aligator/utils/thread-pool.hpp"
 #include <proxsuite-nlp/manifold-base.hpp>
 #include <boost/mpl/bool.hpp>
 
 namespace aligator {
 namespace autodiff {
 
+/// Finite-difference formula, for a step \f$h\f$.
+enum class FiniteDifferenceScheme {
+  /// \f$(f(x + h) - f(x)) / h\f$, with an error in \f$O(h)\f$.
+  FORWARD,
+  /// \f$(f(x + h) - f(x - h)) / 2h\f$, with an error in \f$O(h^2)\f$: twice
+  /// as many evaluations.
+  CENTRAL,
+  /// Richardson extrapolation of central differences with steps \f$h\f$ and
+  /// \f$h/2\f$, with an error in \f$O(h^4)\f$: four times as many evaluations.
+  RICHARDSON
+};
+
 namespace internal {
 
+/// @brief Derivative along one direction, where `eval(h, k)` evaluates the
+/// function at step @p h into buffer `k` (0 or 1), and returns the value.
+/// @param v0  Value at step zero, only used by forward differences.
+template <typename Scalar, typename V0, typename F, typename Out>
+void finite_difference(FiniteDifferenceScheme scheme, const Scalar h,
+                       const V0 &v0, F &&eval, Out &&out) {
+  switch (scheme) {
+  case FiniteDifferenceScheme::FORWARD:
+    out = (eval(h, 0) - v0) / h;
+    break;
+  case FiniteDifferenceScheme::CENTRAL: {
+    const auto &vp = eval(h, 0);
+    const auto &vm = eval(-h, 1);
+    out = (vp - vm) / (Scalar(2) * h);
+    break;
+  }
+  case FiniteDifferenceScheme::RICHARDSON: {
+    const auto &vp = eval(h, 0);
+    const auto &vm = eval(-h, 1);
+    out = (vp - vm) / (Scalar(2) * h);
+    const auto &vp2 = eval(h / 2, 0);
+    const auto &vm2 = eval(-h / 2, 1);
+    out = (Scalar(4) * (vp2 - vm2) / h - out) / Scalar(3);
+    break;
+  }
+  }
+}
+
+/// @brief Call `f(workspace, j)` for the columns j in [0, n), split into
+/// contiguous chunks run in parallel on @p pool, one per workspace.
+template <typename Workspace, typename F>
+void for_each_column(ThreadPool *pool, int n, std::vector<Workspace> &ws,
+                     F &&f) {
+  const std::size_t nchunks = std::min(ws.size(), std::size_t(n));
+  if (!pool || nchunks <= 1) {
+    for (int j = 0; j < n; j++)
+      f(ws[0], j);
+    return;
+  }
+  pool->parallelFor(
+      0, nchunks,
+      [&](std::size_t c) {
+        const int begin = int(c * std::size_t(n) / nchunks);
+        const int end = int((c + 1) * std::size_t(n) / nchunks);
+        for (int j = begin; j < end; j++)
+          f(ws[c], j);
+      },
+      1);
+}
+
+/// Replace @p H by the average of @p H and its transpose.
+template <typename MatrixType> void symmetrize(MatrixType &H) {
+  for (Eigen::Index j = 0; j < H.cols(); j++) {
+    for (Eigen::Index i = 0; i < j; i++)
+      H(i, j) = H(j, i) = (H(i, j) + H(j, i)) / 2;
+  }
+}
+
 // fwd declare the implementation of finite difference algorithms.
 template <typename _Scalar, template <typename> class _Base>
 struct finite_difference_impl : virtual _Base<_Scalar> {
@@ -25,6 +97,20 @@ struct finite_difference_impl : virtual _Base<_Scalar> {
   shared_ptr<Base> func_;
   Scalar fd_eps;
   int nx1, nx2;
+  FiniteDifferenceScheme scheme;
+
+  /// Buffers of the evaluations of one thread.
+  struct Workspace {
+    /// Evaluations at positive and negative steps.
+    shared_ptr<BaseData> data_p, data_m;
+    VectorXs dx, dy;
+    VectorXs xp, up, yp;
+
+    Workspace(finite_difference_impl const &model)
+        : data_p(model.func_->createData()), data_m(model.func_->createData()),
+          dx(VectorXs::Zero(model.ndx1)), dy(VectorXs::Zero(model.ndx2)),
+          xp(model.nx1), up(model.nu), yp(model.nx2) {}
+  };
 
   struct Data : BaseData {
     using BaseData::ndx1;
@@ -32,34 +118,48 @@ struct finite_difference_impl : virtual _Base<_Scalar> {
     using BaseData::nr;
     using BaseData::nu;
     shared_ptr<BaseData> data_0;
-    shared_ptr<BaseData> data_1;
-    VectorXs dx, du, dy;
-    VectorXs xp, up, yp;
+    /// One workspace per thread of the model.
+    std::vector<Workspace> workspaces;
 
     Data(finite_difference_impl const &model)
         : BaseData(model.ndx1, model.nu, model.ndx2, model.nr),
-          data_0(model.func_->createData()), data_1(model.func_->createData()),
-          dx(ndx1), du(nu), dy(ndx2), xp(model.nx1), up(model.nu),
-          yp(model.nx2) {
-      dx.setZero();
-      du.setZero();
-      dy.setZero();
+          data_0(model.func_->createData()) {
+      for (std::size_t i = 0; i < model.numThreads(); i++) {
+        // threads must not share e.g. multibody kinematics
+        SharedDataScope scope;
+        workspaces.emplace_back(model);
+      }
     }
   };
 
   template <typename U = Base, class = std::enable_if_t<std::is_same<
                                    U, StageFunctionTpl<Scalar>>::value>>
   finite_difference_impl(shared_ptr<Manifold> space, shared_ptr<U> func,
-                         const Scalar fd_eps)
+                         const Scalar fd_eps, FiniteDifferenceScheme scheme)
       : Base(func->ndx1, func->nu, func->ndx2, func->nr), space_(space),
-        func_(func), fd_eps(fd_eps), nx1(space->nx()), nx2(space->nx()) {}
+        func_(func), fd_eps(fd_eps), nx1(space->nx()), nx2(space->nx()),
+        scheme(scheme) {}
 
   template <typename U = Base, class = std::enable_if_t<std::is_same<
                                    U, DynamicsModelTpl<Scalar>>::value>>
   finite_difference_impl(shared_ptr<Manifold> space, shared_ptr<U> func,
-                         const Scalar fd_eps, boost::mpl::false_ = {})
+                         const Scalar fd_eps, FiniteDifferenceScheme scheme,
+                         boost::mpl::false_ = {})
       : Base(space, func->nu, space), space_(space), func_(func),
-        fd_eps(fd_eps), nx1(space->nx()), nx2(space->nx()) {}
+        fd_eps(fd_eps), nx1(space->nx()), nx2(space->nx()), scheme(scheme) {}
+
+  /// @brief Evaluate the columns of the Jacobians in parallel, on @p
+  /// num_threads threads.
+  /// @details This only affects the data created afterwards.
+  void setNumThreads(std::size_t num_threads) {
+    if (num_threads > 1)
+      thread_pool_ = std::make_shared<ThreadPool>(num_threads);
+    else
+      thread_pool_.reset();
+  }
+  std::size_t numThreads() const {
+    return thread_pool_ ? thread_pool_->size() : 1;
+  }
 
   void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
                 const ConstVectorRef &y, BaseData &data) const {
@@ -68,36 +168,24 @@ struct finite_difference_impl : virtual _Base<_Scalar> {
     d.value_ = d.data_0->value_;
   }
 
+  /// @details The forward scheme uses the value of the last call to
+  /// evaluate().
   void computeJacobians(const ConstVectorRef &x, const ConstVectorRef &u,
                         const ConstVectorRef &y, BaseData &data) const {
     Data &d = static_cast<Data &>(data);
-
-    VectorXs &v0 = d.data_0->value_;
-    VectorXs &vp = d.data_1->value_;
-
-    for (int i = 0; i < func_->ndx1; i++) {
-      d.dx[i] = fd_eps;
-      space_->integrate(x, d.dx, d.xp);
-      func_->evaluate(d.xp, u, y, *d.data_1);
-      data.Jx_.col(i) = (vp - v0) / fd_eps;
-      d.dx[i] = 0.;
-    }
-
-    for (int i = 0; i < func_->ndx2; i++) {
-      d.dy[i] = fd_eps;
-      space_->integrate(y, d.dy, d.yp);
-      func_->evaluate(x, u, d.yp, *d.data_1);
-      data.Jy_.col(i) = (vp - v0) / fd_eps;
-      d.dy[i] = 0.;
-    }
-
-    for (int i = 0; i < func_->nu; i++) {
-      d.du[i] = fd_eps;
-      d.up = u + d.du;
-      func_->evaluate(x, d.up, y, *d.data_1);
-      data.Ju_.col(i) = (vp - v0) / fd_eps;
-      d.du[i] = 0.;
-    }
+    const VectorXs &v0 = d.data_0->value_;
+    const int nvar = func_->ndx1 + func_->nu + func_->ndx2;
+
+    for_each_column(thread_pool_.get(), nvar, d.workspaces,
+                    [&](Workspace &w, int j) {
+                      auto eval = [&](Scalar h, int k) -> const VectorXs & {
+                        BaseData &out = k == 0 ? *w.data_p : *w.data_m;
+                        evaluatePerturbed(x, u, y, j, h, w, out);
+                        return out.value_;
+                      };
+                      finite_difference(scheme, fd_eps, v0, eval,
+                                        data.jac_buffer_.col(j));
+                    });
   }
 
   void computeVectorHessianProducts(const ConstVectorRef &,
@@ -108,6 +196,33 @@ struct finite_difference_impl : virtual _Base<_Scalar> {
   shared_ptr<BaseData> createData() const {
     return std::make_shared<Data>(*this);
   }
+
+private:
+  /// Evaluate the function with variable @p j of (x, u, y) moved by @p h.
+  void evaluatePerturbed(const ConstVectorRef &x, const ConstVectorRef &u,
+                         const ConstVectorRef &y, int j, Scalar h,
+                         Workspace &w, BaseData &out) const {
+    const int ndx1 = func_->ndx1;
+    const int nu = func_->nu;
+    if (j < ndx1) {
+      w.dx[j] = h;
+      space_->integrate(x, w.dx, w.xp);
+      w.dx[j] = 0.;
+      func_->evaluate(w.xp, u, y, out);
+    } else if (j < ndx1 + nu) {
+      w.up = u;
+      w.up[j - ndx1] += h;
+      func_->evaluate(x, w.up, y, out);
+    } else {
+      const int k = j - ndx1 - nu;
+      w.dy[k] = h;
+      space_->integrate(y, w.dy, w.yp);
+      w.dy[k] = 0.;
+      func_->evaluate(x, u, w.yp, out);
+    }
+  }
+
+  shared_ptr<ThreadPool> thread_pool_;
 };
 
 } // namespace internal
@@ -132,10 +247,12 @@ struct FiniteDifferenceHelper
 
   ALIGATOR_DYNAMIC_TYPEDEFS(_Scalar);
 
-  FiniteDifferenceHelper(shared_ptr<Manifold> space,
-                         shared_ptr<StageFunction> func, const Scalar fd_eps)
+  FiniteDifferenceHelper(
+      shared_ptr<Manifold> space, shared_ptr<StageFunction> func,
+      const Scalar fd_eps,
+      FiniteDifferenceScheme scheme = FiniteDifferenceScheme::FORWARD)
       : StageFunction(func->ndx1, func->nu, func->ndx2, func->nr),
-        Base(space, func, fd_eps) {}
+        Base(space, func, fd_eps, scheme) {}
 };
 
 template <typename _Scalar>
@@ -152,12 +269,20 @@ struct DynamicsFiniteDifferenceHelper
 
   ALIGATOR_DYNAMIC_TYPEDEFS(_Scalar);
 
-  DynamicsFiniteDifferenceHelper(shared_ptr<Manifold> space,
-                                 shared_ptr<DynamicsModel> func,
-                                 const Scalar fd_eps)
-      : DynamicsModel(space, func->nu, space), Base(space, func, fd_eps) {}
+  DynamicsFiniteDifferenceHelper(
+      shared_ptr<Manifold> space, shared_ptr<DynamicsModel> func,
+      const Scalar fd_eps,
+      FiniteDifferenceScheme scheme = FiniteDifferenceScheme::FORWARD)
+      : DynamicsModel(space, func->nu, space),
+        Base(space, func, fd_eps, scheme) {}
 };
 
+/** @brief    Approximate the derivatives of a cost using finite differences.
+ *
+ * @details   The Hessians are the finite differences of the gradients, so
+ * they need a larger step than the gradients (e.g. 1e-4 with central
+ * differences).
+ */
 template <typename Scalar>
 struct CostFiniteDifferenceHelper : CostAbstractTpl<Scalar> {
   using Manifold = ManifoldAbstractTpl<Scalar>;
@@ -168,22 +293,64 @@ struct CostFiniteDifferenceHelper : CostAbstractTpl<Scalar> {
 
   ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
 
+  /// Point moved along one variable.
+  struct Perturbation {
+    VectorXs dx;
+    VectorXs xp, up;
+
+    Perturbation(CostFiniteDifferenceHelper const &obj)
+        : dx(VectorXs::Zero(obj.ndx())), xp(obj.nx()), up(obj.nu) {}
+  };
+
+  /// Buffers of the evaluations of one thread.
+  struct Workspace {
+    Perturbation p, q;
+    /// Evaluations at positive and negative steps, and at the points where
+    /// the gradients are computed.
+    shared_ptr<CostData> c_p, c_m, c_0;
+    /// Gradients at positive and negative steps.
+    VectorXs g_p, g_m;
+
+    Workspace(CostFiniteDifferenceHelper const &obj)
+        : p(obj), q(obj), c_p(obj.cost_->createData()),
+          c_m(obj.cost_->createData()), c_0(obj.cost_->createData()),
+          g_p(obj.ndx() + obj.nu), g_m(obj.ndx() + obj.nu) {}
+  };
+
   struct Data : CostData {
 
     shared_ptr<CostData> c1, c2;
-    VectorXs dx, du;
-    VectorXs xp, up;
+    /// One workspace per thread of the model.
+    std::vector<Workspace> workspaces;
 
-    Data(CostFiniteDifferenceHelper const &obj)
-        : CostData(obj), dx(obj.ndx()), du(obj.nu), xp(obj.nx()), up(obj.nu) {
+    Data(CostFiniteDifferenceHelper const &obj) : CostData(obj) {
       c1 = obj.cost_->createData();
-      c2 = obj.cost_->createData();
+      for (std::size_t i = 0; i < obj.numThreads(); i++) {
+        // threads must not share e.g. multibody kinematics
+        SharedDataScope scope;
+        workspaces.emplace_back(obj);
+      }
+      c2 = workspaces[0].c_p;
     }
   };
 
-  CostFiniteDifferenceHelper(shared_ptr<CostBase> cost, const Scalar fd_eps)
+  CostFiniteDifferenceHelper(
+      shared_ptr<CostBase> cost, const Scalar fd_eps,
+      FiniteDifferenceScheme scheme = FiniteDifferenceScheme::FORWARD)
 
-      : CostBase(cost->space, cost->nu), cost_(cost), fd_eps(fd_eps) {}
+      : CostBase(cost->space, cost->nu), cost_(cost), fd_eps(fd_eps),
+        scheme(scheme) {}
+
+  /// @copydoc internal::finite_difference_impl::setNumThreads()
+  void setNumThreads(std::size_t num_threads) {
+    if (num_threads > 1)
+      thread_pool_ = std::make_shared<ThreadPool>(num_threads);
+    else
+      thread_pool_.reset();
+  }
+  std::size_t numThreads() const {
+    return thread_pool_ ? thread_pool_->size() : 1;
+  }
 
   void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
                 CostData &data_) const override {
@@ -196,34 +363,43 @@ struct CostFiniteDifferenceHelper : CostAbstractTpl<Scalar> {
   void computeGradients(const ConstVectorRef &x, const ConstVectorRef &u,
                         CostData &data_) const override {
     Data &d = static_cast<Data &>(data_);
-    Manifold const &space = *this->space;
-
-    cost_->evaluate(x, u, *d.c1);
-
-    d.dx.setZero();
-    for (int i = 0; i < this->ndx(); i++) {
-      d.dx[i] = fd_eps;
-      space.integrate(x, d.dx, d.xp);
-      cost_->evaluate(d.xp, u, *d.c2);
-
-      d.Lx_[i] = (d.c2->value_ - d.c1->value_) / fd_eps;
-      d.dx[i] = 0.;
-    }
-
-    d.du.setZero();
-    for (int i = 0; i < this->nu; i++) {
-      d.du[i] = fd_eps;
-      d.up = u + d.du;
-      cost_->evaluate(x, d.up, *d.c2);
-
-      d.Lu_[i] = (d.c2->value_ - d.c1->value_) / fd_eps;
-      d.du[i] = 0.;
-    }
+    if (scheme == FiniteDifferenceScheme::FORWARD)
+      cost_->evaluate(x, u, *d.c1);
+    const Scalar v0 = d.c1->value_;
+
+    internal::for_each_column(
+        thread_pool_.get(), this->ndx() + this->nu, d.workspaces,
+        [&](Workspace &w, int j) {
+          auto eval = [&](Scalar h, int k) {
+            perturb(x, u, j, h, w.p);
+            CostData &out = k == 0 ? *w.c_p : *w.c_m;
+            cost_->evaluate(w.p.xp, w.p.up, out);
+            return out.value_;
+          };
+          internal::finite_difference(scheme, fd_eps, v0, eval, d.grad_[j]);
+        });
   }
 
   /// @brief Compute the cost Hessians \f$(\ell_{ij})_{i,j \in \{x,u\}}\f$
-  void computeHessians(const ConstVectorRef &, const ConstVectorRef &,
-                       CostData &) const override {}
+  /// @details This uses the gradient of the last call to computeGradients().
+  void computeHessians(const ConstVectorRef &x, const ConstVectorRef &u,
+                       CostData &data_) const override {
+    Data &d = static_cast<Data &>(data_);
+
+    internal::for_each_column(
+        thread_pool_.get(), this->ndx() + this->nu, d.workspaces,
+        [&](Workspace &w, int j) {
+          auto eval = [&](Scalar h, int k) -> const VectorXs & {
+            perturb(x, u, j, h, w.q);
+            VectorXs &g = k == 0 ? w.g_p : w.g_m;
+            gradient(w.q.xp, w.q.up, w, g);
+            return g;
+          };
+          internal::finite_difference(scheme, fd_eps, d.grad_, eval,
+                                      d.hess_.col(j));
+        });
+    internal::symmetrize(d.hess_);
+  }
 
   shared_ptr<CostData> createData() const override {
     return std::make_shared<Data>(*this);
@@ -231,6 +407,43 @@ struct CostFiniteDifferenceHelper : CostAbstractTpl<Scalar> {
 
   shared_ptr<CostBase> cost_;
   Scalar fd_eps;
+  FiniteDifferenceScheme scheme;
+
+private:
+  /// Set @p p to (x, u) with variable @p j moved by @p h.
+  void perturb(const ConstVectorRef &x, const ConstVectorRef &u, int j,
+               Scalar h, Perturbation &p) const {
+    const int ndx = this->ndx();
+    if (j < ndx) {
+      p.dx[j] = h;
+      space->integrate(x, p.dx, p.xp);
+      p.dx[j] = 0.;
+      p.up = u;
+    } else {
+      p.xp = x;
+      p.up = u;
+      p.up[j - ndx] += h;
+    }
+  }
+
+  /// Gradient at (x, u), computed serially with the buffers of @p w.
+  void gradient(const VectorXs &x, const VectorXs &u, Workspace &w,
+                VectorXs &g) const {
+    if (scheme == FiniteDifferenceScheme::FORWARD)
+      cost_->evaluate(x, u, *w.c_0);
+    const Scalar v0 = w.c_0->value_;
+    for (int j = 0; j < this->ndx() + this->nu; j++) {
+      auto eval = [&](Scalar h, int k) {
+        perturb(x, u, j, h, w.p);
+        CostData &out = k == 0 ? *w.c_p : *w.c_m;
+        cost_->evaluate(w.p.xp, w.p.up, out);
+        return out.value_;
+      };
+      internal::finite_difference(scheme, fd_eps, v0, eval, g[j]);
+    }
+  }
+
+  shared_ptr<ThreadPool> thread_pool_;
 };
 
 #ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
@@ -0,0 +1,266 @@
+/// @file   Helper structs to define the derivatives of a function through
+///         forward-mode automatic differentiation.
+#pragma once
+
+#include "aligator/core/unary-function.hpp"
+#include "aligator/utils/exceptions.hpp"
+
+#include <unsupported/Eigen/AutoDiff>
+
+namespace aligator {
+namespace autodiff {
+
+/// @brief Forward-mode dual number, holding up to @p MaxDirections derivatives
+/// inline (without heap allocation), or any number if it is Eigen::Dynamic.
+/// The derivatives are propagated in all the directions at once, as Eigen
+/// vector operations.
+template <typename Scalar, int MaxDirections>
+using DualScalar = Eigen::AutoDiffScalar<
+    Eigen::Matrix<Scalar, Eigen::Dynamic, 1, 0, MaxDirections, 1>>;
+
+namespace internal {
+
+template <typename T> using VectorX = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+
+inline void check_num_directions(int ndir, int max_directions) {
+  if (max_directions != Eigen::Dynamic && ndir > max_directions) {
+    ALIGATOR_RUNTIME_ERROR(fmt::format(
+        "Number of variables ({:d}) exceeds the maximum number of directions "
+        "of the dual numbers ({:d}).",
+        ndir, max_directions));
+  }
+}
+
+/// Set @p out to the variables [offset, offset + v.size()) of @p ndir.
+template <typename Derived, typename Dual>
+void seed_variables(const Eigen::MatrixBase<Derived> &v, int offset, int ndir,
+                    VectorX<Dual> &out) {
+  for (Eigen::Index i = 0; i < v.size(); i++)
+    out[i] = Dual(v[i], ndir, offset + int(i));
+}
+
+/// Same as seed_variables(), for second-order dual numbers.
+template <typename Derived, typename Dual2>
+void seed_variables2(const Eigen::MatrixBase<Derived> &v, int offset, int ndir,
+                     VectorX<Dual2> &out) {
+  using Dual = typename Dual2::Scalar;
+  for (Eigen::Index i = 0; i < v.size(); i++)
+    out[i] = Dual2(Dual(v[i], ndir, offset + int(i)), ndir, offset + int(i));
+}
+
+/// Write the values and derivatives of @p r to @p value and the rows of @p J.
+template <typename Dual, typename V, typename M>
+void extract_jacobian(const VectorX<Dual> &r, const Eigen::MatrixBase<V> &value,
+                      const Eigen::MatrixBase<M> &J) {
+  V &v_ = value.const_cast_derived();
+  M &J_ = J.const_cast_derived();
+  for (Eigen::Index k = 0; k < r.size(); k++) {
+    v_[k] = r[k].value();
+    // constant outputs have no derivatives
+    if (r[k].derivatives().size() == 0)
+      J_.row(k).setZero();
+    else
+      J_.row(k) = r[k].derivatives().transpose();
+  }
+}
+
+/// Write the Hessian of @f$ \lambda^\top r @f$ to @p H.
+template <typename Dual2, typename Derived, typename M>
+void extract_vhp(const VectorX<Dual2> &r, const Eigen::MatrixBase<Derived> &lbda,
+                 const Eigen::MatrixBase<M> &H) {
+  M &H_ = H.const_cast_derived();
+  Dual2 lag(0.);
+  for (Eigen::Index k = 0; k < r.size(); k++) {
+    if (r[k].derivatives().size() > 0)
+      lag += lbda[k] * r[k];
+  }
+  H_.setZero();
+  const auto &grad = lag.derivatives();
+  for (Eigen::Index i = 0; i < grad.size(); i++) {
+    if (grad[i].derivatives().size() > 0)
+      H_.row(i) = grad[i].derivatives().transpose();
+  }
+}
+
+} // namespace internal
+
+/** @brief    Define a function \f$r(x,u,y)\f$ and its derivatives from a
+ * templated functor, through forward-mode automatic differentiation.
+ *
+ * @details   The functor is called with vectors of dual numbers carrying the
+ * derivatives with respect to all the @f$ n_x + n_u + n_y @f$ variables at
+ * once: the Jacobians are obtained in a single sweep, and are exact. Its
+ * signature is
+ * @code
+ * template <typename T>
+ * void operator()(const VectorX<T> &x, const VectorX<T> &u,
+ *                 const VectorX<T> &y, VectorX<T> &r) const;
+ * @endcode
+ * where `VectorX<T> = Eigen::Matrix<T, Eigen::Dynamic, 1>`, and @p r has size
+ * `nr`. The variables are Euclidean (\f$ n_x = n_{dx} \f$).
+ *
+ * If @p second_order is true, the vector-Hessian products are computed with
+ * nested dual numbers. The dual numbers of the data do not allocate during the
+ * evaluations, unless @p MaxDirections is Eigen::Dynamic.
+ */
+template <typename _Scalar, typename Functor, int MaxDirections = 32>
+struct ForwardDiffFunctionTpl : StageFunctionTpl<_Scalar> {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Base = StageFunctionTpl<Scalar>;
+  using BaseData = typename Base::Data;
+  using Dual = DualScalar<Scalar, MaxDirections>;
+  using Dual2 = DualScalar<Dual, MaxDirections>;
+  template <typename T> using VectorX = internal::VectorX<T>;
+
+  struct Data : BaseData {
+    VectorXs xv, uv, yv;
+    VectorX<Dual> x, u, y, r;
+    /// Second-order dual numbers, empty unless the function is second order.
+    VectorX<Dual2> x2, u2, y2, r2;
+
+    Data(ForwardDiffFunctionTpl const &model)
+        : BaseData(model.ndx1, model.nu, model.ndx2, model.nr),
+          xv(model.ndx1), uv(model.nu), yv(model.ndx2), x(model.ndx1),
+          u(model.nu), y(model.ndx2), r(model.nr) {
+      if (model.second_order) {
+        x2.resize(model.ndx1);
+        u2.resize(model.nu);
+        y2.resize(model.ndx2);
+        r2.resize(model.nr);
+      }
+    }
+  };
+
+  Functor functor;
+  bool second_order;
+
+  ForwardDiffFunctionTpl(const int ndx1, const int nu, const int ndx2,
+                         const int nr, const Functor &functor = Functor(),
+                         bool second_order = false)
+      : Base(ndx1, nu, ndx2, nr), functor(functor),
+        second_order(second_order) {
+    internal::check_num_directions(ndx1 + nu + ndx2, MaxDirections);
+  }
+
+  void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
+                const ConstVectorRef &y, BaseData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    d.xv = x;
+    d.uv = u;
+    d.yv = y;
+    functor(d.xv, d.uv, d.yv, d.value_);
+  }
+
+  /// @details This also updates the function value.
+  void computeJacobians(const ConstVectorRef &x, const ConstVectorRef &u,
+                        const ConstVectorRef &y,
+                        BaseData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    const int ndir = this->ndx1 + this->nu + this->ndx2;
+    internal::seed_variables(x, 0, ndir, d.x);
+    internal::seed_variables(u, this->ndx1, ndir, d.u);
+    internal::seed_variables(y, this->ndx1 + this->nu, ndir, d.y);
+    functor(d.x, d.u, d.y, d.r);
+    internal::extract_jacobian(d.r, d.value_, d.jac_buffer_);
+  }
+
+  void computeVectorHessianProducts(const ConstVectorRef &x,
+                                    const ConstVectorRef &u,
+                                    const ConstVectorRef &y,
+                                    const ConstVectorRef &lbda,
+                                    BaseData &data) const override {
+    if (!second_order)
+      return;
+    Data &d = static_cast<Data &>(data);
+    const int ndir = this->ndx1 + this->nu + this->ndx2;
+    internal::seed_variables2(x, 0, ndir, d.x2);
+    internal::seed_variables2(u, this->ndx1, ndir, d.u2);
+    internal::seed_variables2(y, this->ndx1 + this->nu, ndir, d.y2);
+    functor(d.x2, d.u2, d.y2, d.r2);
+    internal::extract_vhp(d.r2, lbda, d.vhp_buffer_);
+  }
+
+  shared_ptr<BaseData> createData() const override {
+    return std::make_shared<Data>(*this);
+  }
+};
+
+/** @brief    Define a unary function \f$r(x)\f$ and its derivatives from a
+ * templated functor, through forward-mode automatic differentiation.
+ *
+ * @details   Same as ForwardDiffFunctionTpl, with a functor of signature
+ * @code
+ * template <typename T>
+ * void operator()(const VectorX<T> &x, VectorX<T> &r) const;
+ * @endcode
+ */
+template <typename _Scalar, typename Functor, int MaxDirections = 32>
+struct ForwardDiffUnaryFunctionTpl : UnaryFunctionTpl<_Scalar> {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  ALIGATOR_UNARY_FUNCTION_INTERFACE(Scalar);
+  using BaseData = typename Base::Data;
+  using Dual = DualScalar<Scalar, MaxDirections>;
+  using Dual2 = DualScalar<Dual, MaxDirections>;
+  template <typename T> using VectorX = internal::VectorX<T>;
+
+  struct Data : BaseData {
+    VectorXs xv;
+    VectorX<Dual> x, r;
+    /// Second-order dual numbers, empty unless the function is second order.
+    VectorX<Dual2> x2, r2;
+
+    Data(ForwardDiffUnaryFunctionTpl const &model)
+        : BaseData(model.ndx1, model.nu, model.ndx2, model.nr),
+          xv(model.ndx1), x(model.ndx1), r(model.nr) {
+      if (model.second_order) {
+        x2.resize(model.ndx1);
+        r2.resize(model.nr);
+      }
+    }
+  };
+
+  Functor functor;
+  bool second_order;
+
+  ForwardDiffUnaryFunctionTpl(const int ndx, const int nu, const int nr,
+                              const Functor &functor = Functor(),
+                              bool second_order = false)
+      : Base(ndx, nu, nr), functor(functor), second_order(second_order) {
+    internal::check_num_directions(ndx, MaxDirections);
+  }
+
+  void evaluate(const ConstVectorRef &x, BaseData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    d.xv = x;
+    functor(d.xv, d.value_);
+  }
+
+  /// @details This also updates the function value.
+  void computeJacobians(const ConstVectorRef &x,
+                        BaseData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    internal::seed_variables(x, 0, this->ndx1, d.x);
+    functor(d.x, d.r);
+    internal::extract_jacobian(d.r, d.value_, d.Jx_);
+  }
+
+  void computeVectorHessianProducts(const ConstVectorRef &x,
+                                    const ConstVectorRef &lbda,
+                                    BaseData &data) const override {
+    if (!second_order)
+      return;
+    Data &d = static_cast<Data &>(data);
+    internal::seed_variables2(x, 0, this->ndx1, d.x2);
+    functor(d.x2, d.r2);
+    internal::extract_vhp(d.r2, lbda, d.Hxx_);
+  }
+
+  shared_ptr<BaseData> createData() const override {
+    return std::make_shared<Data>(*this);
+  }
+};
+
+} // namespace autodiff
+} // namespace aligator
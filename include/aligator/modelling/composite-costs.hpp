@@ -48,7 +48,6 @@ struct QuadraticResidualCostTpl : CostAbstractTpl<_Scalar> {
   using StageFunction = StageFunctionTpl<Scalar>;
   using Manifold = ManifoldAbstractTpl<Scalar>;
 
-  MatrixXs weights_;
   shared_ptr<StageFunction> residual_;
   bool gauss_newton = true;
 
@@ -57,20 +56,57 @@ struct QuadraticResidualCostTpl : CostAbstractTpl<_Scalar> {
                            const MatrixXs &weights);
 
   void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
-                CostData &data_) const;
+                CostData &data_) const override;
 
   void computeGradients(const ConstVectorRef &x, const ConstVectorRef &u,
-                        CostData &data_) const;
+                        CostData &data_) const override;
 
   void computeHessians(const ConstVectorRef &x, const ConstVectorRef &u,
-                       CostData &data_) const;
+                       CostData &data_) const override;
 
-  shared_ptr<CostData> createData() const {
-    return std::make_shared<Data>(this->ndx(), this->nu,
-                                  residual_->createData());
+  /// The residual Jacobian is computed once, with the residual.
+  void evaluateWithDerivatives(const ConstVectorRef &x, const ConstVectorRef &u,
+                               CostData &data_) const override;
+
+  /// The Gauss-Newton Hessian of a residual with constant Jacobians is
+  /// constant.
+  bool hasConstantHessians() const override {
+    return gauss_newton && residual_->hasConstantJacobians();
+  }
+
+  shared_ptr<CostData> createData() const override;
+
+  /// Weight matrix @f$ W @f$
+  const MatrixXs &getWeights() const { return weights_; }
+
+  /// @brief Set the weight matrix. Diagonal weights are detected, and then
+  /// applied in \f$O(n_r)\f$ operations.
+  void setWeights(const ConstMatrixRef &w) {
+    if ((w.rows() != residual_->nr) || (w.cols() != residual_->nr)) {
+      ALIGATOR_RUNTIME_ERROR(fmt::format(
+          "Weight matrix has wrong dimensions ({:d}, {:d}) (expected {:d}).",
+          w.rows(), w.cols(), residual_->nr));
+    }
+    weights_ = w;
+    diagonal_weights_ = weights_.isDiagonal(Scalar(0));
   }
 
+  /// Whether the weights are diagonal.
+  bool hasDiagonalWeights() const { return diagonal_weights_; }
+
 private:
+  MatrixXs weights_;
+  /// Whether weights_ is diagonal
+  bool diagonal_weights_;
+
+  /// Structure of the Hessian, from the weights and the Jacobian structure
+  /// of the residual.
+  HessianStructure
+  hessianStructure(const StageFunctionDataTpl<Scalar> &rdata) const;
+
+  /// Gradient from the residual value and Jacobian.
+  void assembleGradient(Data &data) const;
+
   void debug_dims() const {
     if (residual_->nr != weights_.cols()) {
       ALIGATOR_RUNTIME_ERROR(
@@ -26,9 +26,12 @@ template <typename _Scalar> struct ConstantCostTpl : CostAbstractTpl<_Scalar> {
   void computeHessians(const ConstVectorRef &, const ConstVectorRef &,
                        CostData &) const override {}
 
+  bool hasConstantHessians() const override { return true; }
+
   shared_ptr<CostData> createData() const override {
     auto d = Base::createData();
     d->value_ = value_;
+    d->hess_structure_ = HessianStructure::DIAGONAL;
     return d;
   }
 };
@@ -29,7 +29,7 @@ struct ControlBoxFunctionTpl : StageFunctionTpl<_Scalar> {
                         const Scalar umax);
 
   void evaluate(const ConstVectorRef &, const ConstVectorRef &u,
-                const ConstVectorRef &, Data &data) const;
+                const ConstVectorRef &, Data &data) const override;
 
   /**
    * @copybrief Base::computeJacobians()
@@ -37,11 +37,14 @@ struct ControlBoxFunctionTpl : StageFunctionTpl<_Scalar> {
    * are already set in createData().
    */
   void computeJacobians(const ConstVectorRef &, const ConstVectorRef &,
-                        const ConstVectorRef &, Data &data) const;
+                        const ConstVectorRef &, Data &data) const override;
+
+  bool hasConstantJacobians() const override { return true; }
 
   /// @copybrief Base::createData()
-  /// @details   This override sets the appropriate values of the Jacobians.
-  virtual shared_ptr<Data> createData() const;
+  /// @details   This override sets the appropriate values of the Jacobians, and
+  /// their structure.
+  shared_ptr<Data> createData() const override;
 };
 
 } // namespace aligator
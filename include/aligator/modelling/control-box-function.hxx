@@ -46,6 +46,13 @@ ControlBoxFunctionTpl<Scalar>::createData() const {
       std::make_shared<Data>(this->ndx1, this->nu, this->ndx2, this->nr);
   data->Ju_.topRows(this->nu).diagonal().array() = static_cast<Scalar>(-1.);
   data->Ju_.bottomRows(this->nu).diagonal().array() = static_cast<Scalar>(1.);
+  // row i and nu + i bound the control i
+  Eigen::VectorXi cols(this->nr);
+  cols << Eigen::VectorXi::LinSpaced(this->nu, 0, this->nu - 1),
+      Eigen::VectorXi::LinSpaced(this->nu, 0, this->nu - 1);
+  data->Jx_structure_ = JacobianStructure::ZERO;
+  data->Ju_structure_ = JacobianStructure::selection(cols);
+  data->Jy_structure_ = JacobianStructure::ZERO;
   return data;
 }
 } // namespace aligator
@@ -28,6 +28,15 @@ struct IntegratorEulerTpl : ExplicitIntegratorAbstractTpl<_Scalar> {
 
   void dForward(const ConstVectorRef &x, const ConstVectorRef &u,
                 ExplicitDynamicsDataTpl<Scalar> &data) const;
+
+  void forwardWithDerivatives(const ConstVectorRef &x, const ConstVectorRef &u,
+                              ExplicitDynamicsDataTpl<Scalar> &data) const;
+
+private:
+  /// Integrate the vector field of the ODE data.
+  void integrate(const ConstVectorRef &x, Data &d) const;
+  /// Jacobians of integrate(), from those of the ODE data.
+  void dIntegrate(const ConstVectorRef &x, Data &d) const;
 };
 
 } // namespace dynamics
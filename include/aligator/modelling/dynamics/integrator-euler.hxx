@@ -14,11 +14,8 @@ void IntegratorEulerTpl<Scalar>::forward(
     const ConstVectorRef &x, const ConstVectorRef &u,
     ExplicitDynamicsDataTpl<Scalar> &data) const {
   Data &d = static_cast<Data &>(data);
-  ODEDataTpl<Scalar> &cdata =
-      static_cast<ODEDataTpl<Scalar> &>(*d.continuous_data);
-  this->ode_->forward(x, u, cdata);
-  d.dx_ = timestep_ * cdata.xdot_;
-  this->space_next().integrate(x, d.dx_, d.xnext_);
+  this->ode_->forward(x, u, *d.continuous_data);
+  integrate(x, d);
 }
 
 template <typename Scalar>
@@ -26,12 +23,33 @@ void IntegratorEulerTpl<Scalar>::dForward(
     const ConstVectorRef &x, const ConstVectorRef &u,
     ExplicitDynamicsDataTpl<Scalar> &data) const {
   Data &d = static_cast<Data &>(data);
-  ODEDataTpl<Scalar> &cdata =
-      static_cast<ODEDataTpl<Scalar> &>(*d.continuous_data);
+  this->ode_->dForward(x, u, *d.continuous_data);
+  dIntegrate(x, d);
+}
 
+template <typename Scalar>
+void IntegratorEulerTpl<Scalar>::forwardWithDerivatives(
+    const ConstVectorRef &x, const ConstVectorRef &u,
+    ExplicitDynamicsDataTpl<Scalar> &data) const {
+  Data &d = static_cast<Data &>(data);
+  this->ode_->forwardWithDerivatives(x, u, *d.continuous_data);
+  integrate(x, d);
+  dIntegrate(x, d);
+}
+
+template <typename Scalar>
+void IntegratorEulerTpl<Scalar>::integrate(const ConstVectorRef &x,
+                                           Data &d) const {
+  d.dx_ = timestep_ * d.continuous_data->xdot_;
+  this->space_next().integrate(x, d.dx_, d.xnext_);
+}
+
+template <typename Scalar>
+void IntegratorEulerTpl<Scalar>::dIntegrate(const ConstVectorRef &x,
+                                            Data &d) const {
+  const ODEDataTpl<Scalar> &cdata = *d.continuous_data;
   // d(dx)_z = dt * df_dz
   // then transport to x+dx
-  this->ode_->dForward(x, u, cdata);
   d.Jx_ = timestep_ * cdata.Jx_; // ddx_dx
   d.Ju_ = timestep_ * cdata.Ju_; // ddx_du
   this->space_next().JintegrateTransport(x, d.dx_, d.Jx_, 1);
@@ -33,12 +33,20 @@ struct IntegratorRK2Tpl : ExplicitIntegratorAbstractTpl<_Scalar> {
   void dForward(const ConstVectorRef &x, const ConstVectorRef &u,
                 BaseData &data) const;
 
+  /// Evaluates each stage of the scheme and its Jacobians in one pass.
+  void forwardWithDerivatives(const ConstVectorRef &x, const ConstVectorRef &u,
+                              BaseData &data) const;
+
   shared_ptr<StageFunctionDataTpl<Scalar>> createData() const {
     return std::make_shared<Data>(this);
   }
 
 protected:
   Scalar dt_2_ = 0.5 * timestep_;
+
+private:
+  /// Jacobians of the scheme, from those of the ODE data of both stages.
+  void composeStages(const ConstVectorRef &x, Data &d) const;
 };
 
 template <typename Scalar>
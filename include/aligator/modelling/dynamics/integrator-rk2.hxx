@@ -32,13 +32,39 @@ void IntegratorRK2Tpl<Scalar>::dForward(const ConstVectorRef &x,
                                         const ConstVectorRef &u,
                                         BaseData &data) const {
   Data &d = static_cast<Data &>(data);
+  this->ode_->dForward(x, u, *d.continuous_data);
+  this->ode_->dForward(d.x1_, u, *d.continuous_data2);
+  composeStages(x, d);
+}
+
+template <typename Scalar>
+void IntegratorRK2Tpl<Scalar>::forwardWithDerivatives(const ConstVectorRef &x,
+                                                      const ConstVectorRef &u,
+                                                      BaseData &data) const {
+  Data &d = static_cast<Data &>(data);
   using ODEData = ODEDataTpl<Scalar>;
   ODEData &cd1 = static_cast<ODEData &>(*d.continuous_data);
   ODEData &cd2 = static_cast<ODEData &>(*d.continuous_data2);
 
+  this->ode_->forwardWithDerivatives(x, u, cd1);
+  d.dx1_ = dt_2_ * cd1.xdot_;
+  this->space_next_->integrate(x, d.dx1_, d.x1_);
+
+  this->ode_->forwardWithDerivatives(d.x1_, u, cd2);
+  d.dx_ = timestep_ * cd2.xdot_;
+  this->space_next_->integrate(x, d.dx_, d.xnext_);
+  composeStages(x, d);
+}
+
+template <typename Scalar>
+void IntegratorRK2Tpl<Scalar>::composeStages(const ConstVectorRef &x,
+                                             Data &d) const {
+  using ODEData = ODEDataTpl<Scalar>;
+  const ODEData &cd1 = static_cast<const ODEData &>(*d.continuous_data);
+  const ODEData &cd2 = static_cast<const ODEData &>(*d.continuous_data2);
+
   // x1 = x + dx1
   // dx1_dz = Transport(d(dx1)_dz) + dx_dz
-  this->ode_->dForward(x, u, cd1);
   d.Jx_ = dt_2_ * cd1.Jx_;
   d.Ju_ = dt_2_ * cd1.Ju_;
   this->space_next_->JintegrateTransport(x, d.dx1_, d.Jx_, 1);
@@ -48,7 +74,6 @@ void IntegratorRK2Tpl<Scalar>::dForward(const ConstVectorRef &x,
 
   // J = d(x+dx)_dz = d(x+dx)_dx1 * dx1_dz
   // then transport J to xnext = exp(dx) * x1
-  this->ode_->dForward(d.x1_, u, cd2);
   d.Jx_ = (timestep_ * cd2.Jx_) * d.Jx_;
   d.Ju_ = (timestep_ * cd2.Jx_) * d.Ju_ + timestep_ * cd2.Ju_;
   this->space_next_->JintegrateTransport(d.x1_, d.dx_, d.Jx_, 1);
@@ -34,9 +34,18 @@ struct IntegratorSemiImplEulerTpl : ExplicitIntegratorAbstractTpl<_Scalar> {
   void dForward(const ConstVectorRef &x, const ConstVectorRef &u,
                 BaseData &data) const;
 
+  void forwardWithDerivatives(const ConstVectorRef &x, const ConstVectorRef &u,
+                              BaseData &data) const;
+
   shared_ptr<StageFunctionDataTpl<Scalar>> createData() const {
     return std::make_shared<Data>(this);
   }
+
+private:
+  /// Integrate the vector field of the ODE data.
+  void integrate(const ConstVectorRef &x, Data &d) const;
+  /// Jacobians of integrate(), from those of the ODE data.
+  void dIntegrate(const ConstVectorRef &x, Data &d) const;
 };
 
 template <typename Scalar>
@@ -14,13 +14,36 @@ IntegratorSemiImplEulerTpl<Scalar>::IntegratorSemiImplEulerTpl(
 }
 
 template <typename Scalar>
-void IntegratorSemiImplEulerTpl<Scalar>::forward(
-    const ConstVectorRef &x, const ConstVectorRef &u,
-    ExplicitDynamicsDataTpl<Scalar> &data) const {
+void IntegratorSemiImplEulerTpl<Scalar>::forward(const ConstVectorRef &x,
+                                                 const ConstVectorRef &u,
+                                                 BaseData &data) const {
   Data &d = static_cast<Data &>(data);
-  ODEDataTpl<Scalar> &cdata =
-      static_cast<ODEDataTpl<Scalar> &>(*d.continuous_data);
-  this->ode_->forward(x, u, cdata);
+  this->ode_->forward(x, u, *d.continuous_data);
+  integrate(x, d);
+}
+
+template <typename Scalar>
+void IntegratorSemiImplEulerTpl<Scalar>::dForward(const ConstVectorRef &x,
+                                                  const ConstVectorRef &u,
+                                                  BaseData &data) const {
+  Data &d = static_cast<Data &>(data);
+  this->ode_->dForward(x, u, *d.continuous_data);
+  dIntegrate(x, d);
+}
+
+template <typename Scalar>
+void IntegratorSemiImplEulerTpl<Scalar>::forwardWithDerivatives(
+    const ConstVectorRef &x, const ConstVectorRef &u, BaseData &data) const {
+  Data &d = static_cast<Data &>(data);
+  this->ode_->forwardWithDerivatives(x, u, *d.continuous_data);
+  integrate(x, d);
+  dIntegrate(x, d);
+}
+
+template <typename Scalar>
+void IntegratorSemiImplEulerTpl<Scalar>::integrate(const ConstVectorRef &x,
+                                                   Data &d) const {
+  const ODEDataTpl<Scalar> &cdata = *d.continuous_data;
   int ndx = this->ndx1;
   const int ndx_2 = ndx / 2;
   d.dx_.bottomRows(ndx_2) = cdata.xdot_.bottomRows(ndx_2) * timestep_;
@@ -30,17 +53,13 @@ void IntegratorSemiImplEulerTpl<Scalar>::forward(
 }
 
 template <typename Scalar>
-void IntegratorSemiImplEulerTpl<Scalar>::dForward(
-    const ConstVectorRef &x, const ConstVectorRef &u,
-    ExplicitDynamicsDataTpl<Scalar> &data) const {
-  Data &d = static_cast<Data &>(data);
-  ODEDataTpl<Scalar> &cdata =
-      static_cast<ODEDataTpl<Scalar> &>(*d.continuous_data);
+void IntegratorSemiImplEulerTpl<Scalar>::dIntegrate(const ConstVectorRef &x,
+                                                    Data &d) const {
+  const ODEDataTpl<Scalar> &cdata = *d.continuous_data;
   int ndx = this->ndx1;
   const int ndx_2 = ndx / 2;
   const auto &space = this->space_next();
 
-  this->ode_->dForward(x, u, cdata);
   // dv_dx and dv_du are same as euler explicit
   d.Jx_ = timestep_ * cdata.Jx_; // dddx_dx
   d.Ju_ = timestep_ * cdata.Ju_; // ddx_du
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "aligator/modelling/dynamics/ode-abstract.hpp"
+#include "aligator/modelling/multibody/kinematics-cache.hpp"
 
 #include <proxsuite-nlp/modelling/spaces/multibody.hpp>
 #include <pinocchio/multibody/data.hpp>
@@ -60,6 +61,11 @@ struct MultibodyFreeFwdDynamicsTpl : ODEAbstractTpl<_Scalar> {
                        BaseData &data) const;
   virtual void dForward(const ConstVectorRef &x, const ConstVectorRef &u,
                         BaseData &data) const;
+  /// The derivatives of ABA also compute the acceleration: this runs a single
+  /// algorithm.
+  virtual void forwardWithDerivatives(const ConstVectorRef &x,
+                                      const ConstVectorRef &u,
+                                      BaseData &data) const;
 
   shared_ptr<ContDataAbstract> createData() const;
 
@@ -76,7 +82,8 @@ template <typename Scalar> struct MultibodyFreeFwdDataTpl : ODEDataTpl<Scalar> {
   VectorXs tau_;
   MatrixXs dtau_dx_;
   MatrixXs dtau_du_;
-  PinDataType pin_data_;
+  /// Kinematics shared with the multibody functions of the stage.
+  shared_ptr<MultibodyKinematicsCacheTpl<Scalar>> kinematics_;
   MultibodyFreeFwdDataTpl(const MultibodyFreeFwdDynamicsTpl<Scalar> *cont_dyn);
 };
 
@@ -3,9 +3,6 @@
 
 #include "aligator/modelling/dynamics/multibody-free-fwd.hpp"
 
-#include <pinocchio/algorithm/aba.hpp>
-#include <pinocchio/algorithm/aba-derivatives.hpp>
-
 namespace aligator {
 namespace dynamics {
 
@@ -43,7 +40,7 @@ void MultibodyFreeFwdDynamicsTpl<Scalar>::forward(const ConstVectorRef &x,
   const auto q = x.head(nq);
   const auto v = x.segment(nq, nv);
   d.xdot_.head(nv) = v;
-  d.xdot_.segment(nv, nv) = pinocchio::aba(model, d.pin_data_, q, v, d.tau_);
+  d.xdot_.segment(nv, nv) = d.kinematics_->aba(model, q, v, d.tau_);
 }
 
 template <typename Scalar>
@@ -55,10 +52,20 @@ void MultibodyFreeFwdDynamicsTpl<Scalar>::dForward(const ConstVectorRef &x,
   const int nq = model.nq;
   const int nv = model.nv;
   auto da_dx = d.Jx_.bottomRows(nv);
-  pinocchio::computeABADerivatives(model, d.pin_data_, x.head(nq), x.tail(nv),
-                                   d.tau_, da_dx.leftCols(nv),
-                                   da_dx.rightCols(nv), d.pin_data_.Minv);
-  d.Ju_.bottomRows(nv) = d.pin_data_.Minv * d.dtau_du_;
+  d.kinematics_->computeABADerivatives(model, x.head(nq), x.tail(nv), d.tau_,
+                                       da_dx.leftCols(nv), da_dx.rightCols(nv));
+  d.Ju_.bottomRows(nv) = d.kinematics_->pin_data.Minv * d.dtau_du_;
+}
+
+template <typename Scalar>
+void MultibodyFreeFwdDynamicsTpl<Scalar>::forwardWithDerivatives(
+    const ConstVectorRef &x, const ConstVectorRef &u, BaseData &data) const {
+  Data &d = static_cast<Data &>(data);
+  d.tau_.noalias() = actuation_matrix_ * u;
+  const int nv = space_->getModel().nv;
+  d.xdot_.head(nv) = x.tail(nv);
+  dForward(x, u, d);
+  d.xdot_.segment(nv, nv) = d.kinematics_->pin_data.ddq;
 }
 
 template <typename Scalar>
@@ -73,10 +80,11 @@ MultibodyFreeFwdDataTpl<Scalar>::MultibodyFreeFwdDataTpl(
     : Base(cont_dyn->ndx(), cont_dyn->nu()),
       tau_(cont_dyn->space_->getModel().nv),
       dtau_dx_(cont_dyn->ntau(), cont_dyn->ndx()),
-      dtau_du_(cont_dyn->actuation_matrix_), pin_data_() {
+      dtau_du_(cont_dyn->actuation_matrix_),
+      kinematics_(MultibodyKinematicsCacheTpl<Scalar>::shared(
+          cont_dyn->space_->getModel())) {
   tau_.setZero();
   const pinocchio::ModelTpl<Scalar> &model = cont_dyn->space_->getModel();
-  pin_data_ = PinDataType(model);
   this->Jx_.topRightCorner(model.nv, model.nv).setIdentity();
 }
 } // namespace dynamics
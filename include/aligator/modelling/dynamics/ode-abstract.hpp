@@ -33,6 +33,12 @@ struct ODEAbstractTpl : ContinuousDynamicsAbstractTpl<_Scalar> {
   virtual void dForward(const ConstVectorRef &x, const ConstVectorRef &u,
                         ODEData &data) const = 0;
 
+  /// Evaluate the vector field and its Jacobians. The default implementation
+  /// calls forward() then dForward().
+  virtual void forwardWithDerivatives(const ConstVectorRef &x,
+                                      const ConstVectorRef &u,
+                                      ODEData &data) const;
+
   /** Declare overrides **/
 
   void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
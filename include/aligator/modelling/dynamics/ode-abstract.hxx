@@ -9,6 +9,14 @@
 namespace aligator {
 namespace dynamics {
 
+template <typename Scalar>
+void ODEAbstractTpl<Scalar>::forwardWithDerivatives(const ConstVectorRef &x,
+                                                    const ConstVectorRef &u,
+                                                    ODEData &data) const {
+  this->forward(x, u, data);
+  this->dForward(x, u, data);
+}
+
 template <typename Scalar>
 void ODEAbstractTpl<Scalar>::evaluate(const ConstVectorRef &x,
                                       const ConstVectorRef &u,
@@ -50,6 +50,10 @@ struct FunctionSliceXprTpl : Base, detail::slice_impl_tpl<Base> {
     this->computeVectorHessianProducts_impl(data, lbda, x, u, y);
   }
 
+  bool hasConstantJacobians() const override {
+    return this->func->hasConstantJacobians();
+  }
+
   shared_ptr<BaseData> createData() const override {
     return std::make_shared<Data>(*this);
   }
@@ -88,6 +92,10 @@ struct FunctionSliceXprTpl<Scalar, UnaryFunctionTpl<Scalar>>
     this->computeVectorHessianProducts_impl(data, lbda, x);
   }
 
+  bool hasConstantJacobians() const override {
+    return this->func->hasConstantJacobians();
+  }
+
   shared_ptr<BaseData> createData() const override {
     return std::make_shared<Data>(*this);
   }
@@ -104,7 +112,12 @@ struct FunctionSliceDataTpl : StageFunctionDataTpl<Scalar> {
   template <typename Base>
   FunctionSliceDataTpl(FunctionSliceXprTpl<Scalar, Base> const &obj)
       : BaseData(obj.ndx1, obj.nu, obj.ndx2, obj.nr),
-        sub_data(obj.func->createData()), lbda_sub(obj.nr) {}
+        sub_data(obj.func->createData()), lbda_sub(obj.nr) {
+    // rows of diagonal blocks are selections
+    this->Jx_structure_ = sub_data->Jx_structure_.sliceRows(obj.indices);
+    this->Ju_structure_ = sub_data->Ju_structure_.sliceRows(obj.indices);
+    this->Jy_structure_ = sub_data->Jy_structure_.sliceRows(obj.indices);
+  }
 };
 
 namespace detail {
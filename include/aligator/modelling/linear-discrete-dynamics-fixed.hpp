@@ -0,0 +1,65 @@
+/// @file
+/// @brief Discrete linear dynamics with dimensions fixed at compile time.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/core/explicit-dynamics.hpp"
+#include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
+
+namespace aligator {
+
+namespace dynamics {
+
+/// @brief Discrete explicit linear dynamics, with state and control dimensions
+/// @p NX and @p NU fixed at compile time.
+/// @details This is the fixed-size counterpart of LinearDiscreteDynamicsTpl.
+template <typename _Scalar, int NX, int NU>
+struct LinearDiscreteDynamicsFixedTpl : ExplicitDynamicsModelTpl<_Scalar> {
+  static_assert((NX > 0) && (NU >= 0), "Dimensions must be fixed.");
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using MatrixA = Eigen::Matrix<Scalar, NX, NX>;
+  using MatrixB = Eigen::Matrix<Scalar, NX, NU>;
+  using VectorNx = Eigen::Matrix<Scalar, NX, 1>;
+  using VectorNu = Eigen::Matrix<Scalar, NU, 1>;
+  const MatrixA A_;
+  const MatrixB B_;
+  const VectorNx c_;
+
+  using Base = ExplicitDynamicsModelTpl<Scalar>;
+  using DynData = DynamicsDataTpl<Scalar>;
+  using Data = ExplicitDynamicsDataTpl<Scalar>;
+  using VectorSpaceType =
+      proxsuite::nlp::VectorSpaceTpl<Scalar, Eigen::Dynamic>;
+
+  LinearDiscreteDynamicsFixedTpl(const MatrixA &A, const MatrixB &B,
+                                 const VectorNx &c)
+      : Base(std::make_shared<VectorSpaceType>(NX), NU), A_(A), B_(B), c_(c) {}
+
+  void forward(const ConstVectorRef &x, const ConstVectorRef &u,
+               Data &data) const override {
+    Eigen::Map<VectorNx> xnext(data.xnext_.data());
+    xnext = c_;
+    xnext.noalias() += A_ * Eigen::Map<const VectorNx>(x.data());
+    xnext.noalias() += B_ * Eigen::Map<const VectorNu>(u.data());
+  }
+
+  void dForward(const ConstVectorRef &, const ConstVectorRef &,
+                Data &) const override {}
+
+  /// The state space is Euclidean, so the Jacobians are constant.
+  bool hasConstantJacobians() const override { return true; }
+
+  shared_ptr<DynData> createData() const override {
+    auto data = std::make_shared<Data>(NX, NU, NX, NX);
+    data->Jx_ = A_;
+    data->Ju_ = B_;
+    data->Jy_structure_ = JacobianStructure::DIAGONAL;
+    return data;
+  }
+};
+
+} // namespace dynamics
+
+} // namespace aligator
@@ -29,17 +29,22 @@ struct LinearDiscreteDynamicsTpl : ExplicitDynamicsModelTpl<_Scalar> {
         A_(A), B_(B), c_(c) {}
 
   void forward(const ConstVectorRef &x, const ConstVectorRef &u,
-               Data &data) const {
+               Data &data) const override {
     data.xnext_ = A_ * x + B_ * u + c_;
   }
 
-  void dForward(const ConstVectorRef &, const ConstVectorRef &, Data &) const {}
+  void dForward(const ConstVectorRef &, const ConstVectorRef &,
+                Data &) const override {}
 
-  shared_ptr<DynData> createData() const {
+  /// The state space is Euclidean, so the Jacobians are constant.
+  bool hasConstantJacobians() const override { return true; }
+
+  shared_ptr<DynData> createData() const override {
     auto data =
         std::make_shared<Data>(this->ndx1, this->nu, this->nx2(), this->ndx2);
     data->Jx_ = A_;
     data->Ju_ = B_;
+    data->Jy_structure_ = JacobianStructure::DIAGONAL;
     return data;
   }
 };
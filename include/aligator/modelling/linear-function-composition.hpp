@@ -42,7 +42,12 @@ template <typename _FunType> struct linear_func_composition_impl : _FunType {
   linear_func_composition_impl(shared_ptr<FunType> func, const ConstMatrixRef A)
       : linear_func_composition_impl(func, A, VectorXs::Zero(A.rows())) {}
 
-  shared_ptr<BaseData> createData() const {
+  /// A linear map of constant Jacobians is constant.
+  bool hasConstantJacobians() const override {
+    return func->hasConstantJacobians();
+  }
+
+  shared_ptr<BaseData> createData() const override {
     return std::make_shared<Data>(*this);
   }
 };
@@ -39,7 +39,7 @@ template <typename Scalar> struct LinearFunctionTpl : StageFunctionTpl<Scalar> {
       : LinearFunctionTpl(A, B, MatrixXs::Zero(A.rows(), A.cols()), d) {}
 
   void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
-                const ConstVectorRef &y, Data &data) const {
+                const ConstVectorRef &y, Data &data) const override {
     data.value_ = A_ * x + B_ * u + C_ * y + d_;
   }
 
@@ -49,15 +49,17 @@ template <typename Scalar> struct LinearFunctionTpl : StageFunctionTpl<Scalar> {
    * are already set in createData().
    */
   void computeJacobians(const ConstVectorRef &, const ConstVectorRef &,
-                        const ConstVectorRef &, Data &data) const {
+                        const ConstVectorRef &, Data &data) const override {
     data.Jx_ = A_;
     data.Ju_ = B_;
     data.Jy_ = C_;
   }
 
+  bool hasConstantJacobians() const override { return true; }
+
   /// @copybrief Base::createData()
   /// @details   This override sets the appropriate values of the Jacobians.
-  virtual shared_ptr<Data> createData() const {
+  shared_ptr<Data> createData() const override {
     auto data =
         std::make_shared<Data>(this->ndx1, this->nu, this->ndx2, this->nr);
     data->Jx_ = A_;
@@ -2,6 +2,7 @@
 
 #include "aligator/core/unary-function.hpp"
 #include "./fwd.hpp"
+#include "./kinematics-cache.hpp"
 
 #include <pinocchio/multibody/model.hpp>
 
@@ -49,8 +50,8 @@ struct CenterOfMassTranslationDataTpl : StageFunctionDataTpl<Scalar> {
   using Base = StageFunctionDataTpl<Scalar>;
   using PinData = pinocchio::DataTpl<Scalar>;
 
-  /// Pinocchio data object.
-  PinData pin_data_;
+  /// Kinematics shared with the other multibody functions of the stage.
+  shared_ptr<MultibodyKinematicsCacheTpl<Scalar>> kinematics_;
 
   CenterOfMassTranslationDataTpl(
       const CenterOfMassTranslationResidualTpl<Scalar> *model);
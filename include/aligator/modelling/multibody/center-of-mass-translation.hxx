@@ -10,8 +10,8 @@ void CenterOfMassTranslationResidualTpl<Scalar>::evaluate(
     const ConstVectorRef &x, BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
-  pinocchio::centerOfMass(model, pdata, x.head(model.nq));
+  pinocchio::DataTpl<Scalar> &pdata = d.kinematics_->pin_data;
+  d.kinematics_->centerOfMass(model, x.head(model.nq));
 
   d.value_ = pdata.com[0] - p_ref_;
 }
@@ -21,8 +21,8 @@ void CenterOfMassTranslationResidualTpl<Scalar>::computeJacobians(
     const ConstVectorRef &x, BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
-  pinocchio::jacobianCenterOfMass(model, pdata, x.head(model.nq));
+  pinocchio::DataTpl<Scalar> &pdata = d.kinematics_->pin_data;
+  d.kinematics_->jacobianCenterOfMass(model, x.head(model.nq));
 
   d.Jx_.leftCols(model.nv) = pdata.Jcom;
 }
@@ -31,6 +31,7 @@ template <typename Scalar>
 CenterOfMassTranslationDataTpl<Scalar>::CenterOfMassTranslationDataTpl(
     const CenterOfMassTranslationResidualTpl<Scalar> *model)
     : Base(model->ndx1, model->nu, model->ndx2, 3),
-      pin_data_(*model->pin_model_) {}
+      kinematics_(
+          MultibodyKinematicsCacheTpl<Scalar>::shared(*model->pin_model_)) {}
 
 } // namespace aligator
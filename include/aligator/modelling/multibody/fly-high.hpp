@@ -2,6 +2,7 @@
 
 #include "aligator/core/unary-function.hpp"
 #include "./fwd.hpp"
+#include "./kinematics-cache.hpp"
 #include <proxsuite-nlp/modelling/spaces/multibody.hpp>
 #include <pinocchio/algorithm/frames-derivatives.hpp>
 
@@ -51,7 +52,8 @@ struct FlyHighResidualTpl<Scalar>::Data : StageFunctionDataTpl<Scalar> {
 
   Data(FlyHighResidualTpl const &model)
       : BaseData(model.ndx1, model.nu, model.ndx2, model.nr),
-        pdata_(model.pmodel_), d_dq(6, model.pmodel_.nv),
+        kinematics_(MultibodyKinematicsCacheTpl<Scalar>::shared(model.pmodel_)),
+        d_dq(6, model.pmodel_.nv),
         d_dv(6, model.pmodel_.nv), l_dnu_dq(6, model.pmodel_.nv),
         l_dnu_dv(6, model.pmodel_.nv), o_dv_dq(3, model.pmodel_.nv),
         o_dv_dv(3, model.pmodel_.nv), vxJ(3, model.pmodel_.nv) {
@@ -64,7 +66,8 @@ struct FlyHighResidualTpl<Scalar>::Data : StageFunctionDataTpl<Scalar> {
     vxJ.setZero();
   }
 
-  pinocchio::DataTpl<Scalar> pdata_;
+  /// Kinematics shared with the other multibody functions of the stage.
+  shared_ptr<MultibodyKinematicsCacheTpl<Scalar>> kinematics_;
   Matrix6Xs d_dq, d_dv;
   Matrix6Xs l_dnu_dq, l_dnu_dv;
   Matrix3Xs o_dv_dq, o_dv_dv, vxJ;
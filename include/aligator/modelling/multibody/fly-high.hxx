@@ -19,15 +19,16 @@ void FlyHighResidualTpl<Scalar>::evaluate(const ConstVectorRef &x,
   Data &d = static_cast<Data &>(data);
   auto q = x.head(pmodel_.nq);
   auto v = x.segment(pmodel_.nq, pmodel_.nv);
-  pinocchio::forwardKinematics(pmodel_, d.pdata_, q, v);
-  pinocchio::updateFramePlacement(pmodel_, d.pdata_, pin_frame_id_);
+  pinocchio::DataTpl<Scalar> &pdata = d.kinematics_->pin_data;
+  d.kinematics_->forwardKinematics(pmodel_, q, v);
+  pinocchio::updateFramePlacement(pmodel_, pdata, pin_frame_id_);
 
-  d.value_ = pinocchio::getFrameVelocity(pmodel_, d.pdata_, pin_frame_id_,
+  d.value_ = pinocchio::getFrameVelocity(pmodel_, pdata, pin_frame_id_,
                                          pinocchio::LOCAL_WORLD_ALIGNED)
                  .linear()
                  .template head<2>();
 
-  const Vector3s &tf = d.pdata_.oMf[pin_frame_id_].translation();
+  const Vector3s &tf = pdata.oMf[pin_frame_id_].translation();
   d.ez = std::exp(-tf[2] * slope_);
   d.value_ *= d.ez;
 }
@@ -39,17 +40,18 @@ void FlyHighResidualTpl<Scalar>::computeJacobians(const ConstVectorRef &x,
   const int nv = pmodel_.nv;
   auto q = x.head(pmodel_.nq);
   auto v = x.segment(pmodel_.nq, nv);
-  auto a = VectorXs::Zero(nv);
+  pinocchio::DataTpl<Scalar> &pdata = d.kinematics_->pin_data;
 
-  pinocchio::computeForwardKinematicsDerivatives(pmodel_, d.pdata_, q, v, a);
-  pinocchio::getFrameVelocityDerivatives(pmodel_, d.pdata_, pin_frame_id_,
+  d.kinematics_->computeForwardKinematicsDerivatives(pmodel_, q, v);
+  pinocchio::updateFramePlacement(pmodel_, pdata, pin_frame_id_);
+  pinocchio::getFrameVelocityDerivatives(pmodel_, pdata, pin_frame_id_,
                                          pinocchio::LOCAL, d.l_dnu_dq,
                                          d.l_dnu_dv);
   const Vector3s &vf = pinocchio::getFrameVelocity(
-                           pmodel_, d.pdata_, pin_frame_id_, pinocchio::LOCAL)
+                           pmodel_, pdata, pin_frame_id_, pinocchio::LOCAL)
                            .linear();
   using Matrix3s = Eigen::Matrix<Scalar, 3, 3>;
-  const Matrix3s &R = d.pdata_.oMf[pin_frame_id_].rotation();
+  const Matrix3s &R = pdata.oMf[pin_frame_id_].rotation();
 
   d.vxJ.noalias() = pinocchio::skew(-vf) * d.l_dnu_dv.template bottomRows<3>();
   d.vxJ += d.l_dnu_dq.template topRows<3>();
@@ -2,6 +2,7 @@
 
 #include "aligator/core/unary-function.hpp"
 #include "./fwd.hpp"
+#include "./kinematics-cache.hpp"
 
 #include <pinocchio/multibody/model.hpp>
 #include <pinocchio/multibody/frame.hpp>
@@ -59,8 +60,8 @@ struct FramePlacementDataTpl : StageFunctionDataTpl<Scalar> {
   using PinData = pinocchio::DataTpl<Scalar>;
   using SE3 = pinocchio::SE3Tpl<Scalar>;
 
-  /// Pinocchio data object.
-  PinData pin_data_;
+  /// Kinematics shared with the other multibody functions of the stage.
+  shared_ptr<MultibodyKinematicsCacheTpl<Scalar>> kinematics_;
   /// Placement error of the frame.
   SE3 rMf_;
   /// Jacobian of the error
@@ -11,8 +11,8 @@ void FramePlacementResidualTpl<Scalar>::evaluate(const ConstVectorRef &x,
                                                  BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
-  pinocchio::forwardKinematics(model, pdata, x.head(model.nq));
+  pinocchio::DataTpl<Scalar> &pdata = d.kinematics_->pin_data;
+  d.kinematics_->forwardKinematics(model, x.head(model.nq));
   pinocchio::updateFramePlacement(model, pdata, pin_frame_id_);
 
   d.rMf_ = p_ref_inverse_ * pdata.oMf[pin_frame_id_];
@@ -20,13 +20,13 @@ void FramePlacementResidualTpl<Scalar>::evaluate(const ConstVectorRef &x,
 }
 
 template <typename Scalar>
-void FramePlacementResidualTpl<Scalar>::computeJacobians(const ConstVectorRef &,
-                                                         BaseData &data) const {
+void FramePlacementResidualTpl<Scalar>::computeJacobians(
+    const ConstVectorRef &x, BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
+  pinocchio::DataTpl<Scalar> &pdata = d.kinematics_->pin_data;
   pinocchio::Jlog6(d.rMf_, d.rJf_);
-  pinocchio::computeJointJacobians(model, pdata);
+  d.kinematics_->computeJointJacobians(model, x.head(model.nq));
   pinocchio::getFrameJacobian(model, pdata, pin_frame_id_, pinocchio::LOCAL,
                               d.fJf_);
   d.Jx_.leftCols(model.nv) = d.rJf_ * d.fJf_;
@@ -35,7 +35,9 @@ void FramePlacementResidualTpl<Scalar>::computeJacobians(const ConstVectorRef &,
 template <typename Scalar>
 FramePlacementDataTpl<Scalar>::FramePlacementDataTpl(
     const FramePlacementResidualTpl<Scalar> &model)
-    : Base(model.ndx1, model.nu, model.ndx2, 6), pin_data_(*model.pin_model_),
+    : Base(model.ndx1, model.nu, model.ndx2, 6),
+      kinematics_(
+          MultibodyKinematicsCacheTpl<Scalar>::shared(*model.pin_model_)),
       rJf_(6, 6), fJf_(6, model.pin_model_->nv) {
   rJf_.setZero();
   fJf_.setZero();
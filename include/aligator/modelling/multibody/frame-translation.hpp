@@ -2,6 +2,7 @@
 
 #include "aligator/core/unary-function.hpp"
 #include "./fwd.hpp"
+#include "./kinematics-cache.hpp"
 
 #include <pinocchio/multibody/model.hpp>
 #include <pinocchio/multibody/frame.hpp>
@@ -39,6 +40,17 @@ struct FrameTranslationResidualTpl : UnaryFunctionTpl<_Scalar>, frame_api {
 
   void computeJacobians(const ConstVectorRef &x, BaseData &data) const;
 
+  /// @brief Exact second-order term of the residual, computed from the joint
+  /// Jacobians of computeJacobians().
+  /// @details The motion subspaces of the joints supporting the frame vary
+  /// along the kinematic chain as \f$\partial S_j / \partial q_i = S_i \times
+  /// S_j\f$ for \f$i < j\f$ in different joints. The result is symmetrized,
+  /// and is the Hessian along the exponential map of the configuration space
+  /// (Lie group of the model).
+  void computeVectorHessianProducts(const ConstVectorRef &x,
+                                    const ConstVectorRef &lbda,
+                                    BaseData &data) const;
+
   shared_ptr<BaseData> createData() const {
     return allocate_shared_eigen_aligned<Data>(*this);
   }
@@ -53,11 +65,15 @@ struct FrameTranslationDataTpl : StageFunctionDataTpl<Scalar> {
   using Base = StageFunctionDataTpl<Scalar>;
   using PinData = pinocchio::DataTpl<Scalar>;
 
-  /// Pinocchio data object.
-  PinData pin_data_;
+  /// Kinematics shared with the other multibody functions of the stage.
+  shared_ptr<MultibodyKinematicsCacheTpl<Scalar>> kinematics_;
 
   /// Jacobian of the error, local frame
   typename math_types<Scalar>::Matrix6Xs fJf_;
+  /// Frame Jacobian, world frame
+  typename math_types<Scalar>::Matrix6Xs wJf_;
+  /// Columns of the error Jacobian crossed with the multiplier
+  typename math_types<Scalar>::MatrixXs Jpxl_;
 
   FrameTranslationDataTpl(const FrameTranslationResidualTpl<Scalar> &model);
 };
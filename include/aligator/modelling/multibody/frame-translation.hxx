@@ -11,8 +11,8 @@ void FrameTranslationResidualTpl<Scalar>::evaluate(const ConstVectorRef &x,
                                                    BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
-  pinocchio::forwardKinematics(model, pdata, x.head(model.nq));
+  pinocchio::DataTpl<Scalar> &pdata = d.kinematics_->pin_data;
+  d.kinematics_->forwardKinematics(model, x.head(model.nq));
   pinocchio::updateFramePlacement(model, pdata, pin_frame_id_);
 
   d.value_ = pdata.oMf[pin_frame_id_].translation() - p_ref_;
@@ -20,22 +20,68 @@ void FrameTranslationResidualTpl<Scalar>::evaluate(const ConstVectorRef &x,
 
 template <typename Scalar>
 void FrameTranslationResidualTpl<Scalar>::computeJacobians(
-    const ConstVectorRef &, BaseData &data) const {
+    const ConstVectorRef &x, BaseData &data) const {
   Data &d = static_cast<Data &>(data);
   const Model &model = *pin_model_;
-  pinocchio::DataTpl<Scalar> &pdata = d.pin_data_;
-  pinocchio::computeJointJacobians(model, pdata);
+  pinocchio::DataTpl<Scalar> &pdata = d.kinematics_->pin_data;
+  d.kinematics_->computeJointJacobians(model, x.head(model.nq));
   pinocchio::getFrameJacobian(model, pdata, pin_frame_id_,
                               pinocchio::LOCAL_WORLD_ALIGNED, d.fJf_);
   d.Jx_.leftCols(model.nv) = d.fJf_.topRows(3);
 }
 
+template <typename Scalar>
+void FrameTranslationResidualTpl<Scalar>::computeVectorHessianProducts(
+    const ConstVectorRef &x, const ConstVectorRef &lbda, BaseData &data) const {
+  Data &d = static_cast<Data &>(data);
+  const Model &model = *pin_model_;
+  pinocchio::DataTpl<Scalar> &pdata = d.kinematics_->pin_data;
+  const long nv = model.nv;
+  d.kinematics_->computeJointJacobians(model, x.head(model.nq));
+  pinocchio::updateFramePlacement(model, pdata, pin_frame_id_);
+  pinocchio::getFrameJacobian(model, pdata, pin_frame_id_, pinocchio::WORLD,
+                              d.wJf_);
+
+  const Vector3s lam = lbda;
+  const Vector3s plam = pdata.oMf[pin_frame_id_].translation().cross(lam);
+  const auto Jp = d.fJf_.template topRows<3>();
+  const auto Jv = d.wJf_.template topRows<3>();
+  const auto Jw = d.wJf_.template bottomRows<3>();
+  auto H = d.Hxx_.topLeftCorner(nv, nv);
+
+  // variation of the frame position: (dp/dq_i x lambda) . w_j
+  d.Jpxl_.noalias() = pinocchio::skew(-lam) * Jp;
+  H.noalias() = d.Jpxl_.transpose() * Jw;
+  // variation of the joint motion subspaces along the chain: columns outside
+  // of the support of the frame are zero. The columns of a same joint (e.g. a
+  // free flyer) move together along the exponential map, which has no such
+  // term once symmetrized.
+  for (int k = 1; k < model.njoints; k++) {
+    const long vk = model.idx_vs[std::size_t(k)];
+    for (long j = vk; j < vk + model.nvs[std::size_t(k)]; j++) {
+      for (long i = 0; i < j; i++) {
+        Scalar dS = 0.;
+        if (i < vk) {
+          dS = lam.dot(Jw.col(i).cross(Jv.col(j)) +
+                       Jv.col(i).cross(Jw.col(j))) +
+               plam.dot(Jw.col(i).cross(Jw.col(j)));
+        }
+        H(i, j) = H(j, i) = 0.5 * (H(i, j) + H(j, i) + dS);
+      }
+    }
+  }
+}
+
 template <typename Scalar>
 FrameTranslationDataTpl<Scalar>::FrameTranslationDataTpl(
     const FrameTranslationResidualTpl<Scalar> &model)
-    : Base(model.ndx1, model.nu, model.ndx2, 3), pin_data_(*model.pin_model_),
-      fJf_(6, model.pin_model_->nv) {
+    : Base(model.ndx1, model.nu, model.ndx2, 3),
+      kinematics_(
+          MultibodyKinematicsCacheTpl<Scalar>::shared(*model.pin_model_)),
+      fJf_(6, model.pin_model_->nv), wJf_(6, model.pin_model_->nv),
+      Jpxl_(3, model.pin_model_->nv) {
   fJf_.setZero();
+  wJf_.setZero();
 }
 
 } // namespace aligator
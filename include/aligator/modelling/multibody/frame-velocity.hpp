@@ -2,6 +2,7 @@
 
 #include "aligator/core/unary-function.hpp"
 #include "./fwd.hpp"
+#include "./kinematics-cache.hpp"
 
 #include <pinocchio/multibody/model.hpp>
 #include <pinocchio/multibody/data.hpp>
@@ -54,8 +55,8 @@ struct FrameVelocityDataTpl : StageFunctionDataTpl<Scalar> {
   using Base = StageFunctionDataTpl<Scalar>;
   using Motion = pinocchio::MotionTpl<Scalar>;
 
-  /// Pinocchio data object.
-  pinocchio::DataTpl<Scalar> pin_data_;
+  /// Kinematics shared with the other multibody functions of the stage.
+  shared_ptr<MultibodyKinematicsCacheTpl<Scalar>> kinematics_;
 
   FrameVelocityDataTpl(const FrameVelocityResidualTpl<Scalar> &model);
 };
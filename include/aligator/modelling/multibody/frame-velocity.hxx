@@ -27,11 +27,11 @@ void FrameVelocityResidualTpl<Scalar>::evaluate(const ConstVectorRef &x,
   const Model &model = *pin_model_;
   auto q = x.head(model.nq);
   auto v = x.segment(model.nq, model.nv);
-  pinocchio::forwardKinematics(model, d.pin_data_, q, v);
-  pinocchio::updateFramePlacement(model, d.pin_data_, pin_frame_id_);
+  pinocchio::DataTpl<Scalar> &pdata = d.kinematics_->pin_data;
+  d.kinematics_->forwardKinematics(model, q, v);
+  pinocchio::updateFramePlacement(model, pdata, pin_frame_id_);
   d.value_ =
-      (pinocchio::getFrameVelocity(model, d.pin_data_, pin_frame_id_, type_) -
-       vref_)
+      (pinocchio::getFrameVelocity(model, pdata, pin_frame_id_, type_) - vref_)
           .toVector();
 }
 
@@ -42,16 +42,18 @@ void FrameVelocityResidualTpl<Scalar>::computeJacobians(const ConstVectorRef &x,
   const Model &model = *pin_model_;
   auto q = x.head(model.nq);
   auto v = x.segment(model.nq, model.nv);
-  VectorXs a = VectorXs::Zero(model.nv);
-  pinocchio::computeForwardKinematicsDerivatives(model, d.pin_data_, q, v, a);
-  pinocchio::getFrameVelocityDerivatives(model, d.pin_data_, pin_frame_id_,
-                                         type_, d.Jx_.leftCols(model.nv),
+  d.kinematics_->computeForwardKinematicsDerivatives(model, q, v);
+  pinocchio::getFrameVelocityDerivatives(model, d.kinematics_->pin_data,
+                                         pin_frame_id_, type_,
+                                         d.Jx_.leftCols(model.nv),
                                          d.Jx_.rightCols(model.nv));
 }
 
 template <typename Scalar>
 FrameVelocityDataTpl<Scalar>::FrameVelocityDataTpl(
     const FrameVelocityResidualTpl<Scalar> &model)
-    : Base(model.ndx1, model.nu, model.ndx2, 6), pin_data_(*model.pin_model_) {}
+    : Base(model.ndx1, model.nu, model.ndx2, 6),
+      kinematics_(
+          MultibodyKinematicsCacheTpl<Scalar>::shared(*model.pin_model_)) {}
 
 } // namespace aligator
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "aligator/fwd.hpp"
+#include "aligator/core/shared-data.hpp"
+
+#include <pinocchio/multibody/model.hpp>
+#include <pinocchio/multibody/data.hpp>
+
+namespace aligator {
+
+/** @brief Pinocchio data shared by the multibody functions of a stage.
+ *
+ * @details The cache records the state \f$(q, v)\f$ of the last computations,
+ * and which quantities were computed: each algorithm runs at most once per
+ * state, whichever function requests it first. Asking for a quantity at
+ * another state recomputes it, so that results are always consistent with
+ * the arguments (e.g. for finite differences or multi-stage integrators).
+ *
+ * The data of the functions built on equal models share a cache when they are
+ * created in the same SharedDataScope, which StageModelTpl::createData()
+ * opens; see shared().
+ */
+template <typename _Scalar> struct MultibodyKinematicsCacheTpl {
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Model = pinocchio::ModelTpl<Scalar>;
+  using PinData = pinocchio::DataTpl<Scalar>;
+
+  /// Quantities of the pinocchio data computed at the current state.
+  enum Quantity : unsigned {
+    PLACEMENTS = 1 << 0,
+    VELOCITIES = 1 << 1,
+    JOINT_JACOBIANS = 1 << 2,
+    /// Derivatives of the joint velocities.
+    KINEMATICS_DERIVATIVES = 1 << 3,
+    CENTER_OF_MASS = 1 << 4,
+    CENTER_OF_MASS_VELOCITY = 1 << 5,
+    CENTER_OF_MASS_JACOBIAN = 1 << 6
+  };
+
+  PinData pin_data;
+
+  explicit MultibodyKinematicsCacheTpl(const Model &model);
+
+  /// Cache of the current SharedDataScope for models equal to @p model.
+  static shared_ptr<MultibodyKinematicsCacheTpl> shared(const Model &model);
+
+  /// Joint placements at configuration @p q.
+  void forwardKinematics(const Model &model, const ConstVectorRef &q);
+  /// Joint placements and velocities at state @p (q, v).
+  void forwardKinematics(const Model &model, const ConstVectorRef &q,
+                         const ConstVectorRef &v);
+  /// Joint placements and Jacobians at configuration @p q.
+  void computeJointJacobians(const Model &model, const ConstVectorRef &q);
+  /// Kinematics and their derivatives at state @p (q, v), with zero
+  /// acceleration.
+  void computeForwardKinematicsDerivatives(const Model &model,
+                                           const ConstVectorRef &q,
+                                           const ConstVectorRef &v);
+  /// Center of mass at configuration @p q.
+  void centerOfMass(const Model &model, const ConstVectorRef &q);
+  /// Center of mass and its velocity at state @p (q, v).
+  void centerOfMass(const Model &model, const ConstVectorRef &q,
+                    const ConstVectorRef &v);
+  /// Jacobian of the center of mass at configuration @p q.
+  void jacobianCenterOfMass(const Model &model, const ConstVectorRef &q);
+
+  /// @brief Joint accelerations from the articulated-body algorithm.
+  /// @details This only computes quantities of the current state.
+  const VectorXs &aba(const Model &model, const ConstVectorRef &q,
+                      const ConstVectorRef &v, const ConstVectorRef &tau);
+  /// @brief Derivatives of the articulated-body algorithm, written to
+  /// @p da_dq, @p da_dv and `pin_data.Minv`.
+  /// @details This also computes the joint placements, velocities and
+  /// Jacobians.
+  void computeABADerivatives(const Model &model, const ConstVectorRef &q,
+                             const ConstVectorRef &v,
+                             const ConstVectorRef &tau, MatrixRef da_dq,
+                             MatrixRef da_dv);
+
+  /// Whether all of @p quantities are computed at the current state.
+  bool has(unsigned quantities) const {
+    return (computed_ & quantities) == quantities;
+  }
+  /// Forget the current state: the next requests recompute their quantities.
+  void invalidate() {
+    has_q_ = false;
+    has_v_ = false;
+    computed_ = 0;
+  }
+
+private:
+  /// Move to configuration @p q, forgetting the quantities if it changed.
+  void setConfiguration(const ConstVectorRef &q);
+  /// Move to state @p (q, v), forgetting the quantities if it changed.
+  void setState(const ConstVectorRef &q, const ConstVectorRef &v);
+
+  VectorXs q_;
+  VectorXs v_;
+  bool has_q_ = false;
+  bool has_v_ = false;
+  unsigned computed_ = 0;
+};
+
+} // namespace aligator
+
+#include "aligator/modelling/multibody/kinematics-cache.hxx"
+
+#ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
+#include "aligator/modelling/multibody/kinematics-cache.txx"
+#endif
@@ -0,0 +1,150 @@
+#pragma once
+
+#include "aligator/modelling/multibody/kinematics-cache.hpp"
+
+#include <pinocchio/algorithm/aba.hpp>
+#include <pinocchio/algorithm/aba-derivatives.hpp>
+#include <pinocchio/algorithm/center-of-mass.hpp>
+#include <pinocchio/algorithm/jacobian.hpp>
+#include <pinocchio/algorithm/kinematics.hpp>
+#include <pinocchio/algorithm/kinematics-derivatives.hpp>
+
+namespace aligator {
+
+template <typename Scalar>
+MultibodyKinematicsCacheTpl<Scalar>::MultibodyKinematicsCacheTpl(
+    const Model &model)
+    : pin_data(model), q_(model.nq), v_(model.nv) {}
+
+template <typename Scalar>
+auto MultibodyKinematicsCacheTpl<Scalar>::shared(const Model &model)
+    -> shared_ptr<MultibodyKinematicsCacheTpl> {
+  return SharedDataScope::get<MultibodyKinematicsCacheTpl>(model, [&] {
+    return allocate_shared_eigen_aligned<MultibodyKinematicsCacheTpl>(model);
+  });
+}
+
+template <typename Scalar>
+void MultibodyKinematicsCacheTpl<Scalar>::setConfiguration(
+    const ConstVectorRef &q) {
+  if (!has_q_ || q_ != q) {
+    q_ = q;
+    has_q_ = true;
+    has_v_ = false;
+    computed_ = 0;
+  }
+}
+
+template <typename Scalar>
+void MultibodyKinematicsCacheTpl<Scalar>::setState(const ConstVectorRef &q,
+                                                   const ConstVectorRef &v) {
+  setConfiguration(q);
+  if (!has_v_ || v_ != v) {
+    v_ = v;
+    has_v_ = true;
+    computed_ &= ~unsigned(VELOCITIES | KINEMATICS_DERIVATIVES |
+                           CENTER_OF_MASS_VELOCITY);
+  }
+}
+
+template <typename Scalar>
+void MultibodyKinematicsCacheTpl<Scalar>::forwardKinematics(
+    const Model &model, const ConstVectorRef &q) {
+  setConfiguration(q);
+  if (has(PLACEMENTS))
+    return;
+  pinocchio::forwardKinematics(model, pin_data, q);
+  computed_ |= PLACEMENTS;
+}
+
+template <typename Scalar>
+void MultibodyKinematicsCacheTpl<Scalar>::forwardKinematics(
+    const Model &model, const ConstVectorRef &q, const ConstVectorRef &v) {
+  setState(q, v);
+  if (has(PLACEMENTS | VELOCITIES))
+    return;
+  pinocchio::forwardKinematics(model, pin_data, q, v);
+  computed_ |= PLACEMENTS | VELOCITIES;
+}
+
+template <typename Scalar>
+void MultibodyKinematicsCacheTpl<Scalar>::computeJointJacobians(
+    const Model &model, const ConstVectorRef &q) {
+  setConfiguration(q);
+  if (has(JOINT_JACOBIANS))
+    return;
+  pinocchio::computeJointJacobians(model, pin_data, q);
+  computed_ |= PLACEMENTS | JOINT_JACOBIANS;
+}
+
+template <typename Scalar>
+void MultibodyKinematicsCacheTpl<Scalar>::computeForwardKinematicsDerivatives(
+    const Model &model, const ConstVectorRef &q, const ConstVectorRef &v) {
+  setState(q, v);
+  if (has(KINEMATICS_DERIVATIVES))
+    return;
+  pinocchio::computeForwardKinematicsDerivatives(model, pin_data, q, v,
+                                                 VectorXs::Zero(model.nv));
+  computed_ |=
+      PLACEMENTS | VELOCITIES | JOINT_JACOBIANS | KINEMATICS_DERIVATIVES;
+}
+
+template <typename Scalar>
+void MultibodyKinematicsCacheTpl<Scalar>::centerOfMass(
+    const Model &model, const ConstVectorRef &q) {
+  setConfiguration(q);
+  if (has(CENTER_OF_MASS))
+    return;
+  if (has(PLACEMENTS))
+    pinocchio::centerOfMass(model, pin_data, pinocchio::POSITION);
+  else
+    pinocchio::centerOfMass(model, pin_data, q);
+  computed_ |= PLACEMENTS | CENTER_OF_MASS;
+}
+
+template <typename Scalar>
+void MultibodyKinematicsCacheTpl<Scalar>::centerOfMass(
+    const Model &model, const ConstVectorRef &q, const ConstVectorRef &v) {
+  setState(q, v);
+  if (has(CENTER_OF_MASS | CENTER_OF_MASS_VELOCITY))
+    return;
+  if (has(PLACEMENTS | VELOCITIES))
+    pinocchio::centerOfMass(model, pin_data, pinocchio::VELOCITY);
+  else
+    pinocchio::centerOfMass(model, pin_data, q, v);
+  computed_ |=
+      PLACEMENTS | VELOCITIES | CENTER_OF_MASS | CENTER_OF_MASS_VELOCITY;
+}
+
+template <typename Scalar>
+void MultibodyKinematicsCacheTpl<Scalar>::jacobianCenterOfMass(
+    const Model &model, const ConstVectorRef &q) {
+  setConfiguration(q);
+  if (has(CENTER_OF_MASS_JACOBIAN))
+    return;
+  forwardKinematics(model, q);
+  pinocchio::jacobianCenterOfMass(model, pin_data);
+  computed_ |= CENTER_OF_MASS_JACOBIAN;
+}
+
+template <typename Scalar>
+auto MultibodyKinematicsCacheTpl<Scalar>::aba(const Model &model,
+                                              const ConstVectorRef &q,
+                                              const ConstVectorRef &v,
+                                              const ConstVectorRef &tau)
+    -> const VectorXs & {
+  setState(q, v);
+  return pinocchio::aba(model, pin_data, q, v, tau);
+}
+
+template <typename Scalar>
+void MultibodyKinematicsCacheTpl<Scalar>::computeABADerivatives(
+    const Model &model, const ConstVectorRef &q, const ConstVectorRef &v,
+    const ConstVectorRef &tau, MatrixRef da_dq, MatrixRef da_dv) {
+  setState(q, v);
+  pinocchio::computeABADerivatives(model, pin_data, q, v, tau, da_dq, da_dv,
+                                   pin_data.Minv);
+  computed_ |= PLACEMENTS | VELOCITIES | JOINT_JACOBIANS;
+}
+
+} // namespace aligator
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "./kinematics-cache.hpp"
+#include "aligator/context.hpp"
+
+namespace aligator {
+
+extern template struct MultibodyKinematicsCacheTpl<context::Scalar>;
+
+} // namespace aligator
@@ -0,0 +1,114 @@
+/// @file
+/// @brief Quadratic cost with dimensions fixed at compile time.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/modelling/quad-costs.hpp"
+
+namespace aligator {
+
+/// @brief Euclidean quadratic cost, with state and control dimensions @p NX
+/// and @p NU fixed at compile time.
+/// @details This is the fixed-size counterpart of QuadraticCostTpl, meant for
+/// small systems where Eigen can unroll the products. It uses the same data
+/// struct, so it can be mixed with other costs (e.g. in a CostStackTpl).
+template <typename _Scalar, int NX, int NU>
+struct QuadraticCostFixedTpl : CostAbstractTpl<_Scalar> {
+  static_assert((NX > 0) && (NU >= 0), "Dimensions must be fixed.");
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Base = CostAbstractTpl<Scalar>;
+  using CostData = CostDataAbstractTpl<Scalar>;
+  using Data = QuadraticCostDataTpl<Scalar>;
+  using VectorSpace = proxsuite::nlp::VectorSpaceTpl<Scalar, Eigen::Dynamic>;
+
+  using VectorNx = Eigen::Matrix<Scalar, NX, 1>;
+  using VectorNu = Eigen::Matrix<Scalar, NU, 1>;
+  using MatrixNx = Eigen::Matrix<Scalar, NX, NX>;
+  using MatrixNu = Eigen::Matrix<Scalar, NU, NU>;
+  using MatrixNxNu = Eigen::Matrix<Scalar, NX, NU>;
+
+  /// Weight @f$ Q @f$
+  MatrixNx weights_x;
+  /// Weight @f$ R @f$
+  MatrixNu weights_u;
+  /// Weight N for term @f$ x^\top N u @f$
+  MatrixNxNu weights_cross;
+  VectorNx interp_x;
+  VectorNu interp_u;
+
+  QuadraticCostFixedTpl(const MatrixNx &w_x, const MatrixNu &w_u,
+                        const MatrixNxNu &w_cross, const VectorNx &interp_x,
+                        const VectorNu &interp_u)
+      : Base(std::make_shared<VectorSpace>(NX), NU), weights_x(w_x),
+        weights_u(w_u), weights_cross(w_cross), interp_x(interp_x),
+        interp_u(interp_u), has_cross_term_(!w_cross.isZero(0.)) {}
+
+  QuadraticCostFixedTpl(const MatrixNx &w_x, const MatrixNu &w_u)
+      : QuadraticCostFixedTpl(w_x, w_u, MatrixNxNu::Zero(), VectorNx::Zero(),
+                              VectorNu::Zero()) {}
+
+  void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
+                CostData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    Eigen::Map<const VectorNx> xf(x.data());
+    Eigen::Map<const VectorNu> uf(u.data());
+    Eigen::Map<VectorNx> wx(d.w_times_x_.data());
+    Eigen::Map<VectorNu> wu(d.w_times_u_.data());
+    wx.noalias() = weights_x * xf;
+    wu.noalias() = weights_u * uf;
+    if (has_cross_term_) {
+      wx.noalias() += weights_cross * uf;
+      wu.noalias() += weights_cross.transpose() * xf;
+    }
+    data.value_ = Scalar(0.5) * xf.dot(wx + 2 * interp_x) +
+                  Scalar(0.5) * uf.dot(wu + 2 * interp_u);
+  }
+
+  void computeGradients(const ConstVectorRef &, const ConstVectorRef &,
+                        CostData &data) const override {
+    Data &d = static_cast<Data &>(data);
+    Eigen::Map<VectorNx>(d.grad_.data()) =
+        Eigen::Map<const VectorNx>(d.w_times_x_.data()) + interp_x;
+    Eigen::Map<VectorNu>(d.grad_.data() + NX) =
+        Eigen::Map<const VectorNu>(d.w_times_u_.data()) + interp_u;
+  }
+
+  /// @copydoc QuadraticCostTpl::computeHessians()
+  void computeHessians(const ConstVectorRef &, const ConstVectorRef &,
+                       CostData &data) const override {
+    data.hess_structure_ = hessianStructure();
+    data.Lxx_ = weights_x;
+    data.Luu_ = weights_u;
+    data.Lxu_ = weights_cross;
+    data.Lux_ = weights_cross.transpose();
+  }
+
+  bool hasConstantHessians() const override { return true; }
+
+  shared_ptr<CostData> createData() const override {
+    auto data = std::make_shared<Data>(NX, NU);
+    computeHessians(VectorNx::Zero(), VectorNu::Zero(), *data);
+    return data;
+  }
+
+  /// Structure of the Hessian, detected from the current weights (these are
+  /// small, fixed-size matrices).
+  HessianStructure hessianStructure() const {
+    if (!weights_cross.isZero(Scalar(0)))
+      return HessianStructure::DENSE;
+    if (weights_x.isDiagonal(Scalar(0)) && weights_u.isDiagonal(Scalar(0)))
+      return HessianStructure::DIAGONAL;
+    return HessianStructure::BLOCK_DIAGONAL;
+  }
+
+  /// @copydoc has_cross_term_
+  bool hasCrossTerm() const { return has_cross_term_; }
+
+protected:
+  /// Whether a cross term exists
+  bool has_cross_term_;
+};
+
+} // namespace aligator
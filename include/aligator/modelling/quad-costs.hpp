@@ -18,12 +18,11 @@ public:
   using Data = QuadraticCostDataTpl<Scalar>;
   using VectorSpace = proxsuite::nlp::VectorSpaceTpl<Scalar, Eigen::Dynamic>;
 
+protected:
   /// Weight @f$ Q @f$
   MatrixXs weights_x;
   /// Weight @f$ R @f$
   MatrixXs weights_u;
-
-protected:
   /// Weight N for term @f$ x^\top N u @f$
   MatrixXs weights_cross_;
 
@@ -61,6 +60,7 @@ public:
         interp_x(interp_x), interp_u(interp_u), has_cross_term_(false) {
     debug_check_dims();
     weights_cross_.setZero();
+    updateWeightStructure();
   }
 
   QuadraticCostTpl(const ConstMatrixRef &w_x, const ConstMatrixRef &w_u,
@@ -71,6 +71,7 @@ public:
         weights_u(w_u), weights_cross_(w_cross), interp_x(interp_x),
         interp_u(interp_u), has_cross_term_(true) {
     debug_check_dims();
+    updateWeightStructure();
   }
 
   QuadraticCostTpl(const ConstMatrixRef &w_x, const ConstMatrixRef &w_u)
@@ -83,10 +84,16 @@ public:
                          VectorXs::Zero(w_u.cols())) {}
 
   void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
-                CostData &data) const {
+                CostData &data) const override {
     Data &d = static_cast<Data &>(data);
-    d.w_times_x_.noalias() = weights_x * x;
-    d.w_times_u_.noalias() = weights_u * u;
+    if (diagonal_x_)
+      d.w_times_x_ = weights_x.diagonal().cwiseProduct(x);
+    else
+      d.w_times_x_.noalias() = weights_x * x;
+    if (diagonal_u_)
+      d.w_times_u_ = weights_u.diagonal().cwiseProduct(u);
+    else
+      d.w_times_u_.noalias() = weights_u * u;
     if (has_cross_term_) {
       d.cross_x_.noalias() = weights_cross_ * u;
       d.cross_u_.noalias() = weights_cross_.transpose() * x;
@@ -99,24 +106,68 @@ public:
   }
 
   void computeGradients(const ConstVectorRef &, const ConstVectorRef &,
-                        CostData &data) const {
+                        CostData &data) const override {
     Data &d = static_cast<Data &>(data);
     d.Lx_ = d.w_times_x_ + interp_x;
     d.Lu_ = d.w_times_u_ + interp_u;
   }
 
+  /// The Hessians are the weights; being constant, they are only copied
+  /// again when the stage data is invalidated, e.g. after the weights change.
   void computeHessians(const ConstVectorRef &, const ConstVectorRef &,
-                       CostData &) const {}
+                       CostData &data) const override {
+    data.hess_structure_ = hessianStructure();
+    data.Lxx_ = weights_x;
+    data.Luu_ = weights_u;
+    data.Lxu_ = weights_cross_;
+    data.Lux_ = weights_cross_.transpose();
+  }
 
-  shared_ptr<CostData> createData() const {
+  bool hasConstantHessians() const override { return true; }
+
+  shared_ptr<CostData> createData() const override {
     auto data = std::make_shared<Data>(this->ndx(), this->nu);
     data->Lxx_ = weights_x;
     data->Luu_ = weights_u;
     data->Lxu_ = weights_cross_;
     data->Lux_ = weights_cross_.transpose();
+    data->hess_structure_ = hessianStructure();
     return data;
   }
 
+  /// Weight @f$ Q @f$
+  const MatrixXs &getWeightsX() const { return weights_x; }
+  /// Weight @f$ R @f$
+  const MatrixXs &getWeightsU() const { return weights_u; }
+
+  /// @brief Set the weight @f$ Q @f$. Diagonal weights are detected, and then
+  /// applied in \f$O(n)\f$ operations.
+  void setWeightsX(const ConstMatrixRef &w) {
+    check_dim_equal(w.rows(), this->ndx(), " for x weights");
+    check_dim_equal(w.cols(), this->ndx(), " for x weights");
+    weights_x = w;
+    updateWeightStructure();
+  }
+
+  /// @brief Set the weight @f$ R @f$, see setWeightsX().
+  void setWeightsU(const ConstMatrixRef &w) {
+    check_dim_equal(w.rows(), this->nu, " for u weights");
+    check_dim_equal(w.cols(), this->nu, " for u weights");
+    weights_u = w;
+    updateWeightStructure();
+  }
+
+  /// Whether the state and control weights are diagonal.
+  bool hasDiagonalWeights() const { return diagonal_x_ && diagonal_u_; }
+
+  /// Structure of the Hessian, given the structure of the weights.
+  HessianStructure hessianStructure() const {
+    if (has_cross_term_)
+      return HessianStructure::DENSE;
+    return hasDiagonalWeights() ? HessianStructure::DIAGONAL
+                                : HessianStructure::BLOCK_DIAGONAL;
+  }
+
   const ConstMatrixRef getCrossWeights() const { return weights_cross_; }
   void setCrossWeight(const ConstMatrixRef &w) {
     weights_cross_ = w;
@@ -130,6 +181,16 @@ public:
 protected:
   /// Whether a cross term exists
   bool has_cross_term_;
+  /// Whether weights_x is diagonal
+  bool diagonal_x_;
+  /// Whether weights_u is diagonal
+  bool diagonal_u_;
+
+  /// Detect the diagonal weights.
+  void updateWeightStructure() {
+    diagonal_x_ = weights_x.isDiagonal(Scalar(0));
+    diagonal_u_ = weights_u.isDiagonal(Scalar(0));
+  }
 };
 
 template <typename Scalar>
@@ -10,8 +10,9 @@ template <typename Scalar>
 QuadraticResidualCostTpl<Scalar>::QuadraticResidualCostTpl(
     shared_ptr<Manifold> space, shared_ptr<StageFunction> function,
     const MatrixXs &weights)
-    : Base(space, function->nu), weights_(weights), residual_(function) {
+    : Base(space, function->nu), residual_(function), weights_(weights) {
   debug_dims();
+  diagonal_weights_ = weights_.isDiagonal(Scalar(0));
 }
 
 template <typename Scalar>
@@ -21,7 +22,10 @@ void QuadraticResidualCostTpl<Scalar>::evaluate(const ConstVectorRef &x,
   Data &data = static_cast<Data &>(data_);
   StageFunctionDataTpl<Scalar> &under_data = *data.residual_data;
   residual_->evaluate(x, u, x, under_data);
-  data.value_ = .5 * under_data.value_.dot(weights_ * under_data.value_);
+  if (diagonal_weights_)
+    data.value_ = .5 * weights_.diagonal().dot(under_data.value_.cwiseAbs2());
+  else
+    data.value_ = .5 * under_data.value_.dot(weights_ * under_data.value_);
 }
 
 template <typename Scalar>
@@ -31,10 +35,7 @@ void QuadraticResidualCostTpl<Scalar>::computeGradients(const ConstVectorRef &x,
   Data &data = static_cast<Data &>(data_);
   StageFunctionDataTpl<Scalar> &under_data = *data.residual_data;
   residual_->computeJacobians(x, u, x, under_data);
-  const Eigen::Index size = data.grad_.size();
-  MatrixRef J = under_data.jac_buffer_.leftCols(size);
-  data.Wv_buf.noalias() = weights_ * under_data.value_;
-  data.grad_.noalias() = J.transpose() * data.Wv_buf;
+  assembleGradient(data);
 }
 
 template <typename Scalar>
@@ -44,13 +45,106 @@ void QuadraticResidualCostTpl<Scalar>::computeHessians(const ConstVectorRef &x,
   Data &data = static_cast<Data &>(data_);
   StageFunctionDataTpl<Scalar> &under_data = *data.residual_data;
   const Eigen::Index size = data.grad_.size();
+  const int ndx = data.ndx_;
+  const int nu = data.nu_;
   MatrixRef J = under_data.jac_buffer_.leftCols(size);
-  data.JtW_buf.noalias() = J.transpose() * weights_;
-  data.hess_ = data.JtW_buf * J;
+  // the structure changes with the weights and gauss_newton
+  const HessianStructure structure = hessianStructure(under_data);
+  if (structure != data.hess_structure_) {
+    data.hess_.setZero();
+    data.hess_structure_ = structure;
+  }
+  const MatrixRef Jx = under_data.Jx_;
+  const MatrixRef Ju = under_data.Ju_;
+  const auto w = weights_.diagonal();
+  switch (data.hess_structure_) {
+  case HessianStructure::DIAGONAL:
+    // at most one of Jx, Ju is nonzero, and it is diagonal
+    if (!under_data.Jx_structure_.isZero())
+      data.Lxx_.diagonal() = w.cwiseProduct(Jx.diagonal().cwiseAbs2());
+    if (!under_data.Ju_structure_.isZero())
+      data.Luu_.diagonal() = w.cwiseProduct(Ju.diagonal().cwiseAbs2());
+    break;
+  case HessianStructure::BLOCK_DIAGONAL:
+    // one of Jx, Ju is zero
+    if (!under_data.Jx_structure_.isZero()) {
+      auto JxtW = data.JtW_buf.topRows(ndx);
+      if (diagonal_weights_)
+        JxtW.noalias() = Jx.transpose() * w.asDiagonal();
+      else
+        JxtW.noalias() = Jx.transpose() * weights_;
+      data.Lxx_.noalias() = JxtW * Jx;
+    }
+    if (!under_data.Ju_structure_.isZero()) {
+      auto JutW = data.JtW_buf.bottomRows(nu);
+      if (diagonal_weights_)
+        JutW.noalias() = Ju.transpose() * w.asDiagonal();
+      else
+        JutW.noalias() = Ju.transpose() * weights_;
+      data.Luu_.noalias() = JutW * Ju;
+    }
+    break;
+  default:
+    if (diagonal_weights_)
+      data.JtW_buf.noalias() = J.transpose() * w.asDiagonal();
+    else
+      data.JtW_buf.noalias() = J.transpose() * weights_;
+    data.hess_.noalias() = data.JtW_buf * J;
+    break;
+  }
   if (!gauss_newton) {
     residual_->computeVectorHessianProducts(x, u, x, data.Wv_buf, under_data);
     data.hess_ = under_data.vhp_buffer_;
   }
 }
 
+template <typename Scalar>
+void QuadraticResidualCostTpl<Scalar>::evaluateWithDerivatives(
+    const ConstVectorRef &x, const ConstVectorRef &u, CostData &data_) const {
+  Data &data = static_cast<Data &>(data_);
+  StageFunctionDataTpl<Scalar> &under_data = *data.residual_data;
+  residual_->evaluateWithJacobians(x, u, x, under_data);
+  assembleGradient(data);
+  data.value_ = .5 * under_data.value_.dot(data.Wv_buf);
+  computeHessians(x, u, data);
+}
+
+template <typename Scalar>
+void QuadraticResidualCostTpl<Scalar>::assembleGradient(Data &data) const {
+  StageFunctionDataTpl<Scalar> &under_data = *data.residual_data;
+  if (diagonal_weights_)
+    data.Wv_buf = weights_.diagonal().cwiseProduct(under_data.value_);
+  else
+    data.Wv_buf.noalias() = weights_ * under_data.value_;
+  data.grad_.setZero();
+  addJacobianTransposeProduct<Scalar>(under_data.Jx_structure_, under_data.Jx_,
+                                      data.Wv_buf, data.Lx_);
+  addJacobianTransposeProduct<Scalar>(under_data.Ju_structure_, under_data.Ju_,
+                                      data.Wv_buf, data.Lu_);
+}
+
+template <typename Scalar>
+shared_ptr<CostDataAbstractTpl<Scalar>>
+QuadraticResidualCostTpl<Scalar>::createData() const {
+  auto data = std::make_shared<Data>(this->ndx(), this->nu,
+                                     residual_->createData());
+  data->hess_structure_ = hessianStructure(*data->residual_data);
+  return data;
+}
+
+template <typename Scalar>
+HessianStructure QuadraticResidualCostTpl<Scalar>::hessianStructure(
+    const StageFunctionDataTpl<Scalar> &rdata) const {
+  const JacobianStructure &sx = rdata.Jx_structure_;
+  const JacobianStructure &su = rdata.Ju_structure_;
+  auto diagonal = [](const JacobianStructure &s) {
+    return s.isZero() || s.type == JacobianStructure::DIAGONAL;
+  };
+  if (!gauss_newton || !(sx.isZero() || su.isZero()))
+    return HessianStructure::DENSE;
+  if (diagonal_weights_ && diagonal(sx) && diagonal(su))
+    return HessianStructure::DIAGONAL;
+  return HessianStructure::BLOCK_DIAGONAL;
+}
+
 } // namespace aligator
@@ -45,6 +45,14 @@ struct StateOrControlErrorResidual<_Scalar, 0> : UnaryFunctionTpl<_Scalar> {
   void computeJacobians(const ConstVectorRef &x, Data &data) const override {
     space_->Jdifference(target_, x, data.Jx_, 1);
   }
+
+  /// The Jacobian is the identity on a vector space.
+  shared_ptr<Data> createData() const override {
+    auto data = Base::createData();
+    if (dynamic_cast<const VectorSpace *>(space_.get()))
+      data->Jx_structure_ = JacobianStructure::DIAGONAL;
+    return data;
+  }
 };
 
 template <typename _Scalar, unsigned int arg>
@@ -91,7 +99,7 @@ struct StateOrControlErrorResidual : StageFunctionTpl<_Scalar> {
   }
 
   void evaluate(const ConstVectorRef &, const ConstVectorRef &u,
-                const ConstVectorRef &y, Data &data) const {
+                const ConstVectorRef &y, Data &data) const override {
     switch (arg) {
     case 1:
       space_->difference(target_, u, data.value_);
@@ -105,7 +113,7 @@ struct StateOrControlErrorResidual : StageFunctionTpl<_Scalar> {
   }
 
   void computeJacobians(const ConstVectorRef &, const ConstVectorRef &u,
-                        const ConstVectorRef &y, Data &data) const {
+                        const ConstVectorRef &y, Data &data) const override {
     switch (arg) {
     case 1:
       space_->Jdifference(target_, u, data.Ju_, 1);
@@ -118,6 +126,19 @@ struct StateOrControlErrorResidual : StageFunctionTpl<_Scalar> {
     }
   }
 
+  /// The Jacobian is zero except with respect to the argument, where it is
+  /// the identity on a vector space.
+  shared_ptr<Data> createData() const override {
+    auto data = Base::createData();
+    const bool euclidean = dynamic_cast<const VectorSpace *>(space_.get());
+    const JacobianStructure arg_structure =
+        euclidean ? JacobianStructure::DIAGONAL : JacobianStructure::DENSE;
+    data->Jx_structure_ = JacobianStructure::ZERO;
+    data->Ju_structure_ = (arg == 1) ? arg_structure : JacobianStructure::ZERO;
+    data->Jy_structure_ = (arg == 2) ? arg_structure : JacobianStructure::ZERO;
+    return data;
+  }
+
 private:
   inline void check_target_viable() const {
     if (!space_->isNormalized(target_)) {
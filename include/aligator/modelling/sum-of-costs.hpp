@@ -44,15 +44,22 @@ template <typename _Scalar> struct CostStackTpl : CostAbstractTpl<_Scalar> {
   std::size_t size() const;
 
   void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
-                CostData &data) const;
+                CostData &data) const override;
 
   void computeGradients(const ConstVectorRef &x, const ConstVectorRef &u,
-                        CostData &data) const;
+                        CostData &data) const override;
 
   void computeHessians(const ConstVectorRef &x, const ConstVectorRef &u,
-                       CostData &data) const;
+                       CostData &data) const override;
 
-  shared_ptr<CostData> createData() const;
+  /// Calls the combined evaluation of each component.
+  void evaluateWithDerivatives(const ConstVectorRef &x, const ConstVectorRef &u,
+                               CostData &data) const override;
+
+  /// Whether the Hessians of all components are constant.
+  bool hasConstantHessians() const override;
+
+  shared_ptr<CostData> createData() const override;
 };
 
 namespace {
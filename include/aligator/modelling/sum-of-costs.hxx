@@ -2,7 +2,74 @@
 
 #include "aligator/modelling/sum-of-costs.hpp"
 
+#include <algorithm>
+
 namespace aligator {
+namespace detail {
+/// Set the Hessian entries within the structure of @p data to zero.
+template <typename Scalar>
+void setZeroHessian(CostDataAbstractTpl<Scalar> &data) {
+  switch (data.hess_structure_) {
+  case HessianStructure::DIAGONAL:
+    data.hess_.diagonal().setZero();
+    break;
+  case HessianStructure::BLOCK_DIAGONAL:
+    data.Lxx_.setZero();
+    data.Luu_.setZero();
+    break;
+  default:
+    data.hess_.setZero();
+    break;
+  }
+}
+
+/// Add @p weight times the Hessian of @p src to that of @p dst, whose
+/// structure must contain that of @p src.
+template <typename Scalar>
+void addHessian(const Scalar weight, const CostDataAbstractTpl<Scalar> &src,
+                CostDataAbstractTpl<Scalar> &dst) {
+  switch (src.hess_structure_) {
+  case HessianStructure::DIAGONAL:
+    dst.hess_.diagonal() += weight * src.hess_.diagonal();
+    break;
+  case HessianStructure::BLOCK_DIAGONAL:
+    dst.Lxx_ += weight * src.Lxx_;
+    dst.Luu_ += weight * src.Luu_;
+    break;
+  default:
+    dst.hess_ += weight * src.hess_;
+    break;
+  }
+}
+
+/// Structure of the Hessian of a stack: that of its least structured
+/// component.
+template <typename Scalar>
+HessianStructure stackHessianStructure(
+    const std::vector<shared_ptr<CostDataAbstractTpl<Scalar>>> &sub_data) {
+  HessianStructure s = HessianStructure::DIAGONAL;
+  for (const auto &sd : sub_data)
+    s = std::max(s, sd->hess_structure_);
+  return s;
+}
+
+/// Sum the Hessians of the components of a stack, weighted by @p weights.
+/// The structures of the components may change with their parameters.
+template <typename Scalar>
+void sumHessians(const std::vector<Scalar> &weights,
+                 CostStackDataTpl<Scalar> &data) {
+  const HessianStructure s = stackHessianStructure(data.sub_cost_data);
+  if (s != data.hess_structure_) {
+    data.hess_.setZero();
+    data.hess_structure_ = s;
+  } else {
+    setZeroHessian(data);
+  }
+  for (std::size_t i = 0; i < weights.size(); i++)
+    addHessian(weights[i], *data.sub_cost_data[i], data);
+}
+} // namespace detail
+
 template <typename Scalar>
 CostStackTpl<Scalar>::CostStackTpl(shared_ptr<Manifold> space, const int nu,
                                    const std::vector<CostPtr> &comps,
@@ -81,11 +148,34 @@ void CostStackTpl<Scalar>::computeHessians(const ConstVectorRef &x,
                                            const ConstVectorRef &u,
                                            CostData &data) const {
   SumCostData &d = static_cast<SumCostData &>(data);
-  d.hess_.setZero();
-  for (std::size_t i = 0; i < components_.size(); i++) {
+  for (std::size_t i = 0; i < components_.size(); i++)
     components_[i]->computeHessians(x, u, *d.sub_cost_data[i]);
-    d.hess_.noalias() += this->weights_[i] * d.sub_cost_data[i]->hess_;
+  detail::sumHessians(this->weights_, d);
+}
+
+template <typename Scalar>
+void CostStackTpl<Scalar>::evaluateWithDerivatives(const ConstVectorRef &x,
+                                                   const ConstVectorRef &u,
+                                                   CostData &data) const {
+  SumCostData &d = static_cast<SumCostData &>(data);
+  d.value_ = 0.;
+  d.grad_.setZero();
+  for (std::size_t i = 0; i < components_.size(); i++) {
+    CostData &sd = *d.sub_cost_data[i];
+    components_[i]->evaluateWithDerivatives(x, u, sd);
+    d.value_ += this->weights_[i] * sd.value_;
+    d.grad_.noalias() += this->weights_[i] * sd.grad_;
+  }
+  detail::sumHessians(this->weights_, d);
+}
+
+template <typename Scalar>
+bool CostStackTpl<Scalar>::hasConstantHessians() const {
+  for (const CostPtr &comp : components_) {
+    if (!comp->hasConstantHessians())
+      return false;
   }
+  return true;
 }
 
 template <typename Scalar>
@@ -102,6 +192,7 @@ CostStackDataTpl<Scalar>::CostStackDataTpl(const CostStackTpl<Scalar> &obj)
   for (std::size_t i = 0; i < obj.size(); i++) {
     sub_cost_data.push_back(obj.components_[i]->createData());
   }
+  this->hess_structure_ = detail::stackHessianStructure(sub_cost_data);
 }
 
 } // namespace aligator
@@ -0,0 +1,130 @@
+/// @file parlqr.hpp
+/// @brief Data structures for the parallel-in-time LQR/Riccati recursion.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/math.hpp"
+
+#include <array>
+#include <cmath>
+#include <fmt/ranges.h>
+
+namespace aligator {
+
+/// @brief A knot (stage) of a linear-quadratic problem
+/// \f[
+///   \min_{x,u} \tfrac12 x^\top Qx + x^\top Su + \tfrac12 u^\top Ru + q^\top x
+///   + r^\top u \quad\mathrm{s.t.}\quad Ax + Bu + Ex' + f = 0,
+///   \quad Cx + Du + d = 0.
+/// \f]
+template <typename Scalar> struct LQRKnot {
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+
+  std::size_t nx, nu, nc;
+
+  MatrixXs Q, S, R;
+  VectorXs q, r;
+  MatrixXs A, B, E;
+  VectorXs f;
+  MatrixXs C, D;
+  VectorXs d;
+
+  LQRKnot(std::size_t nx, std::size_t nu, std::size_t nc)
+      : nx(nx), nu(nu), nc(nc), Q(nx, nx), S(nx, nu), R(nu, nu), q(nx), r(nu),
+        A(nx, nx), B(nx, nu), E(nx, nx), f(nx), C(nc, nx), D(nc, nu), d(nc) {
+    Q.setZero();
+    S.setZero();
+    R.setZero();
+    q.setZero();
+    r.setZero();
+
+    A.setZero();
+    B.setZero();
+    E.setIdentity();
+    E *= -1;
+    f.setZero();
+
+    C.setZero();
+    D.setZero();
+    d.setZero();
+  }
+};
+
+/// @brief Complete binary tree over the knots of a linear-quadratic problem.
+/// @details Nodes are numbered in breadth-first order: the root has index 0
+/// and the children of node @p i are @f$ 2i+1 @f$ and @f$ 2i+2 @f$. The node
+/// @p i at depth @p d covers a contiguous range of knots (a *leg* of the
+/// horizon), see getNodeRange(). The legs at a given depth can be factorized
+/// independently, then merged back up the tree.
+template <typename Scalar> struct LQRTree {
+  using KnotType = LQRKnot<Scalar>;
+
+  explicit LQRTree(std::size_t num_knots)
+      : num_knots_(num_knots), depth_(computeMaxDepth(num_knots)) {}
+
+  LQRTree(const std::vector<KnotType> &knots) : LQRTree(knots.size()) {}
+
+  /// Number of knots (leaves).
+  std::size_t numKnots() const { return num_knots_; }
+
+  /// Maximum depth of the tree, such that each node at this depth covers at
+  /// least one knot.
+  std::size_t maxDepth() const { return depth_; }
+
+  /// Number of nodes at depth @p depth.
+  static std::size_t numNodesAtDepth(std::size_t depth) {
+    return std::size_t(1) << depth;
+  }
+
+  /// Breadth-first index of the @p i-th node at depth @p depth.
+  static std::size_t getIndex(std::size_t depth, std::size_t i) {
+    return numNodesAtDepth(depth) - 1 + i;
+  }
+
+  /// Indices of the two children of node @p index.
+  static std::array<std::size_t, 2> getChildren(std::size_t index) {
+    return {2 * index + 1, 2 * index + 2};
+  }
+
+  /// Index of the @p i-th leaf, i.e. the @p i-th node at maximum depth.
+  std::size_t getLeafIndex(std::size_t i) const { return getIndex(depth_, i); }
+
+  /// Depth of node @p index.
+  static std::size_t getIndexDepth(std::size_t index) {
+    std::size_t depth = 0;
+    while (index > 0) {
+      index = (index - 1) / 2;
+      depth++;
+    }
+    return depth;
+  }
+
+  /// Parent of node @p index. The root is its own parent.
+  static std::size_t getIndexParent(std::size_t index) {
+    if (index == 0)
+      return 0;
+    return (index - 1) / 2;
+  }
+
+  /// @brief Range @f$ [b, e) @f$ of knots covered by the @p i-th node at depth
+  /// @p depth.
+  std::array<std::size_t, 2> getNodeRange(std::size_t depth,
+                                          std::size_t i) const {
+    assert(depth <= depth_);
+    const std::size_t n = numNodesAtDepth(depth);
+    return {i * num_knots_ / n, (i + 1) * num_knots_ / n};
+  }
+
+private:
+  static std::size_t computeMaxDepth(std::size_t num_knots) {
+    std::size_t depth = 0;
+    while ((std::size_t(2) << depth) <= num_knots)
+      depth++;
+    return depth;
+  }
+
+  std::size_t num_knots_;
+  std::size_t depth_;
+};
+
+} // namespace aligator
@@ -30,16 +30,16 @@ ResultsFDDPTpl<Scalar>::ResultsFDDPTpl(
   xs_default_init(problem, xs);
   us_default_init(problem, us);
 
-  gains_.resize(nsteps);
-
+  std::vector<std::array<long, 2>> gain_dims(nsteps);
   for (std::size_t i = 0; i < nsteps; i++) {
     const StageModel &sm = *problem.stages_[i];
 
     const int ndx = sm.ndx1();
     const int nu = sm.nu();
 
-    gains_[i] = MatrixXs::Zero(nu, ndx + 1);
+    gain_dims[i] = {nu, ndx + 1};
   }
+  gains_ = MatrixArenaTpl<Scalar>(gain_dims);
   this->m_isInitialized = true;
 }
 
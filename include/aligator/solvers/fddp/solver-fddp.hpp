@@ -13,6 +13,7 @@
 #include "./linesearch.hpp"
 
 #include "aligator/utils/logger.hpp"
+#include "aligator/utils/timings.hpp"
 
 #include <fmt/ostream.h>
 #include <unordered_map>
@@ -26,9 +27,20 @@ namespace aligator {
  * @brief   The feasible DDP (FDDP) algorithm, from Mastalli et al. (2020).
  * @details The implementation very similar to Crocoddyl's SolverFDDP.
  *
+ * @tparam NX State tangent space dimension, fixed at compile time.
+ * @tparam NU Control dimension, fixed at compile time.
+ * If both @p NX and @p NU are set, the Riccati recursion uses fixed-size
+ * Eigen types (which unroll for small systems), and every stage of the
+ * problem must have these dimensions. The default is the dynamic-size
+ * solver. This is the only solver with a fixed-size kernel: SolverProxDDP
+ * uses dynamic sizes, since its KKT systems also depend on the constraints.
  */
-template <typename Scalar> struct SolverFDDP {
+template <typename Scalar, int NX, int NU> struct SolverFDDP {
   ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  /// Whether the Riccati recursion uses the compile-time dimensions.
+  static constexpr bool IsFixedSize =
+      (NX != Eigen::Dynamic) && (NU != Eigen::Dynamic);
+  static constexpr int NXU = IsFixedSize ? NX + NU : Eigen::Dynamic;
   using Problem = TrajOptProblemTpl<Scalar>;
   using StageModel = StageModelTpl<Scalar>;
   using StageData = StageDataTpl<Scalar>;
@@ -72,12 +84,20 @@ template <typename Scalar> struct SolverFDDP {
   /// satisfy the initial condition. This flag switches that behaviour on or
   /// off.
   bool force_initial_condition_;
+  /// Pin the threads of the pool created by setup() to distinct cores.
+  bool pin_threads = false;
 
   BaseLogger logger{};
 
 private:
   /// Callbacks
   CallbackMap callbacks_;
+  /// Thread pool the parallel loops run on
+  shared_ptr<ThreadPool> thread_pool_;
+  /// Whether thread_pool_ is managed by setup()
+  bool owns_thread_pool_ = true;
+  /// Records the time spent in each phase
+  PhaseTimer timer_;
 
 public:
   Results results_;
@@ -95,8 +115,18 @@ public:
   }
 
   /// @brief Allocate workspace and results structs.
+  /// @details With multithreading support, this also creates a thread pool of
+  /// TrajOptProblemTpl::getNumThreads() threads (unless a pool was given
+  /// through setThreadPool()).
   void setup(const Problem &problem);
 
+  /// @brief Run the parallel loops on @p pool, e.g. to share one pool between
+  /// several solvers. Passing nullptr lets setup() create a pool again.
+  void setThreadPool(shared_ptr<ThreadPool> pool);
+  /// @brief The thread pool the parallel loops run on, or nullptr if they run
+  /// sequentially.
+  ThreadPool *getThreadPool() const { return thread_pool_.get(); }
+
   /**
    * @brief   Perform a nonlinear rollout, keeping an infeasibility gap.
    * @details Perform a nonlinear rollout using the computed sensitivity gains
@@ -137,6 +167,11 @@ public:
   /// @brief   Perform the backward pass and compute Riccati gains.
   void backwardPass(const Problem &problem, Workspace &workspace) const;
 
+  /// @brief   Riccati step for stage @p i, with the compile-time dimensions.
+  void backwardStepFixedSize(Workspace &workspace, const CostData &cd,
+                             const DynamicsDataTpl<Scalar> &dd,
+                             const std::size_t i) const;
+
   /// @brief   Accept the gains computed in the last backwardPass().
   /// @details This is called if the convergence check after computeCriterion()
   /// did not exit.
@@ -182,6 +217,7 @@ public:
   void clearCallbacks() { callbacks_.clear(); }
 
   void invokeCallbacks(Workspace &workspace, Results &results) {
+    ScopedPhase phase(timer_, SolverPhase::CALLBACKS);
     for (const auto &cb : callbacks_) {
       cb.second->call(workspace, results);
     }
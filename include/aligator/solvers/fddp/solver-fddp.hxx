@@ -6,19 +6,29 @@
 
 namespace aligator {
 
-/* SolverFDDP<Scalar> */
+/* SolverFDDP<Scalar, NX, NU> */
 
-template <typename Scalar>
-SolverFDDP<Scalar>::SolverFDDP(const Scalar tol, VerboseLevel verbose,
-                               const Scalar reg_init,
-                               const std::size_t max_iters)
+template <typename Scalar, int NX, int NU>
+SolverFDDP<Scalar, NX, NU>::SolverFDDP(const Scalar tol, VerboseLevel verbose,
+                                       const Scalar reg_init,
+                                       const std::size_t max_iters)
     : target_tol_(tol), reg_init(reg_init), verbose_(verbose),
       max_iters(max_iters), force_initial_condition_(false) {
   ls_params.alpha_min = pow(2., -9.);
 }
 
-template <typename Scalar>
-void SolverFDDP<Scalar>::setup(const Problem &problem) {
+template <typename Scalar, int NX, int NU>
+void SolverFDDP<Scalar, NX, NU>::setup(const Problem &problem) {
+  if (IsFixedSize) {
+    for (std::size_t i = 0; i < problem.numSteps(); i++) {
+      const StageModel &sm = *problem.stages_[i];
+      if ((sm.ndx1() != NX) || (sm.ndx2() != NX) || (sm.nu() != NU))
+        ALIGATOR_RUNTIME_ERROR(fmt::format(
+            "Stage {:d} has dimensions (ndx1={:d}, ndx2={:d}, nu={:d}), "
+            "but the solver was compiled for (ndx={:d}, nu={:d}).",
+            i, sm.ndx1(), sm.ndx2(), sm.nu(), NX, NU));
+    }
+  }
   results_ = Results(problem);
   workspace_ = Workspace(problem);
   // check if there are any constraints other than dynamics and throw a warning
@@ -41,18 +51,38 @@ void SolverFDDP<Scalar>::setup(const Problem &problem) {
                           "this solver cannot "
                           "handle.\n");
   }
+
+#ifdef ALIGATOR_MULTITHREADING
+  const std::size_t num_threads = problem.getNumThreads();
+  if (owns_thread_pool_ &&
+      (thread_pool_ ? thread_pool_->size() : 1) != num_threads) {
+    thread_pool_ = num_threads > 1
+                       ? std::make_shared<ThreadPool>(num_threads, pin_threads)
+                       : nullptr;
+  }
+#endif
+  workspace_.problem_data.thread_pool = thread_pool_.get();
 }
 
-template <typename Scalar>
-Scalar
-SolverFDDP<Scalar>::forwardPass(const Problem &problem, const Results &results,
-                                Workspace &workspace, const Scalar alpha) {
+template <typename Scalar, int NX, int NU>
+void SolverFDDP<Scalar, NX, NU>::setThreadPool(shared_ptr<ThreadPool> pool) {
+  owns_thread_pool_ = pool == nullptr;
+  thread_pool_ = std::move(pool);
+  workspace_.problem_data.thread_pool = thread_pool_.get();
+}
+
+template <typename Scalar, int NX, int NU>
+Scalar SolverFDDP<Scalar, NX, NU>::forwardPass(const Problem &problem,
+                                               const Results &results,
+                                               Workspace &workspace,
+                                               const Scalar alpha) {
   ALIGATOR_NOMALLOC_BEGIN;
   const std::size_t nsteps = workspace.nsteps;
   std::vector<VectorXs> &xs_try = workspace.trial_xs;
   std::vector<VectorXs> &us_try = workspace.trial_us;
   const std::vector<VectorXs> &fs = workspace.dyn_slacks;
   ProblemData &prob_data = workspace.problem_data;
+  const AllocationSite alloc_site = AllocationAudit::currentSite();
 
   {
     const auto &space = problem.stages_[0]->xspace_;
@@ -73,13 +103,22 @@ SolverFDDP<Scalar>::forwardPass(const Problem &problem, const Results &results,
     sm.uspace().integrate(results.us[i], workspace.dus[i], us_try[i]);
 
     ALIGATOR_NOMALLOC_END;
-    sm.evaluate(xs_try[i], us_try[i], xs_try[i + 1], sd);
+    {
+      ScopedTrace span(prob_data.trace, "evaluate", i);
+      ScopedAllocationStage stage_site(alloc_site, i);
+      sm.evaluate(xs_try[i], us_try[i], xs_try[i + 1], sd);
+
+      // move the next state: the explicit dynamics only depend on it through
+      // the gap, the other constraints are evaluated again
+      const ExpData &dd = stage_get_dynamics_data(sd);
+      workspace.dxs[i + 1] = (alpha - 1.) * fs[i + 1]; // use as tmp variable
+      sm.xspace_next_->integrate(dd.xnext_, workspace.dxs[i + 1],
+                                 xs_try[i + 1]);
+      sm.xspace_next_->difference(xs_try[i + 1], dd.xnext_,
+                                  sd.dyn_data().value_);
+      sm.evaluateAtNextState(xs_try[i], us_try[i], xs_try[i + 1], sd);
+    }
     ALIGATOR_NOMALLOC_BEGIN;
-
-    const ExpData &dd = stage_get_dynamics_data(sd);
-
-    workspace.dxs[i + 1] = (alpha - 1.) * fs[i + 1]; // use as tmp variable
-    sm.xspace_next_->integrate(dd.xnext_, workspace.dxs[i + 1], xs_try[i + 1]);
     const CostData &cd = *sd.cost_data;
 
     ALIGATOR_RAISE_IF_NAN_NAME(xs_try[i + 1], fmt::format("xs[{}]", i + 1));
@@ -105,9 +144,10 @@ SolverFDDP<Scalar>::forwardPass(const Problem &problem, const Results &results,
   return traj_cost_;
 }
 
-template <typename Scalar>
-void SolverFDDP<Scalar>::expectedImprovement(Workspace &workspace, Scalar &d1,
-                                             Scalar &d2) const {
+template <typename Scalar, int NX, int NU>
+void SolverFDDP<Scalar, NX, NU>::expectedImprovement(Workspace &workspace,
+                                                     Scalar &d1,
+                                                     Scalar &d2) const {
   ALIGATOR_NOMALLOC_BEGIN;
   Scalar &dv = workspace.dv_;
   dv = 0.;
@@ -123,9 +163,9 @@ void SolverFDDP<Scalar>::expectedImprovement(Workspace &workspace, Scalar &d1,
   ALIGATOR_NOMALLOC_END;
 }
 
-template <typename Scalar>
-void SolverFDDP<Scalar>::updateExpectedImprovement(Workspace &workspace,
-                                                   Results &results) const {
+template <typename Scalar, int NX, int NU>
+void SolverFDDP<Scalar, NX, NU>::updateExpectedImprovement(
+    Workspace &workspace, Results &results) const {
   ALIGATOR_NOMALLOC_BEGIN;
   Scalar &dg = workspace.dg_;
   Scalar &dq = workspace.dq_;
@@ -151,8 +191,9 @@ void SolverFDDP<Scalar>::updateExpectedImprovement(Workspace &workspace,
   ALIGATOR_NOMALLOC_END;
 }
 
-template <typename Scalar>
-Scalar SolverFDDP<Scalar>::computeInfeasibility(const Problem &problem) {
+template <typename Scalar, int NX, int NU>
+Scalar
+SolverFDDP<Scalar, NX, NU>::computeInfeasibility(const Problem &problem) {
   ALIGATOR_NOMALLOC_BEGIN;
   const std::size_t nsteps = problem.numSteps();
   const ProblemData &pd = workspace_.problem_data;
@@ -162,20 +203,19 @@ Scalar SolverFDDP<Scalar>::computeInfeasibility(const Problem &problem) {
   const auto &space = problem.stages_[0]->xspace_;
   space->difference(xs[0], problem.getInitState(), fs[0]);
 
-#pragma omp parallel for num_threads(problem.getNumThreads())
-  for (std::size_t i = 0; i < nsteps; i++) {
+  parallel_for(thread_pool_.get(), 0, nsteps, [&](std::size_t i) {
     const StageModel &sm = *problem.stages_[i];
     const auto &sd = pd.getStageData(i);
     const ExpData &dd = stage_get_dynamics_data(sd);
     sm.xspace_->difference(xs[i + 1], dd.xnext_, fs[i + 1]);
-  }
+  });
   Scalar res = math::infty_norm(fs);
   ALIGATOR_NOMALLOC_END;
   return res;
 }
 
-template <typename Scalar>
-Scalar SolverFDDP<Scalar>::computeCriterion(Workspace &workspace) {
+template <typename Scalar, int NX, int NU>
+Scalar SolverFDDP<Scalar, NX, NU>::computeCriterion(Workspace &workspace) {
   ALIGATOR_NOMALLOC_BEGIN;
   const std::size_t nsteps = workspace.nsteps;
   Scalar v = 0.;
@@ -187,9 +227,9 @@ Scalar SolverFDDP<Scalar>::computeCriterion(Workspace &workspace) {
   return v;
 }
 
-template <typename Scalar>
-void SolverFDDP<Scalar>::backwardPass(const Problem &problem,
-                                      Workspace &workspace) const {
+template <typename Scalar, int NX, int NU>
+void SolverFDDP<Scalar, NX, NU>::backwardPass(const Problem &problem,
+                                              Workspace &workspace) const {
   ALIGATOR_NOMALLOC_BEGIN;
 
   const std::size_t nsteps = workspace.nsteps;
@@ -208,7 +248,10 @@ void SolverFDDP<Scalar>::backwardPass(const Problem &problem,
     vp.Vx_ += ftVxx;
   }
 
+  const AllocationSite alloc_site = AllocationAudit::currentSite();
   for (std::size_t i = nsteps; i-- > 0;) {
+    ScopedTrace span(prob_data.trace, "backward_pass", i);
+    ScopedAllocationStage stage_site(alloc_site, i);
     const VParams &vnext = workspace.value_params[i + 1];
     QParams &qparam = workspace.q_params[i];
 
@@ -222,6 +265,11 @@ void SolverFDDP<Scalar>::backwardPass(const Problem &problem,
     const CostData &cd = *sd.cost_data;
     const DynamicsDataTpl<Scalar> &dd = sd.dyn_data();
 
+    if (IsFixedSize) {
+      backwardStepFixedSize(workspace, cd, dd, i);
+      continue;
+    }
+
     /* Assemble Q-function */
     auto J_x_u = dd.jac_buffer_.leftCols(ndx1 + nu);
 
@@ -237,7 +285,7 @@ void SolverFDDP<Scalar>::backwardPass(const Problem &problem,
 
     /* Compute gains */
 
-    MatrixXs &kkt_rhs = workspace.kkt_rhs_bufs[i];
+    auto kkt_rhs = workspace.kkt_rhs_bufs[i];
     auto kkt_ff = kkt_rhs.col(0);
     auto kkt_fb = kkt_rhs.rightCols(ndx1);
 
@@ -248,16 +296,6 @@ void SolverFDDP<Scalar>::backwardPass(const Problem &problem,
     llt.compute(qparam.Quu);
     llt.solveInPlace(kkt_rhs);
 
-#ifndef NDEBUG
-    {
-      ALIGATOR_NOMALLOC_END;
-      std::FILE *fi = std::fopen("fddp.log", "a");
-      fmt::print(fi, "uff[{:d}]={}\n", i, kkt_ff.head(nu).transpose());
-      fmt::print(fi, "V'x[{:d}]={}\n", i, vnext.Vx_.transpose());
-      std::fclose(fi);
-      ALIGATOR_NOMALLOC_BEGIN;
-    }
-#endif
     workspace.Quuks_[i].noalias() = qparam.Quu * kkt_ff;
 
     /* Compute value function */
@@ -276,22 +314,94 @@ void SolverFDDP<Scalar>::backwardPass(const Problem &problem,
   ALIGATOR_NOMALLOC_END;
 }
 
-template <typename Scalar>
-bool SolverFDDP<Scalar>::run(const Problem &problem,
-                             const std::vector<VectorXs> &xs_init,
-                             const std::vector<VectorXs> &us_init) {
+template <typename Scalar, int NX, int NU>
+void SolverFDDP<Scalar, NX, NU>::backwardStepFixedSize(
+    Workspace &workspace, const CostData &cd, const DynamicsDataTpl<Scalar> &dd,
+    const std::size_t i) const {
+  using VectorNx = Eigen::Matrix<Scalar, NX, 1>;
+  using VectorNu = Eigen::Matrix<Scalar, NU, 1>;
+  using VectorNxu = Eigen::Matrix<Scalar, NXU, 1>;
+  using MatrixNx = Eigen::Matrix<Scalar, NX, NX>;
+  using MatrixNuNu = Eigen::Matrix<Scalar, NU, NU>;
+  using MatrixNxu = Eigen::Matrix<Scalar, NXU, NXU>;
+  using MatrixJac = Eigen::Matrix<Scalar, NX, NXU>;
+  using MatrixGains =
+      Eigen::Matrix<Scalar, NU, IsFixedSize ? NX + 1 : Eigen::Dynamic>;
+  ALIGATOR_NOMALLOC_BEGIN;
+
+  const VParams &vnext = workspace.value_params[i + 1];
+  QParams &qparam = workspace.q_params[i];
+  VParams &vp = workspace.value_params[i];
+  const long ndx = vp.Vx_.size();
+  const long nu = qparam.Qu.size();
+  const long nxu = ndx + nu;
+
+  // all buffers are contiguous: view them with the static dimensions
+  Eigen::Map<const MatrixJac> J_x_u(dd.jac_buffer_.data(), ndx, nxu);
+  Eigen::Map<const VectorNx> Vx_next(vnext.Vx_.data(), ndx);
+  Eigen::Map<const MatrixNx> Vxx_next(vnext.Vxx_.data(), ndx, ndx);
+  Eigen::Map<VectorNxu> grad(qparam.grad_.data(), nxu);
+  Eigen::Map<MatrixNxu> hess(qparam.hess_.data(), nxu, nxu);
+
+  /* Assemble Q-function */
+  qparam.q_ = cd.value_;
+  grad = Eigen::Map<const VectorNxu>(cd.grad_.data(), nxu);
+  grad.noalias() += J_x_u.transpose() * Vx_next;
+
+  const Eigen::Matrix<Scalar, NXU, NX> JtH = J_x_u.transpose() * Vxx_next;
+  hess = Eigen::Map<const MatrixNxu>(cd.hess_.data(), nxu, nxu);
+  hess.noalias() += JtH * J_x_u;
+
+  auto Qx = grad.template segment<NX>(0, ndx);
+  auto Qu = grad.template segment<NU>(ndx, nu);
+  auto Qxx = hess.template block<NX, NX>(0, 0, ndx, ndx);
+  auto Qxu = hess.template block<NX, NU>(0, ndx, ndx, nu);
+  auto Quu = hess.template block<NU, NU>(ndx, ndx, nu, nu);
+  Quu.diagonal().array() += ureg_;
+
+  /* Compute gains */
+  Eigen::Map<MatrixGains> kkt_rhs(workspace.kkt_rhs_bufs[i].data(), nu,
+                                  ndx + 1);
+  auto kkt_ff = kkt_rhs.col(0);
+  auto kkt_fb = kkt_rhs.template block<NU, NX>(0, 1, nu, ndx);
+  kkt_ff = -Qu;
+  kkt_fb = -Qxu.transpose();
+
+  const Eigen::LLT<MatrixNuNu> llt(Quu);
+  llt.solveInPlace(kkt_rhs);
+  Eigen::Map<VectorNu>(workspace.Quuks_[i].data(), nu).noalias() =
+      Quu * kkt_ff;
+
+  /* Compute value function */
+  Eigen::Map<VectorNx> Vx(vp.Vx_.data(), ndx);
+  Eigen::Map<MatrixNx> Vxx(vp.Vxx_.data(), ndx, ndx);
+  Vx = Qx;
+  Vx.noalias() += kkt_fb.transpose() * Qu;
+  Vxx = Qxx;
+  Vxx.noalias() += Qxu * kkt_fb;
+  Vxx = Vxx.template selfadjointView<Eigen::Lower>();
+  Vxx.diagonal().array() += xreg_;
+  Eigen::Map<VectorNx> ftVxx(workspace.ftVxx_[i].data(), ndx);
+  ftVxx.noalias() = Vxx * Eigen::Map<const VectorNx>(
+                              workspace.dyn_slacks[i].data(), ndx);
+  Vx += ftVxx;
+  ALIGATOR_NOMALLOC_END;
+}
+
+template <typename Scalar, int NX, int NU>
+bool SolverFDDP<Scalar, NX, NU>::run(const Problem &problem,
+                                     const std::vector<VectorXs> &xs_init,
+                                     const std::vector<VectorXs> &us_init) {
   xreg_ = reg_init;
   ureg_ = xreg_;
 
-#ifndef NDEBUG
-  std::FILE *fi = std::fopen("fddp.log", "w");
-  std::fclose(fi);
-#endif
-
   if (!results_.isInitialized() || !workspace_.isInitialized()) {
     ALIGATOR_RUNTIME_ERROR(
         "Either results or workspace not allocated. Call setup() first!");
   }
+  ScopedAllocationAudit alloc_audit(results_.allocations);
+  // the problem parameters may have changed since the last run
+  workspace_.problem_data.invalidateEvaluations();
 
   check_trajectory_and_assign(problem, xs_init, us_init, results_.xs,
                               results_.us);
@@ -307,6 +417,10 @@ bool SolverFDDP<Scalar>::run(const Problem &problem,
   // in Crocoddyl, linesearch xs is primed to use problem x0
 
   const auto linesearch_fun = [&](const Scalar alpha) {
+    ScopedPhase trial_phase(timer_, SolverPhase::LINESEARCH_TRIAL);
+    ScopedPhase eval_phase(timer_, SolverPhase::EVALUATE);
+    ScopedTrace span(workspace_.problem_data.trace, "linesearch_trial",
+                     results_.num_iters);
     return forwardPass(problem, results_, workspace_, alpha);
   };
 
@@ -321,20 +435,39 @@ bool SolverFDDP<Scalar>::run(const Problem &problem,
 
   LogRecord record;
 
+  timer_.reset();
+  results_.timings.setZero();
+  results_.iter_timings.clear();
+
+  // the callbacks may attach a trace buffer to the problem data
+  workspace_.problem_data.trace = nullptr;
+  for (const auto &cb : callbacks_)
+    cb.second->pre_run_call(workspace_);
+
   std::size_t &iter = results_.num_iters;
-  results_.traj_cost_ =
-      problem.evaluate(results_.xs, results_.us, workspace_.problem_data);
+  {
+    // the first iteration reuses these derivatives
+    ScopedPhase phase(timer_, SolverPhase::EVALUATE);
+    results_.traj_cost_ = problem.evaluateWithDerivatives(
+        results_.xs, results_.us, workspace_.problem_data);
+  }
 
   for (iter = 0; iter < max_iters; ++iter) {
     record.iter = iter + 1;
 
-    problem.computeDerivatives(results_.xs, results_.us,
-                               workspace_.problem_data);
+    {
+      ScopedPhase phase(timer_, SolverPhase::DERIVATIVES);
+      problem.computeDerivatives(results_.xs, results_.us,
+                                 workspace_.problem_data);
+    }
     results_.prim_infeas = computeInfeasibility(problem);
     ALIGATOR_RAISE_IF_NAN(results_.prim_infeas);
     record.prim_err = results_.prim_infeas;
 
-    backwardPass(problem, workspace_);
+    {
+      ScopedPhase phase(timer_, SolverPhase::BACKWARD_PASS);
+      backwardPass(problem, workspace_);
+    }
     results_.dual_infeas = computeCriterion(workspace_);
     ALIGATOR_RAISE_IF_NAN(results_.dual_infeas);
     record.dual_err = results_.dual_infeas;
@@ -366,8 +499,10 @@ bool SolverFDDP<Scalar>::run(const Problem &problem,
     record.dphi0 = d1_phi;
     record.xreg = xreg_;
 
-    results_.xs = workspace_.trial_xs;
-    results_.us = workspace_.trial_us;
+    // accept the step: swap the buffers, the trial point is overwritten by
+    // the next forward pass anyway
+    results_.xs.swap(workspace_.trial_xs);
+    results_.us.swap(workspace_.trial_us);
     if (std::abs(d1_phi) < th_grad_) {
       results_.conv = true;
       break;
@@ -385,9 +520,23 @@ bool SolverFDDP<Scalar>::run(const Problem &problem,
     }
 
     invokeCallbacks(workspace_, results_);
+    if (PhaseTimer::enabled) {
+      results_.iter_timings.emplace_back();
+      timer_.collect(results_.iter_timings.back());
+      results_.timings += results_.iter_timings.back();
+    }
     logger.log(record);
   }
 
+  if (PhaseTimer::enabled) {
+    PhaseTimings rest;
+    timer_.collect(rest);
+    results_.timings += rest;
+  }
+  for (const auto &cb : callbacks_)
+    cb.second->post_run_call(workspace_, results_);
+  workspace_.problem_data.trace = nullptr;
+
   if (iter < max_iters)
     logger.log(record);
   logger.finish(results_.conv);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "aligator/core/workspace-base.hpp"
+#include "aligator/utils/matrix-arena.hpp"
 #include <Eigen/Cholesky>
 
 namespace aligator {
@@ -22,8 +23,8 @@ template <typename Scalar> struct WorkspaceFDDPTpl : WorkspaceBaseTpl<Scalar> {
   std::vector<VectorXs> ftVxx_;
   /// Buffer for KKT matrices.
   std::vector<MatrixXs> kkt_mat_bufs;
-  /// Buffer for KKT system right-hand sides.
-  std::vector<MatrixXs> kkt_rhs_bufs;
+  /// Buffer for KKT system right-hand sides, laid out as the gains.
+  MatrixArenaTpl<Scalar> kkt_rhs_bufs;
   /// LLT struct for each KKT system.
   std::vector<Eigen::LLT<MatrixXs>> llts_;
 
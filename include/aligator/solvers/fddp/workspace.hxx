@@ -16,9 +16,9 @@ WorkspaceFDDPTpl<Scalar>::WorkspaceFDDPTpl(
   Quuks_.resize(nsteps);
   ftVxx_.resize(nsteps + 1);
   kkt_mat_bufs.resize(nsteps);
-  kkt_rhs_bufs.resize(nsteps);
   llts_.reserve(nsteps);
   JtH_temp_.reserve(nsteps);
+  std::vector<std::array<long, 2>> rhs_dims(nsteps);
 
   if (nsteps > 0) {
     const int ndx = problem.stages_[0]->ndx1();
@@ -47,11 +47,12 @@ WorkspaceFDDPTpl<Scalar>::WorkspaceFDDPTpl(
     Quuks_[i] = VectorXs::Zero(nu);
     ftVxx_[i + 1] = VectorXs::Zero(sm.ndx2());
     kkt_mat_bufs[i] = MatrixXs::Zero(nu, nu);
-    kkt_rhs_bufs[i] = MatrixXs::Zero(nu, ndx + 1);
+    rhs_dims[i] = {nu, ndx + 1};
     llts_.emplace_back(nu);
     JtH_temp_.emplace_back(ndx + nu, ndx);
     JtH_temp_.back().setZero();
   }
+  kkt_rhs_bufs = MatrixArenaTpl<Scalar>(rhs_dims);
   const StageModelTpl<Scalar> &sm = *problem.stages_.back();
   dxs[nsteps] = VectorXs::Zero(sm.ndx2());
   value_params.emplace_back(sm.ndx2());
@@ -67,7 +68,7 @@ template <typename Scalar> void WorkspaceFDDPTpl<Scalar>::cycleLeft() {
   rotate_vec_left(Quuks_);
   rotate_vec_left(ftVxx_, 1);
   rotate_vec_left(kkt_mat_bufs);
-  rotate_vec_left(kkt_rhs_bufs);
+  kkt_rhs_bufs.rotateLeft();
   rotate_vec_left(llts_);
   rotate_vec_left(JtH_temp_);
 }
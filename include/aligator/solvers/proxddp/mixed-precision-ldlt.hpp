@@ -0,0 +1,83 @@
+/// @file mixed-precision-ldlt.hpp
+/// @brief Low-precision factorization of the stage KKT systems.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/math.hpp"
+
+#include <array>
+#include <Eigen/Cholesky>
+
+namespace aligator {
+
+/// @brief Dense LDLT factorization carried out in the lower precision
+/// @p LowScalar, for systems in the working precision @p Scalar.
+///
+/// @details The matrix is rounded to @p LowScalar and factorized there;
+/// solves round the right-hand side, solve in @p LowScalar and write the
+/// result back. On its own this is only accurate to the low precision: it is
+/// meant to be wrapped in IterativeRefinementVisitor, which computes the
+/// residuals in @p Scalar and so recovers the working precision in a few
+/// steps when the system is not too ill-conditioned.
+///
+/// The interface mimics the LDLT routines used for the full KKT matrix.
+template <typename _Scalar, typename _LowScalar = float>
+struct MixedPrecisionLDLTTpl {
+  using Scalar = _Scalar;
+  using LowScalar = _LowScalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using LowMatrix = Eigen::Matrix<LowScalar, Eigen::Dynamic, Eigen::Dynamic>;
+
+  /// @param size   Dimension of the system.
+  /// @param ncols  Number of right-hand side columns to preallocate for.
+  MixedPrecisionLDLTTpl(const long size, const long ncols)
+      : mat_low_(size, size), rhs_low_(size, ncols), ldlt_(size) {
+    mat_low_.setZero();
+    rhs_low_.setZero();
+  }
+
+  long size() const { return mat_low_.rows(); }
+
+  /// Round @p mat to the low precision and factorize it.
+  void compute(const ConstMatrixRef &mat) {
+    assert(mat.rows() == size());
+    assert(mat.cols() == size());
+    mat_low_ = mat.template cast<LowScalar>();
+    ldlt_.compute(mat_low_);
+  }
+
+  /// Solve the system in-place, for any number of columns.
+  template <typename Derived>
+  void solveInPlace(const Eigen::MatrixBase<Derived> &rhs_) const {
+    auto &rhs = rhs_.const_cast_derived();
+    assert(rhs.rows() == size());
+    if (rhs.cols() > rhs_low_.cols())
+      rhs_low_.resize(size(), rhs.cols());
+    auto buf = rhs_low_.leftCols(rhs.cols());
+    buf = rhs.template cast<LowScalar>();
+    buf = ldlt_.solve(buf);
+    rhs = buf.template cast<Scalar>();
+  }
+
+  /// Inertia \f$(n_+, n_-, n_0)\f$ of the last factorized matrix.
+  std::array<int, 3> inertia() const {
+    std::array<int, 3> out{0, 0, 0};
+    const auto &D = ldlt_.vectorD();
+    for (Eigen::Index i = 0; i < D.size(); i++) {
+      if (D[i] > LowScalar(0))
+        out[0]++;
+      else if (D[i] < LowScalar(0))
+        out[1]++;
+      else
+        out[2]++;
+    }
+    return out;
+  }
+
+protected:
+  LowMatrix mat_low_;
+  mutable LowMatrix rhs_low_;
+  Eigen::LDLT<LowMatrix> ldlt_;
+};
+
+} // namespace aligator
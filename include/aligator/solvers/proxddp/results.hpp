@@ -19,18 +19,29 @@ template <typename _Scalar> struct ResultsTpl : ResultsBaseTpl<_Scalar> {
   using Base::xs;
 
   std::size_t al_iter = 0;
+  /// Whether the last run stopped because the time budget ran out (see
+  /// SolverProxDDP::time_budget).
+  bool timed_out = false;
 
   ResultsTpl() : Base() {}
   /// @brief    Create the results struct from a problem (TrajOptProblemTpl)
   /// instance.
   explicit ResultsTpl(const TrajOptProblemTpl<Scalar> &problem);
+
+  /// @brief Shift the trajectory, multipliers and gains one stage to the left,
+  /// for receding-horizon control (see SolverProxDDP::cycleProblem()).
+  /// @details The buffers of the first stage are moved to the back. The new
+  /// last knot is warm-started by copying the previous one (zero-order hold)
+  /// when their dimensions match. This does not allocate.
+  void cycleLeft();
 };
 
 template <typename Scalar>
 std::ostream &operator<<(std::ostream &oss, const ResultsTpl<Scalar> &self) {
   oss << "Results {";
   self.printBase(oss);
-  return oss << fmt::format("\n  al_iters:     {:d},", self.al_iter) << "\n}";
+  return oss << fmt::format("\n  al_iters:     {:d},", self.al_iter)
+             << fmt::format("\n  timed out:    {},", self.timed_out) << "\n}";
 }
 
 } // namespace aligator
@@ -4,6 +4,7 @@
 
 #include "./results.hpp"
 #include "aligator/core/solver-util.hpp"
+#include "aligator/utils/mpc-util.hpp"
 
 #include <fmt/format.h>
 
@@ -13,7 +14,8 @@ template <typename Scalar>
 ResultsTpl<Scalar>::ResultsTpl(const TrajOptProblemTpl<Scalar> &problem) {
 
   const std::size_t nsteps = problem.numSteps();
-  gains_.reserve(nsteps);
+  std::vector<std::array<long, 2>> gain_dims;
+  gain_dims.reserve(nsteps + 1);
   xs_default_init(problem, xs);
   us_default_init(problem, us);
   lams.reserve(nsteps + 1);
@@ -25,7 +27,7 @@ ResultsTpl<Scalar>::ResultsTpl(const TrajOptProblemTpl<Scalar> &problem) {
     const StageModelTpl<Scalar> &stage = *problem.stages_[i];
     const int nprim = stage.numPrimal();
     const int ndual = stage.numDual();
-    gains_.push_back(MatrixXs::Zero(nprim + ndual, stage.ndx1() + 1));
+    gain_dims.push_back({nprim + ndual, stage.ndx1() + 1});
     lams.push_back(VectorXs::Zero(ndual));
   }
 
@@ -33,11 +35,35 @@ ResultsTpl<Scalar>::ResultsTpl(const TrajOptProblemTpl<Scalar> &problem) {
     const long ndx = (long)problem.stages_.back()->ndx2();
     const long ndual = problem.term_cstrs_.totalDim();
     lams.push_back(VectorXs::Zero(ndual));
-    gains_.push_back(MatrixXs::Zero(ndual, ndx + 1));
+    gain_dims.push_back({ndual, ndx + 1});
   }
+  gains_ = MatrixArenaTpl<Scalar>(gain_dims);
   assert(xs.size() == nsteps + 1);
   assert(us.size() == nsteps);
 
   this->m_isInitialized = true;
 }
+
+template <typename Scalar> void ResultsTpl<Scalar>::cycleLeft() {
+  const std::size_t nsteps = us.size();
+  // terminal constraint multipliers and gains stay at the tail
+  const long n_tail = lams.size() > nsteps + 1 ? 1 : 0;
+  rotate_vec_left(xs);
+  rotate_vec_left(us);
+  rotate_vec_left(lams, 1, n_tail);
+  gains_.rotateLeft(0, n_tail);
+  if (nsteps < 2)
+    return;
+
+  ALIGATOR_NOMALLOC_BEGIN;
+  auto hold = [](auto &v, std::size_t i) {
+    if (v[i].rows() == v[i - 1].rows() && v[i].cols() == v[i - 1].cols())
+      v[i] = v[i - 1];
+  };
+  hold(xs, nsteps);
+  hold(us, nsteps - 1);
+  hold(lams, nsteps);
+  hold(gains_, nsteps - 1);
+  ALIGATOR_NOMALLOC_END;
+}
 } // namespace aligator
@@ -0,0 +1,287 @@
+/// @file schur-kkt.hpp
+/// @brief Structure-exploiting factorization of the stage KKT systems.
+/// @copyright Copyright (C) 2023 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/math.hpp"
+
+#include <array>
+#include <Eigen/Cholesky>
+#include <Eigen/LU>
+
+namespace aligator {
+
+/// @brief Block factorization of the stage KKT matrix of SolverProxDDP.
+///
+/// @details The stage KKT matrix is ordered as \f$(u, y, \lambda_d,
+/// \lambda_c)\f$, where \f$\lambda_d\f$ are the multipliers of the dynamics
+/// and \f$\lambda_c\f$ those of the other constraints:
+/// \f[
+///   K = \begin{bmatrix}
+///     Q_{uu} & Q_{uy} & J_{u,d}^\top & J_{u,c}^\top
+///     \\ Q_{yu} & V_{yy} & J_{y,d}^\top & J_{y,c}^\top
+///     \\ J_{u,d} & J_{y,d} & -\Delta_d & 0
+///     \\ J_{u,c} & J_{y,c} & 0 & -\Delta_c
+///   \end{bmatrix},
+/// \f]
+/// with diagonal \f$\Delta_d,\Delta_c > 0\f$. The middle block
+/// \f$M = \begin{bsmallmatrix} V_{yy} & J_{y,d}^\top \\ J_{y,d} & -\Delta_d
+/// \end{bsmallmatrix}\f$ is eliminated analytically using the invertibility of
+/// the dynamics Jacobian \f$J_{y,d}\f$: with \f$G = J_{y,d}^{-1}
+/// \Delta_d^{1/2}\f$, only the well-conditioned matrix \f$H = I + G^\top
+/// V_{yy} G\f$ is factorized (no division by the small \f$\Delta_d\f$ is
+/// involved), and its inertia gives that of \f$M\f$. The remaining Schur
+/// complement on \f$(u,\lambda_c)\f$ is reduced to the controls. Overall, only
+/// the \f$n_x\times n_x\f$, \f$n_u\times n_u\f$ and \f$n_c\times n_c\f$
+/// blocks are factorized, and the dynamics Jacobian is not inverted when it
+/// is \f$-I\f$ (as for explicit dynamics on vector spaces).
+///
+/// The interface mimics the LDLT routines used for the full KKT matrix,
+/// so that e.g. IterativeRefinementVisitor can be used.
+template <typename _Scalar> struct SchurKktSolverTpl {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+
+  /// @param nu      Control dimension.
+  /// @param ndx2    Next state (and dynamics) dimension.
+  /// @param ndual   Total constraint dimension, including the dynamics.
+  /// @param ncols   Number of right-hand side columns to preallocate for.
+  SchurKktSolverTpl(const long nu, const long ndx2, const long ndual,
+                    const long ncols);
+
+  /// Factorize the KKT matrix @p kkt_mat.
+  /// @pre @p kkt_mat is fully assembled (both triangular parts).
+  void compute(const ConstMatrixRef &kkt_mat);
+
+  /// Solve the KKT system in-place, for any number of columns.
+  template <typename Derived>
+  void solveInPlace(const Eigen::MatrixBase<Derived> &rhs) const;
+
+  /// Inertia \f$(n_+, n_-, n_0)\f$ of the last factorized matrix.
+  const std::array<int, 3> &inertia() const { return inertia_; }
+
+  long nu() const { return nu_; }
+  long ndx2() const { return ndx2_; }
+  long ndual() const { return ndual_; }
+  long ntot() const { return nu_ + ndx2_ + ndual_; }
+
+protected:
+  long nu_;
+  long ndx2_;
+  long ndual_;
+  /// Number of non-dynamics constraints.
+  long nc_;
+  std::array<int, 3> inertia_;
+
+  /// Whether the dynamics Jacobian is \f$-I\f$.
+  bool dyn_jac_neg_id_;
+  /// Whether the middle and constraint blocks are coupled.
+  bool cstr_coupled_;
+
+  /// @name Elimination of the middle block
+  /// @{
+  MatrixXs Vyy_;
+  VectorXs sqrtD_;
+  MatrixXs Jinv_;
+  MatrixXs G_;
+  MatrixXs VG_;
+  MatrixXs H_;
+  Eigen::PartialPivLU<MatrixXs> jac_lu_;
+  Eigen::LDLT<MatrixXs> ldlt_h_;
+  /// Off-diagonal block \f$K_{M,(u,c)}\f$, and \f$M^{-1}K_{M,(u,c)}\f$.
+  MatrixXs Kmid_;
+  MatrixXs Zmid_;
+  MatrixXs Ztmp_;
+  /// @}
+
+  /// @name Factorization of the Schur complement on (u, c)
+  /// @{
+  MatrixXs S2_;
+  Eigen::LDLT<MatrixXs> ldlt_c_;
+  Eigen::LDLT<MatrixXs> ldlt_u_;
+  /// \f$S_{cc}^{-1} S_{cu}\f$
+  MatrixXs Wcu_;
+  MatrixXs Su_;
+  /// @}
+
+  /// @name Right-hand side buffers
+  /// @{
+  mutable MatrixXs buf_mid_;
+  mutable MatrixXs buf_mid2_;
+  mutable MatrixXs buf_out_;
+  /// @}
+
+  /// Apply @f$M^{-1}@f$ to the columns of @p X, in-place.
+  template <typename Derived>
+  void applyMidInverse(const Eigen::MatrixBase<Derived> &X,
+                       MatrixRef tmp) const;
+
+  template <typename Derived>
+  void solveBlockInPlace(const Eigen::MatrixBase<Derived> &rhs) const;
+};
+
+template <typename Scalar>
+SchurKktSolverTpl<Scalar>::SchurKktSolverTpl(const long nu, const long ndx2,
+                                             const long ndual, const long ncols)
+    : nu_(nu), ndx2_(ndx2), ndual_(ndual), nc_(ndual - ndx2),
+      inertia_({0, 0, 0}), dyn_jac_neg_id_(false), cstr_coupled_(false),
+      Vyy_(ndx2, ndx2), sqrtD_(ndx2), Jinv_(ndx2, ndx2), G_(ndx2, ndx2),
+      VG_(ndx2, ndx2), H_(ndx2, ndx2), jac_lu_(ndx2), ldlt_h_(ndx2),
+      Kmid_(2 * ndx2, nu + nc_), Zmid_(2 * ndx2, nu + nc_),
+      Ztmp_(ndx2, nu + nc_), S2_(nu + nc_, nu + nc_), ldlt_c_(nc_),
+      ldlt_u_(nu), Wcu_(nc_, nu), Su_(nu, nu), buf_mid_(2 * ndx2, ncols),
+      buf_mid2_(ndx2, ncols), buf_out_(nu + nc_, ncols) {
+  assert(nc_ >= 0);
+  assert(ncols > 0);
+}
+
+template <typename Scalar>
+void SchurKktSolverTpl<Scalar>::compute(const ConstMatrixRef &kkt_mat) {
+  const long nu = nu_;
+  const long ndx2 = ndx2_;
+  const long nc = nc_;
+  const long nmid = 2 * ndx2;
+  const long nprim = nu + ndx2;
+  assert(kkt_mat.rows() == ntot());
+  assert(kkt_mat.cols() == ntot());
+
+  auto Jyd = kkt_mat.block(nprim, nu, ndx2, ndx2);
+  Vyy_ = kkt_mat.block(nu, nu, ndx2, ndx2);
+  sqrtD_ = (-kkt_mat.diagonal().segment(nprim, ndx2)).cwiseSqrt();
+
+  // eliminate the middle block, using G = J^{-1} D^{1/2}
+  dyn_jac_neg_id_ = (-Jyd).isIdentity(0.);
+  if (dyn_jac_neg_id_) {
+    Jinv_.setIdentity();
+    Jinv_ *= -1.;
+    G_.setZero();
+    G_.diagonal() = -sqrtD_;
+    H_ = sqrtD_.asDiagonal() * Vyy_ * sqrtD_.asDiagonal();
+  } else {
+    jac_lu_.compute(Jyd);
+    if (jac_lu_.rcond() <= std::numeric_limits<Scalar>::epsilon()) {
+      inertia_ = {0, 0, int(ntot())};
+      return;
+    }
+    Jinv_.noalias() = jac_lu_.inverse();
+    G_.noalias() = Jinv_ * sqrtD_.asDiagonal();
+    VG_.noalias() = Vyy_ * G_;
+    H_.noalias() = G_.transpose() * VG_;
+  }
+  H_.diagonal().array() += 1.;
+  ldlt_h_.compute(H_);
+
+  // coupling between the middle block and (u, c)
+  Kmid_.leftCols(nu) = kkt_mat.block(nu, 0, nmid, nu);
+  Kmid_.rightCols(nc) = kkt_mat.block(nu, nu + nmid, nmid, nc);
+  cstr_coupled_ = !Kmid_.rightCols(nc).isZero(0.);
+  const long ncpl = cstr_coupled_ ? nu + nc : nu;
+  Zmid_.leftCols(ncpl) = Kmid_.leftCols(ncpl);
+  applyMidInverse(Zmid_.leftCols(ncpl), Ztmp_.leftCols(ncpl));
+  if (!cstr_coupled_)
+    Zmid_.rightCols(nc).setZero();
+
+  // Schur complement on (u, c)
+  S2_.topLeftCorner(nu, nu) = kkt_mat.topLeftCorner(nu, nu);
+  S2_.topRightCorner(nu, nc) = kkt_mat.topRightCorner(nu, nc);
+  S2_.bottomLeftCorner(nc, nu) = kkt_mat.bottomLeftCorner(nc, nu);
+  S2_.bottomRightCorner(nc, nc) = kkt_mat.bottomRightCorner(nc, nc);
+  S2_.leftCols(ncpl).noalias() -= Kmid_.transpose() * Zmid_.leftCols(ncpl);
+
+  // eliminate the constraint multipliers
+  auto Scc = S2_.bottomRightCorner(nc, nc);
+  auto Scu = S2_.bottomLeftCorner(nc, nu);
+  auto Suc = S2_.topRightCorner(nu, nc);
+  ldlt_c_.compute(Scc);
+  Wcu_ = ldlt_c_.solve(Scu);
+  Su_ = S2_.topLeftCorner(nu, nu);
+  Su_.noalias() -= Suc * Wcu_;
+  ldlt_u_.compute(Su_);
+
+  // Haynsworth inertia additivity: M has the inertia of H, plus ndx2
+  // negative eigenvalues.
+  inertia_ = {0, int(ndx2), 0};
+  auto count_signs = [&](const auto &vecD) {
+    for (long i = 0; i < vecD.size(); i++) {
+      if (vecD[i] > 0.)
+        inertia_[0]++;
+      else if (vecD[i] < 0.)
+        inertia_[1]++;
+      else
+        inertia_[2]++;
+    }
+  };
+  count_signs(ldlt_h_.vectorD());
+  count_signs(ldlt_c_.vectorD());
+  count_signs(ldlt_u_.vectorD());
+}
+
+template <typename Scalar>
+template <typename Derived>
+void SchurKktSolverTpl<Scalar>::applyMidInverse(
+    const Eigen::MatrixBase<Derived> &X_, MatrixRef tmp) const {
+  Derived &X = X_.const_cast_derived();
+  const long ndx2 = ndx2_;
+  auto Xy = X.topRows(ndx2);
+  auto Xd = X.bottomRows(ndx2);
+  // y = J^{-1} r_d + G c, lam = D^{-1/2} c,
+  // where c = H^{-1} G^T (r_y - V J^{-1} r_d)
+  tmp.noalias() = Jinv_ * Xd;
+  Xy.noalias() -= Vyy_ * tmp;
+  Xd.noalias() = G_.transpose() * Xy;
+  ldlt_h_.solveInPlace(Xd);
+  Xy = tmp;
+  Xy.noalias() += G_ * Xd;
+  Xd = sqrtD_.cwiseInverse().asDiagonal() * Xd;
+}
+
+template <typename Scalar>
+template <typename Derived>
+void SchurKktSolverTpl<Scalar>::solveInPlace(
+    const Eigen::MatrixBase<Derived> &rhs_) const {
+  Derived &rhs = rhs_.const_cast_derived();
+  const long cap = buf_out_.cols();
+  for (long j = 0; j < rhs.cols(); j += cap) {
+    const long nj = std::min(cap, rhs.cols() - j);
+    solveBlockInPlace(rhs.middleCols(j, nj));
+  }
+}
+
+template <typename Scalar>
+template <typename Derived>
+void SchurKktSolverTpl<Scalar>::solveBlockInPlace(
+    const Eigen::MatrixBase<Derived> &rhs_) const {
+  Derived &rhs = rhs_.const_cast_derived();
+  const long nu = nu_;
+  const long nc = nc_;
+  const long nmid = 2 * ndx2_;
+  const long ncols = rhs.cols();
+  auto Xu = rhs.topRows(nu);
+  auto Xmid = rhs.middleRows(nu, nmid);
+  auto Xc = rhs.bottomRows(nc);
+
+  // forward: eliminate the middle block
+  auto Ymid = buf_mid_.leftCols(ncols);
+  Ymid = Xmid;
+  applyMidInverse(Ymid, buf_mid2_.leftCols(ncols));
+  auto R2 = buf_out_.leftCols(ncols);
+  R2.topRows(nu) = Xu;
+  R2.bottomRows(nc) = Xc;
+  R2.noalias() -= Kmid_.transpose() * Ymid;
+
+  // solve the Schur complement system on (u, c)
+  auto Ru = R2.topRows(nu);
+  auto Rc = R2.bottomRows(nc);
+  ldlt_c_.solveInPlace(Rc);
+  Ru.noalias() -= S2_.topRightCorner(nu, nc) * Rc;
+  ldlt_u_.solveInPlace(Ru);
+  Rc.noalias() -= Wcu_ * Ru;
+
+  // back-substitute
+  Xu = Ru;
+  Xc = Rc;
+  Xmid = Ymid;
+  Xmid.noalias() -= Zmid_ * R2;
+}
+
+} // namespace aligator
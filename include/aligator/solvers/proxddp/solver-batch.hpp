@@ -0,0 +1,74 @@
+/// @file solver-batch.hpp
+/// @brief  Solve many instances of a trajectory optimization problem in
+/// parallel.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "./solver-proxddp.hpp"
+
+namespace aligator {
+
+/// @brief Batch front-end for SolverProxDDP: solves many instances of the
+/// same problem, e.g. for different initial states, in parallel.
+///
+/// @details Each instance has its own TrajOptProblemTpl, which shares the
+/// stage models, terminal cost and terminal constraints of the original
+/// problem, but has its own copy of the initial condition. Instances can be
+/// customized further through problems_ (e.g. by replacing a stage with one
+/// using a different cost reference). Each instance also has its own solver,
+/// hence its own workspace and results.
+///
+/// The instances are solved on a ThreadPool of num_threads threads, which
+/// the instance solvers also use for their own parallel loops: threads which
+/// are done with their instances help with the remaining ones.
+template <typename _Scalar> struct SolverProxDDPBatch {
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using Solver = SolverProxDDP<Scalar>;
+  using Problem = TrajOptProblemTpl<Scalar>;
+  using Results = ResultsTpl<Scalar>;
+
+  /// Number of threads the instances are solved on. Takes effect in setup().
+  std::size_t num_threads = 1;
+  /// Pin the threads to distinct cores. Takes effect in setup().
+  bool pin_threads = false;
+  /// Problem instances.
+  std::vector<Problem> problems_;
+  /// Solver instances.
+  std::vector<Solver> solvers_;
+
+  /// @param solver         Solver whose options are copied to each instance.
+  /// The callbacks are not copied.
+  /// @param problem        Problem to solve.
+  /// @param num_instances  Number of instances.
+  SolverProxDDPBatch(const Solver &solver, const Problem &problem,
+                     std::size_t num_instances);
+
+  std::size_t size() const { return solvers_.size(); }
+
+  /// @brief Create the thread pool, and allocate the workspace and results of
+  /// each instance.
+  void setup();
+
+  /// @brief Solve all the instances, from the default initial guess.
+  /// @returns The number of instances which converged.
+  std::size_t run();
+
+  /// @brief Set the initial state of each instance, then solve them all.
+  /// @param x0s  Initial states, one per instance.
+  /// @returns The number of instances which converged.
+  std::size_t run(const std::vector<VectorXs> &x0s);
+
+  const Results &results(std::size_t i) const { return solvers_[i].results_; }
+
+private:
+  shared_ptr<ThreadPool> thread_pool_;
+};
+
+} // namespace aligator
+
+#include "./solver-batch.hxx"
+
+#ifdef ALIGATOR_ENABLE_TEMPLATE_INSTANTIATION
+#include "./solver-batch.txx"
+#endif
@@ -0,0 +1,68 @@
+/// @file solver-batch.hxx
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "./solver-batch.hpp"
+
+#include <atomic>
+
+namespace aligator {
+
+template <typename Scalar>
+SolverProxDDPBatch<Scalar>::SolverProxDDPBatch(const Solver &solver,
+                                               const Problem &problem,
+                                               std::size_t num_instances) {
+  using StateErrorResidual = StateErrorResidualTpl<Scalar>;
+  auto state_err =
+      std::dynamic_pointer_cast<StateErrorResidual>(problem.init_condition_);
+  problems_.reserve(num_instances);
+  solvers_.reserve(num_instances);
+  for (std::size_t i = 0; i < num_instances; i++) {
+    shared_ptr<UnaryFunctionTpl<Scalar>> init_cond = problem.init_condition_;
+    if (state_err)
+      init_cond = std::make_shared<StateErrorResidual>(*state_err);
+    problems_.emplace_back(init_cond, problem.stages_, problem.term_cost_);
+    problems_[i].term_cstrs_ = problem.term_cstrs_;
+    solvers_.push_back(solver);
+    solvers_[i].clearCallbacks();
+  }
+}
+
+template <typename Scalar> void SolverProxDDPBatch<Scalar>::setup() {
+  thread_pool_ = num_threads > 1
+                     ? std::make_shared<ThreadPool>(num_threads, pin_threads)
+                     : nullptr;
+  // the solvers must not move after this: their workspace points to them
+  for (std::size_t i = 0; i < size(); i++) {
+    solvers_[i].setThreadPool(thread_pool_);
+    solvers_[i].setup(problems_[i]);
+  }
+}
+
+template <typename Scalar> std::size_t SolverProxDDPBatch<Scalar>::run() {
+  std::atomic<std::size_t> num_conv{0};
+  auto solve = [&](std::size_t i) {
+    if (solvers_[i].run(problems_[i]))
+      num_conv++;
+  };
+  // one instance per chunk, for load balancing
+  if (thread_pool_)
+    thread_pool_->parallelFor(0, size(), solve, 1);
+  else
+    parallel_for(nullptr, 0, size(), solve);
+  return num_conv;
+}
+
+template <typename Scalar>
+std::size_t SolverProxDDPBatch<Scalar>::run(const std::vector<VectorXs> &x0s) {
+  if (x0s.size() != size()) {
+    ALIGATOR_RUNTIME_ERROR(fmt::format(
+        "Expected {:d} initial states, got {:d}.", size(), x0s.size()));
+  }
+  for (std::size_t i = 0; i < size(); i++) {
+    problems_[i].setInitState(x0s[i]);
+  }
+  return run();
+}
+
+} // namespace aligator
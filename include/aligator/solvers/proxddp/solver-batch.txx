@@ -0,0 +1,9 @@
+#pragma once
+
+#include "aligator/context.hpp"
+
+namespace aligator {
+
+extern template struct SolverProxDDPBatch<context::Scalar>;
+
+} // namespace aligator
@@ -10,6 +10,7 @@
 #include "aligator/utils/exceptions.hpp"
 #include "aligator/utils/logger.hpp"
 #include "aligator/utils/forward-dyn.hpp"
+#include "aligator/utils/timings.hpp"
 #include "./workspace.hpp"
 #include "./results.hpp"
 #include "./merit-function.hpp"
@@ -17,6 +18,8 @@
 #include <proxsuite-nlp/modelling/constraints.hpp>
 #include <proxsuite-nlp/bcl-params.hpp>
 
+#include <boost/variant/apply_visitor.hpp>
+#include <chrono>
 #include <unordered_map>
 
 namespace aligator {
@@ -31,6 +34,9 @@ void applyDefaultScalingStrategy(ConstraintProximalScalerTpl<Scalar> &scaler) {
 
 /// @brief A proximal, augmented Lagrangian-type solver for trajectory
 /// optimization.
+/// @details The backward pass always uses dynamic-size matrices, also with
+/// the fixed-size models: there is no compile-time fixed-size kernel for
+/// this solver, only for SolverFDDP.
 template <typename _Scalar> struct SolverProxDDP {
 public:
   // typedefs
@@ -48,10 +54,12 @@ public:
   using StageData = StageDataTpl<Scalar>;
   using VParams = ValueFunctionTpl<Scalar>;
   using QParams = QFunctionTpl<Scalar>;
+  using RiccatiLeg = RiccatiLegTpl<Scalar>;
   using CallbackPtr = shared_ptr<CallbackBaseTpl<Scalar>>;
   using CallbackMap = std::unordered_map<std::string, CallbackPtr>;
   using ConstraintStack = ConstraintStackTpl<Scalar>;
   using CstrSet = ConstraintSetBase<Scalar>;
+  using EqualitySet = proxsuite::nlp::EqualityConstraint<Scalar>;
   using TrajOptData = TrajOptDataTpl<Scalar>;
   using LinesearchOptions = typename Linesearch<Scalar>::Options;
   using CstrProximalScaler = ConstraintProximalScalerTpl<Scalar>;
@@ -106,6 +114,11 @@ public:
   Scalar dual_weight = 1.0;
   /// Type of rollout for the forward pass.
   RolloutType rollout_type_ = RolloutType::NONLINEAR;
+  /// Number of step sizes \f$1, \beta, \dots, \beta^{n-1}\f$ evaluated
+  /// concurrently by the linesearch, with \f$\beta\f$ the minimum contraction
+  /// factor in ls_params. Only used with the linear rollout; values below 2
+  /// select the sequential linesearch. Takes effect in setup().
+  std::size_t ls_batch_size = 1;
   /// Parameters for the BCL outer loop of the augmented Lagrangian algorithm.
   BCLParamsTpl<Scalar> bcl_params;
 
@@ -121,12 +134,33 @@ public:
   Scalar refinement_threshold_ = 1e-13;
   /// Choice of factorization routine.
   LDLTChoice ldlt_algo_choice_;
+  /// Choice of solver for the stage KKT systems. Takes effect in setup().
+  KktSolverChoice kkt_solver_choice = KktSolverChoice::FULL_LDLT;
+  /// Choice of linear-quadratic solver for the backward pass. The parallel
+  /// solver splits the horizon into one leg per thread (see
+  /// TrajOptProblemTpl::setNumThreads()). Takes effect in setup().
+  LQSolverChoice linear_solver_choice = LQSolverChoice::SERIAL;
+  /// \}
+
+  /// @name Multithreading
+  /// \{
+  /// Pin the threads of the pool created by setup() to distinct cores.
+  bool pin_threads = false;
   /// \}
 
   /// Maximum number \f$N_{\mathrm{max}}\f$ of Newton iterations.
   std::size_t max_iters;
   /// Maximum number of ALM iterations.
   std::size_t max_al_iters = 100;
+  /// Wall-clock time budget of run(), in seconds. Zero or negative values mean
+  /// no limit.
+  /// @details The budget is checked between the phases of an iteration
+  /// (derivatives, backward pass, linesearch), so it can be overrun by the
+  /// duration of one phase. When it runs out, the solver stops and sets
+  /// ResultsTpl::timed_out: results_ holds the last accepted iterate, which has
+  /// the lowest merit value so far, and the gains of the last completed
+  /// backward pass.
+  Scalar time_budget = 0.;
 
   /// Minimum possible penalty parameter.
   Scalar MU_MIN = 1e-8;
@@ -167,6 +201,17 @@ public:
                                     Workspace &workspace,
                                     const Results &results, const Scalar alpha);
 
+  /// @copybrief forward_linear_impl()
+  /// @details Same as above, writing the trial point and problem data into
+  /// the given buffers instead of the workspace.
+  static Scalar forward_linear_impl(const Problem &problem,
+                                    const Workspace &workspace,
+                                    const Results &results, const Scalar alpha,
+                                    std::vector<VectorXs> &xs,
+                                    std::vector<VectorXs> &us,
+                                    std::vector<VectorXs> &lams,
+                                    TrajOptData &prob_data);
+
   /// @brief    Policy rollout using the full nonlinear dynamics. The feedback
   /// gains need to be computed first. This will evaluate all the terms in the
   /// problem into the problem data, similar to TrajOptProblemTpl::evaluate().
@@ -175,6 +220,14 @@ public:
 
   Scalar forwardPass(const Problem &problem, const Scalar alpha);
 
+  /// @brief    Armijo backtracking linesearch evaluating batches of step sizes
+  /// concurrently, on the trial buffers WorkspaceTpl::ls_trials_. The largest
+  /// step size satisfying the Armijo condition is selected, and its trial
+  /// point is swapped into the workspace.
+  /// @returns  The merit function value at the selected trial point.
+  Scalar batchedLinesearch(const Problem &problem, const Scalar phi0,
+                           const Scalar dphi0, Scalar &alpha_opt);
+
   /// @brief    Compute search direction in the first state variable \f$x_0\f$.
   void compute_dir_x0(const Problem &problem);
 
@@ -182,21 +235,45 @@ public:
   void computeTerminalValue(const Problem &problem);
 
   /// @brief    Compute the Hamiltonian parameters at time @param t.
-  void updateHamiltonian(const Problem &problem, const std::size_t);
+  /// @param vnext  Value function at time \f$t+1\f$.
+  void updateHamiltonian(const Problem &problem, const std::size_t t,
+                         const VParams &vnext);
 
   /// Assemble the right-hand side of the KKT system.
-  void assembleKktSystem(const Problem &problem, const std::size_t t);
+  void assembleKktSystem(const Problem &problem, const std::size_t t,
+                         const VParams &vnext);
 
   /// @brief    Perform the Riccati backward pass.
   /// @pre  Compute the derivatives first!
   BackwardRet backwardPass(const Problem &problem);
 
+  /// @brief    Parallel-in-time variant of the Riccati backward pass.
+  /// @details  The legs of the horizon (see RiccatiLegTpl) are first factorized
+  /// concurrently, parametrized by the costate at their end. The legs are then
+  /// merged sequentially from the last one, which gives the exact value
+  /// function at each leg boundary, and the gains in each leg are recomputed
+  /// concurrently. This does about twice the work of the sequential pass.
+  /// @pre  The workspace legs were allocated, see
+  /// WorkspaceTpl::configureParallelRiccati().
+  BackwardRet backwardPassParallel(const Problem &problem);
+
   /// @brief Allocate new workspace and results instances according to the
   /// specifications of @p problem.
   /// @param problem  The problem instance with respect to which memory will be
   /// allocated.
+  /// @details If aligator was compiled with multithreading support, this also
+  /// creates a thread pool of TrajOptProblemTpl::getNumThreads() threads, on
+  /// which all the parallel loops of the solver run (unless a pool was given
+  /// through setThreadPool()).
   void setup(const Problem &problem);
 
+  /// @brief Run the parallel loops on @p pool, e.g. to share one pool between
+  /// several solvers. Passing nullptr lets setup() create a pool again.
+  void setThreadPool(shared_ptr<ThreadPool> pool);
+  /// @brief The thread pool the parallel loops run on, or nullptr if they run
+  /// sequentially.
+  ThreadPool *getThreadPool() const { return thread_pool_.get(); }
+
   /// @brief Run the numerical solver.
   /// @param problem  The trajectory optimization problem to solve.
   /// @param xs_init  Initial trajectory guess.
@@ -212,6 +289,43 @@ public:
   /// minimization).
   bool innerLoop(const Problem &problem);
 
+  /// @name Real-time iteration
+  /// Split a single SQP iteration into a preparation phase, which can run
+  /// before the new initial state is known, and a cheap feedback phase.
+  /// \{
+
+  /// @brief    Linearize the problem around the current iterate in results_
+  /// and compute the gains of the backward pass. The proximal terms are
+  /// centered at the current iterate.
+  /// @returns  false if the backward pass failed at the maximum regularization.
+  /// @pre  You must call SolverProxDDP::setup beforehand.
+  bool prepareRTI(const Problem &problem);
+
+  /// @brief    Take a full step along the gains computed by prepareRTI(), from
+  /// the current initial condition of @p problem (see
+  /// TrajOptProblemTpl::setInitState()), and accept it.
+  /// @returns  The merit function value at the new iterate.
+  Scalar feedbackRTI(const Problem &problem);
+  /// \}
+
+  /// @brief    Shift the horizon by one stage, for receding-horizon control.
+  /// @details  The first stage of @p problem is dropped and @p stage is
+  /// appended (see TrajOptProblemTpl::replaceStageCircular()). All the
+  /// per-stage buffers of the workspace and results are rotated, and those of
+  /// the dropped stage are reused for @p stage, which must have the same
+  /// dimensions. The constraint scalers are rebound to @p stage, and the new
+  /// last knot of results_ is warm-started by copying the previous one.
+  ///
+  /// This does not allocate if @p stage has the same cost and constraint
+  /// functions (pointers) as the dropped stage, e.g. if it is the dropped
+  /// stage itself: their stage data is then reused. Otherwise, stage data is
+  /// created for the linesearch trial points, and for the problem data unless
+  /// @p data is given.
+  /// @param data  Data for @p stage (e.g. preallocated with
+  /// StageModelTpl::createData()), or nullptr.
+  void cycleProblem(Problem &problem, const shared_ptr<StageModel> &stage,
+                    shared_ptr<StageData> data = nullptr);
+
   /// @brief    Compute the primal infeasibility measures.
   /// @warning  This will alter the constraint values (by projecting on the
   /// normal cone in-place).
@@ -243,6 +357,7 @@ public:
 
   /// @brief    Invoke callbacks.
   void invokeCallbacks(Workspace &workspace, Results &results) {
+    ScopedPhase phase(timer_, SolverPhase::CALLBACKS);
     for (const auto &cb : callbacks_) {
       cb.second->call(workspace, results);
     }
@@ -255,6 +370,15 @@ public:
   void computeMultipliers(const Problem &problem,
                           const std::vector<VectorXs> &lams);
 
+  /// @copybrief computeMultipliers(), for the initial condition only.
+  void computeInitialMultipliers(const VectorXs &lam0);
+
+  /// Compute the problem derivatives at the current iterate. With the exact
+  /// Hessian approximation, this includes the vector-Hessian products of the
+  /// constraints with the current multipliers; they are reused across the
+  /// inertia corrections of the backward pass.
+  void computeDerivatives(const Problem &problem);
+
   /// @copydoc mu_penal_
   ALIGATOR_INLINE Scalar mu() const { return mu_penal_; }
 
@@ -268,7 +392,9 @@ public:
 
   /// @brief  Put together the Q-function parameters and compute the Riccati
   /// gains.
-  inline BackwardRet computeGains(const Problem &problem, const std::size_t t);
+  /// @param vp  Output value function at time \f$t\f$.
+  inline BackwardRet computeGains(const Problem &problem, const std::size_t t,
+                                  VParams &vp);
 
   auto getLinesearchMuLowerBound() const { return min_mu_linesearch_; }
   void setLinesearchMuLowerBound(Scalar mu) { min_mu_linesearch_ = mu; }
@@ -279,6 +405,46 @@ protected:
   void update_tols_on_failure();
   void update_tols_on_success();
 
+  /// @brief Apply @p visitor to the factorization of the KKT system at time
+  /// @p t, i.e. a SchurKktSolverTpl, a MixedPrecisionLDLTTpl or the LDLT
+  /// variant.
+  template <typename Visitor>
+  decltype(auto) visitKktSolver(const std::size_t t, Visitor &&visitor) {
+    if (!workspace_.schur_kkts_.empty())
+      return visitor(workspace_.schur_kkts_[t]);
+    if (!workspace_.mixed_ldlts_.empty())
+      return visitor(workspace_.mixed_ldlts_[t]);
+    return boost::apply_visitor(std::forward<Visitor>(visitor),
+                                workspace_.ldlts_[t + 1]);
+  }
+
+  /// @brief Run the backward pass, increasing the regularization until the
+  /// KKT systems have the correct inertia.
+  /// @returns false if the maximum regularization was reached.
+  bool backwardPassRegularized(const Problem &problem);
+
+  /// Check the time budget of run(), and set ResultsTpl::timed_out.
+  bool checkTimeBudget() {
+    if (time_budget <= 0.)
+      return false;
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - run_start_;
+    results_.timed_out = elapsed.count() >= double(time_budget);
+    return results_.timed_out;
+  }
+
+  /// @brief Compute the sensitivities of the value function at time @p t
+  /// w.r.t. the costate parameter of @p leg.
+  /// @pre computeGains() was called at time @p t.
+  void computeLegSensitivities(const Problem &problem, RiccatiLeg &leg,
+                               const std::size_t t);
+
+  /// @brief Eliminate the costate parameter of @p leg, given the exact value
+  /// function @p vnext at the end of the leg.
+  /// @details @p vnext only needs to be positive-semidefinite.
+  /// @returns false if the merge failed.
+  static bool mergeLeg(RiccatiLeg &leg, const VParams &vnext, VParams &vout);
+
   /// Set dual proximal/ALM penalty parameter.
   ALIGATOR_INLINE void set_penalty_mu(Scalar new_mu) noexcept {
     mu_penal_ = std::max(new_mu, MU_MIN);
@@ -327,6 +493,26 @@ private:
   Scalar rho_penal_ = rho_init;
   /// Linesearch function
   LinesearchType linesearch_;
+  /// Start time of the last call to run()
+  std::chrono::steady_clock::time_point run_start_;
+  /// Thread pool the parallel loops run on
+  shared_ptr<ThreadPool> thread_pool_;
+  /// Whether thread_pool_ is managed by setup()
+  bool owns_thread_pool_ = true;
+  /// Make the problem data of the workspace use thread_pool_.
+  void attachThreadPool();
+  /// Set the trace buffer of the problem data, and of the linesearch trials.
+  void attachTrace(TraceBuffer *trace);
+  /// Records the time spent in each phase
+  PhaseTimer timer_;
+  /// Move the phase timings of the current iteration to results_.
+  void recordIterationTimings() {
+    if (!PhaseTimer::enabled)
+      return;
+    results_.iter_timings.emplace_back();
+    timer_.collect(results_.iter_timings.back());
+    results_.timings += results_.iter_timings.back();
+  }
 };
 
 } // namespace aligator
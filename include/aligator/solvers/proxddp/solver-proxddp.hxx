@@ -54,28 +54,33 @@ Scalar SolverProxDDP<Scalar>::forward_linear_impl(const Problem &problem,
                                                   Workspace &workspace,
                                                   const Results &results,
                                                   const Scalar alpha) {
+  return forward_linear_impl(problem, workspace, results, alpha,
+                             workspace.trial_xs, workspace.trial_us,
+                             workspace.trial_lams, workspace.problem_data);
+}
+
+template <typename Scalar>
+Scalar SolverProxDDP<Scalar>::forward_linear_impl(
+    const Problem &problem, const Workspace &workspace, const Results &results,
+    const Scalar alpha, std::vector<VectorXs> &xs, std::vector<VectorXs> &us,
+    std::vector<VectorXs> &lams, TrajOptData &prob_data) {
 
   const std::size_t nsteps = workspace.nsteps;
 
   for (std::size_t i = 0; i < results.lams.size(); i++) {
-    workspace.trial_lams[i] = results.lams[i] + alpha * workspace.dlams[i];
+    lams[i] = results.lams[i] + alpha * workspace.dlams[i];
   }
 
-  for (std::size_t i = 0; i < nsteps; i++) {
+  parallel_for(prob_data.thread_pool, 0, nsteps, [&](std::size_t i) {
     const StageModel &stage = *problem.stages_[i];
-    stage.xspace_->integrate(results.xs[i], alpha * workspace.dxs[i],
-                             workspace.trial_xs[i]);
-    stage.uspace_->integrate(results.us[i], alpha * workspace.dus[i],
-                             workspace.trial_us[i]);
-  }
+    stage.xspace_->integrate(results.xs[i], alpha * workspace.dxs[i], xs[i]);
+    stage.uspace_->integrate(results.us[i], alpha * workspace.dus[i], us[i]);
+  });
   const StageModel &stage = *problem.stages_[nsteps - 1];
   stage.xspace_next_->integrate(results.xs[nsteps],
-                                alpha * workspace.dxs[nsteps],
-                                workspace.trial_xs[nsteps]);
-  TrajOptData &prob_data = workspace.problem_data;
-  problem.evaluate(workspace.trial_xs, workspace.trial_us, prob_data);
-  prob_data.cost_ = problem.computeTrajectoryCost(prob_data);
-  return prob_data.cost_;
+                                alpha * workspace.dxs[nsteps], xs[nsteps]);
+  // evaluates the stages in parallel, and sets prob_data.cost_
+  return problem.evaluate(xs, us, prob_data);
 }
 
 template <typename Scalar>
@@ -88,7 +93,7 @@ void SolverProxDDP<Scalar>::compute_dir_x0(const Problem &problem) {
   const int ndx0 = problem.init_condition_->ndx1;
   const VectorXs &lampl0 = workspace_.lams_plus[0];
   const VectorXs &lamin0 = results_.lams[0];
-  MatrixXs &kkt_mat = workspace_.kkt_mats_[0];
+  MatrixRef kkt_mat = workspace_.kkt_mats_[0];
   VectorRef kkt_rhs = workspace_.kkt_rhs_[0].col(0);
   VectorRef kktx = kkt_rhs.head(ndx0);
   assert(kkt_rhs.size() == ndx0 + ndual0);
@@ -102,7 +107,8 @@ void SolverProxDDP<Scalar>::compute_dir_x0(const Problem &problem) {
   } else {
     auto kktl = kkt_rhs.tail(ndual0);
     kktx = vp.Vx_;
-    kktx.noalias() += init_data.Jx_.transpose() * lamin0;
+    addJacobianTransposeProduct<Scalar>(init_data.Jx_structure_, init_data.Jx_,
+                                        lamin0, kktx);
     kktl = mu() * (lampl0 - lamin0);
 
     auto kkt_xx = kkt_mat.topLeftCorner(ndx0, ndx0);
@@ -114,7 +120,7 @@ void SolverProxDDP<Scalar>::compute_dir_x0(const Problem &problem) {
     auto &ldlt = workspace_.ldlts_[0];
     ALIGATOR_NOMALLOC_END;
     boost::apply_visitor([&](auto &&fac) { fac.compute(kkt_mat); }, ldlt);
-    auto &resdl = workspace_.kkt_resdls_[0];
+    MatrixRef resdl = workspace_.kkt_resdls_[0].col(0);
     auto &gains = workspace_.pd_step_[0];
     boost::apply_visitor(
         IterativeRefinementVisitor<Scalar>{kkt_mat, kkt_rhs, resdl, gains,
@@ -133,6 +139,50 @@ void SolverProxDDP<Scalar>::setup(const Problem &problem) {
 
   workspace_.configureScalers(problem, mu_penal_,
                               applyDefaultScalingStrategy<Scalar>);
+  if (kkt_solver_choice == KktSolverChoice::SCHUR) {
+    workspace_.configureSchurKktSolvers(problem);
+  } else if (kkt_solver_choice == KktSolverChoice::MIXED_PRECISION) {
+    workspace_.configureMixedPrecisionKktSolvers(problem);
+  }
+  workspace_.configureLinesearchBatch(problem, ls_batch_size);
+  if (linear_solver_choice == LQSolverChoice::PARALLEL) {
+    // one leg per thread, rounded down to a power of two
+    const std::size_t depth =
+        LQRTree<Scalar>(problem.getNumThreads()).maxDepth();
+    workspace_.configureParallelRiccati(problem, depth);
+  }
+
+#ifdef ALIGATOR_MULTITHREADING
+  const std::size_t num_threads = problem.getNumThreads();
+  if (owns_thread_pool_ &&
+      (thread_pool_ ? thread_pool_->size() : 1) != num_threads) {
+    thread_pool_ = num_threads > 1
+                       ? std::make_shared<ThreadPool>(num_threads, pin_threads)
+                       : nullptr;
+  }
+#endif
+  attachThreadPool();
+}
+
+template <typename Scalar>
+void SolverProxDDP<Scalar>::setThreadPool(shared_ptr<ThreadPool> pool) {
+  owns_thread_pool_ = pool == nullptr;
+  thread_pool_ = std::move(pool);
+  attachThreadPool();
+}
+
+template <typename Scalar> void SolverProxDDP<Scalar>::attachThreadPool() {
+  ThreadPool *pool = thread_pool_.get();
+  workspace_.problem_data.thread_pool = pool;
+  for (auto &trial : workspace_.ls_trials_)
+    trial.problem_data.thread_pool = pool;
+}
+
+template <typename Scalar>
+void SolverProxDDP<Scalar>::attachTrace(TraceBuffer *trace) {
+  workspace_.problem_data.trace = trace;
+  for (auto &trial : workspace_.ls_trials_)
+    trial.problem_data.trace = trace;
 }
 
 template <typename Scalar>
@@ -141,12 +191,20 @@ auto SolverProxDDP<Scalar>::backwardPass(const Problem &problem)
   /* Terminal node */
   computeTerminalValue(problem);
 
+  if (workspace_.par_legs_.size() > 1) {
+    return backwardPassParallel(problem);
+  }
+
+  std::vector<VParams> &vps = workspace_.value_params;
   const std::size_t nsteps = workspace_.nsteps;
+  const AllocationSite alloc_site = AllocationAudit::currentSite();
   for (std::size_t i = 0; i < nsteps; i++) {
     std::size_t t = nsteps - i - 1;
-    updateHamiltonian(problem, t);
-    assembleKktSystem(problem, t);
-    BackwardRet b = computeGains(problem, t);
+    ScopedTrace span(workspace_.problem_data.trace, "backward_pass", t);
+    ScopedAllocationStage stage_site(alloc_site, t);
+    updateHamiltonian(problem, t, vps[t + 1]);
+    assembleKktSystem(problem, t, vps[t + 1]);
+    BackwardRet b = computeGains(problem, t, vps[t]);
     if (b != BWD_SUCCESS) {
       return b;
     }
@@ -154,9 +212,179 @@ auto SolverProxDDP<Scalar>::backwardPass(const Problem &problem)
   return BWD_SUCCESS;
 }
 
+template <typename Scalar>
+auto SolverProxDDP<Scalar>::backwardPassParallel(const Problem &problem)
+    -> BackwardRet {
+  std::vector<RiccatiLeg> &legs = workspace_.par_legs_;
+  std::vector<VParams> &vps = workspace_.value_params;
+  const long num_legs = (long)legs.size();
+  assert(num_legs > 1);
+  assert(legs.back().end == workspace_.nsteps);
+  std::atomic<int> num_failed{0};
+  TraceBuffer *trace = workspace_.problem_data.trace;
+  const AllocationSite alloc_site = AllocationAudit::currentSite();
+
+  // 1. Factorize every leg, parametrized by the costate at its end. The last
+  // leg starts from the terminal value function and is solved exactly.
+  auto factorize_leg = [&](std::size_t k) {
+    RiccatiLeg &leg = legs[k];
+    const bool is_last = (long)k == num_legs - 1;
+    for (std::size_t t = leg.end; t-- > leg.begin;) {
+      ScopedTrace span(trace, "backward_pass", t);
+      ScopedAllocationStage stage_site(alloc_site, t);
+      const VParams &vnext =
+          (!is_last && (t + 1 == leg.end)) ? leg.zero_value : vps[t + 1];
+      updateHamiltonian(problem, t, vnext);
+      assembleKktSystem(problem, t, vnext);
+      if (computeGains(problem, t, vps[t]) != BWD_SUCCESS) {
+        num_failed++;
+        break;
+      }
+      if (!is_last)
+        computeLegSensitivities(problem, leg, t);
+    }
+  };
+  parallel_for(thread_pool_.get(), 0, (std::size_t)num_legs, factorize_leg);
+  if (num_failed > 0)
+    return BWD_WRONG_INERTIA;
+
+  // 2. Merge the legs backwards in time: this recovers the exact value
+  // function at the start of each leg.
+  for (long k = num_legs - 2; k >= 0; k--) {
+    RiccatiLeg &leg = legs[(std::size_t)k];
+    if (!mergeLeg(leg, vps[leg.end], vps[leg.begin]))
+      return BWD_WRONG_INERTIA;
+  }
+
+  // 3. Recompute the gains of every leg but the last. The value function at
+  // the start of each leg is already known: write it to scratch space, so as
+  // not to race with the previous leg.
+  auto recompute_leg = [&](std::size_t k) {
+    RiccatiLeg &leg = legs[k];
+    for (std::size_t t = leg.end; t-- > leg.begin;) {
+      ScopedTrace span(trace, "backward_pass", t);
+      ScopedAllocationStage stage_site(alloc_site, t);
+      VParams &vout = (t == leg.begin) ? leg.scratch_value : vps[t];
+      updateHamiltonian(problem, t, vps[t + 1]);
+      assembleKktSystem(problem, t, vps[t + 1]);
+      if (computeGains(problem, t, vout) != BWD_SUCCESS) {
+        num_failed++;
+        break;
+      }
+    }
+  };
+  parallel_for(thread_pool_.get(), 0, (std::size_t)num_legs - 1,
+               recompute_leg);
+  if (num_failed > 0)
+    return BWD_WRONG_INERTIA;
+  return BWD_SUCCESS;
+}
+
+template <typename Scalar>
+void SolverProxDDP<Scalar>::computeLegSensitivities(const Problem &problem,
+                                                    RiccatiLeg &leg,
+                                                    const std::size_t t) {
+  ALIGATOR_NOMALLOC_BEGIN;
+  const StageModel &stage = *problem.stages_[t];
+  const long nu = stage.nu();
+  const long ndx1 = stage.ndx1();
+  const long ndx2 = stage.ndx2();
+  const std::size_t i = t - leg.begin;
+  const bool is_leg_end = t + 1 == leg.end;
+
+  // The leg's value function at t+1 has the additional terms
+  //   x' Vxt th + 0.5 th' Vtt th + vt' th,
+  // with Vxt = I, Vtt = 0 and vt = 0 at the end of the leg.
+  MatrixXs &rhs = leg.rhs_theta[i];
+  rhs.setZero();
+  if (is_leg_end)
+    rhs.middleRows(nu, ndx2).setIdentity();
+  else
+    rhs.middleRows(nu, ndx2) = leg.Vxt[i + 1];
+
+  ALIGATOR_NOMALLOC_END;
+  visitKktSolver(t, [&](auto &&fac) { fac.solveInPlace(rhs); });
+  ALIGATOR_NOMALLOC_BEGIN;
+  // rhs now holds minus the sensitivity of the primal-dual step
+  rhs *= -1.;
+
+  ConstMatrixRef kkt_rhs = workspace_.kkt_rhs_[t + 1];
+  auto Qxw = kkt_rhs.rightCols(ndx1).transpose();
+  auto dy_theta = rhs.middleRows(nu, ndx2);
+  auto ff_y = results_.getFeedforward(t).segment(nu, ndx2);
+
+  leg.Vxt[i].noalias() = Qxw * rhs;
+  if (is_leg_end) {
+    leg.Vtt[i] = dy_theta;
+    leg.vt[i] = ff_y;
+  } else {
+    leg.Vtt[i] = leg.Vtt[i + 1];
+    leg.Vtt[i].noalias() += leg.Vxt[i + 1].transpose() * dy_theta;
+    leg.vt[i] = leg.vt[i + 1];
+    leg.vt[i].noalias() += leg.Vxt[i + 1].transpose() * ff_y;
+  }
+  ALIGATOR_NOMALLOC_END;
+}
+
+template <typename Scalar>
+bool SolverProxDDP<Scalar>::mergeLeg(RiccatiLeg &leg, const VParams &vnext,
+                                     VParams &vout) {
+  ALIGATOR_NOMALLOC_BEGIN;
+  // The exact value function at the end of the leg is the Legendre transform
+  // of V(th) = 0.5 (th - p)' P^{-1} (th - p), with P = Vxx and p = Vx:
+  // maximize the leg's value over the costate th. Writing th = P w + p, the
+  // maximizer solves (I - Vtt P) w = Vtx x + vt + Vtt p, which does not
+  // require P to be invertible (e.g. states without any cost).
+  leg.Mmat.setIdentity();
+  leg.Mmat.noalias() -= leg.Vtt[0] * vnext.Vxx_;
+  leg.Mlu.compute(leg.Mmat);
+
+  leg.MinvVtx.noalias() = leg.Mlu.solve(leg.Vxt[0].transpose());
+  leg.nvec = leg.vt[0];
+  leg.nvec.noalias() += leg.Vtt[0] * vnext.Vx_;
+  leg.Minvn.noalias() = leg.Mlu.solve(leg.nvec);
+  if (!leg.MinvVtx.allFinite() || !leg.Minvn.allFinite())
+    return false;
+
+  // sensitivity of the maximizer th to x, and its value at x = 0
+  leg.thetaVtx.noalias() = vnext.Vxx_ * leg.MinvVtx;
+  leg.theta0 = vnext.Vx_;
+  leg.theta0.noalias() += vnext.Vxx_ * leg.Minvn;
+  vout.Vxx_.noalias() += leg.Vxt[0] * leg.thetaVtx;
+  vout.Vx_.noalias() += leg.Vxt[0] * leg.theta0;
+  ALIGATOR_NOMALLOC_END;
+  return true;
+}
+
+template <typename Scalar>
+void SolverProxDDP<Scalar>::computeDerivatives(const Problem &problem) {
+  if (hess_approx_ == HessianApprox::EXACT) {
+    problem.computeDerivatives(results_.xs, results_.us, results_.lams,
+                               workspace_.problem_data);
+  } else {
+    problem.computeDerivatives(results_.xs, results_.us,
+                               workspace_.problem_data);
+  }
+}
+
+template <typename Scalar>
+void SolverProxDDP<Scalar>::computeInitialMultipliers(const VectorXs &lam0) {
+  const VectorXs &plam0 = workspace_.prev_lams[0];
+  VectorXs &shifted_constraint = workspace_.shifted_constraints[0];
+  VectorXs &lam_plus = workspace_.lams_plus[0];
+  VectorXs &lam_pdal = workspace_.lams_pdal[0];
+  const StageFunctionData &data = workspace_.problem_data.getInitData();
+  shifted_constraint = data.value_ + mu() * plam0;
+  lam_plus = shifted_constraint * mu_inv();
+  lam_pdal = shifted_constraint - 0.5 * mu() * lam0;
+  lam_pdal *= 2. * mu_inv();
+  /// TODO: generalize to the other types of initial constraint (non-equality)
+}
+
 template <typename Scalar>
 void SolverProxDDP<Scalar>::computeMultipliers(
     const Problem &problem, const std::vector<VectorXs> &lams) {
+  ScopedPhase phase(timer_, SolverPhase::MULTIPLIERS);
 
   TrajOptData &prob_data = workspace_.problem_data;
   const std::size_t nsteps = workspace_.nsteps;
@@ -164,27 +392,17 @@ void SolverProxDDP<Scalar>::computeMultipliers(
   std::vector<VectorXs> &lams_prev = workspace_.prev_lams;
   std::vector<VectorXs> &lams_plus = workspace_.lams_plus;
   std::vector<VectorXs> &lams_pdal = workspace_.lams_pdal;
-  std::vector<VectorXs> &Lds = workspace_.Lds_;
+  auto &Lds = workspace_.Lds_;
   std::vector<VectorXs> &shifted_constraints = workspace_.shifted_constraints;
 
-  // initial constraint
-  {
-    const VectorXs &lam0 = lams[0];
-    const VectorXs &plam0 = lams_prev[0];
-    StageFunctionData &data = prob_data.getInitData();
-    shifted_constraints[0] = data.value_ + mu() * plam0;
-    lams_plus[0] = shifted_constraints[0] * mu_inv();
-    lams_pdal[0] = shifted_constraints[0] - 0.5 * mu() * lam0;
-    lams_pdal[0] *= 2. * mu_inv();
-    /// TODO: generalize to the other types of initial constraint (non-equality)
-  }
+  computeInitialMultipliers(lams[0]);
 
   using FuncDataVec = std::vector<shared_ptr<StageFunctionData>>;
   auto execute_on_stack =
       [dual_weight = dual_weight](
           const ConstraintStack &stack, const VectorXs &lambda,
           const VectorXs &prevlam, VectorXs &lamplus, VectorXs &lampdal,
-          VectorXs &ld, VectorXs &shift_cvals,
+          VectorRef ld, VectorXs &shift_cvals,
           typename Workspace::VecBool &active_cstr,
           const FuncDataVec &constraint_data, CstrProximalScaler &scaler) {
         // k: constraint count variable
@@ -216,8 +434,7 @@ void SolverProxDDP<Scalar>::computeMultipliers(
       };
 
   // loop over the stages
-#pragma omp parallel for num_threads(problem.getNumThreads())
-  for (std::size_t i = 0; i < nsteps; i++) {
+  parallel_for(thread_pool_.get(), 0, nsteps, [&](std::size_t i) {
     const StageModel &stage = *problem.stages_[i];
     const StageData &sdata = *prob_data.stage_data[i];
     const ConstraintStack &cstr_stack = stage.constraints_;
@@ -231,7 +448,7 @@ void SolverProxDDP<Scalar>::computeMultipliers(
     execute_on_stack(cstr_stack, lami, plami, lamplusi, lampdali, Lds[i + 1],
                      shiftcvali, workspace_.active_constraints[i + 1],
                      sdata.constraint_data, workspace_.cstr_scalers[i]);
-  }
+  });
 
   if (!problem.term_cstrs_.empty()) {
     execute_on_stack(problem.term_cstrs_, lams.back(), lams_prev.back(),
@@ -244,11 +461,11 @@ void SolverProxDDP<Scalar>::computeMultipliers(
 
 template <typename Scalar>
 void SolverProxDDP<Scalar>::updateHamiltonian(const Problem &problem,
-                                              const std::size_t t) {
+                                              const std::size_t t,
+                                              const VParams &vnext) {
   ALIGATOR_NOMALLOC_BEGIN;
 
   const StageModel &stage = *problem.stages_[t];
-  const VParams &vnext = workspace_.value_params[t + 1];
   QParams &qparam = workspace_.q_params[t];
 
   StageData &stage_data = workspace_.problem_data.getStageData(t);
@@ -260,15 +477,21 @@ void SolverProxDDP<Scalar>::updateHamiltonian(const Problem &problem,
 
   int ndx1 = stage.ndx1();
   int nu = stage.nu();
+  int ndx2 = stage.ndx2();
   auto qpar_xu = qparam.hess_.topLeftCorner(ndx1 + nu, ndx1 + nu);
   qpar_xu = cdata.hess_;
+  // the blocks coupling with y are only written to by the vector-Hessian
+  // products: reset them, as this is called again on inertia correction
+  qparam.hess_.rightCols(ndx2).setZero();
+  qparam.hess_.bottomRows(ndx2).setZero();
   qparam.Qyy = vnext.Vxx_;
   qparam.Quu.diagonal().array() += ureg_;
 
-  const ConstraintStack &cstr_stack = stage.constraints_;
-  for (std::size_t k = 0; k < cstr_stack.size(); k++) {
-    StageFunctionData &cstr_data = *stage_data.constraint_data[k];
-    if (hess_approx_ == HessianApprox::EXACT) {
+  if (hess_approx_ == HessianApprox::EXACT) {
+    // products computed with the current multipliers in computeDerivatives()
+    const ConstraintStack &cstr_stack = stage.constraints_;
+    for (std::size_t k = 0; k < cstr_stack.size(); k++) {
+      const StageFunctionData &cstr_data = *stage_data.constraint_data[k];
       qparam.hess_ += cstr_data.vhp_buffer_;
     }
   }
@@ -300,7 +523,7 @@ void SolverProxDDP<Scalar>::computeTerminalValue(const Problem &problem) {
     const VectorXs &lamin = results_.lams[nsteps + 1];
     auto ff = results_.getFeedforward(nsteps);
     auto fb = results_.getFeedback(nsteps);
-    MatrixXs &pJx = workspace_.proj_jacobians.back();
+    MatrixRef pJx = workspace_.proj_jacobians.back();
 
     for (std::size_t k = 0; k < cstr_mgr.size(); ++k) {
       const CstrSet &cstr_set = *cstr_mgr[k].set;
@@ -321,7 +544,8 @@ void SolverProxDDP<Scalar>::computeTerminalValue(const Problem &problem) {
 
       term_value.v_ += 0.5 * mu_inv() * lamplus.squaredNorm();
       term_value.Vx_.noalias() += pJx_k.transpose() * ffk;
-      term_value.Vxx_ += cstr_data.Hxx_;
+      if (hess_approx_ == HessianApprox::EXACT)
+        term_value.Vxx_ += cstr_data.Hxx_;
       term_value.Vxx_.noalias() += pJx_k.transpose() * fbk;
     }
   }
@@ -330,14 +554,13 @@ void SolverProxDDP<Scalar>::computeTerminalValue(const Problem &problem) {
 
 template <typename Scalar>
 void SolverProxDDP<Scalar>::assembleKktSystem(const Problem &problem,
-                                              const std::size_t t) {
+                                              const std::size_t t,
+                                              const VParams &vnext) {
+  ScopedPhase phase(timer_, SolverPhase::KKT_ASSEMBLY);
   ALIGATOR_NOMALLOC_BEGIN;
-  using ColXpr = typename MatrixXs::ColXpr;
-  using ColsBlockXpr = typename MatrixXs::ColsBlockXpr;
   const StageModel &stage = *problem.stages_[t];
 
   QParams &qparam = workspace_.q_params[t];
-  const VParams &vnext = workspace_.value_params[t + 1];
 
   const StageData &stage_data = workspace_.problem_data.getStageData(t);
   const int nprim = stage.numPrimal();
@@ -348,10 +571,10 @@ void SolverProxDDP<Scalar>::assembleKktSystem(const Problem &problem,
 
   const VectorXs &laminnr = results_.lams[t + 1];
   const VectorXs &shift_cstr = workspace_.shifted_constraints[t + 1];
-  const VectorXs &Ld = workspace_.Lds_[t + 1];
+  ConstVectorRef Ld = workspace_.Lds_[t + 1];
 
-  MatrixXs &kkt_mat = workspace_.kkt_mats_[t + 1];
-  MatrixXs &kkt_rhs = workspace_.kkt_rhs_[t + 1];
+  MatrixRef kkt_mat = workspace_.kkt_mats_[t + 1];
+  MatrixRef kkt_rhs = workspace_.kkt_rhs_[t + 1];
 
   assert(kkt_mat.rows() == (nprim + ndual));
   assert(kkt_rhs.rows() == (nprim + ndual));
@@ -361,8 +584,8 @@ void SolverProxDDP<Scalar>::assembleKktSystem(const Problem &problem,
   auto kkt_prim = kkt_mat.topLeftCorner(nprim, nprim);
   auto kkt_dual = kkt_mat.bottomRightCorner(ndual, ndual);
 
-  ColXpr kkt_rhs_ff(kkt_rhs.col(0));
-  ColsBlockXpr kkt_rhs_fb(kkt_rhs.rightCols(ndx1));
+  auto kkt_rhs_ff = kkt_rhs.col(0);
+  auto kkt_rhs_fb = kkt_rhs.rightCols(ndx1);
 
   auto kkt_rhs_u = kkt_rhs_ff.head(nu);
   auto kkt_rhs_y = kkt_rhs_ff.segment(nu, ndx2);
@@ -379,15 +602,18 @@ void SolverProxDDP<Scalar>::assembleKktSystem(const Problem &problem,
   kkt_prim.topLeftCorner(nu, nu) = qparam.Quu;
   kkt_prim.bottomLeftCorner(ndx2, nu) = qparam.Quy.transpose();
   kkt_prim.topRightCorner(nu, ndx2) = qparam.Quy;
-  kkt_prim.bottomRightCorner(ndx2, ndx2) = vnext.Vxx_;
+  kkt_prim.bottomRightCorner(ndx2, ndx2) = qparam.Qyy;
 
   auto kkt_rhs_l = kkt_rhs_ff.tail(ndual);
   // memory buffer for the projected Jacobian matrix
-  MatrixXs &proj_jac = workspace_.proj_jacobians[t + 1];
+  MatrixRef proj_jac = workspace_.proj_jacobians[t + 1];
   const ConstraintStack &cstr_mgr = stage.constraints_;
   assert(cstr_mgr.totalDim() == ndual);
   const CstrProximalScaler &weight_strat = workspace_.cstr_scalers[t];
   kkt_dual.diagonal() = -weight_strat.diagMatrix();
+  // the projected Jacobian of an equality constraint is its Jacobian: if it
+  // is constant, so are its rows of the KKT system
+  char &has_constant_rows = workspace_.kkt_constant_rows_[t + 1];
 
   // Loop over constraints
   for (std::size_t j = 0; j < stage.numConstraints(); j++) {
@@ -396,73 +622,105 @@ void SolverProxDDP<Scalar>::assembleKktSystem(const Problem &problem,
     const auto shift_cstr_j = cstr_mgr.constSegmentByConstraint(shift_cstr, j);
     const auto laminnr_j = cstr_mgr.constSegmentByConstraint(laminnr, j);
 
-    // project constraint jacobian
+    // get j-th rhs dual gradient
+    auto ld_j = cstr_mgr.constSegmentByConstraint(Ld, j);
+    cstr_mgr.segmentByConstraint(kkt_rhs_l, j) = ld_j;
+
+    const bool constant_rows = cstr_mgr[j].func->hasConstantJacobians() &&
+                               dynamic_cast<const EqualitySet *>(&cstr_set);
+    if (constant_rows && has_constant_rows)
+      continue;
+
+    // project constraint jacobian: the projection acts on the rows, so it
+    // leaves the zero blocks unchanged
     auto jac_proj_j = cstr_mgr.rowsByConstraint(proj_jac, j);
     jac_proj_j = cstr_data.jac_buffer_;
-    cstr_set.applyNormalConeProjectionJacobian(shift_cstr_j, jac_proj_j);
     auto Jx_proj = jac_proj_j.leftCols(ndx1);
+    auto Ju_proj = jac_proj_j.middleCols(ndx1, nu);
+    auto Jy_proj = jac_proj_j.rightCols(ndx2);
     auto Juy_proj = jac_proj_j.rightCols(nprim);
+    const bool x_zero = cstr_data.Jx_structure_.isZero();
+    const bool u_zero = cstr_data.Ju_structure_.isZero();
+    const bool y_zero = cstr_data.Jy_structure_.isZero();
+    if (!(x_zero || u_zero || y_zero)) {
+      cstr_set.applyNormalConeProjectionJacobian(shift_cstr_j, jac_proj_j);
+    } else {
+      if (!x_zero)
+        cstr_set.applyNormalConeProjectionJacobian(shift_cstr_j, Jx_proj);
+      if (!u_zero)
+        cstr_set.applyNormalConeProjectionJacobian(shift_cstr_j, Ju_proj);
+      if (!y_zero)
+        cstr_set.applyNormalConeProjectionJacobian(shift_cstr_j, Jy_proj);
+    }
 
     cstr_mgr.rowsByConstraint(kkt_rhs_lx, j) = Jx_proj;
     cstr_mgr.rowsByConstraint(kkt_jac, j) = Juy_proj;
-
-    // get j-th rhs dual gradient
-    auto ld_j = cstr_mgr.constSegmentByConstraint(Ld, j);
-    cstr_mgr.segmentByConstraint(kkt_rhs_l, j) = ld_j;
-
-    auto Jx_orig = cstr_data.jac_buffer_.leftCols(ndx1);
-    auto Juy_orig = cstr_data.jac_buffer_.rightCols(nprim);
-    // // add correction to kkt rhs ff
-    auto kkt_rhs_prim = kkt_rhs_ff.head(nprim);
-    kkt_rhs_prim.noalias() += (Juy_orig - Juy_proj).transpose() * ld_j;
-    qparam.Qx.noalias() += (Jx_orig - Jx_proj).transpose() * ld_j;
+    if (constant_rows)
+      continue;
+
+    // add correction to kkt rhs ff
+    if (!u_zero)
+      kkt_rhs_u.noalias() += (cstr_data.Ju_ - Ju_proj).transpose() * ld_j;
+    if (!y_zero)
+      kkt_rhs_y.noalias() += (cstr_data.Jy_ - Jy_proj).transpose() * ld_j;
+    if (!x_zero)
+      qparam.Qx.noalias() += (cstr_data.Jx_ - Jx_proj).transpose() * ld_j;
   }
+  has_constant_rows = true;
   kkt_mat = kkt_mat.template selfadjointView<Eigen::Lower>();
   ALIGATOR_NOMALLOC_END;
 }
 
 template <typename Scalar>
 auto SolverProxDDP<Scalar>::computeGains(const Problem &problem,
-                                         const std::size_t t) -> BackwardRet {
+                                         const std::size_t t, VParams &vp)
+    -> BackwardRet {
   ALIGATOR_NOMALLOC_BEGIN;
   const StageModel &stage = *problem.stages_[t];
   const QParams &qparam = workspace_.q_params[t];
   const int ndx1 = stage.ndx1();
   const int ndual = stage.numDual();
-  MatrixXs &kkt_mat = workspace_.kkt_mats_[t + 1];
-  MatrixXs &kkt_rhs = workspace_.kkt_rhs_[t + 1];
-  MatrixXs &resdl = workspace_.kkt_resdls_[t + 1];
-  MatrixXs &gains = results_.gains_[t];
+  MatrixRef kkt_mat = workspace_.kkt_mats_[t + 1];
+  MatrixRef kkt_rhs = workspace_.kkt_rhs_[t + 1];
+  MatrixRef resdl = workspace_.kkt_resdls_[t + 1];
+  MatrixRef gains = results_.gains_[t];
 
-  auto &ldlt = workspace_.ldlts_[t + 1];
   ALIGATOR_NOMALLOC_END;
-  boost::apply_visitor([&](auto &&fac) { fac.compute(kkt_mat); }, ldlt);
-  ALIGATOR_NOMALLOC_BEGIN;
-
-  // check inertia
   {
-    Eigen::VectorXi signature;
-    boost::apply_visitor(proxsuite::nlp::ComputeSignatureVisitor{signature},
-                         ldlt);
-    // (n+, n-, n0)
-    std::array<int, 3> inertia = proxsuite::nlp::computeInertiaTuple(signature);
+    ScopedPhase phase(timer_, SolverPhase::FACTORIZATION);
+    visitKktSolver(t, [&](auto &&fac) { fac.compute(kkt_mat); });
+
+    // check inertia (n+, n-, n0)
+    std::array<int, 3> inertia;
+    if (!workspace_.schur_kkts_.empty()) {
+      inertia = workspace_.schur_kkts_[t].inertia();
+    } else if (!workspace_.mixed_ldlts_.empty()) {
+      inertia = workspace_.mixed_ldlts_[t].inertia();
+    } else {
+      Eigen::VectorXi signature;
+      boost::apply_visitor(proxsuite::nlp::ComputeSignatureVisitor{signature},
+                           workspace_.ldlts_[t + 1]);
+      inertia = proxsuite::nlp::computeInertiaTuple(signature);
+    }
     if ((inertia[2] > 0) || (inertia[1] != ndual)) {
       return BWD_WRONG_INERTIA;
     }
-  }
 
-  ALIGATOR_NOMALLOC_END;
-  boost::apply_visitor(
-      IterativeRefinementVisitor<Scalar>{kkt_mat, kkt_rhs, resdl, gains,
-                                         refinement_threshold_,
-                                         max_refinement_steps_},
-      ldlt);
+    // the single-precision factorization needs at least one refinement step
+    // to recover the working precision
+    const std::size_t refinement_steps =
+        workspace_.mixed_ldlts_.empty()
+            ? max_refinement_steps_
+            : std::max(max_refinement_steps_, std::size_t(1));
+    visitKktSolver(t, IterativeRefinementVisitor<Scalar>{
+                          kkt_mat, kkt_rhs, resdl, gains,
+                          refinement_threshold_, refinement_steps});
+  }
   ALIGATOR_NOMALLOC_BEGIN;
 
   /// Value function/Riccati update:
   /// provided by the Schur complement.
 
-  VParams &vp = workspace_.value_params[t];
   auto kkt_rhs_fb = kkt_rhs.rightCols(ndx1);
   auto Qxw = kkt_rhs_fb.transpose();
   auto ff = results_.getFeedforward(t);
@@ -491,6 +749,7 @@ Scalar SolverProxDDP<Scalar>::nonlinear_rollout_impl(const Problem &problem,
   const std::vector<VectorXs> &lams_prev = workspace_.prev_lams;
   std::vector<VectorXs> &dyn_slacks = workspace_.dyn_slacks;
   TrajOptData &prob_data = workspace_.problem_data;
+  const AllocationSite alloc_site = AllocationAudit::currentSite();
 
   {
     compute_dir_x0(problem);
@@ -526,8 +785,6 @@ Scalar SolverProxDDP<Scalar>::nonlinear_rollout_impl(const Problem &problem,
     dlam.noalias() += fb_lm * dxs[t];
     lams[t + 1] = results_.lams[t + 1] + dlam;
 
-    stage.evaluate(xs[t], us[t], xs[t + 1], data);
-
     // compute desired multiple-shooting gap from the multipliers
     {
       const auto &weight_strat = workspace_.cstr_scalers[t];
@@ -550,11 +807,20 @@ Scalar SolverProxDDP<Scalar>::nonlinear_rollout_impl(const Problem &problem,
     };
 
     if (!stage.has_dyn_model() || stage.dyn_model().is_explicit()) {
+      ScopedTrace span(prob_data.trace, "evaluate", t);
+      ScopedAllocationStage stage_site(alloc_site, t);
+      // the forward dynamics do not depend on the next state: evaluate them
+      // before moving it, then the other constraints at the new next state
+      stage.evaluate(xs[t], us[t], xs[t + 1], data);
       explicit_model_update_xnext();
+      stage.evaluateAtNextState(xs[t], us[t], xs[t + 1], data);
     } else {
       ConstVectorRef slack = dyn_slacks[t];
       forwardDynamics<Scalar>::run(stage.dyn_model(), xs[t], us[t], dd,
                                    xs[t + 1], slack, rollout_max_iters);
+      ScopedTrace span(prob_data.trace, "evaluate", t);
+      ScopedAllocationStage stage_site(alloc_site, t);
+      stage.evaluate(xs[t], us[t], xs[t + 1], data);
     }
 
     stage.xspace_next().difference(results_.xs[t + 1], xs[t + 1], dxs[t + 1]);
@@ -594,9 +860,11 @@ bool SolverProxDDP<Scalar>::run(const Problem &problem,
                                 const std::vector<VectorXs> &xs_init,
                                 const std::vector<VectorXs> &us_init,
                                 const std::vector<VectorXs> &lams_init) {
+  run_start_ = std::chrono::steady_clock::now();
   if (!workspace_.isInitialized() || !results_.isInitialized()) {
     ALIGATOR_RUNTIME_ERROR("workspace and results were not allocated yet!");
   }
+  ScopedAllocationAudit alloc_audit(results_.allocations);
 
   check_trajectory_and_assign(problem, xs_init, us_init, results_.xs,
                               results_.us);
@@ -620,6 +888,8 @@ bool SolverProxDDP<Scalar>::run(const Problem &problem,
   workspace_.prev_xs = results_.xs;
   workspace_.prev_us = results_.us;
   workspace_.prev_lams = results_.lams;
+  // the problem parameters may have changed since the last run
+  workspace_.invalidateEvaluations();
 
   inner_tol_ = inner_tol0;
   prim_tol_ = prim_tol0;
@@ -629,6 +899,16 @@ bool SolverProxDDP<Scalar>::run(const Problem &problem,
   prim_tol_ = std::max(prim_tol_, target_tol_);
 
   bool &conv = results_.conv = false;
+  results_.timed_out = false;
+  timer_.reset();
+  results_.timings.setZero();
+  results_.iter_timings.clear();
+
+  // the callbacks may attach a trace buffer to the problem data
+  workspace_.problem_data.trace = nullptr;
+  for (const auto &cb : callbacks_)
+    cb.second->pre_run_call(workspace_);
+  attachTrace(workspace_.problem_data.trace);
 
   results_.al_iter = 0;
   results_.num_iters = 0;
@@ -677,12 +957,23 @@ bool SolverProxDDP<Scalar>::run(const Problem &problem,
     }
     rho_penal_ *= bcl_params.rho_update_factor;
 
-    inner_tol_ = std::max(inner_tol_, 0.01 * target_tol_);
+    inner_tol_ = std::max(inner_tol_, Scalar(0.01) * target_tol_);
     prim_tol_ = std::max(prim_tol_, target_tol_);
 
     al_iter++;
   }
 
+  // phases after the last complete iteration (e.g. the convergence check)
+  if (PhaseTimer::enabled) {
+    PhaseTimings rest;
+    timer_.collect(rest);
+    results_.timings += rest;
+  }
+
+  for (const auto &cb : callbacks_)
+    cb.second->post_run_call(workspace_, results_);
+  attachTrace(nullptr);
+
   logger.finish(conv);
   return conv;
 }
@@ -702,26 +993,76 @@ void SolverProxDDP<Scalar>::update_tols_on_success() {
 template <typename Scalar>
 Scalar SolverProxDDP<Scalar>::forwardPass(const Problem &problem,
                                           const Scalar alpha) {
-  switch (rollout_type_) {
-  case RolloutType::LINEAR:
-    forward_linear_impl(problem, workspace_, results_, alpha);
-    break;
-  case RolloutType::NONLINEAR:
-    nonlinear_rollout_impl(problem, alpha);
-    break;
-  default:
-    assert(false && "unknown RolloutType!");
-    break;
+  {
+    ScopedPhase phase(timer_, SolverPhase::EVALUATE);
+    switch (rollout_type_) {
+    case RolloutType::LINEAR:
+      forward_linear_impl(problem, workspace_, results_, alpha);
+      break;
+    case RolloutType::NONLINEAR:
+      nonlinear_rollout_impl(problem, alpha);
+      break;
+    default:
+      assert(false && "unknown RolloutType!");
+      break;
+    }
   }
   computeMultipliers(problem, workspace_.trial_lams);
   return PDALFunction<Scalar>::evaluate(*this, problem, workspace_.trial_lams,
                                         workspace_);
 }
 
+template <typename Scalar>
+Scalar SolverProxDDP<Scalar>::batchedLinesearch(const Problem &problem,
+                                                const Scalar phi0,
+                                                const Scalar dphi0,
+                                                Scalar &alpha_opt) {
+  using LinesearchTrial = typename Workspace::LinesearchTrial;
+  std::vector<LinesearchTrial> &trials = workspace_.ls_trials_;
+  const std::size_t num_trials = trials.size();
+  const Scalar beta = ls_params.contraction_min;
+  TraceBuffer *trace = workspace_.problem_data.trace;
+  Scalar alpha = 1.;
+
+  while (true) {
+    for (LinesearchTrial &trial : trials) {
+      trial.alpha = alpha;
+      alpha *= beta;
+    }
+
+    // the expensive part: one problem evaluation per trial point
+    parallel_for(thread_pool_.get(), 0, num_trials, [&](std::size_t k) {
+      ScopedPhase trial_phase(timer_, SolverPhase::LINESEARCH_TRIAL);
+      ScopedPhase eval_phase(timer_, SolverPhase::EVALUATE);
+      ScopedTrace span(trace, "linesearch_trial", results_.num_iters);
+      LinesearchTrial &trial = trials[k];
+      forward_linear_impl(problem, workspace_, results_, trial.alpha, trial.xs,
+                          trial.us, trial.lams, trial.problem_data);
+    });
+
+    // merit function, from the largest step size down
+    for (LinesearchTrial &trial : trials) {
+      workspace_.swapTrial(trial);
+      computeMultipliers(problem, workspace_.trial_lams);
+      const Scalar phi = PDALFunction<Scalar>::evaluate(
+          *this, problem, workspace_.trial_lams, workspace_);
+      alpha_opt = trial.alpha;
+      if ((phi <= phi0 + ls_params.armijo_c1 * alpha_opt * dphi0) ||
+          (alpha_opt <= ls_params.alpha_min)) {
+        return phi;
+      }
+      workspace_.swapTrial(trial);
+    }
+  }
+}
+
 template <typename Scalar>
 bool SolverProxDDP<Scalar>::innerLoop(const Problem &problem) {
 
   auto merit_eval_fun = [&](Scalar a0) -> Scalar {
+    ScopedPhase phase(timer_, SolverPhase::LINESEARCH_TRIAL);
+    ScopedTrace span(workspace_.problem_data.trace, "linesearch_trial",
+                     results_.num_iters);
     return forwardPass(problem, a0);
   };
 
@@ -729,21 +1070,35 @@ bool SolverProxDDP<Scalar>::innerLoop(const Problem &problem) {
 
   std::size_t &iter = results_.num_iters;
   std::size_t inner_step = 0;
-  results_.traj_cost_ =
-      problem.evaluate(results_.xs, results_.us, workspace_.problem_data);
+  // after the first inner loop, the problem data was last evaluated at the
+  // current iterate; the derivatives of the first iteration are computed
+  // together with the evaluation
+  if (results_.al_iter == 0) {
+    ScopedPhase phase(timer_, SolverPhase::EVALUATE);
+    results_.traj_cost_ = problem.evaluateWithDerivatives(
+        results_.xs, results_.us, workspace_.problem_data);
+  }
   computeMultipliers(problem, results_.lams);
   results_.merit_value_ =
       PDALFunction<Scalar>::evaluate(*this, problem, results_.lams, workspace_);
 
   for (; iter < max_iters; iter++) {
-    // ASSUMPTION: last evaluation in previous iterate
-    // was during linesearch, at the current candidate solution (x,u).
-    /// TODO: make this smarter using e.g. some caching mechanism
-    problem.computeDerivatives(results_.xs, results_.us,
-                               workspace_.problem_data);
+    if (checkTimeBudget())
+      return false;
+    // The last evaluation was during the linesearch, at the current iterate:
+    // the stage derivatives reuse it (see StageDataTpl::isEvaluatedAt()).
+    {
+      ScopedPhase phase(timer_, SolverPhase::DERIVATIVES);
+      computeDerivatives(problem);
+    }
     const Scalar phi0 = results_.merit_value_;
+    if (checkTimeBudget())
+      return false;
 
-    computeLagrangianDerivatives(problem, workspace_, results_.lams);
+    {
+      ScopedPhase phase(timer_, SolverPhase::LAGRANGIAN_DERIVATIVES);
+      computeLagrangianDerivatives(problem, workspace_, results_.lams);
+    }
     if (force_initial_condition_) {
       workspace_.Lxs_[0].setZero();
     }
@@ -754,23 +1109,12 @@ bool SolverProxDDP<Scalar>::innerLoop(const Problem &problem) {
     if (outer_crit <= target_tol_)
       return true;
 
-    // attempt backward pass until successful
-    // i.e. no inertia problems
     initialize_regularization();
-    while (true) {
-      BackwardRet b = backwardPass(problem);
-      switch (b) {
-      case BWD_SUCCESS:
-        break;
-      case BWD_WRONG_INERTIA: {
-        if (xreg_ >= reg_max)
-          return false;
-        increase_regularization();
-        continue;
-      }
-      }
-      break; // if you broke from the switch
-    }
+    if (!backwardPassRegularized(problem))
+      return false;
+    // the gains are now those of the current iterate
+    if (checkTimeBudget())
+      return false;
 
     bool inner_conv = (workspace_.inner_criterion <= inner_tol_);
     if (inner_conv && (inner_step > 0))
@@ -788,12 +1132,19 @@ bool SolverProxDDP<Scalar>::innerLoop(const Problem &problem) {
 
     // otherwise continue linesearch
     Scalar alpha_opt = 1;
-    Scalar phi_new = linesearch_.run(merit_eval_fun, phi0, dphi0, alpha_opt);
+    Scalar phi_new;
+    if (!workspace_.ls_trials_.empty() &&
+        rollout_type_ == RolloutType::LINEAR) {
+      phi_new = batchedLinesearch(problem, phi0, dphi0, alpha_opt);
+    } else {
+      phi_new = linesearch_.run(merit_eval_fun, phi0, dphi0, alpha_opt);
+    }
 
-    // accept the step
-    results_.xs = workspace_.trial_xs;
-    results_.us = workspace_.trial_us;
-    results_.lams = workspace_.trial_lams;
+    // accept the step: swap the buffers, the trial point is overwritten by
+    // the next linesearch anyway
+    results_.xs.swap(workspace_.trial_xs);
+    results_.us.swap(workspace_.trial_us);
+    results_.lams.swap(workspace_.trial_lams);
     results_.traj_cost_ = workspace_.problem_data.cost_;
     results_.merit_value_ = phi_new;
     ALIGATOR_RAISE_IF_NAN_NAME(alpha_opt, "alpha_opt");
@@ -818,6 +1169,7 @@ bool SolverProxDDP<Scalar>::innerLoop(const Problem &problem) {
       increase_regularization();
     }
     invokeCallbacks(workspace_, results_);
+    recordIterationTimings();
     logger.log(iter_log);
 
     xreg_last_ = xreg_;
@@ -826,6 +1178,169 @@ bool SolverProxDDP<Scalar>::innerLoop(const Problem &problem) {
   return false;
 }
 
+template <typename Scalar>
+bool SolverProxDDP<Scalar>::backwardPassRegularized(const Problem &problem) {
+  ScopedPhase phase(timer_, SolverPhase::BACKWARD_PASS);
+  // attempt backward pass until successful
+  // i.e. no inertia problems
+  while (true) {
+    ScopedPhase retry(timer_, SolverPhase::INERTIA_RETRY);
+    BackwardRet b = backwardPass(problem);
+    switch (b) {
+    case BWD_SUCCESS:
+      retry.dismiss();
+      break;
+    case BWD_WRONG_INERTIA: {
+      if (xreg_ >= reg_max)
+        return false;
+      increase_regularization();
+      continue;
+    }
+    }
+    break; // if you broke from the switch
+  }
+  return true;
+}
+
+template <typename Scalar>
+bool SolverProxDDP<Scalar>::prepareRTI(const Problem &problem) {
+  if (!workspace_.isInitialized() || !results_.isInitialized()) {
+    ALIGATOR_RUNTIME_ERROR("workspace and results were not allocated yet!");
+  }
+
+  workspace_.prev_xs = results_.xs;
+  workspace_.prev_us = results_.us;
+  workspace_.prev_lams = results_.lams;
+  workspace_.invalidateEvaluations();
+
+  {
+    ScopedPhase phase(timer_, SolverPhase::EVALUATE);
+    results_.traj_cost_ = problem.evaluateWithDerivatives(
+        results_.xs, results_.us, workspace_.problem_data);
+  }
+  computeMultipliers(problem, results_.lams);
+  results_.merit_value_ =
+      PDALFunction<Scalar>::evaluate(*this, problem, results_.lams, workspace_);
+  {
+    ScopedPhase phase(timer_, SolverPhase::DERIVATIVES);
+    computeDerivatives(problem);
+  }
+
+  {
+    ScopedPhase phase(timer_, SolverPhase::LAGRANGIAN_DERIVATIVES);
+    computeLagrangianDerivatives(problem, workspace_, results_.lams);
+  }
+  if (force_initial_condition_) {
+    workspace_.Lxs_[0].setZero();
+  }
+  computeInfeasibilities(problem);
+  computeCriterion(problem);
+
+  initialize_regularization();
+  if (!backwardPassRegularized(problem))
+    return false;
+  xreg_last_ = xreg_;
+  return true;
+}
+
+template <typename Scalar>
+Scalar SolverProxDDP<Scalar>::feedbackRTI(const Problem &problem) {
+  // only the initial condition changed since the preparation phase
+  problem.init_condition_->evaluate(results_.xs[0],
+                                    workspace_.problem_data.getInitData());
+  computeInitialMultipliers(results_.lams[0]);
+  if (force_initial_condition_) {
+    workspace_.trial_xs[0] = problem.getInitState();
+  }
+  // the nonlinear rollout computes dx0 itself
+  if (rollout_type_ == RolloutType::LINEAR)
+    linearRollout(problem);
+  const Scalar phi_new = forwardPass(problem, 1.);
+
+  results_.xs.swap(workspace_.trial_xs);
+  results_.us.swap(workspace_.trial_us);
+  results_.lams.swap(workspace_.trial_lams);
+  results_.traj_cost_ = workspace_.problem_data.cost_;
+  results_.merit_value_ = phi_new;
+  results_.num_iters++;
+  invokeCallbacks(workspace_, results_);
+  recordIterationTimings();
+  return phi_new;
+}
+
+template <typename Scalar>
+void SolverProxDDP<Scalar>::cycleProblem(Problem &problem,
+                                         const shared_ptr<StageModel> &stage,
+                                         shared_ptr<StageData> data) {
+  if (!workspace_.isInitialized() || !results_.isInitialized()) {
+    ALIGATOR_RUNTIME_ERROR("workspace and results were not allocated yet!");
+  }
+  if (stage == nullptr)
+    ALIGATOR_RUNTIME_ERROR("Input stage is null.");
+  if (problem.numSteps() != workspace_.nsteps)
+    ALIGATOR_RUNTIME_ERROR("Problem does not match the workspace.");
+  if (problem.numSteps() == 0)
+    return;
+
+  {
+    const StageModel &first = *problem.stages_[0];
+    if ((stage->ndx1() != first.ndx1()) || (stage->nu() != first.nu()) ||
+        (stage->ndx2() != first.ndx2()) ||
+        (stage->constraints_.getDims() != first.constraints_.getDims())) {
+      ALIGATOR_RUNTIME_ERROR("The appended stage does not have the dimensions "
+                             "of the dropped stage.");
+    }
+  }
+  // the stage data is created by the cost and constraint functions: that of
+  // the dropped stage is valid for any stage sharing them
+  const StageModel &dropped = *problem.stages_[0];
+  bool reuse_data = stage->cost_ == dropped.cost_;
+  for (std::size_t j = 0; reuse_data && j < dropped.numConstraints(); j++) {
+    reuse_data = stage->constraints_[j].func == dropped.constraints_[j].func;
+  }
+  if (data == nullptr) {
+    data = reuse_data ? workspace_.problem_data.stage_data[0]
+                      : stage->createData();
+  }
+
+  problem.replaceStageCircular(stage);
+  workspace_.cycleAppend(data);
+  results_.cycleLeft();
+
+  const std::size_t nsteps = workspace_.nsteps;
+  workspace_.cstr_scalers[nsteps - 1].rebind(stage->constraints_);
+  if (!reuse_data) {
+    for (auto &trial : workspace_.ls_trials_)
+      trial.problem_data.stage_data.back() = stage->createData();
+  }
+
+  // the legs only depend on the stage dimensions: reallocate them if these
+  // moved across leg boundaries
+  auto leg_matches = [&](const RiccatiLeg &leg) {
+    if (leg.ntheta != problem.stages_[leg.end - 1]->ndx2())
+      return false;
+    for (std::size_t t = leg.begin; t < leg.end; t++) {
+      const StageModel &st = *problem.stages_[t];
+      const std::size_t k = t - leg.begin;
+      if ((leg.rhs_theta[k].rows() != st.numPrimal() + st.numDual()) ||
+          (leg.Vxt[k].rows() != st.ndx1()))
+        return false;
+    }
+    return true;
+  };
+  std::vector<RiccatiLeg> &legs = workspace_.par_legs_;
+  for (const RiccatiLeg &leg : legs) {
+    if (!leg_matches(leg)) {
+      std::size_t depth = 0;
+      while ((std::size_t(1) << depth) < legs.size())
+        depth++;
+      workspace_.configureParallelRiccati(problem, depth);
+      break;
+    }
+  }
+  workspace_.invalidateEvaluations();
+}
+
 template <typename Scalar>
 void SolverProxDDP<Scalar>::computeInfeasibilities(const Problem &problem) {
   // modifying quantities such as Qu, Qy... is allowed
@@ -853,13 +1368,12 @@ void SolverProxDDP<Scalar>::computeInfeasibilities(const Problem &problem) {
   };
 
   // compute infeasibility of all stage constraints
-#pragma omp parallel for num_threads(problem.getNumThreads())
-  for (std::size_t i = 0; i < nsteps; i++) {
+  parallel_for(thread_pool_.get(), 0, nsteps, [&](std::size_t i) {
     const StageModel &stage = *problem.stages_[i];
     VectorXs &stage_infeas = workspace_.stage_prim_infeas[i + 1];
     execute_on_stack(stage.constraints_, lams_plus[i + 1], lams_prev[i + 1],
                      stage_infeas, workspace_.cstr_scalers[i]);
-  }
+  });
 
   // compute infeasibility of terminal constraints
   if (!problem.term_cstrs_.empty()) {
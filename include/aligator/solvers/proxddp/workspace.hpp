@@ -6,6 +6,10 @@
 #include "aligator/core/workspace-base.hpp"
 #include "aligator/core/proximal-penalty.hpp"
 #include "aligator/core/alm-weights.hpp"
+#include "aligator/parlqr/parlqr.hpp"
+#include "aligator/utils/matrix-arena.hpp"
+#include "./schur-kkt.hpp"
+#include "./mixed-precision-ldlt.hpp"
 
 #include <array>
 #include <proxsuite-nlp/ldlt-allocator.hpp>
@@ -14,6 +18,50 @@ namespace aligator {
 
 using proxsuite::nlp::LDLTChoice;
 
+/// @brief Storage for a leg (sub-horizon) of the parallel Riccati recursion.
+/// @details The leg covers the stages @f$ [b, e) @f$. In the first sweep, it is
+/// factorized independently of the rest of the horizon, by replacing the value
+/// function at @f$ e @f$ with the linear term @f$ \theta^\top x_e @f$; the
+/// sensitivities of the leg's value function w.r.t. the costate parameter
+/// @f$ \theta @f$ are stored here, and used to merge the legs afterwards.
+template <typename Scalar> struct RiccatiLegTpl {
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  using VParams = ValueFunctionTpl<Scalar>;
+
+  /// First stage of the leg.
+  std::size_t begin;
+  /// One-past-the-last stage of the leg.
+  std::size_t end;
+  /// Dimension of the costate parameter \f$\theta\f$.
+  long ntheta;
+  /// Placeholder value function at the end of the leg.
+  VParams zero_value;
+  /// Output buffer for the value function at the first stage of the leg.
+  VParams scratch_value;
+
+  /// @name Parametric sensitivities, for each stage of the leg
+  /// @{
+  std::vector<MatrixXs> rhs_theta;
+  std::vector<MatrixXs> Vxt;
+  std::vector<MatrixXs> Vtt;
+  std::vector<VectorXs> vt;
+  /// @}
+
+  /// @name Buffers for merging with the next leg
+  /// @{
+  MatrixXs Mmat;
+  MatrixXs MinvVtx;
+  MatrixXs thetaVtx;
+  VectorXs nvec;
+  VectorXs Minvn;
+  VectorXs theta0;
+  Eigen::PartialPivLU<MatrixXs> Mlu;
+  /// @}
+
+  RiccatiLegTpl(const TrajOptProblemTpl<Scalar> &problem, std::size_t begin,
+                std::size_t end);
+};
+
 /** @brief Workspace for solver SolverProxDDP.
  *
  * @details This struct holds data for the Riccati forward and backward passes,
@@ -25,6 +73,8 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
   using Base = WorkspaceBaseTpl<Scalar>;
   using VecBool = Eigen::Matrix<bool, Eigen::Dynamic, 1>;
   using CstrProxScaler = ConstraintProximalScalerTpl<Scalar>;
+  using MatrixArena = MatrixArenaTpl<Scalar>;
+  using VectorArena = VectorArenaTpl<Scalar>;
 
   using Base::dyn_slacks;
   using Base::nsteps;
@@ -39,9 +89,9 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
 
   /// @name Lagrangian Gradients
   /// @{
-  std::vector<VectorXs> Lxs_;
-  std::vector<VectorXs> Lus_;
-  std::vector<VectorXs> Lds_;
+  VectorArena Lxs_;
+  VectorArena Lus_;
+  VectorArena Lds_;
   /// @}
 
   /// Lagrange multipliers for ALM & linesearch.
@@ -50,7 +100,8 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
   std::vector<VectorXs> lams_pdal;
   /// Shifted constraints the projection operators should be applied to.
   std::vector<VectorXs> shifted_constraints;
-  std::vector<MatrixXs> proj_jacobians;
+  /// Projected constraint Jacobians.
+  MatrixArena proj_jacobians;
   std::vector<VecBool> active_constraints;
 
   /// @name Riccati gains, memory buffers for primal-dual steps
@@ -61,11 +112,16 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
   std::vector<VectorRef> dlams;
 
   /// Buffer for KKT matrix
-  std::vector<MatrixXs> kkt_mats_;
+  MatrixArena kkt_mats_;
   /// Buffer for KKT right hand side
-  std::vector<MatrixXs> kkt_rhs_;
+  MatrixArena kkt_rhs_;
   /// Linear system residual buffers: used for iterative refinement
-  std::vector<MatrixXs> kkt_resdls_;
+  MatrixArena kkt_resdls_;
+  /// Whether the rows of each KKT system (indexed as kkt_mats_) from the
+  /// equality constraints with constant Jacobians were assembled: they are
+  /// not assembled again. This is a char per stage, so that stages can be
+  /// assembled concurrently.
+  std::vector<char> kkt_constant_rows_;
 
   using LDLTVariant = proxsuite::nlp::LDLTVariant<Scalar>;
   /// LDLT solvers
@@ -73,6 +129,27 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
 
   /// @}
 
+  /// Structured KKT solvers, one per stage (empty if unused).
+  std::vector<SchurKktSolverTpl<Scalar>> schur_kkts_;
+  /// Single-precision KKT solvers, one per stage (empty if unused).
+  std::vector<MixedPrecisionLDLTTpl<Scalar>> mixed_ldlts_;
+
+  /// Legs for the parallel Riccati backward pass (empty if unused).
+  std::vector<RiccatiLegTpl<Scalar>> par_legs_;
+
+  /// @brief Buffers for a trial point of the batched linesearch.
+  struct LinesearchTrial {
+    /// Step size.
+    Scalar alpha = 1.;
+    std::vector<VectorXs> xs;
+    std::vector<VectorXs> us;
+    std::vector<VectorXs> lams;
+    TrajOptDataTpl<Scalar> problem_data;
+  };
+  /// Trial points of the batched linesearch, evaluated concurrently (empty if
+  /// unused).
+  std::vector<LinesearchTrial> ls_trials_;
+
   /// @name Previous external/proximal iterates
   /// @{
 
@@ -105,6 +182,50 @@ template <typename Scalar> struct WorkspaceTpl : WorkspaceBaseTpl<Scalar> {
 
   void cycleLeft() override;
 
+  /// @brief Forget the assembled KKT rows of the constant constraints, e.g.
+  /// when the parameters of the problem may have changed.
+  void resetConstantKktRows() {
+    std::fill(kkt_constant_rows_.begin(), kkt_constant_rows_.end(), false);
+  }
+
+  /// @brief Forget the evaluations of the problem data and of the linesearch
+  /// trials, and the assembled KKT rows of the constant constraints: the
+  /// constant derivatives are computed again.
+  void invalidateEvaluations() {
+    problem_data.invalidateEvaluations();
+    for (LinesearchTrial &trial : ls_trials_)
+      trial.problem_data.invalidateEvaluations();
+    resetConstantKktRows();
+  }
+
+  /// @brief Allocate the structured KKT solvers (SchurKktSolverTpl) for each
+  /// stage, to be used instead of the LDLT factorizations.
+  void configureSchurKktSolvers(const TrajOptProblemTpl<Scalar> &problem);
+  /// @brief Allocate the single-precision stage KKT solvers.
+  void
+  configureMixedPrecisionKktSolvers(const TrajOptProblemTpl<Scalar> &problem);
+
+  /// @brief Split the horizon into @f$ 2^d @f$ legs for the parallel Riccati
+  /// backward pass, where @f$ d @f$ is @p depth (clamped to the depth of the
+  /// LQRTree over the stages). A single leg disables the parallel pass.
+  void configureParallelRiccati(const TrajOptProblemTpl<Scalar> &problem,
+                                std::size_t depth);
+
+  /// @brief Allocate @p num_trials trial points for the batched linesearch.
+  /// Less than two trial points disables it.
+  void configureLinesearchBatch(const TrajOptProblemTpl<Scalar> &problem,
+                                std::size_t num_trials);
+
+  /// @brief Exchange the buffers of @p trial with the trial point of the
+  /// workspace (trial_xs, trial_us, trial_lams and problem_data). This does
+  /// not copy nor allocate.
+  void swapTrial(LinesearchTrial &trial) {
+    trial_xs.swap(trial.xs);
+    trial_us.swap(trial.us);
+    trial_lams.swap(trial.lams);
+    std::swap(problem_data, trial.problem_data);
+  }
+
   template <typename T>
   friend std::ostream &operator<<(std::ostream &oss,
                                   const WorkspaceTpl<T> &self);
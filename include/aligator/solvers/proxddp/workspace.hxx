@@ -21,39 +21,50 @@ WorkspaceTpl<Scalar>::WorkspaceTpl(const TrajOptProblemTpl<Scalar> &problem,
     : Base(problem), stage_inner_crits(nsteps + 1),
       stage_dual_infeas(nsteps + 1) {
 
-  Lxs_.reserve(nsteps + 1);
-  Lus_.reserve(nsteps);
+  // sizes of the Lagrangian gradients, allocated in one go below
+  std::vector<long> lx_sizes;
+  std::vector<long> lu_sizes;
+  std::vector<long> ld_sizes;
+  lx_sizes.reserve(nsteps + 1);
+  lu_sizes.reserve(nsteps);
+  ld_sizes.reserve(nsteps + 2);
 
   prev_xs = trial_xs;
   prev_us = trial_us;
-  kkt_mats_.reserve(nsteps + 1);
-  kkt_rhs_.reserve(nsteps + 1);
   stage_prim_infeas.reserve(nsteps + 1);
   ldlts_.reserve(nsteps + 1);
 
   active_constraints.resize(nsteps + 1);
   lams_plus.resize(nsteps + 1);
-  proj_jacobians.reserve(nsteps + 2);
   pd_step_.resize(nsteps + 1);
   dxs.reserve(nsteps + 1);
   dus.reserve(nsteps);
   dlams.reserve(nsteps + 1);
   dyn_slacks.reserve(nsteps);
 
+  // dimensions of the matrix buffers, allocated in one go below
+  std::vector<std::array<long, 2>> kkt_dims;
+  std::vector<std::array<long, 2>> rhs_dims;
+  std::vector<std::array<long, 2>> pjac_dims;
+  kkt_dims.reserve(nsteps + 1);
+  rhs_dims.reserve(nsteps + 1);
+  pjac_dims.reserve(nsteps + 2);
+
   {
     const int ndx1 = problem.init_condition_->ndx1;
     const int nprim = ndx1;
     const int ndual = problem.init_condition_->nr;
     const int ntot = nprim + ndual;
 
-    kkt_mats_.emplace_back(ntot, ntot);
-    kkt_rhs_.emplace_back(ntot, ndx1 + 1);
+    kkt_dims.push_back({ntot, ntot});
+    rhs_dims.push_back({ntot, ndx1 + 1});
     stage_prim_infeas.emplace_back(1);
     ldlts_.emplace_back(proxsuite::nlp::allocate_ldlt_from_sizes<Scalar>(
         {ndx1}, {ndual}, ldlt_choice));
 
     lams_plus[0] = VectorXs::Zero(ndual);
-    proj_jacobians.emplace_back(ndual, ndx1);
+    ld_sizes.push_back(ndual);
+    pjac_dims.push_back({ndual, ndx1});
     active_constraints[0] = VecBool::Zero(ndual);
     pd_step_[0] = VectorXs::Zero(ntot);
     dxs.emplace_back(pd_step_[0].head(ndx1));
@@ -71,20 +82,21 @@ WorkspaceTpl<Scalar>::WorkspaceTpl(const TrajOptProblemTpl<Scalar> &problem,
     const int ntot = nprim + ndual;
     const std::size_t ncb = stage.numConstraints();
 
-    Lxs_.emplace_back(ndx1);
-    Lus_.emplace_back(nu);
+    lx_sizes.push_back(ndx1);
+    lu_sizes.push_back(nu);
 
     value_params.emplace_back(ndx1);
     q_params.emplace_back(ndx1, nu, ndx2);
 
-    kkt_mats_.emplace_back(ntot, ntot);
-    kkt_rhs_.emplace_back(ntot, ndx1 + 1);
+    kkt_dims.push_back({ntot, ntot});
+    rhs_dims.push_back({ntot, ndx1 + 1});
     ldlts_.emplace_back(proxsuite::nlp::allocate_ldlt_from_sizes<Scalar>(
         {nu, ndx2}, stage.constraints_.getDims(), ldlt_choice));
     stage_prim_infeas.emplace_back(ncb);
 
     lams_plus[i + 1] = VectorXs::Zero(ndual);
-    proj_jacobians.emplace_back(ndual, ndx1 + nprim);
+    ld_sizes.push_back(ndual);
+    pjac_dims.push_back({ndual, ndx1 + nprim});
     active_constraints[i + 1] = VecBool::Zero(ndual);
     pd_step_[i + 1] = VectorXs::Zero(ntot);
     dus.emplace_back(pd_step_[i + 1].head(nu));
@@ -95,7 +107,7 @@ WorkspaceTpl<Scalar>::WorkspaceTpl(const TrajOptProblemTpl<Scalar> &problem,
 
   {
     const int ndx2 = problem.term_cost_->ndx();
-    Lxs_.emplace_back(ndx2);
+    lx_sizes.push_back(ndx2);
     value_params.emplace_back(ndx2);
   }
 
@@ -105,26 +117,28 @@ WorkspaceTpl<Scalar>::WorkspaceTpl(const TrajOptProblemTpl<Scalar> &problem,
     const long ndual = problem.term_cstrs_.totalDim();
     stage_prim_infeas.emplace_back(1);
     lams_plus.push_back(VectorXs::Zero(ndual));
-    proj_jacobians.emplace_back(ndual, ndx1);
+    ld_sizes.push_back(ndual);
+    pjac_dims.push_back({ndual, ndx1});
     active_constraints.push_back(VecBool::Zero(ndual));
     pd_step_.push_back(VectorXs::Zero(ndual));
     dlams.push_back(pd_step_.back().tail(ndual));
   }
 
-  math::setZero(Lxs_);
-  math::setZero(Lus_);
+  Lxs_ = VectorArena(lx_sizes);
+  Lus_ = VectorArena(lu_sizes);
+  Lds_ = VectorArena(ld_sizes);
 
   math::setZero(lams_plus);
   lams_pdal = lams_plus;
   trial_lams = lams_plus;
   prev_lams = lams_plus;
-  Lds_ = prev_lams;
   shifted_constraints = lams_plus;
 
-  math::setZero(kkt_mats_);
-  math::setZero(kkt_rhs_);
-  math::setZero(proj_jacobians);
-  kkt_resdls_ = kkt_rhs_;
+  kkt_mats_ = MatrixArena(kkt_dims);
+  kkt_rhs_ = MatrixArena(rhs_dims);
+  kkt_resdls_ = MatrixArena(rhs_dims);
+  kkt_constant_rows_.assign(kkt_dims.size(), false);
+  proj_jacobians = MatrixArena(pjac_dims);
 
   stage_inner_crits.setZero();
   stage_dual_infeas.setZero();
@@ -134,43 +148,139 @@ WorkspaceTpl<Scalar>::WorkspaceTpl(const TrajOptProblemTpl<Scalar> &problem,
   assert(dus.size() == nsteps);
 }
 
+template <typename Scalar>
+RiccatiLegTpl<Scalar>::RiccatiLegTpl(const TrajOptProblemTpl<Scalar> &problem,
+                                     std::size_t begin, std::size_t end)
+    : begin(begin), end(end), ntheta(problem.stages_[end - 1]->ndx2()),
+      zero_value((int)ntheta), scratch_value(problem.stages_[begin]->ndx1()),
+      Mmat(ntheta, ntheta), nvec(ntheta), Minvn(ntheta), theta0(ntheta),
+      Mlu(ntheta) {
+  assert(begin < end);
+  zero_value.v_ = 0.;
+  const std::size_t n = end - begin;
+  rhs_theta.reserve(n);
+  Vxt.reserve(n);
+  Vtt.reserve(n);
+  vt.reserve(n);
+  for (std::size_t t = begin; t < end; t++) {
+    const StageModelTpl<Scalar> &stage = *problem.stages_[t];
+    const int ntot = stage.numPrimal() + stage.numDual();
+    rhs_theta.push_back(MatrixXs::Zero(ntot, ntheta));
+    Vxt.push_back(MatrixXs::Zero(stage.ndx1(), ntheta));
+    Vtt.push_back(MatrixXs::Zero(ntheta, ntheta));
+    vt.push_back(VectorXs::Zero(ntheta));
+  }
+  const int ndx = problem.stages_[begin]->ndx1();
+  MinvVtx.setZero(ntheta, ndx);
+  thetaVtx.setZero(ntheta, ndx);
+}
+
+template <typename Scalar>
+void WorkspaceTpl<Scalar>::configureSchurKktSolvers(
+    const TrajOptProblemTpl<Scalar> &problem) {
+  schur_kkts_.clear();
+  schur_kkts_.reserve(nsteps);
+  for (std::size_t t = 0; t < nsteps; t++) {
+    const StageModel &stage = *problem.stages_[t];
+    schur_kkts_.emplace_back(stage.nu(), stage.ndx2(), stage.numDual(),
+                             stage.ndx1() + 1);
+  }
+}
+
+template <typename Scalar>
+void WorkspaceTpl<Scalar>::configureMixedPrecisionKktSolvers(
+    const TrajOptProblemTpl<Scalar> &problem) {
+  mixed_ldlts_.clear();
+  mixed_ldlts_.reserve(nsteps);
+  for (std::size_t t = 0; t < nsteps; t++) {
+    const StageModel &stage = *problem.stages_[t];
+    mixed_ldlts_.emplace_back(stage.numPrimal() + stage.numDual(),
+                              stage.ndx1() + 1);
+  }
+}
+
+template <typename Scalar>
+void WorkspaceTpl<Scalar>::configureParallelRiccati(
+    const TrajOptProblemTpl<Scalar> &problem, std::size_t depth) {
+  par_legs_.clear();
+  if (nsteps == 0)
+    return;
+  LQRTree<Scalar> tree(nsteps);
+  depth = std::min(depth, tree.maxDepth());
+  const std::size_t num_legs = tree.numNodesAtDepth(depth);
+  if (num_legs < 2)
+    return;
+  par_legs_.reserve(num_legs);
+  for (std::size_t k = 0; k < num_legs; k++) {
+    const auto range = tree.getNodeRange(depth, k);
+    par_legs_.emplace_back(problem, range[0], range[1]);
+  }
+}
+
+template <typename Scalar>
+void WorkspaceTpl<Scalar>::configureLinesearchBatch(
+    const TrajOptProblemTpl<Scalar> &problem, std::size_t num_trials) {
+  ls_trials_.clear();
+  if (num_trials < 2)
+    return;
+  ls_trials_.resize(num_trials);
+  for (LinesearchTrial &trial : ls_trials_) {
+    trial.xs = trial_xs;
+    trial.us = trial_us;
+    trial.lams = trial_lams;
+    trial.problem_data = TrajOptDataTpl<Scalar>(problem);
+  }
+}
+
 template <typename Scalar> void WorkspaceTpl<Scalar>::cycleLeft() {
   Base::cycleLeft();
 
-  rotate_vec_left(cstr_scalers);
-  rotate_vec_left(Lxs_);
-  rotate_vec_left(Lus_);
-  rotate_vec_left(Lds_);
-
   // number of "tail" multipliers that shouldn't be in the cycle
   long n_tail = 1;
   if (lams_plus.size() < (nsteps + 2)) {
     n_tail = 0;
   }
 
+  rotate_vec_left(cstr_scalers, 0, n_tail);
+  Lxs_.rotateLeft();
+  Lus_.rotateLeft();
+  Lds_.rotateLeft(1, n_tail);
+
   rotate_vec_left(trial_lams, 1, n_tail);
   rotate_vec_left(lams_plus, 1, n_tail);
   rotate_vec_left(lams_pdal, 1, n_tail);
   rotate_vec_left(shifted_constraints, 1, n_tail);
-  rotate_vec_left(proj_jacobians, 1, n_tail);
+  proj_jacobians.rotateLeft(1, n_tail);
   rotate_vec_left(active_constraints, 1, n_tail);
 
+  // the step views follow the buffers of pd_step_
   rotate_vec_left(pd_step_, 1, n_tail);
-  rotate_vec_left(dxs);
+  rotate_vec_left(dxs, 1);
   rotate_vec_left(dus);
   rotate_vec_left(dlams, 1, n_tail);
 
-  rotate_vec_left(kkt_mats_, 1);
-  rotate_vec_left(kkt_rhs_, 1);
-  rotate_vec_left(kkt_resdls_, 1);
-  // rotate_vec_left(ldlts_, 1);
-  // std::rotate(ldlts_.begin(), ldlts_.begin() + 2, ldlts_.end());
+  kkt_mats_.rotateLeft(1);
+  kkt_rhs_.rotateLeft(1);
+  kkt_resdls_.rotateLeft(1);
+  // the KKT system of the last stage is for the new stage
+  rotate_vec_left(kkt_constant_rows_, 1);
+  kkt_constant_rows_.back() = false;
+  rotate_vec_left(ldlts_, 1);
+  rotate_vec_left(schur_kkts_);
+  rotate_vec_left(mixed_ldlts_);
 
   rotate_vec_left(prev_xs);
   rotate_vec_left(prev_us);
   rotate_vec_left(prev_lams, 1, n_tail);
 
   rotate_vec_left(stage_prim_infeas, 1, n_tail);
+
+  for (LinesearchTrial &trial : ls_trials_) {
+    rotate_vec_left(trial.problem_data.stage_data);
+    rotate_vec_left(trial.xs);
+    rotate_vec_left(trial.us);
+    rotate_vec_left(trial.lams, 1, n_tail);
+  }
 }
 
 template <typename Scalar>
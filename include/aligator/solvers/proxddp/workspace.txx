@@ -5,6 +5,7 @@
 
 namespace aligator {
 
+extern template struct RiccatiLegTpl<context::Scalar>;
 extern template struct WorkspaceTpl<context::Scalar>;
 
 } // namespace aligator
@@ -0,0 +1,157 @@
+/// @file
+/// @brief Auditing of the heap allocations made during the solver runs.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/utils/timings.hpp"
+
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace aligator {
+
+/// Number and total size of heap allocations.
+struct AllocationCount {
+  std::size_t count = 0;
+  std::size_t bytes = 0;
+
+  AllocationCount &operator+=(const AllocationCount &other) {
+    count += other.count;
+    bytes += other.bytes;
+    return *this;
+  }
+};
+
+/// Where the heap allocations of a thread are attributed to.
+struct AllocationSite {
+  static constexpr std::size_t npos = std::size_t(-1);
+  /// Index of the SolverPhase, or NUM_SOLVER_PHASES outside of any phase.
+  std::size_t phase = NUM_SOLVER_PHASES;
+  /// Stage index, or npos.
+  std::size_t stage = npos;
+  /// Mangled type name of the function (or cost) being called, or nullptr.
+  const char *function = nullptr;
+};
+
+/// @brief Heap allocations made during a solver run, by phase and by site.
+struct AllocationReport {
+  struct Entry {
+    std::size_t phase;
+    std::size_t stage;
+    /// Demangled type name of the function, or empty.
+    std::string function;
+    AllocationCount allocs;
+  };
+
+  AllocationCount total;
+  /// Allocations per SolverPhase; the last entry counts the allocations made
+  /// outside of any phase.
+  std::array<AllocationCount, NUM_SOLVER_PHASES + 1> by_phase{};
+  /// Allocations per site (phase, stage and function), by decreasing count.
+  std::vector<Entry> sites;
+  /// Whether some sites are missing from #sites, because there were too many
+  /// of them. The totals are still exact.
+  bool truncated = false;
+
+  /// Whether the run did not allocate at all.
+  bool allocationFree() const { return total.count == 0; }
+
+  void clear() {
+    total = AllocationCount{};
+    by_phase.fill(AllocationCount{});
+    sites.clear();
+    truncated = false;
+  }
+};
+
+std::ostream &operator<<(std::ostream &oss, const AllocationReport &self);
+
+/// @brief Process-wide counting of the heap allocations (malloc and
+/// operator new), attributed to the current AllocationSite of each thread.
+/// @details Only available if aligator was compiled with
+/// ALIGATOR_ENABLE_ALLOCATION_AUDIT (CMake option ENABLE_ALLOCATION_AUDIT),
+/// which replaces the allocation functions of the process (on glibc,
+/// malloc and its variants; elsewhere, only operator new). Otherwise, the
+/// reports are always empty and the scopes below compile to nothing.
+///
+/// Allocations of every thread are counted while an audit is running, so
+/// concurrent runs (e.g. SolverProxDDPBatch) share their counts. Unlike
+/// ALIGATOR_NOMALLOC_BEGIN, this covers the whole run, including the stage
+/// functions, the linear solvers and the callbacks.
+class AllocationAudit {
+public:
+#ifdef ALIGATOR_ENABLE_ALLOCATION_AUDIT
+  static constexpr bool enabled = true;
+
+  /// Start counting; the counters are reset unless an audit is running.
+  static void begin();
+  /// Write the allocations counted since the outermost begin() to @p out,
+  /// and stop counting if this ends the outermost audit.
+  static void end(AllocationReport &out);
+  /// The site the allocations of the calling thread are attributed to.
+  static AllocationSite currentSite();
+  /// Set the site of the calling thread, return the previous one.
+  static AllocationSite exchangeSite(const AllocationSite &site);
+#else
+  static constexpr bool enabled = false;
+
+  static void begin() {}
+  static void end(AllocationReport &out) { out.clear(); }
+  static AllocationSite currentSite() { return {}; }
+#endif
+};
+
+/// @brief Audit the allocations of a scope, e.g. a solver run.
+class ScopedAllocationAudit {
+public:
+  explicit ScopedAllocationAudit(AllocationReport &out) : out_(out) {
+    AllocationAudit::begin();
+  }
+  ~ScopedAllocationAudit() { AllocationAudit::end(out_); }
+
+private:
+  AllocationReport &out_;
+};
+
+/// @brief Attribute the allocations of a scope to a stage, in the phase of
+/// @p parent. The parent site is passed explicitly, so that the phase is kept
+/// on the threads of a ThreadPool.
+class ScopedAllocationStage {
+public:
+#ifdef ALIGATOR_ENABLE_ALLOCATION_AUDIT
+  ScopedAllocationStage(const AllocationSite &parent, std::size_t stage) {
+    AllocationSite site;
+    site.phase = parent.phase;
+    site.stage = stage;
+    prev_ = AllocationAudit::exchangeSite(site);
+  }
+  ~ScopedAllocationStage() { AllocationAudit::exchangeSite(prev_); }
+
+private:
+  AllocationSite prev_;
+#else
+  ScopedAllocationStage(const AllocationSite &, std::size_t) {}
+#endif
+};
+
+/// @brief Attribute the allocations of a scope to the type of @p function, in
+/// the current phase and stage.
+class ScopedAllocationFunction {
+public:
+#ifdef ALIGATOR_ENABLE_ALLOCATION_AUDIT
+  template <typename T> explicit ScopedAllocationFunction(const T &function) {
+    AllocationSite site = AllocationAudit::currentSite();
+    site.function = typeid(function).name();
+    prev_ = AllocationAudit::exchangeSite(site);
+  }
+  ~ScopedAllocationFunction() { AllocationAudit::exchangeSite(prev_); }
+
+private:
+  AllocationSite prev_;
+#else
+  template <typename T> explicit ScopedAllocationFunction(const T &) {}
+#endif
+};
+
+} // namespace aligator
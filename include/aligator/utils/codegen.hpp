@@ -0,0 +1,262 @@
+/// @file
+/// @brief Symbolic tracing of functions, and compilation of their derivatives
+/// to C code loaded at runtime.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace aligator {
+namespace codegen {
+
+enum class OpCode : std::uint8_t {
+  VARIABLE,
+  CONSTANT,
+  ADD,
+  SUB,
+  MUL,
+  DIV,
+  NEG,
+  SQRT,
+  EXP,
+  LOG,
+  SIN,
+  COS,
+  TAN,
+  TANH,
+  POW,
+  ABS,
+  SIGN
+};
+
+/// @brief Expression graph recorded by SymbolicScalar operations.
+/// @details Nodes only refer to previous nodes. Identical nodes are shared,
+/// and constant expressions are folded. The derivatives are built as new
+/// nodes of the same tape, by reverse accumulation.
+class Tape {
+public:
+  struct Node {
+    OpCode op;
+    int a;
+    int b;
+    /// Value of a constant, or index of a variable.
+    double value;
+  };
+
+  /// Node of the variable @p index (the input of the generated functions).
+  int variable(int index);
+  int constant(double c);
+  int unary(OpCode op, int a);
+  int binary(OpCode op, int a, int b);
+
+  const Node &operator[](int id) const { return nodes_[std::size_t(id)]; }
+  std::size_t size() const { return nodes_.size(); }
+  bool isConstant(int id, double c) const {
+    const Node &n = (*this)[id];
+    return n.op == OpCode::CONSTANT && n.value == c;
+  }
+
+  /// Gradient of the node @p out with respect to the first @p num_vars
+  /// variables.
+  std::vector<int> gradient(int out, int num_vars);
+  /// Jacobian of the @p outputs, stored column-major.
+  std::vector<int> jacobian(const std::vector<int> &outputs, int num_vars);
+  /// Hessian of the sum of the @p outputs weighted by @p weights, with
+  /// respect to the first @p num_vars variables, stored column-major.
+  std::vector<int> weightedHessian(const std::vector<int> &outputs,
+                                   const std::vector<int> &weights,
+                                   int num_vars);
+
+  /// @brief Write a C function `void name(const real *in, real *out)`
+  /// computing the @p outputs, where `real` is a typedef of the generated
+  /// source (see emitHeader()).
+  void emitFunction(std::ostream &os, const std::string &name,
+                    const std::vector<int> &outputs) const;
+  /// Write the includes and typedef of a C source file.
+  static void emitHeader(std::ostream &os, const char *real_type);
+
+private:
+  int push(const Node &node);
+  std::vector<Node> nodes_;
+  std::unordered_map<std::string, int> cache_;
+};
+
+/// @brief Scalar type recording the operations made on it to a Tape.
+/// @details A scalar without a tape is a constant. Use it to trace functors
+/// templated on their scalar type, as for ForwardDiffFunctionTpl.
+class SymbolicScalar {
+public:
+  SymbolicScalar() : SymbolicScalar(0.) {}
+  SymbolicScalar(double c) : tape_(nullptr), id_(-1), value_(c) {}
+  SymbolicScalar(Tape *tape, int id) : tape_(tape), id_(id), value_(0.) {}
+
+  static SymbolicScalar variable(Tape &tape, int index) {
+    return {&tape, tape.variable(index)};
+  }
+
+  bool isConstant() const { return tape_ == nullptr; }
+  /// Value of a constant scalar.
+  double value() const { return value_; }
+  /// Node of the scalar in @p tape (constants are added to it).
+  int node(Tape &tape) const { return tape_ ? id_ : tape.constant(value_); }
+
+  SymbolicScalar &operator+=(const SymbolicScalar &o) {
+    return *this = *this + o;
+  }
+  SymbolicScalar &operator-=(const SymbolicScalar &o) {
+    return *this = *this - o;
+  }
+  SymbolicScalar &operator*=(const SymbolicScalar &o) {
+    return *this = *this * o;
+  }
+  SymbolicScalar &operator/=(const SymbolicScalar &o) {
+    return *this = *this / o;
+  }
+
+  friend SymbolicScalar operator+(const SymbolicScalar &a,
+                                  const SymbolicScalar &b) {
+    return binary(OpCode::ADD, a, b);
+  }
+  friend SymbolicScalar operator-(const SymbolicScalar &a,
+                                  const SymbolicScalar &b) {
+    return binary(OpCode::SUB, a, b);
+  }
+  friend SymbolicScalar operator*(const SymbolicScalar &a,
+                                  const SymbolicScalar &b) {
+    return binary(OpCode::MUL, a, b);
+  }
+  friend SymbolicScalar operator/(const SymbolicScalar &a,
+                                  const SymbolicScalar &b) {
+    return binary(OpCode::DIV, a, b);
+  }
+  friend SymbolicScalar operator-(const SymbolicScalar &a) {
+    return unary(OpCode::NEG, a);
+  }
+  friend SymbolicScalar operator+(const SymbolicScalar &a) { return a; }
+
+  friend SymbolicScalar sqrt(const SymbolicScalar &a) {
+    return unary(OpCode::SQRT, a);
+  }
+  friend SymbolicScalar exp(const SymbolicScalar &a) {
+    return unary(OpCode::EXP, a);
+  }
+  friend SymbolicScalar log(const SymbolicScalar &a) {
+    return unary(OpCode::LOG, a);
+  }
+  friend SymbolicScalar sin(const SymbolicScalar &a) {
+    return unary(OpCode::SIN, a);
+  }
+  friend SymbolicScalar cos(const SymbolicScalar &a) {
+    return unary(OpCode::COS, a);
+  }
+  friend SymbolicScalar tan(const SymbolicScalar &a) {
+    return unary(OpCode::TAN, a);
+  }
+  friend SymbolicScalar tanh(const SymbolicScalar &a) {
+    return unary(OpCode::TANH, a);
+  }
+  friend SymbolicScalar abs(const SymbolicScalar &a) {
+    return unary(OpCode::ABS, a);
+  }
+  friend SymbolicScalar pow(const SymbolicScalar &a, const SymbolicScalar &b) {
+    return binary(OpCode::POW, a, b);
+  }
+
+private:
+  static SymbolicScalar unary(OpCode op, const SymbolicScalar &a);
+  static SymbolicScalar binary(OpCode op, const SymbolicScalar &a,
+                               const SymbolicScalar &b);
+
+  Tape *tape_;
+  int id_;
+  double value_;
+};
+
+/// Name of the C type corresponding to @p Scalar.
+template <typename Scalar> const char *c_type_name();
+template <> inline const char *c_type_name<double>() { return "double"; }
+template <> inline const char *c_type_name<float>() { return "float"; }
+
+/// Options of the compilation of generated code.
+struct CompileOptions {
+  /// Directory of the compiled libraries, created if needed. If empty, the
+  /// environment variable ALIGATOR_CODEGEN_CACHE_DIR is used, or
+  /// `$XDG_CACHE_HOME/aligator-codegen` (by default
+  /// `~/.cache/aligator-codegen`). It must be owned by the current user and
+  /// not writable by other users.
+  std::string cache_dir;
+  /// C compiler. If empty, the environment variable CC is used, or `cc`.
+  /// This and the flags are split at whitespace and run without a shell.
+  std::string compiler;
+  std::string flags = "-O2";
+};
+
+/// @brief Shared library compiled from generated C source.
+/// @details The library is cached on disk under a hash of its source and
+/// compilation command: it is only compiled the first time. Only available on
+/// POSIX systems.
+class CompiledLibrary {
+public:
+  template <typename Scalar>
+  using Function = void (*)(const Scalar *in, Scalar *out);
+
+  CompiledLibrary(const std::string &source,
+                  const CompileOptions &options = CompileOptions());
+  ~CompiledLibrary();
+  CompiledLibrary(const CompiledLibrary &) = delete;
+  CompiledLibrary &operator=(const CompiledLibrary &) = delete;
+
+  /// Path of the shared library.
+  const std::string &path() const { return path_; }
+
+  /// Address of the generated function @p name.
+  template <typename Scalar> Function<Scalar> function(const char *name) const {
+    return reinterpret_cast<Function<Scalar>>(symbol(name));
+  }
+
+private:
+  void *symbol(const char *name) const;
+  void *handle_;
+  std::string path_;
+};
+
+} // namespace codegen
+} // namespace aligator
+
+namespace Eigen {
+template <>
+struct NumTraits<aligator::codegen::SymbolicScalar> : NumTraits<double> {
+  using Real = aligator::codegen::SymbolicScalar;
+  using NonInteger = aligator::codegen::SymbolicScalar;
+  using Nested = aligator::codegen::SymbolicScalar;
+  using Literal = aligator::codegen::SymbolicScalar;
+  enum {
+    IsComplex = 0,
+    IsInteger = 0,
+    IsSigned = 1,
+    RequireInitialization = 1,
+    ReadCost = 1,
+    AddCost = 1,
+    MulCost = 1
+  };
+};
+
+template <typename BinaryOp>
+struct ScalarBinaryOpTraits<aligator::codegen::SymbolicScalar, double,
+                            BinaryOp> {
+  using ReturnType = aligator::codegen::SymbolicScalar;
+};
+
+template <typename BinaryOp>
+struct ScalarBinaryOpTraits<double, aligator::codegen::SymbolicScalar,
+                            BinaryOp> {
+  using ReturnType = aligator::codegen::SymbolicScalar;
+};
+} // namespace Eigen
@@ -0,0 +1,149 @@
+/// @file
+/// @brief Contiguous storage for a family of dynamic-size matrices.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include "aligator/math.hpp"
+
+#include <array>
+#include <type_traits>
+#include <vector>
+#include <algorithm>
+
+namespace aligator {
+
+/// @brief Stores a sequence of matrices of (possibly different) sizes in a
+/// single aligned buffer, and hands out per-element views.
+///
+/// @details This replaces a `std::vector<MatrixXs>` where every element is a
+/// separate heap allocation: the whole family is allocated once, and sweeping
+/// over the elements in order walks memory linearly. Each block starts on an
+/// `EIGEN_MAX_ALIGN_BYTES` boundary so that the views keep vectorized access.
+///
+/// Views are computed on access from the block table; they stay valid as long
+/// as the arena is neither destroyed nor reassigned. Swapping or moving an
+/// arena does not move the data: views keep pointing to the same elements,
+/// which now belong to the other arena.
+///
+/// @tparam _Cols Number of columns of every element, if fixed. Set it to 1
+/// for a family of vectors (see VectorArenaTpl).
+template <typename _Scalar, int _Cols = Eigen::Dynamic> class MatrixArenaTpl {
+public:
+  using Scalar = _Scalar;
+  ALIGATOR_DYNAMIC_TYPEDEFS(Scalar);
+  static constexpr int Cols = _Cols;
+  using PlainType = Eigen::Matrix<Scalar, Eigen::Dynamic, Cols>;
+  /// Alignment of each block, in number of scalars.
+  static constexpr Eigen::Index Alignment =
+      std::max<Eigen::Index>(EIGEN_MAX_ALIGN_BYTES / sizeof(Scalar), 1);
+  static constexpr int MapOptions =
+      (EIGEN_MAX_ALIGN_BYTES % sizeof(Scalar) == 0) ? Eigen::AlignedMax
+                                                     : Eigen::Unaligned;
+  using MapType = Eigen::Map<PlainType, MapOptions>;
+  using ConstMapType = Eigen::Map<const PlainType, MapOptions>;
+
+  MatrixArenaTpl() = default;
+  MatrixArenaTpl(const MatrixArenaTpl &) = default;
+  MatrixArenaTpl(MatrixArenaTpl &&) = default;
+  MatrixArenaTpl &operator=(const MatrixArenaTpl &) = default;
+  MatrixArenaTpl &operator=(MatrixArenaTpl &&) = default;
+
+  /// @brief Allocate the arena and zero-initialize it.
+  /// @param dims (rows, cols) for each of the elements.
+  explicit MatrixArenaTpl(const std::vector<std::array<long, 2>> &dims) {
+    blocks_.reserve(dims.size());
+    Eigen::Index offset = 0;
+    for (const auto &d : dims) {
+      assert((d[0] >= 0) && (d[1] >= 0));
+      assert((Cols == Eigen::Dynamic) || (d[1] == Cols));
+      blocks_.push_back({offset, d[0], d[1]});
+      offset += alignedSize(d[0] * d[1]);
+    }
+    data_.setZero(offset);
+  }
+
+  /// @brief Allocate an arena of vectors and zero-initialize it.
+  /// @param sizes Size of each of the elements.
+  template <int C = Cols, typename = std::enable_if_t<C == 1>>
+  explicit MatrixArenaTpl(const std::vector<long> &sizes) {
+    blocks_.reserve(sizes.size());
+    Eigen::Index offset = 0;
+    for (const long n : sizes) {
+      assert(n >= 0);
+      blocks_.push_back({offset, n, 1});
+      offset += alignedSize(n);
+    }
+    data_.setZero(offset);
+  }
+
+  std::size_t size() const { return blocks_.size(); }
+  bool empty() const { return blocks_.empty(); }
+  /// Total number of scalars allocated, including padding.
+  Eigen::Index capacity() const { return data_.size(); }
+
+  MapType operator[](std::size_t i) {
+    assert(i < blocks_.size());
+    const Block &b = blocks_[i];
+    return MapType(data_.data() + b.offset, b.rows, b.cols);
+  }
+
+  ConstMapType operator[](std::size_t i) const {
+    assert(i < blocks_.size());
+    const Block &b = blocks_[i];
+    return ConstMapType(data_.data() + b.offset, b.rows, b.cols);
+  }
+
+  MapType back() { return (*this)[size() - 1]; }
+  ConstMapType back() const { return (*this)[size() - 1]; }
+
+  void setZero() { data_.setZero(); }
+
+  /// @brief Exchange the contents with another arena, in constant time and
+  /// without allocating.
+  void swap(MatrixArenaTpl &other) {
+    data_.swap(other.data_);
+    blocks_.swap(other.blocks_);
+  }
+
+  friend void swap(MatrixArenaTpl &lhs, MatrixArenaTpl &rhs) { lhs.swap(rhs); }
+
+  /// @brief Rotate the elements to the left, leaving @p n_head elements at the
+  /// head and @p n_tail at the tail in place. Only the block table is permuted,
+  /// the data does not move.
+  /// @sa rotate_vec_left()
+  void rotateLeft(long n_head = 0, long n_tail = 0) {
+    if ((long)size() - n_head - n_tail < 2)
+      return;
+    auto beg = std::next(blocks_.begin(), n_head);
+    auto end = std::prev(blocks_.end(), n_tail);
+    std::rotate(beg, beg + 1, end);
+  }
+
+  /// Copy the elements out into separately allocated matrices.
+  std::vector<PlainType> toVector() const {
+    std::vector<PlainType> out;
+    out.reserve(size());
+    for (std::size_t i = 0; i < size(); i++)
+      out.emplace_back((*this)[i]);
+    return out;
+  }
+
+private:
+  struct Block {
+    Eigen::Index offset;
+    Eigen::Index rows;
+    Eigen::Index cols;
+  };
+
+  static Eigen::Index alignedSize(Eigen::Index n) {
+    return (n + Alignment - 1) / Alignment * Alignment;
+  }
+
+  VectorXs data_;
+  std::vector<Block> blocks_;
+};
+
+/// @brief A family of vectors stored in a single buffer.
+template <typename Scalar> using VectorArenaTpl = MatrixArenaTpl<Scalar, 1>;
+
+} // namespace aligator
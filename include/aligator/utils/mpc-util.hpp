@@ -5,6 +5,8 @@
 
 #include <vector>
 #include <algorithm>
+#include <new>
+#include <Eigen/Core>
 
 namespace aligator {
 
@@ -13,12 +15,37 @@ namespace aligator {
 /// @tparam Alloc
 /// @param  n_head The length of the vector (at the head) to keep.
 /// @param  n_tail The length of the vector (at the tail ) to keep.
+/// @details Does nothing if less than two elements are to be rotated (e.g. the
+/// vector is empty).
 template <typename T, typename Alloc>
 void rotate_vec_left(std::vector<T, Alloc> &v, long n_head = 0,
                      long n_tail = 0) {
+  if ((long)v.size() - n_head - n_tail < 2)
+    return;
   auto beg = std::next(v.begin(), n_head);
   auto end = std::prev(v.end(), n_tail);
   std::rotate(beg, beg + 1, end);
 }
 
+/// @brief Overload for a std::vector of Eigen::Ref. Assigning an Eigen::Ref
+/// copies the referenced data, so std::rotate would shuffle the data between
+/// the underlying buffers; here the references themselves are rotated.
+template <typename PlainType, int Options, typename StrideType, typename Alloc>
+void rotate_vec_left(
+    std::vector<Eigen::Ref<PlainType, Options, StrideType>, Alloc> &v,
+    long n_head = 0, long n_tail = 0) {
+  using RefType = Eigen::Ref<PlainType, Options, StrideType>;
+  const long end = (long)v.size() - n_tail;
+  if (end - n_head < 2)
+    return;
+  const RefType first(v[(std::size_t)n_head]);
+  auto rebind = [&v](long i, const RefType &r) {
+    v[(std::size_t)i].~RefType();
+    ::new (&v[(std::size_t)i]) RefType(r);
+  };
+  for (long i = n_head; i < end - 1; i++)
+    rebind(i, v[(std::size_t)i + 1]);
+  rebind(end - 1, first);
+}
+
 } // namespace aligator
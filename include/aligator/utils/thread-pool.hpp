@@ -0,0 +1,133 @@
+/// @file
+/// @brief Persistent thread pool with work stealing.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace aligator {
+
+/// @brief A persistent pool of threads running parallel loops, with work
+/// stealing.
+///
+/// @details parallelFor() splits a loop into chunks, which are spread over
+/// per-thread queues. Each thread runs the chunks of its own queue, then
+/// steals from the other queues, so that uneven iteration costs are balanced
+/// out. The calling thread takes part in the loop: a pool of size @p n has
+/// n - 1 worker threads, which sleep when there is no work.
+///
+/// A thread waiting for a loop to finish keeps running chunks from the queues.
+/// This makes nested calls to parallelFor() safe: e.g. a batch of solves, each
+/// running its own parallel loops, can share a single pool without
+/// oversubscribing the cores. The pool can also be used from several threads
+/// at once.
+class ThreadPool {
+public:
+  /// @param num_threads  Number of threads running the loops, including the
+  /// calling thread.
+  /// @param pin_threads  Pin each worker thread to a distinct core (only on
+  /// Linux).
+  explicit ThreadPool(std::size_t num_threads, bool pin_threads = false);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ~ThreadPool();
+
+  /// Number of threads running the loops, including the calling thread.
+  std::size_t size() const { return num_threads_; }
+
+  /// @brief Call @p f(i) for every i in [begin, end), in parallel.
+  /// @details Returns once all iterations have run. If iterations throw, the
+  /// other iterations still run and the first exception is rethrown.
+  /// @param grain  Number of iterations per chunk. The default (zero) makes
+  /// about four chunks per thread.
+  template <typename F>
+  void parallelFor(std::size_t begin, std::size_t end, F &&f,
+                   std::size_t grain = 0);
+
+private:
+  /// A parallel loop, stored on the stack of the thread which started it.
+  struct Job {
+    void (*invoke)(void *, std::size_t, std::size_t);
+    void *fn;
+    std::atomic<std::size_t> pending{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+  };
+  /// A chunk [begin, end) of a parallel loop.
+  struct Task {
+    Job *job;
+    std::size_t begin;
+    std::size_t end;
+  };
+  struct Queue;
+
+  /// Queue the chunks of @p job, and run chunks until all of them are done.
+  void runJob(Job &job, std::size_t begin, std::size_t end,
+              std::size_t grain);
+  /// Run one chunk, from queue @p self or stolen from another queue.
+  /// @returns false if all the queues are empty.
+  bool runOneTask(std::size_t self);
+  void workerLoop(std::size_t id);
+  /// Queue of the calling thread: its own if it is a worker of this pool,
+  /// the shared queue 0 otherwise.
+  std::size_t currentQueue() const;
+
+  std::size_t num_threads_;
+  bool pin_threads_;
+  std::unique_ptr<Queue[]> queues_;
+  std::vector<std::thread> workers_;
+  /// Number of chunks waiting in the queues.
+  std::atomic<std::size_t> num_queued_{0};
+  std::mutex sleep_mtx_;
+  std::condition_variable wake_;
+  bool stop_ = false;
+};
+
+template <typename F>
+void ThreadPool::parallelFor(std::size_t begin, std::size_t end, F &&f,
+                             std::size_t grain) {
+  if (begin >= end)
+    return;
+  const std::size_t n = end - begin;
+  if (grain == 0)
+    grain = std::max(std::size_t(1), n / (4 * num_threads_));
+  if ((num_threads_ == 1) || (n <= grain)) {
+    for (std::size_t i = begin; i < end; i++)
+      f(i);
+    return;
+  }
+
+  using Fn = std::remove_reference_t<F>;
+  Job job;
+  job.fn = const_cast<void *>(static_cast<const void *>(std::addressof(f)));
+  job.invoke = [](void *fn, std::size_t b, std::size_t e) {
+    Fn &g = *static_cast<Fn *>(fn);
+    for (std::size_t i = b; i < e; i++)
+      g(i);
+  };
+  runJob(job, begin, end, grain);
+}
+
+/// @brief Call @p f(i) for every i in [begin, end), on @p pool if it is
+/// non-null, sequentially otherwise.
+template <typename F>
+void parallel_for(ThreadPool *pool, std::size_t begin, std::size_t end,
+                  F &&f) {
+  if (pool) {
+    pool->parallelFor(begin, end, std::forward<F>(f));
+    return;
+  }
+  for (std::size_t i = begin; i < end; i++)
+    f(i);
+}
+
+} // namespace aligator
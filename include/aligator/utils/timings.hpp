@@ -0,0 +1,195 @@
+/// @file
+/// @brief Instrumentation of the phases of the solvers.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+namespace aligator {
+
+/// Phases of a solver iteration whose wall time and number of calls are
+/// recorded. Phases can be nested, e.g. linesearch trials include the problem
+/// evaluation; phases a solver does not have are left at zero.
+enum struct SolverPhase : std::size_t {
+  /// Problem evaluation (rollouts).
+  EVALUATE,
+  /// Problem derivatives.
+  DERIVATIVES,
+  /// Derivatives of the Lagrangian (SolverProxDDP).
+  LAGRANGIAN_DERIVATIVES,
+  /// Multiplier estimates (SolverProxDDP).
+  MULTIPLIERS,
+  /// Backward pass, including the retries with increased regularization.
+  BACKWARD_PASS,
+  /// Assembly of the stage KKT systems (SolverProxDDP).
+  KKT_ASSEMBLY,
+  /// Factorization and solution of the stage KKT systems (SolverProxDDP).
+  FACTORIZATION,
+  /// Backward passes which failed due to the inertia of a KKT system, and
+  /// were retried with increased regularization (SolverProxDDP).
+  INERTIA_RETRY,
+  /// Linesearch trials, one per step size.
+  LINESEARCH_TRIAL,
+  /// Callbacks.
+  CALLBACKS
+};
+
+constexpr std::size_t NUM_SOLVER_PHASES = 10;
+
+inline const char *phase_name(SolverPhase phase) {
+  static constexpr std::array<const char *, NUM_SOLVER_PHASES> names = {
+      "evaluate",      "derivatives",   "lagrangian_derivatives",
+      "multipliers",   "backward_pass", "kkt_assembly",
+      "factorization", "inertia_retry", "linesearch_trial",
+      "callbacks"};
+  return names[static_cast<std::size_t>(phase)];
+}
+
+/// @brief Wall time (in seconds) and number of calls of each SolverPhase.
+/// @details The time of a phase run in parallel (e.g. the KKT assembly in the
+/// parallel backward pass) is summed over the threads.
+struct PhaseTimings {
+  std::array<double, NUM_SOLVER_PHASES> seconds{};
+  std::array<std::size_t, NUM_SOLVER_PHASES> calls{};
+
+  double time(SolverPhase phase) const {
+    return seconds[static_cast<std::size_t>(phase)];
+  }
+  std::size_t numCalls(SolverPhase phase) const {
+    return calls[static_cast<std::size_t>(phase)];
+  }
+
+  void setZero() {
+    seconds.fill(0.);
+    calls.fill(0);
+  }
+
+  PhaseTimings &operator+=(const PhaseTimings &other) {
+    for (std::size_t k = 0; k < NUM_SOLVER_PHASES; k++) {
+      seconds[k] += other.seconds[k];
+      calls[k] += other.calls[k];
+    }
+    return *this;
+  }
+};
+
+inline std::ostream &operator<<(std::ostream &oss, const PhaseTimings &self) {
+  oss << "PhaseTimings {";
+  for (std::size_t k = 0; k < NUM_SOLVER_PHASES; k++) {
+    if (self.calls[k] == 0)
+      continue;
+    oss << "\n  " << phase_name(static_cast<SolverPhase>(k)) << ": "
+        << self.seconds[k] << " s (" << self.calls[k] << " calls),";
+  }
+  return oss << "\n}";
+}
+
+/// @brief Thread-safe accumulator of PhaseTimings, owned by a solver.
+/// @details The phases are only recorded if aligator was compiled with
+/// ALIGATOR_ENABLE_TIMINGS (CMake option ENABLE_SOLVER_TIMINGS); otherwise
+/// ScopedPhase compiles to nothing.
+class PhaseTimer {
+public:
+#ifdef ALIGATOR_ENABLE_TIMINGS
+  static constexpr bool enabled = true;
+#else
+  static constexpr bool enabled = false;
+#endif
+
+  PhaseTimer() { reset(); }
+  PhaseTimer(const PhaseTimer &other) { *this = other; }
+  PhaseTimer &operator=(const PhaseTimer &other) {
+    for (std::size_t k = 0; k < NUM_SOLVER_PHASES; k++) {
+      nanoseconds_[k].store(other.nanoseconds_[k].load());
+      calls_[k].store(other.calls_[k].load());
+    }
+    return *this;
+  }
+
+  void add(SolverPhase phase, std::chrono::steady_clock::duration elapsed) {
+    const auto k = static_cast<std::size_t>(phase);
+    nanoseconds_[k].fetch_add(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+        std::memory_order_relaxed);
+    calls_[k].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void reset() {
+    for (std::size_t k = 0; k < NUM_SOLVER_PHASES; k++) {
+      nanoseconds_[k].store(0, std::memory_order_relaxed);
+      calls_[k].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  /// Write the timings recorded since the last reset() to @p out, and reset.
+  void collect(PhaseTimings &out) {
+    for (std::size_t k = 0; k < NUM_SOLVER_PHASES; k++) {
+      out.seconds[k] = 1e-9 * double(nanoseconds_[k].exchange(0));
+      out.calls[k] = calls_[k].exchange(0);
+    }
+  }
+
+private:
+  std::array<std::atomic<std::int64_t>, NUM_SOLVER_PHASES> nanoseconds_;
+  std::array<std::atomic<std::size_t>, NUM_SOLVER_PHASES> calls_;
+};
+
+#ifdef ALIGATOR_ENABLE_ALLOCATION_AUDIT
+namespace detail {
+/// Set the phase the heap allocations of the calling thread are attributed to
+/// (see AllocationAudit), return the previous one.
+std::size_t exchange_allocation_phase(std::size_t phase);
+} // namespace detail
+#endif
+
+/// @brief Record the duration of a scope as a call of @p phase.
+/// @details With ALIGATOR_ENABLE_ALLOCATION_AUDIT, the heap allocations of the
+/// scope are also attributed to @p phase.
+class ScopedPhase {
+public:
+  ScopedPhase(PhaseTimer &timer, SolverPhase phase)
+#ifdef ALIGATOR_ENABLE_TIMINGS
+      : timer_(&timer), phase_(phase),
+        start_(std::chrono::steady_clock::now())
+#endif
+  {
+    (void)timer;
+#ifdef ALIGATOR_ENABLE_ALLOCATION_AUDIT
+    prev_alloc_phase_ =
+        detail::exchange_allocation_phase(static_cast<std::size_t>(phase));
+#else
+    (void)phase;
+#endif
+  }
+  ~ScopedPhase() {
+#ifdef ALIGATOR_ENABLE_TIMINGS
+    if (timer_)
+      timer_->add(phase_, std::chrono::steady_clock::now() - start_);
+#endif
+#ifdef ALIGATOR_ENABLE_ALLOCATION_AUDIT
+    detail::exchange_allocation_phase(prev_alloc_phase_);
+#endif
+  }
+  /// Do not record the duration of this scope.
+  void dismiss() {
+#ifdef ALIGATOR_ENABLE_TIMINGS
+    timer_ = nullptr;
+#endif
+  }
+
+private:
+#ifdef ALIGATOR_ENABLE_TIMINGS
+  PhaseTimer *timer_;
+  SolverPhase phase_;
+  std::chrono::steady_clock::time_point start_;
+#endif
+#ifdef ALIGATOR_ENABLE_ALLOCATION_AUDIT
+  std::size_t prev_alloc_phase_;
+#endif
+};
+
+} // namespace aligator
@@ -0,0 +1,111 @@
+/// @file
+/// @brief Timeline of the solver phases, exported in the Chrome trace format.
+/// @copyright Copyright (C) 2024 LAAS-CNRS, INRIA
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace aligator {
+
+/// Index of the calling thread, numbered in order of first call.
+inline std::size_t current_thread_index() {
+  static std::atomic<std::size_t> next_index{0};
+  thread_local const std::size_t index = next_index++;
+  return index;
+}
+
+/// A span of time spent by a thread on some part of a solver iteration.
+struct TraceEvent {
+  /// Name of the span, e.g. "evaluate". Must be a string literal.
+  const char *name;
+  /// Stage (or linesearch trial) index.
+  std::size_t index;
+  /// Thread index, see current_thread_index().
+  std::size_t thread;
+  /// Start time, in nanoseconds since the buffer was cleared.
+  std::int64_t start_ns;
+  std::int64_t duration_ns;
+};
+
+/// @brief Fixed-capacity ring buffer of TraceEvent, which can be written to
+/// from several threads at once.
+/// @details Recording does not allocate nor lock. When the buffer is full,
+/// the oldest events are overwritten. The buffer must not be read while it is
+/// written to, e.g. read it after the solver run.
+class TraceBuffer {
+public:
+  using clock = std::chrono::steady_clock;
+
+  explicit TraceBuffer(std::size_t capacity = 1 << 16)
+      : events_(std::max(capacity, std::size_t(1))), origin_(clock::now()) {}
+
+  std::size_t capacity() const { return events_.size(); }
+  /// Number of events held by the buffer.
+  std::size_t size() const { return std::min(head_.load(), capacity()); }
+  /// Number of events which were overwritten.
+  std::size_t numDropped() const {
+    const std::size_t n = head_.load();
+    return n > capacity() ? n - capacity() : 0;
+  }
+
+  /// Drop all the events, and restart the clock.
+  void clear() {
+    head_.store(0);
+    origin_ = clock::now();
+  }
+
+  void record(const char *name, std::size_t index, clock::time_point start,
+              clock::time_point end) {
+    using std::chrono::nanoseconds;
+    const std::size_t k = head_.fetch_add(1, std::memory_order_relaxed);
+    TraceEvent &e = events_[k % capacity()];
+    e.name = name;
+    e.index = index;
+    e.thread = current_thread_index();
+    e.start_ns =
+        std::chrono::duration_cast<nanoseconds>(start - origin_).count();
+    e.duration_ns = std::chrono::duration_cast<nanoseconds>(end - start).count();
+  }
+
+  /// The events held by the buffer, from the oldest to the newest.
+  std::vector<TraceEvent> events() const;
+
+  /// @brief Write the events in the Chrome trace-event (JSON) format, which
+  /// can be opened in Perfetto (ui.perfetto.dev) or chrome://tracing.
+  /// @details Each event is a complete event ("ph": "X") on the timeline of
+  /// its thread, with its stage index in "args".
+  void writeChromeTrace(std::ostream &os) const;
+
+private:
+  std::vector<TraceEvent> events_;
+  /// Total number of events recorded since the last clear()
+  std::atomic<std::size_t> head_{0};
+  clock::time_point origin_;
+};
+
+/// @brief Record the duration of a scope in a TraceBuffer, if it is non-null.
+class ScopedTrace {
+public:
+  ScopedTrace(TraceBuffer *buffer, const char *name, std::size_t index = 0)
+      : buffer_(buffer), name_(name), index_(index) {
+    if (buffer_)
+      start_ = TraceBuffer::clock::now();
+  }
+  ~ScopedTrace() {
+    if (buffer_)
+      buffer_->record(name_, index_, start_, TraceBuffer::clock::now());
+  }
+
+private:
+  TraceBuffer *buffer_;
+  const char *name_;
+  std::size_t index_;
+  TraceBuffer::clock::time_point start_;
+};
+
+} // namespace aligator
@@ -0,0 +1,7 @@
+#include "aligator/helpers/trace-callback.hpp"
+
+namespace aligator {
+
+template struct TraceCallbackTpl<context::Scalar>;
+
+} // namespace aligator
@@ -0,0 +1,7 @@
+#include "aligator/modelling/multibody/kinematics-cache.hpp"
+
+namespace aligator {
+
+template struct MultibodyKinematicsCacheTpl<context::Scalar>;
+
+} // namespace aligator
@@ -0,0 +1,7 @@
+#include "aligator/solvers/proxddp/solver-batch.hpp"
+
+namespace aligator {
+
+template struct SolverProxDDPBatch<context::Scalar>;
+
+} // namespace aligator
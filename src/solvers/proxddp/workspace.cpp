@@ -4,6 +4,7 @@
 
 namespace aligator {
 
+template struct RiccatiLegTpl<context::Scalar>;
 template struct WorkspaceTpl<context::Scalar>;
 
 } // namespace aligator
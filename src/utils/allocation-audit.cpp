@@ -0,0 +1,258 @@
+#include "aligator/utils/allocation-audit.hpp"
+
+#include <boost/core/demangle.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+
+namespace aligator {
+
+constexpr std::size_t AllocationSite::npos;
+
+namespace {
+void print_site(std::ostream &oss, std::size_t phase, std::size_t stage,
+                const std::string &function) {
+  oss << (phase < NUM_SOLVER_PHASES ? phase_name(static_cast<SolverPhase>(phase))
+                                    : "(no phase)");
+  if (stage != AllocationSite::npos)
+    oss << ", stage " << stage;
+  if (!function.empty())
+    oss << ", " << function;
+}
+} // namespace
+
+std::ostream &operator<<(std::ostream &oss, const AllocationReport &self) {
+  oss << "AllocationReport {\n  total: " << self.total.count
+      << " allocations (" << self.total.bytes << " bytes)";
+  for (std::size_t k = 0; k <= NUM_SOLVER_PHASES; k++) {
+    const AllocationCount &c = self.by_phase[k];
+    if (c.count == 0)
+      continue;
+    oss << ",\n  ";
+    print_site(oss, k, AllocationSite::npos, "");
+    oss << ": " << c.count << " (" << c.bytes << " bytes)";
+  }
+  if (!self.sites.empty())
+    oss << ",\n  sites" << (self.truncated ? " (truncated):" : ":");
+  for (const AllocationReport::Entry &e : self.sites) {
+    oss << "\n    ";
+    print_site(oss, e.phase, e.stage, e.function);
+    oss << ": " << e.allocs.count << " (" << e.allocs.bytes << " bytes)";
+  }
+  return oss << "\n}";
+}
+
+#ifdef ALIGATOR_ENABLE_ALLOCATION_AUDIT
+
+namespace {
+
+struct SiteSlot {
+  AllocationSite site;
+  AllocationCount allocs;
+  bool used;
+};
+
+constexpr std::size_t NUM_SLOTS = 1024;
+
+// The state below is accessed from the allocation functions: it must not
+// allocate, nor require dynamic initialization.
+std::atomic<bool> g_active{false};
+std::atomic_flag g_lock = ATOMIC_FLAG_INIT;
+std::size_t g_depth = 0;
+AllocationCount g_by_phase[NUM_SOLVER_PHASES + 1];
+SiteSlot g_slots[NUM_SLOTS];
+bool g_truncated = false;
+
+// initial-exec: accessing these must not call into the allocator
+thread_local AllocationSite tl_site __attribute__((tls_model("initial-exec")));
+// set while the calling thread is in the audit itself
+thread_local bool tl_suspended __attribute__((tls_model("initial-exec"))) =
+    false;
+
+struct LockGuard {
+  LockGuard() {
+    while (g_lock.test_and_set(std::memory_order_acquire)) {
+    }
+  }
+  ~LockGuard() { g_lock.clear(std::memory_order_release); }
+};
+
+std::size_t hash_site(const AllocationSite &s) {
+  std::size_t h = s.phase * 31 + s.stage;
+  h = h * 1000003 ^ (reinterpret_cast<std::uintptr_t>(s.function) >> 4);
+  return h % NUM_SLOTS;
+}
+
+void record_allocation(std::size_t size) {
+  if (!g_active.load(std::memory_order_relaxed) || tl_suspended)
+    return;
+  tl_suspended = true;
+  {
+    LockGuard lock;
+    if (g_active.load(std::memory_order_relaxed)) {
+      const AllocationSite &s = tl_site;
+      AllocationCount &c = g_by_phase[std::min(s.phase, NUM_SOLVER_PHASES)];
+      c.count++;
+      c.bytes += size;
+      std::size_t k = hash_site(s);
+      std::size_t probe = 0;
+      for (; probe < NUM_SLOTS; probe++, k = (k + 1) % NUM_SLOTS) {
+        SiteSlot &slot = g_slots[k];
+        if (!slot.used) {
+          slot.used = true;
+          slot.site = s;
+        } else if (slot.site.phase != s.phase || slot.site.stage != s.stage ||
+                   slot.site.function != s.function) {
+          continue;
+        }
+        slot.allocs.count++;
+        slot.allocs.bytes += size;
+        break;
+      }
+      if (probe == NUM_SLOTS)
+        g_truncated = true;
+    }
+  }
+  tl_suspended = false;
+}
+
+} // namespace
+
+namespace detail {
+std::size_t exchange_allocation_phase(std::size_t phase) {
+  std::size_t prev = tl_site.phase;
+  tl_site.phase = phase;
+  return prev;
+}
+} // namespace detail
+
+void AllocationAudit::begin() {
+  tl_suspended = true;
+  {
+    LockGuard lock;
+    if (g_depth++ == 0) {
+      std::fill(std::begin(g_by_phase), std::end(g_by_phase),
+                AllocationCount{});
+      std::fill(std::begin(g_slots), std::end(g_slots), SiteSlot{});
+      g_truncated = false;
+      g_active.store(true);
+    }
+  }
+  tl_suspended = false;
+}
+
+void AllocationAudit::end(AllocationReport &out) {
+  // the report allocates: do not count it
+  tl_suspended = true;
+  out.clear();
+  std::vector<SiteSlot> slots;
+  slots.reserve(NUM_SLOTS);
+  {
+    LockGuard lock;
+    std::copy(std::begin(g_by_phase), std::end(g_by_phase),
+              out.by_phase.begin());
+    for (const SiteSlot &slot : g_slots) {
+      if (slot.used)
+        slots.push_back(slot);
+    }
+    out.truncated = g_truncated;
+    if (g_depth > 0 && --g_depth == 0)
+      g_active.store(false);
+  }
+  for (const AllocationCount &c : out.by_phase)
+    out.total += c;
+  std::sort(slots.begin(), slots.end(),
+            [](const SiteSlot &a, const SiteSlot &b) {
+              if (a.allocs.count != b.allocs.count)
+                return a.allocs.count > b.allocs.count;
+              if (a.site.phase != b.site.phase)
+                return a.site.phase < b.site.phase;
+              return a.site.stage < b.site.stage;
+            });
+  out.sites.reserve(slots.size());
+  for (const SiteSlot &slot : slots) {
+    out.sites.push_back(
+        {slot.site.phase, slot.site.stage,
+         slot.site.function ? boost::core::demangle(slot.site.function) : "",
+         slot.allocs});
+  }
+  tl_suspended = false;
+}
+
+AllocationSite AllocationAudit::currentSite() { return tl_site; }
+
+AllocationSite AllocationAudit::exchangeSite(const AllocationSite &site) {
+  AllocationSite prev = tl_site;
+  tl_site = site;
+  return prev;
+}
+
+#endif // ALIGATOR_ENABLE_ALLOCATION_AUDIT
+
+} // namespace aligator
+
+#ifdef ALIGATOR_ENABLE_ALLOCATION_AUDIT
+// Replacement of the allocation functions of the process. With glibc, malloc
+// and its variants are replaced (they are used by operator new and by Eigen),
+// and forward to the glibc allocator. Elsewhere, only operator new is.
+#ifdef __GLIBC__
+extern "C" {
+void *__libc_malloc(std::size_t size);
+void *__libc_calloc(std::size_t n, std::size_t size);
+void *__libc_realloc(void *ptr, std::size_t size);
+void *__libc_memalign(std::size_t alignment, std::size_t size);
+
+void *malloc(std::size_t size) __THROW {
+  aligator::record_allocation(size);
+  return __libc_malloc(size);
+}
+
+void *calloc(std::size_t n, std::size_t size) __THROW {
+  aligator::record_allocation(n * size);
+  return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, std::size_t size) __THROW {
+  if (size > 0)
+    aligator::record_allocation(size);
+  return __libc_realloc(ptr, size);
+}
+
+void *memalign(std::size_t alignment, std::size_t size) __THROW {
+  aligator::record_allocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(std::size_t alignment, std::size_t size) __THROW {
+  aligator::record_allocation(size);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, std::size_t alignment, std::size_t size) __THROW {
+  aligator::record_allocation(size);
+  void *p = __libc_memalign(alignment, size);
+  if (p == nullptr)
+    return ENOMEM;
+  *ptr = p;
+  return 0;
+}
+}
+#else
+void *operator new(std::size_t size) {
+  aligator::record_allocation(size);
+  if (void *p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+#endif // __GLIBC__
+#endif // ALIGATOR_ENABLE_ALLOCATION_AUDIT
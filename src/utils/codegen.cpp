@@ -0,0 +1,577 @@
+#include "aligator/utils/codegen.hpp"
+#include "aligator/utils/exceptions.hpp"
+
+#include <fmt/format.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <ostream>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define ALIGATOR_CODEGEN_POSIX
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <pwd.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char **environ;
+#endif
+
+namespace aligator {
+namespace codegen {
+
+namespace {
+
+double apply(OpCode op, double a, double b) {
+  switch (op) {
+  case OpCode::ADD:
+    return a + b;
+  case OpCode::SUB:
+    return a - b;
+  case OpCode::MUL:
+    return a * b;
+  case OpCode::DIV:
+    return a / b;
+  case OpCode::NEG:
+    return -a;
+  case OpCode::SQRT:
+    return std::sqrt(a);
+  case OpCode::EXP:
+    return std::exp(a);
+  case OpCode::LOG:
+    return std::log(a);
+  case OpCode::SIN:
+    return std::sin(a);
+  case OpCode::COS:
+    return std::cos(a);
+  case OpCode::TAN:
+    return std::tan(a);
+  case OpCode::TANH:
+    return std::tanh(a);
+  case OpCode::POW:
+    return std::pow(a, b);
+  case OpCode::ABS:
+    return std::abs(a);
+  case OpCode::SIGN:
+    return double((a > 0) - (a < 0));
+  default:
+    ALIGATOR_RUNTIME_ERROR("Not an operation.");
+  }
+}
+
+const char *function_name(OpCode op) {
+  switch (op) {
+  case OpCode::SQRT:
+    return "sqrt";
+  case OpCode::EXP:
+    return "exp";
+  case OpCode::LOG:
+    return "log";
+  case OpCode::SIN:
+    return "sin";
+  case OpCode::COS:
+    return "cos";
+  case OpCode::TAN:
+    return "tan";
+  case OpCode::TANH:
+    return "tanh";
+  case OpCode::POW:
+    return "pow";
+  case OpCode::ABS:
+    return "fabs";
+  default:
+    return nullptr;
+  }
+}
+
+// FNV-1a: stable across platforms and runs, unlike std::hash
+std::uint64_t hash_string(const std::string &s) {
+  std::uint64_t h = 14695981039346656037ull;
+  for (char c : s) {
+    h ^= std::uint64_t(static_cast<unsigned char>(c));
+    h *= 1099511628211ull;
+  }
+  return h;
+}
+
+std::string get_env(const char *name, const std::string &fallback) {
+  const char *v = std::getenv(name);
+  return (v && *v) ? std::string(v) : fallback;
+}
+
+#ifdef ALIGATOR_CODEGEN_POSIX
+
+/// Create the directory @p dir, private to the user, if it does not exist.
+void make_private_dir(const std::string &dir) {
+  if (::mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST) {
+    ALIGATOR_RUNTIME_ERROR(
+        fmt::format("Could not create the directory {}.", dir));
+  }
+}
+
+/// Refuse @p path if another user could have written it: the libraries found
+/// there are loaded into the process.
+void check_private(const std::string &path, bool directory) {
+  struct stat st;
+  if (::stat(path.c_str(), &st) != 0)
+    ALIGATOR_RUNTIME_ERROR(fmt::format("Could not access {}.", path));
+  if (directory && !S_ISDIR(st.st_mode))
+    ALIGATOR_RUNTIME_ERROR(fmt::format("{} is not a directory.", path));
+  if (st.st_uid != ::geteuid()) {
+    ALIGATOR_RUNTIME_ERROR(
+        fmt::format("{} is not owned by the current user.", path));
+  }
+  if ((st.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+    ALIGATOR_RUNTIME_ERROR(
+        fmt::format("{} is writable by other users.", path));
+  }
+}
+
+/// `$XDG_CACHE_HOME/aligator-codegen`, or `~/.cache/aligator-codegen`.
+std::string default_cache_dir() {
+  std::string base = get_env("XDG_CACHE_HOME", "");
+  if (base.empty()) {
+    std::string home = get_env("HOME", "");
+    if (home.empty()) {
+      const struct passwd *pw = ::getpwuid(::geteuid());
+      if (!pw || !pw->pw_dir) {
+        ALIGATOR_RUNTIME_ERROR(
+            "Could not find the home directory for the code cache.");
+      }
+      home = pw->pw_dir;
+    }
+    base = home + "/.cache";
+    make_private_dir(base);
+  }
+  return base + "/aligator-codegen";
+}
+
+std::vector<std::string> split_words(const std::string &s) {
+  std::istringstream iss(s);
+  std::vector<std::string> words;
+  std::string w;
+  while (iss >> w)
+    words.push_back(w);
+  return words;
+}
+
+/// Run @p args without a shell, writing its output to @p log_path. Return
+/// whether it exited successfully.
+bool run_command(const std::vector<std::string> &args,
+                 const std::string &log_path) {
+  std::vector<char *> argv;
+  argv.reserve(args.size() + 1);
+  for (const std::string &a : args)
+    argv.push_back(const_cast<char *>(a.c_str()));
+  argv.push_back(nullptr);
+
+  // posix_spawn is fork/exec, safe to call from a multithreaded process
+  posix_spawn_file_actions_t actions;
+  ::posix_spawn_file_actions_init(&actions);
+  ::posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, log_path.c_str(),
+                                     O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  ::posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+  pid_t pid;
+  const int err =
+      ::posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+  ::posix_spawn_file_actions_destroy(&actions);
+  if (err != 0)
+    return false;
+  int status;
+  while (::waitpid(pid, &status, 0) < 0) {
+    if (errno != EINTR)
+      return false;
+  }
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+#endif // ALIGATOR_CODEGEN_POSIX
+
+} // namespace
+
+/* Tape */
+
+int Tape::push(const Node &node) {
+  const std::string key =
+      fmt::format("{:d},{:d},{:d},{:a}", int(node.op), node.a, node.b,
+                  node.value);
+  auto it = cache_.find(key);
+  if (it != cache_.end())
+    return it->second;
+  nodes_.push_back(node);
+  const int id = int(nodes_.size()) - 1;
+  cache_.emplace(key, id);
+  return id;
+}
+
+int Tape::variable(int index) {
+  return push({OpCode::VARIABLE, -1, -1, double(index)});
+}
+
+int Tape::constant(double c) { return push({OpCode::CONSTANT, -1, -1, c}); }
+
+int Tape::unary(OpCode op, int a) {
+  const Node &na = (*this)[a];
+  if (na.op == OpCode::CONSTANT)
+    return constant(apply(op, na.value, 0.));
+  if (op == OpCode::NEG && na.op == OpCode::NEG)
+    return na.a;
+  return push({op, a, -1, 0.});
+}
+
+int Tape::binary(OpCode op, int a, int b) {
+  const Node &na = (*this)[a];
+  const Node &nb = (*this)[b];
+  if (na.op == OpCode::CONSTANT && nb.op == OpCode::CONSTANT)
+    return constant(apply(op, na.value, nb.value));
+  switch (op) {
+  case OpCode::ADD:
+    if (isConstant(a, 0.))
+      return b;
+    if (isConstant(b, 0.))
+      return a;
+    break;
+  case OpCode::SUB:
+    if (isConstant(b, 0.))
+      return a;
+    if (isConstant(a, 0.))
+      return unary(OpCode::NEG, b);
+    if (a == b)
+      return constant(0.);
+    break;
+  case OpCode::MUL:
+    if (isConstant(a, 0.) || isConstant(b, 0.))
+      return constant(0.);
+    if (isConstant(a, 1.))
+      return b;
+    if (isConstant(b, 1.))
+      return a;
+    if (isConstant(a, -1.))
+      return unary(OpCode::NEG, b);
+    if (isConstant(b, -1.))
+      return unary(OpCode::NEG, a);
+    break;
+  case OpCode::DIV:
+    if (isConstant(a, 0.))
+      return constant(0.);
+    if (isConstant(b, 1.))
+      return a;
+    break;
+  case OpCode::POW:
+    if (isConstant(b, 0.))
+      return constant(1.);
+    if (isConstant(b, 1.))
+      return a;
+    break;
+  default:
+    break;
+  }
+  // share commutative operations regardless of the order of the operands
+  if ((op == OpCode::ADD || op == OpCode::MUL) && b < a)
+    std::swap(a, b);
+  return push({op, a, b, 0.});
+}
+
+std::vector<int> Tape::gradient(int out, int num_vars) {
+  const int zero = constant(0.);
+  std::vector<int> grad(std::size_t(num_vars), zero);
+  // adjoint of each node, or -1
+  std::vector<int> adj(std::size_t(out) + 1, -1);
+  auto accumulate = [&](int i, int v) {
+    if ((*this)[i].op == OpCode::CONSTANT)
+      return;
+    int &ai = adj[std::size_t(i)];
+    ai = ai < 0 ? v : binary(OpCode::ADD, ai, v);
+  };
+  adj[std::size_t(out)] = constant(1.);
+  for (int k = out; k >= 0; k--) {
+    const int w = adj[std::size_t(k)];
+    if (w < 0)
+      continue;
+    // copy: the tape grows below
+    const Node n = (*this)[k];
+    switch (n.op) {
+    case OpCode::VARIABLE:
+      if (int(n.value) < num_vars)
+        grad[std::size_t(n.value)] = w;
+      break;
+    case OpCode::CONSTANT:
+    case OpCode::SIGN:
+      break;
+    case OpCode::ADD:
+      accumulate(n.a, w);
+      accumulate(n.b, w);
+      break;
+    case OpCode::SUB:
+      accumulate(n.a, w);
+      accumulate(n.b, unary(OpCode::NEG, w));
+      break;
+    case OpCode::MUL:
+      accumulate(n.a, binary(OpCode::MUL, w, n.b));
+      accumulate(n.b, binary(OpCode::MUL, w, n.a));
+      break;
+    case OpCode::DIV:
+      accumulate(n.a, binary(OpCode::DIV, w, n.b));
+      accumulate(n.b, unary(OpCode::NEG, binary(OpCode::MUL, w,
+                                                 binary(OpCode::DIV, k, n.b))));
+      break;
+    case OpCode::NEG:
+      accumulate(n.a, unary(OpCode::NEG, w));
+      break;
+    case OpCode::SQRT:
+      accumulate(n.a, binary(OpCode::DIV, w,
+                             binary(OpCode::MUL, constant(2.), k)));
+      break;
+    case OpCode::EXP:
+      accumulate(n.a, binary(OpCode::MUL, w, k));
+      break;
+    case OpCode::LOG:
+      accumulate(n.a, binary(OpCode::DIV, w, n.a));
+      break;
+    case OpCode::SIN:
+      accumulate(n.a, binary(OpCode::MUL, w, unary(OpCode::COS, n.a)));
+      break;
+    case OpCode::COS:
+      accumulate(n.a, unary(OpCode::NEG, binary(OpCode::MUL, w,
+                                                 unary(OpCode::SIN, n.a))));
+      break;
+    case OpCode::TAN:
+      accumulate(n.a,
+                 binary(OpCode::MUL, w,
+                        binary(OpCode::ADD, constant(1.),
+                               binary(OpCode::MUL, k, k))));
+      break;
+    case OpCode::TANH:
+      accumulate(n.a,
+                 binary(OpCode::MUL, w,
+                        binary(OpCode::SUB, constant(1.),
+                               binary(OpCode::MUL, k, k))));
+      break;
+    case OpCode::POW: {
+      const int bm1 = binary(OpCode::SUB, n.b, constant(1.));
+      accumulate(n.a, binary(OpCode::MUL, w,
+                             binary(OpCode::MUL, n.b,
+                                    binary(OpCode::POW, n.a, bm1))));
+      accumulate(n.b,
+                 binary(OpCode::MUL, w,
+                        binary(OpCode::MUL, k, unary(OpCode::LOG, n.a))));
+      break;
+    }
+    case OpCode::ABS:
+      accumulate(n.a, binary(OpCode::MUL, w, unary(OpCode::SIGN, n.a)));
+      break;
+    }
+  }
+  return grad;
+}
+
+std::vector<int> Tape::jacobian(const std::vector<int> &outputs,
+                                int num_vars) {
+  const std::size_t nr = outputs.size();
+  std::vector<int> jac(nr * std::size_t(num_vars));
+  for (std::size_t k = 0; k < nr; k++) {
+    const std::vector<int> g = gradient(outputs[k], num_vars);
+    for (std::size_t j = 0; j < g.size(); j++)
+      jac[j * nr + k] = g[j];
+  }
+  return jac;
+}
+
+std::vector<int> Tape::weightedHessian(const std::vector<int> &outputs,
+                                       const std::vector<int> &weights,
+                                       int num_vars) {
+  int lag = constant(0.);
+  for (std::size_t k = 0; k < outputs.size(); k++)
+    lag = binary(OpCode::ADD, lag, binary(OpCode::MUL, weights[k], outputs[k]));
+  const std::vector<int> grad = gradient(lag, num_vars);
+  const std::size_t n = std::size_t(num_vars);
+  std::vector<int> hess(n * n);
+  for (std::size_t i = 0; i < n; i++) {
+    const std::vector<int> hi = gradient(grad[i], num_vars);
+    for (std::size_t j = 0; j < n; j++)
+      hess[j * n + i] = hi[j];
+  }
+  return hess;
+}
+
+void Tape::emitHeader(std::ostream &os, const char *real_type) {
+  os << "#include <math.h>\n\ntypedef " << real_type << " real;\n";
+}
+
+void Tape::emitFunction(std::ostream &os, const std::string &name,
+                        const std::vector<int> &outputs) const {
+  std::vector<bool> used(nodes_.size(), false);
+  for (int o : outputs)
+    used[std::size_t(o)] = true;
+  for (std::size_t k = nodes_.size(); k-- > 0;) {
+    if (!used[k])
+      continue;
+    const Node &n = nodes_[k];
+    if (n.a >= 0)
+      used[std::size_t(n.a)] = true;
+    if (n.b >= 0)
+      used[std::size_t(n.b)] = true;
+  }
+
+  auto operand = [&](int i) -> std::string {
+    const Node &n = (*this)[i];
+    if (n.op == OpCode::VARIABLE)
+      return fmt::format("in[{:d}]", int(n.value));
+    if (n.op == OpCode::CONSTANT) {
+      if (std::isnan(n.value))
+        return "((real)NAN)";
+      if (std::isinf(n.value))
+        return n.value > 0 ? "((real)INFINITY)" : "(-(real)INFINITY)";
+      return fmt::format("((real){:.17g})", n.value);
+    }
+    return fmt::format("v{:d}", i);
+  };
+
+  os << "\nvoid " << name << "(const real *in, real *out) {\n";
+  for (std::size_t k = 0; k < nodes_.size(); k++) {
+    const Node &n = nodes_[k];
+    if (!used[k] || n.op == OpCode::VARIABLE || n.op == OpCode::CONSTANT)
+      continue;
+    std::string expr;
+    switch (n.op) {
+    case OpCode::ADD:
+      expr = operand(n.a) + " + " + operand(n.b);
+      break;
+    case OpCode::SUB:
+      expr = operand(n.a) + " - " + operand(n.b);
+      break;
+    case OpCode::MUL:
+      expr = operand(n.a) + " * " + operand(n.b);
+      break;
+    case OpCode::DIV:
+      expr = operand(n.a) + " / " + operand(n.b);
+      break;
+    case OpCode::NEG:
+      expr = "-" + operand(n.a);
+      break;
+    case OpCode::SIGN:
+      expr = fmt::format("(real)(({0} > 0) - ({0} < 0))", operand(n.a));
+      break;
+    case OpCode::POW:
+      expr = fmt::format("pow({}, {})", operand(n.a), operand(n.b));
+      break;
+    default:
+      expr = fmt::format("{}({})", function_name(n.op), operand(n.a));
+      break;
+    }
+    os << "  const real v" << k << " = " << expr << ";\n";
+  }
+  for (std::size_t j = 0; j < outputs.size(); j++)
+    os << "  out[" << j << "] = " << operand(outputs[j]) << ";\n";
+  os << "}\n";
+}
+
+/* SymbolicScalar */
+
+SymbolicScalar SymbolicScalar::unary(OpCode op, const SymbolicScalar &a) {
+  if (a.isConstant())
+    return apply(op, a.value_, 0.);
+  return {a.tape_, a.tape_->unary(op, a.id_)};
+}
+
+SymbolicScalar SymbolicScalar::binary(OpCode op, const SymbolicScalar &a,
+                                      const SymbolicScalar &b) {
+  if (a.isConstant() && b.isConstant())
+    return apply(op, a.value_, b.value_);
+  Tape *tape = a.tape_ ? a.tape_ : b.tape_;
+  if (a.tape_ && b.tape_ && a.tape_ != b.tape_)
+    ALIGATOR_RUNTIME_ERROR("Operands are recorded on different tapes.");
+  return {tape, tape->binary(op, a.node(*tape), b.node(*tape))};
+}
+
+/* CompiledLibrary */
+
+#ifdef ALIGATOR_CODEGEN_POSIX
+
+CompiledLibrary::CompiledLibrary(const std::string &source,
+                                 const CompileOptions &options)
+    : handle_(nullptr) {
+  std::string dir = options.cache_dir;
+  if (dir.empty())
+    dir = get_env("ALIGATOR_CODEGEN_CACHE_DIR", "");
+  if (dir.empty())
+    dir = default_cache_dir();
+  make_private_dir(dir);
+  check_private(dir, true);
+
+  const std::string compiler =
+      options.compiler.empty() ? get_env("CC", "cc") : options.compiler;
+  const std::string command =
+      fmt::format("{} {} -shared -fPIC", compiler, options.flags);
+  const std::uint64_t hash = hash_string(command + '\n' + source);
+  path_ = fmt::format("{}/lib{:016x}.so", dir, hash);
+
+  if (::access(path_.c_str(), F_OK) != 0) {
+    // concurrent compilations write to distinct files, then one of them
+    // atomically replaces the other
+    const std::string stem = fmt::format("{}.{:d}", path_, ::getpid());
+    const std::string src_path = stem + ".c";
+    const std::string tmp_path = stem + ".tmp";
+    const std::string log_path = stem + ".log";
+    {
+      std::ofstream ofs(src_path);
+      ofs << source;
+      if (!ofs.good())
+        ALIGATOR_RUNTIME_ERROR(fmt::format("Could not write {}.", src_path));
+    }
+    std::vector<std::string> args = split_words(command);
+    args.insert(args.end(), {"-o", tmp_path, src_path});
+    if (!run_command(args, log_path)) {
+      ALIGATOR_RUNTIME_ERROR(fmt::format(
+          "Compilation of the generated code failed ({}); see {}", command,
+          log_path));
+    }
+    std::rename(tmp_path.c_str(), path_.c_str());
+    std::remove(src_path.c_str());
+    std::remove(log_path.c_str());
+  }
+  check_private(path_, false);
+
+  handle_ = ::dlopen(path_.c_str(), RTLD_NOW | RTLD_LOCAL);
+  if (!handle_) {
+    ALIGATOR_RUNTIME_ERROR(
+        fmt::format("Could not load {}: {}", path_, ::dlerror()));
+  }
+}
+
+CompiledLibrary::~CompiledLibrary() {
+  if (handle_)
+    ::dlclose(handle_);
+}
+
+void *CompiledLibrary::symbol(const char *name) const {
+  void *f = ::dlsym(handle_, name);
+  if (!f) {
+    ALIGATOR_RUNTIME_ERROR(
+        fmt::format("Symbol {} not found in {}.", name, path_));
+  }
+  return f;
+}
+
+#else
+
+CompiledLibrary::CompiledLibrary(const std::string &, const CompileOptions &)
+    : handle_(nullptr) {
+  ALIGATOR_RUNTIME_ERROR(
+      "Compilation of generated code is only supported on POSIX systems.");
+}
+
+CompiledLibrary::~CompiledLibrary() {}
+
+void *CompiledLibrary::symbol(const char *) const { return nullptr; }
+
+#endif // ALIGATOR_CODEGEN_POSIX
+
+} // namespace codegen
+} // namespace aligator
@@ -0,0 +1,181 @@
+#include "aligator/utils/thread-pool.hpp"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace aligator {
+
+namespace {
+/// Pool and queue of the current thread, if it is a worker.
+struct WorkerId {
+  const ThreadPool *pool;
+  std::size_t id;
+};
+thread_local WorkerId current_worker{nullptr, 0};
+
+void pin_to_core(std::size_t core) {
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(core, &set);
+  pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+  (void)core;
+#endif
+}
+} // namespace
+
+/// Double-ended queue of chunks, stored in a ring buffer which only grows.
+/// The owner pushes and pops at the back, thieves pop at the front.
+struct alignas(64) ThreadPool::Queue {
+  std::mutex mtx;
+  std::vector<Task> buf;
+  std::size_t head = 0;
+  /// Number of chunks, also read without the lock to skip empty queues.
+  std::atomic<std::size_t> count{0};
+
+  void push(const Task &task) {
+    std::lock_guard<std::mutex> lock(mtx);
+    const std::size_t n = count.load(std::memory_order_relaxed);
+    if (n == buf.size()) {
+      std::vector<Task> grown(std::max(std::size_t(16), 2 * n));
+      for (std::size_t k = 0; k < n; k++)
+        grown[k] = buf[(head + k) % buf.size()];
+      buf.swap(grown);
+      head = 0;
+    }
+    buf[(head + n) % buf.size()] = task;
+    count.store(n + 1, std::memory_order_relaxed);
+  }
+
+  bool popBack(Task &task) {
+    if (count.load(std::memory_order_relaxed) == 0)
+      return false;
+    std::lock_guard<std::mutex> lock(mtx);
+    const std::size_t n = count.load(std::memory_order_relaxed);
+    if (n == 0)
+      return false;
+    task = buf[(head + n - 1) % buf.size()];
+    count.store(n - 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  bool popFront(Task &task) {
+    if (count.load(std::memory_order_relaxed) == 0)
+      return false;
+    std::lock_guard<std::mutex> lock(mtx);
+    const std::size_t n = count.load(std::memory_order_relaxed);
+    if (n == 0)
+      return false;
+    task = buf[head];
+    head = (head + 1) % buf.size();
+    count.store(n - 1, std::memory_order_relaxed);
+    return true;
+  }
+};
+
+ThreadPool::ThreadPool(std::size_t num_threads, bool pin_threads)
+    : num_threads_(std::max(num_threads, std::size_t(1))),
+      pin_threads_(pin_threads), queues_(new Queue[num_threads_]) {
+  workers_.reserve(num_threads_ - 1);
+  for (std::size_t id = 1; id < num_threads_; id++) {
+    workers_.emplace_back([this, id] { workerLoop(id); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mtx_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (std::thread &w : workers_)
+    w.join();
+}
+
+std::size_t ThreadPool::currentQueue() const {
+  return current_worker.pool == this ? current_worker.id : 0;
+}
+
+void ThreadPool::runJob(Job &job, std::size_t begin, std::size_t end,
+                        std::size_t grain) {
+  const std::size_t num_chunks = (end - begin + grain - 1) / grain;
+  const std::size_t self = currentQueue();
+  job.pending.store(num_chunks, std::memory_order_relaxed);
+  // count the chunks before queuing them, so that the counter never wraps
+  num_queued_.fetch_add(num_chunks, std::memory_order_relaxed);
+  for (std::size_t c = 0; c < num_chunks; c++) {
+    const std::size_t b = begin + c * grain;
+    Task task{&job, b, std::min(end, b + grain)};
+    queues_[(self + c) % num_threads_].push(task);
+  }
+  {
+    std::lock_guard<std::mutex> lock(sleep_mtx_);
+  }
+  wake_.notify_all();
+
+  // help until the loop is done; this may run chunks of other loops
+  while (job.pending.load(std::memory_order_acquire) > 0) {
+    if (!runOneTask(self))
+      std::this_thread::yield();
+  }
+  if (job.error)
+    std::rethrow_exception(job.error);
+}
+
+bool ThreadPool::runOneTask(std::size_t self) {
+  Task task;
+  bool found = queues_[self].popBack(task);
+  for (std::size_t k = 1; !found && (k < num_threads_); k++) {
+    found = queues_[(self + k) % num_threads_].popFront(task);
+  }
+  if (!found)
+    return false;
+  num_queued_.fetch_sub(1, std::memory_order_relaxed);
+
+  Job &job = *task.job;
+  try {
+    job.invoke(job.fn, task.begin, task.end);
+  } catch (...) {
+    if (!job.failed.exchange(true))
+      job.error = std::current_exception();
+  }
+  // last access to the job: its owner may return as soon as this is zero
+  job.pending.fetch_sub(1, std::memory_order_acq_rel);
+  return true;
+}
+
+void ThreadPool::workerLoop(std::size_t id) {
+  current_worker = {this, id};
+  if (pin_threads_) {
+    const std::size_t num_cores =
+        std::max(std::thread::hardware_concurrency(), 1U);
+    pin_to_core(id % num_cores);
+  }
+
+  // number of attempts to find work before going to sleep: this keeps the
+  // workers awake between the closely-spaced loops of a solver iteration
+  constexpr int max_spins = 256;
+  int spins = 0;
+  while (true) {
+    if (runOneTask(id)) {
+      spins = 0;
+      continue;
+    }
+    if (spins++ < max_spins) {
+      std::this_thread::yield();
+      continue;
+    }
+    spins = 0;
+    std::unique_lock<std::mutex> lock(sleep_mtx_);
+    wake_.wait(lock, [this] {
+      return stop_ || (num_queued_.load(std::memory_order_relaxed) > 0);
+    });
+    if (stop_)
+      return;
+  }
+}
+
+} // namespace aligator
@@ -0,0 +1,32 @@
+#include "aligator/utils/trace.hpp"
+
+#include <fmt/format.h>
+
+namespace aligator {
+
+std::vector<TraceEvent> TraceBuffer::events() const {
+  const std::size_t n = size();
+  const std::size_t first = head_.load() - n;
+  std::vector<TraceEvent> out;
+  out.reserve(n);
+  for (std::size_t k = 0; k < n; k++)
+    out.push_back(events_[(first + k) % capacity()]);
+  return out;
+}
+
+void TraceBuffer::writeChromeTrace(std::ostream &os) const {
+  os << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  const std::vector<TraceEvent> evs = events();
+  for (std::size_t k = 0; k < evs.size(); k++) {
+    const TraceEvent &e = evs[k];
+    // timestamps are in microseconds
+    os << fmt::format("{}\n{{\"name\": \"{}\", \"ph\": \"X\", \"pid\": 0, "
+                      "\"tid\": {:d}, \"ts\": {:.3f}, \"dur\": {:.3f}, "
+                      "\"args\": {{\"index\": {:d}}}}}",
+                      k > 0 ? "," : "", e.name, e.thread, 1e-3 * e.start_ns,
+                      1e-3 * e.duration_ns, e.index);
+  }
+  os << "\n]}\n";
+}
+
+} // namespace aligator
@@ -0,0 +1,119 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/solvers/fddp/solver-fddp.hpp"
+
+#include "generate-problem.hpp"
+
+#include <sstream>
+
+using namespace aligator;
+
+using T = double;
+using Eigen::VectorXd;
+using QuadCost = QuadraticCostTpl<T>;
+
+/// A quadratic cost which allocates a temporary in evaluate().
+struct AllocatingCost : QuadCost {
+  using QuadCost::QuadCost;
+  void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
+                CostData &data) const override {
+    VectorXd tmp = x;
+    QuadCost::evaluate(tmp, u, data);
+  }
+};
+
+static TrajOptProblemTpl<T> makeProblem(std::size_t nsteps,
+                                        std::size_t allocating_stage) {
+  auto problem = makeLqrProblem(nsteps);
+  auto cost = makeLqrCost();
+  problem.stages_[allocating_stage] = std::make_shared<StageModelTpl<T>>(
+      std::make_shared<AllocatingCost>(cost->getWeightsX(),
+                                       cost->getWeightsU()),
+      makeLqrDynamics());
+  return problem;
+}
+
+/// Check the allocations of the cost of @p stage were attributed to it.
+static void checkReport(const AllocationReport &report, std::size_t stage) {
+  if (!AllocationAudit::enabled) {
+    BOOST_CHECK(report.allocationFree());
+    BOOST_CHECK(report.sites.empty());
+    return;
+  }
+  BOOST_CHECK(!report.allocationFree());
+  AllocationCount sum;
+  for (const AllocationCount &c : report.by_phase)
+    sum += c;
+  BOOST_CHECK_EQUAL(sum.count, report.total.count);
+  BOOST_CHECK(!report.truncated);
+
+  std::size_t num_found = 0;
+  for (const AllocationReport::Entry &e : report.sites) {
+    if (e.function.find("AllocatingCost") == std::string::npos)
+      continue;
+    BOOST_CHECK_EQUAL(e.stage, stage);
+    BOOST_CHECK(e.phase == std::size_t(SolverPhase::EVALUATE) ||
+                e.phase == std::size_t(SolverPhase::DERIVATIVES));
+    num_found += e.allocs.count;
+  }
+  BOOST_CHECK_GT(num_found, 0);
+
+  std::ostringstream oss;
+  oss << report;
+  BOOST_CHECK_NE(oss.str().find("AllocatingCost"), std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(audit_scope) {
+  PhaseTimer timer;
+  AllocationReport report;
+  {
+    ScopedAllocationAudit audit(report);
+    std::unique_ptr<int> p(new int(0));
+    ScopedPhase phase(timer, SolverPhase::CALLBACKS);
+    {
+      ScopedAllocationStage site(AllocationAudit::currentSite(), 3);
+      std::vector<double> v(100);
+    }
+  }
+  if (!AllocationAudit::enabled) {
+    BOOST_CHECK(report.allocationFree());
+    return;
+  }
+  BOOST_CHECK_EQUAL(report.total.count, 2);
+  const auto k = std::size_t(SolverPhase::CALLBACKS);
+  BOOST_CHECK_EQUAL(report.by_phase[k].count, 1);
+  BOOST_CHECK_EQUAL(report.by_phase[k].bytes, 100 * sizeof(double));
+  BOOST_CHECK_EQUAL(report.by_phase[NUM_SOLVER_PHASES].count, 1);
+  BOOST_REQUIRE_EQUAL(report.sites.size(), 2);
+  for (const AllocationReport::Entry &e : report.sites) {
+    if (e.phase == k)
+      BOOST_CHECK_EQUAL(e.stage, 3);
+  }
+
+  // nothing is counted outside of an audit
+  AllocationReport report2;
+  std::vector<double> w(10);
+  {
+    ScopedAllocationAudit audit(report2);
+  }
+  BOOST_CHECK(report2.allocationFree());
+}
+
+BOOST_AUTO_TEST_CASE(proxddp_allocations) {
+  const std::size_t nsteps = 10;
+  auto problem = makeProblem(nsteps, 4);
+  SolverProxDDP<T> solver(1e-7, 1e-4);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+  checkReport(solver.results_.allocations, 4);
+}
+
+BOOST_AUTO_TEST_CASE(fddp_allocations) {
+  const std::size_t nsteps = 10;
+  auto problem = makeProblem(nsteps, 7);
+  SolverFDDP<T> solver(1e-8);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+  checkReport(solver.results_.allocations, 7);
+}
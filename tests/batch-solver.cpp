@@ -0,0 +1,45 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/proxddp/solver-batch.hpp"
+
+#include "generate-problem.hpp"
+
+using namespace aligator;
+
+using T = double;
+using Eigen::VectorXd;
+
+BOOST_AUTO_TEST_CASE(batch_solve) {
+  const int nx = 4;
+  const std::size_t nsteps = 20;
+  const std::size_t num_instances = 8;
+  auto problem = makeLqrProblem(nsteps, 1.);
+  problem.setInitState(VectorXd::Zero(nx));
+
+  const T tol = 1e-8;
+  std::vector<VectorXd> x0s;
+  for (std::size_t i = 0; i < num_instances; i++)
+    x0s.push_back(VectorXd::Constant(nx, 0.5 * T(i)));
+
+  SolverProxDDP<T> solver(tol, 1e-4);
+  SolverProxDDPBatch<T> batch(solver, problem, num_instances);
+  batch.num_threads = 4;
+  batch.setup();
+  BOOST_CHECK_EQUAL(batch.run(x0s), num_instances);
+  // the original problem is left untouched
+  BOOST_CHECK(problem.getInitState().isZero());
+
+  for (std::size_t i = 0; i < num_instances; i++) {
+    problem.setInitState(x0s[i]);
+    SolverProxDDP<T> solver_ref(tol, 1e-4);
+    solver_ref.setup(problem);
+    BOOST_CHECK(solver_ref.run(problem));
+    const auto &res = batch.results(i);
+    BOOST_CHECK(res.xs[0].isApprox(x0s[i]));
+    for (std::size_t t = 0; t < nsteps; t++) {
+      BOOST_CHECK(res.us[t].isApprox(solver_ref.results_.us[t], 1e-6));
+    }
+  }
+
+  BOOST_CHECK_THROW(batch.run({VectorXd::Zero(nx)}), std::runtime_error);
+}
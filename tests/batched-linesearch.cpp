@@ -0,0 +1,40 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+
+#include "generate-problem.hpp"
+
+using namespace aligator;
+
+using T = double;
+
+BOOST_AUTO_TEST_CASE(batched_linesearch) {
+  const std::size_t nsteps = 30;
+  auto problem = makeLqrProblem(nsteps, 0.5);
+  problem.setNumThreads(4);
+
+  const T tol = 1e-7;
+  SolverProxDDP<T> solver(tol, 1e-4);
+  solver.rollout_type_ = RolloutType::LINEAR;
+  solver.setup(problem);
+  BOOST_CHECK(solver.workspace_.ls_trials_.empty());
+  BOOST_CHECK(solver.run(problem));
+
+  SolverProxDDP<T> solver_batch(tol, 1e-4);
+  solver_batch.rollout_type_ = RolloutType::LINEAR;
+  solver_batch.ls_batch_size = 4;
+  solver_batch.setup(problem);
+  BOOST_CHECK_EQUAL(solver_batch.workspace_.ls_trials_.size(), 4);
+  BOOST_CHECK(solver_batch.run(problem));
+
+  // the workspace holds the data of the accepted trial point
+  TrajOptDataTpl<T> check_data(problem);
+  const auto &res = solver_batch.results_;
+  const T cost_check = problem.evaluate(res.xs, res.us, check_data);
+  BOOST_CHECK_CLOSE(cost_check, res.traj_cost_, 1e-8);
+
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(solver.results_.us[t].isApprox(res.us[t], 1e-4));
+    BOOST_CHECK(solver.results_.xs[t + 1].isApprox(res.xs[t + 1], 1e-4));
+  }
+}
@@ -0,0 +1,206 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/modelling/autodiff/codegen-function.hpp"
+#include "aligator/modelling/autodiff/forward-diff.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace aligator;
+using namespace aligator::autodiff;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+/// r(x, u, y) = (sin(x0) u0 + y1^2, |x|^2 - u1 exp(y0), sqrt(1 + x2^2) / y2)
+struct TestResidual {
+  template <typename S>
+  void operator()(const internal::VectorX<S> &x, const internal::VectorX<S> &u,
+                  const internal::VectorX<S> &y,
+                  internal::VectorX<S> &r) const {
+    using std::exp;
+    using std::sin;
+    using std::sqrt;
+    r[0] = sin(x[0]) * u[0] + y[1] * y[1];
+    r[1] = x.squaredNorm() - u[1] * exp(y[0]);
+    r[2] = sqrt(1. + x[2] * x[2]) / y[2];
+  }
+};
+
+/// l(x, u) = cos(x0 x1) + 0.5 |u|^2 + log(2 + x1^2) u0
+struct TestCost {
+  template <typename S>
+  S operator()(const internal::VectorX<S> &x,
+               const internal::VectorX<S> &u) const {
+    using std::cos;
+    using std::log;
+    return cos(x[0] * x[1]) + 0.5 * u.squaredNorm() +
+           log(2. + x[1] * x[1]) * u[0];
+  }
+};
+
+/// Remove the directory @p dir and its contents.
+static void removeDir(const std::string &dir) {
+  if (DIR *d = ::opendir(dir.c_str())) {
+    while (const struct dirent *e = ::readdir(d)) {
+      const std::string name = e->d_name;
+      if (name == "." || name == "..")
+        continue;
+      const std::string path = dir + "/" + name;
+      struct stat st;
+      if (::lstat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+        removeDir(path);
+      else
+        std::remove(path.c_str());
+    }
+    ::closedir(d);
+  }
+  ::rmdir(dir.c_str());
+}
+
+/// Compile to an empty cache, in a temporary directory. Its name needs
+/// quoting in a shell.
+struct CodeGenFixture {
+  codegen::CompileOptions options;
+  CodeGenFixture() {
+    const char *tmp = std::getenv("TMPDIR");
+    std::string name = std::string(tmp && *tmp ? tmp : "/tmp") +
+                       "/aligator codegen 'test'.XXXXXX";
+    BOOST_REQUIRE(::mkdtemp(&name[0]) != nullptr);
+    options.cache_dir = name;
+  }
+  ~CodeGenFixture() { removeDir(options.cache_dir); }
+};
+
+BOOST_AUTO_TEST_CASE(symbolic_tape) {
+  using codegen::SymbolicScalar;
+  codegen::Tape tape;
+  SymbolicScalar x = SymbolicScalar::variable(tape, 0);
+  SymbolicScalar y = SymbolicScalar::variable(tape, 1);
+  // identical expressions are shared, constants are folded
+  const int n = (x * y).node(tape);
+  BOOST_CHECK_EQUAL(tape.size(), 3);
+  BOOST_CHECK_EQUAL((y * x).node(tape), n);
+  BOOST_CHECK_EQUAL(tape.size(), 3);
+  BOOST_CHECK_EQUAL((x * 1. + 0.).node(tape), x.node(tape));
+  BOOST_CHECK((SymbolicScalar(2.) * 3.).isConstant());
+  BOOST_CHECK_EQUAL((SymbolicScalar(2.) * 3.).value(), 6.);
+
+  const auto grad = tape.gradient(n, 2);
+  BOOST_CHECK_EQUAL(grad[0], y.node(tape));
+  BOOST_CHECK_EQUAL(grad[1], x.node(tape));
+}
+
+BOOST_FIXTURE_TEST_CASE(codegen_function, CodeGenFixture) {
+  const int nx = 3;
+  const int nu = 2;
+  using Function = CodeGenFunctionTpl<T, TestResidual>;
+  using Reference = ForwardDiffFunctionTpl<T, TestResidual>;
+  std::string path;
+  {
+    Function func(nx, nu, nx, 3, "test_residual", TestResidual(), true,
+                  options);
+    Reference ref(nx, nu, nx, 3, TestResidual(), true);
+    auto data = func.createData();
+    auto ref_data = ref.createData();
+
+    VectorXd x = VectorXd::Random(nx);
+    VectorXd u = VectorXd::Random(nu);
+    VectorXd y = VectorXd::Random(nx);
+    VectorXd lbda = VectorXd::Random(3);
+    func.evaluate(x, u, y, *data);
+    func.computeJacobians(x, u, y, *data);
+    func.computeVectorHessianProducts(x, u, y, lbda, *data);
+    ref.evaluate(x, u, y, *ref_data);
+    ref.computeJacobians(x, u, y, *ref_data);
+    ref.computeVectorHessianProducts(x, u, y, lbda, *ref_data);
+
+    BOOST_CHECK(data->value_.isApprox(ref_data->value_));
+    BOOST_CHECK(data->jac_buffer_.isApprox(ref_data->jac_buffer_));
+    BOOST_CHECK(data->vhp_buffer_.isApprox(ref_data->vhp_buffer_));
+    path = func.library().path();
+  }
+
+  // the compiled library is loaded from the cache, without compiling it
+  BOOST_CHECK(std::ifstream(path).good());
+  std::ofstream(path) << "not a library";
+  BOOST_CHECK_THROW(Function(nx, nu, nx, 3, "test_residual", TestResidual(),
+                             true, options),
+                    std::runtime_error);
+  std::remove(path.c_str());
+  Function func(nx, nu, nx, 3, "test_residual", TestResidual(), true, options);
+  BOOST_CHECK_EQUAL(func.library().path(), path);
+
+  BOOST_CHECK_THROW(Function(nx, nu, nx, 3, "1-residual"), std::runtime_error);
+}
+
+BOOST_FIXTURE_TEST_CASE(codegen_cache_dir, CodeGenFixture) {
+  using codegen::CompiledLibrary;
+  const std::string source =
+      "void copy(const double *in, double *out) { out[0] = in[0]; }\n";
+  const char *dir = options.cache_dir.c_str();
+
+  // the libraries of a cache other users can write to are not loaded
+  ::chmod(dir, 0777);
+  BOOST_CHECK_THROW(CompiledLibrary(source, options), std::runtime_error);
+  ::chmod(dir, 0700);
+  {
+    CompiledLibrary lib(source, options);
+    const double in = 3.;
+    double out = 0.;
+    lib.function<double>("copy")(&in, &out);
+    BOOST_CHECK_EQUAL(out, in);
+    ::chmod(lib.path().c_str(), 0666);
+  }
+  BOOST_CHECK_THROW(CompiledLibrary(source, options), std::runtime_error);
+
+  // the default cache is private, in the cache directory of the user
+  ::unsetenv("ALIGATOR_CODEGEN_CACHE_DIR");
+  ::setenv("XDG_CACHE_HOME", dir, 1);
+  CompiledLibrary lib(source);
+  const std::string default_dir = options.cache_dir + "/aligator-codegen";
+  BOOST_CHECK_EQUAL(lib.path().compare(0, default_dir.size(), default_dir), 0);
+  struct stat st;
+  BOOST_REQUIRE_EQUAL(::stat(default_dir.c_str(), &st), 0);
+  BOOST_CHECK_EQUAL(st.st_mode & 0777, 0700);
+  ::unsetenv("XDG_CACHE_HOME");
+}
+
+BOOST_FIXTURE_TEST_CASE(codegen_cost, CodeGenFixture) {
+  const int nx = 2;
+  const int nu = 2;
+  using Cost = CodeGenCostTpl<T, TestCost>;
+  Cost cost(nx, nu, "test_cost", TestCost(), options);
+  auto data = cost.createData();
+
+  VectorXd x = VectorXd::Random(nx);
+  VectorXd u = VectorXd::Random(nu);
+  cost.evaluate(x, u, *data);
+  cost.computeGradients(x, u, *data);
+  cost.computeHessians(x, u, *data);
+
+  const T a = x[0] * x[1];
+  const T s = 2. + x[1] * x[1];
+  BOOST_CHECK_CLOSE(data->value_,
+                    std::cos(a) + 0.5 * u.squaredNorm() + std::log(s) * u[0],
+                    1e-10);
+  VectorXd grad(nx + nu);
+  grad << -std::sin(a) * x[1], -std::sin(a) * x[0] + 2. * x[1] * u[0] / s,
+      u[0] + std::log(s), u[1];
+  BOOST_CHECK(data->grad_.isApprox(grad));
+
+  MatrixXd hess = MatrixXd::Zero(nx + nu, nx + nu);
+  hess(0, 0) = -std::cos(a) * x[1] * x[1];
+  hess(0, 1) = hess(1, 0) = -std::cos(a) * a - std::sin(a);
+  hess(1, 1) =
+      -std::cos(a) * x[0] * x[0] + u[0] * (2. * s - 4. * x[1] * x[1]) / (s * s);
+  hess(1, 2) = hess(2, 1) = 2. * x[1] / s;
+  hess(2, 2) = hess(3, 3) = 1.;
+  BOOST_CHECK(data->hess_.isApprox(hess));
+}
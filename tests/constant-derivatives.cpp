@@ -0,0 +1,253 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/solvers/fddp/solver-fddp.hpp"
+#include "aligator/modelling/linear-discrete-dynamics.hpp"
+#include "aligator/modelling/linear-function.hpp"
+#include "aligator/modelling/quad-costs.hpp"
+#include "aligator/modelling/sum-of-costs.hpp"
+#include "aligator/modelling/control-box-function.hpp"
+
+#include <proxsuite-nlp/modelling/constraints/negative-orthant.hpp>
+#include <proxsuite-nlp/modelling/constraints/equality-constraint.hpp>
+
+using namespace aligator;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using Dynamics = dynamics::LinearDiscreteDynamicsTpl<T>;
+using QuadCost = QuadraticCostTpl<T>;
+using EqualityConstraint = proxsuite::nlp::EqualityConstraint<T>;
+using NegativeOrthant = proxsuite::nlp::NegativeOrthant<T>;
+
+constexpr int NX = 4;
+constexpr int NU = 2;
+
+/// Linear function counting its Jacobian computations, which may declare
+/// non-constant Jacobians.
+struct CountingLinearFunction : LinearFunctionTpl<T> {
+  using Base = LinearFunctionTpl<T>;
+  bool constant;
+  mutable int num_jacobians = 0;
+
+  CountingLinearFunction(const MatrixXd &A, const MatrixXd &B, bool constant)
+      : Base(A, B, VectorXd::Zero(A.rows())), constant(constant) {}
+
+  void computeJacobians(const ConstVectorRef &x, const ConstVectorRef &u,
+                        const ConstVectorRef &y, Data &data) const override {
+    num_jacobians++;
+    Base::computeJacobians(x, u, y, data);
+  }
+
+  bool hasConstantJacobians() const override { return constant; }
+};
+
+/// Quadratic cost counting its Hessian computations.
+struct CountingQuadCost : QuadCost {
+  mutable int num_hessians = 0;
+
+  using QuadCost::QuadCost;
+
+  void computeHessians(const ConstVectorRef &x, const ConstVectorRef &u,
+                       CostData &data) const override {
+    num_hessians++;
+    QuadCost::computeHessians(x, u, data);
+  }
+};
+
+/// Linear dynamics which do not declare their Jacobians constant.
+struct NonConstantDynamics : Dynamics {
+  using Dynamics::Dynamics;
+  bool hasConstantJacobians() const override { return false; }
+};
+
+struct lq_fixture {
+  MatrixXd A = MatrixXd::Identity(NX, NX);
+  MatrixXd B = MatrixXd::Zero(NX, NU);
+  MatrixXd w_x = MatrixXd::Identity(NX, NX);
+  MatrixXd w_u = 1e-2 * MatrixXd::Identity(NU, NU);
+  // u[0] = u[1]
+  MatrixXd Bc = (MatrixXd(1, NU) << 1., -1.).finished();
+
+  lq_fixture() {
+    A.topRightCorner(NU, NU).diagonal().setConstant(0.1);
+    B.bottomRows(NU).setIdentity();
+  }
+
+  shared_ptr<StageModelTpl<T>> makeStage(bool constant) const {
+    shared_ptr<Dynamics> dyn;
+    if (constant)
+      dyn = std::make_shared<Dynamics>(A, B, VectorXd::Zero(NX));
+    else
+      dyn = std::make_shared<NonConstantDynamics>(A, B, VectorXd::Zero(NX));
+    auto cost = std::make_shared<QuadCost>(w_x, w_u);
+    auto stage = std::make_shared<StageModelTpl<T>>(cost, dyn);
+    auto func = std::make_shared<CountingLinearFunction>(
+        MatrixXd::Zero(1, NX), Bc, constant);
+    stage->addConstraint(func, std::make_shared<EqualityConstraint>());
+    auto box = std::make_shared<ControlBoxFunctionTpl<T>>(NX, NU, -0.5, 0.5);
+    stage->addConstraint(box, std::make_shared<NegativeOrthant>());
+    return stage;
+  }
+
+  TrajOptProblemTpl<T> makeProblem(std::size_t nsteps, bool constant) const {
+    auto stage = makeStage(constant);
+    auto term_cost = std::make_shared<QuadCost>(w_x, MatrixXd::Zero(NU, NU));
+    TrajOptProblemTpl<T> problem(VectorXd::Ones(NX), NU,
+                                 stage->xspace_next_, term_cost);
+    for (std::size_t i = 0; i < nsteps; i++)
+      problem.addStage(stage);
+    return problem;
+  }
+};
+
+BOOST_AUTO_TEST_CASE(declarations) {
+  MatrixXd A = MatrixXd::Identity(NX, NX);
+  MatrixXd B = MatrixXd::Ones(NX, NU);
+  Dynamics dyn(A, B, VectorXd::Zero(NX));
+  BOOST_CHECK(dyn.hasConstantJacobians());
+  ControlBoxFunctionTpl<T> box(NX, NU, -1., 1.);
+  BOOST_CHECK(box.hasConstantJacobians());
+
+  auto cost = std::make_shared<QuadCost>(A, MatrixXd::Identity(NU, NU));
+  BOOST_CHECK(cost->hasConstantHessians());
+  CostStackTpl<T> stack(cost);
+  BOOST_CHECK(stack.hasConstantHessians());
+  CostAbstractTpl<T> &base = stack;
+  BOOST_CHECK(base.hasConstantHessians());
+}
+
+BOOST_FIXTURE_TEST_CASE(stage_constant_derivatives, lq_fixture) {
+  for (bool constant : {true, false}) {
+    auto dyn = std::make_shared<Dynamics>(A, B, VectorXd::Zero(NX));
+    auto cost = std::make_shared<CountingQuadCost>(w_x, w_u);
+    auto func = std::make_shared<CountingLinearFunction>(
+        MatrixXd::Zero(1, NX), Bc, constant);
+    StageModelTpl<T> stage(cost, dyn);
+    stage.addConstraint(func, std::make_shared<EqualityConstraint>());
+    auto data = stage.createData();
+    const int per_call = constant ? 0 : 1;
+
+    VectorXd x = VectorXd::Random(NX);
+    VectorXd u = VectorXd::Random(NU);
+    VectorXd y = VectorXd::Random(NX);
+    stage.evaluate(x, u, y, *data);
+    stage.computeDerivatives(x, u, y, *data);
+    BOOST_CHECK_EQUAL(func->num_jacobians, 1);
+    BOOST_CHECK_EQUAL(cost->num_hessians, 1);
+    BOOST_CHECK(data->has_constant_derivatives);
+
+    // the constant derivatives are not computed again
+    x.setRandom();
+    stage.evaluate(x, u, y, *data);
+    stage.computeDerivatives(x, u, y, *data);
+    BOOST_CHECK_EQUAL(func->num_jacobians, 1 + per_call);
+    BOOST_CHECK_EQUAL(cost->num_hessians, 1);
+    u.setRandom();
+    stage.evaluateWithDerivatives(x, u, y, *data);
+    BOOST_CHECK_EQUAL(func->num_jacobians, 1 + 2 * per_call);
+    BOOST_CHECK_EQUAL(cost->num_hessians, 1);
+
+    const auto &fdata = *data->constraint_data[1];
+    BOOST_CHECK(fdata.Ju_.isApprox(Bc));
+    BOOST_CHECK(data->cost_data->Luu_.isApprox(w_u));
+    // the gradients are always computed
+    BOOST_CHECK(data->cost_data->Lu_.isApprox(w_u * u));
+
+    // invalidating the data computes them again
+    data->invalidateEvaluation();
+    stage.computeDerivatives(x, u, y, *data);
+    BOOST_CHECK_EQUAL(func->num_jacobians, 2 + 2 * per_call);
+    BOOST_CHECK_EQUAL(cost->num_hessians, 2);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(proxddp_constant_kkt_rows, lq_fixture) {
+  const std::size_t nsteps = 20;
+  const T tol = 1e-8;
+  auto problem = makeProblem(nsteps, true);
+  auto problem_ref = makeProblem(nsteps, false);
+
+  SolverProxDDP<T> solver(tol, 1e-6);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+  SolverProxDDP<T> solver_ref(tol, 1e-6);
+  solver_ref.setup(problem_ref);
+  BOOST_CHECK(solver_ref.run(problem_ref));
+
+  // caching the rows of the constant constraints does not change the iterates
+  BOOST_CHECK_EQUAL(solver.results_.num_iters, solver_ref.results_.num_iters);
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(solver.results_.us[t].isApprox(solver_ref.results_.us[t]));
+    BOOST_CHECK(
+        solver.results_.xs[t + 1].isApprox(solver_ref.results_.xs[t + 1]));
+    BOOST_CHECK(solver.workspace_.kkt_mats_[t + 1].isApprox(
+        solver_ref.workspace_.kkt_mats_[t + 1]));
+    BOOST_CHECK(solver.workspace_.kkt_constant_rows_[t + 1]);
+  }
+
+  // cycling the problem assembles the KKT systems again
+  solver.cycleProblem(problem, makeStage(true));
+  BOOST_CHECK(!solver.workspace_.kkt_constant_rows_[1]);
+  BOOST_CHECK(!solver.workspace_.kkt_constant_rows_[nsteps]);
+  solver_ref.cycleProblem(problem_ref, makeStage(false));
+  BOOST_CHECK(solver.run(problem));
+  BOOST_CHECK(solver_ref.run(problem_ref));
+  BOOST_CHECK_EQUAL(solver.results_.num_iters, solver_ref.results_.num_iters);
+  for (std::size_t t = 0; t < nsteps; t++)
+    BOOST_CHECK(solver.results_.us[t].isApprox(solver_ref.results_.us[t]));
+}
+
+BOOST_FIXTURE_TEST_CASE(parameters_change_between_runs, lq_fixture) {
+  const std::size_t nsteps = 20;
+  const T tol = 1e-8;
+  auto problem = makeProblem(nsteps, true);
+  SolverProxDDP<T> solver(tol, 1e-6);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+
+  // change the cost weights and the constraint matrix, in place
+  auto &stage = *problem.stages_[0];
+  auto &cost = static_cast<QuadCost &>(*stage.cost_);
+  cost.setWeightsX(10. * cost.getWeightsX());
+  auto &func = static_cast<CountingLinearFunction &>(
+      *stage.constraints_[1].func);
+  func.B_ << 1., 0.;
+  const int num_jacobians = func.num_jacobians;
+  BOOST_CHECK(solver.run(problem));
+  BOOST_CHECK_GT(func.num_jacobians, num_jacobians);
+
+  SolverProxDDP<T> solver_ref(tol, 1e-6);
+  solver_ref.setup(problem);
+  BOOST_CHECK(solver_ref.run(problem));
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK_SMALL((solver.results_.us[t] - solver_ref.results_.us[t]).norm(),
+                      1e-6);
+    BOOST_CHECK_SMALL(solver.results_.us[t][0], 1e-6);
+  }
+}
+
+BOOST_FIXTURE_TEST_CASE(fddp_parameters_change_between_runs, lq_fixture) {
+  const std::size_t nsteps = 20;
+  const T tol = 1e-8;
+  auto dyn = std::make_shared<Dynamics>(A, B, VectorXd::Zero(NX));
+  auto cost = std::make_shared<QuadCost>(w_x, w_u);
+  TrajOptProblemTpl<T> problem(VectorXd::Ones(NX), NU, dyn->space_next_,
+                               std::make_shared<QuadCost>(w_x, w_u));
+  for (std::size_t i = 0; i < nsteps; i++)
+    problem.addStage(std::make_shared<StageModelTpl<T>>(cost, dyn));
+
+  SolverFDDP<T> solver(tol);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+  cost->setWeightsU(100. * cost->getWeightsU());
+  BOOST_CHECK(solver.run(problem));
+
+  SolverFDDP<T> solver_ref(tol);
+  solver_ref.setup(problem);
+  BOOST_CHECK(solver_ref.run(problem));
+  for (std::size_t t = 0; t < nsteps; t++)
+    BOOST_CHECK_SMALL((solver.results_.us[t] - solver_ref.results_.us[t]).norm(),
+                      1e-6);
+}
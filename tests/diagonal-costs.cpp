@@ -0,0 +1,214 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/modelling/quad-costs.hpp"
+#include "aligator/modelling/quad-state-cost.hpp"
+#include "aligator/modelling/sum-of-costs.hpp"
+#include "aligator/modelling/constant-cost.hpp"
+
+using namespace aligator;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using QuadCost = QuadraticCostTpl<T>;
+using CostData = CostDataAbstractTpl<T>;
+using VectorSpace = proxsuite::nlp::VectorSpaceTpl<T>;
+
+constexpr int NX = 6;
+constexpr int NU = 3;
+
+/// Check the value, gradient and Hessian of @p cost against the quadratic
+/// form \f$\frac12 z^\top H z + g^\top z\f$ in \f$z = (x - x_0, u - u_0)\f$.
+void checkQuadratic(const CostAbstractTpl<T> &cost, const MatrixXd &H,
+                    const VectorXd &z0) {
+  auto data = cost.createData();
+  for (int k = 0; k < 3; k++) {
+    VectorXd x = VectorXd::Random(NX);
+    VectorXd u = VectorXd::Random(NU);
+    VectorXd z(NX + NU);
+    z << x, u;
+    z -= z0;
+    cost.evaluateWithDerivatives(x, u, *data);
+    BOOST_CHECK_CLOSE(data->value_, 0.5 * z.dot(H * z), 1e-10);
+    BOOST_CHECK(data->grad_.isApprox(H * z));
+    BOOST_CHECK(data->hess_.isApprox(H));
+
+    // the separate calls agree with the combined evaluation
+    auto data2 = cost.createData();
+    cost.evaluate(x, u, *data2);
+    cost.computeGradients(x, u, *data2);
+    cost.computeHessians(x, u, *data2);
+    BOOST_CHECK_CLOSE(data2->value_, data->value_, 1e-10);
+    BOOST_CHECK(data2->grad_.isApprox(data->grad_));
+    BOOST_CHECK(data2->hess_.isApprox(data->hess_));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(quadratic_cost) {
+  MatrixXd w_x = VectorXd::Random(NX).cwiseAbs().asDiagonal();
+  MatrixXd w_u = VectorXd::Random(NU).cwiseAbs().asDiagonal();
+  MatrixXd H = MatrixXd::Zero(NX + NU, NX + NU);
+  H.topLeftCorner(NX, NX) = w_x;
+  H.bottomRightCorner(NU, NU) = w_u;
+
+  QuadCost cost(w_x, w_u);
+  BOOST_CHECK(cost.hasDiagonalWeights());
+  BOOST_CHECK(cost.createData()->hess_structure_ ==
+              HessianStructure::DIAGONAL);
+  checkQuadratic(cost, H, VectorXd::Zero(NX + NU));
+
+  // dense state weights
+  MatrixXd A = MatrixXd::Random(NX, NX);
+  cost.setWeightsX(A.transpose() * A);
+  BOOST_CHECK(!cost.hasDiagonalWeights());
+  BOOST_CHECK(cost.createData()->hess_structure_ ==
+              HessianStructure::BLOCK_DIAGONAL);
+  H.topLeftCorner(NX, NX) = cost.getWeightsX();
+  checkQuadratic(cost, H, VectorXd::Zero(NX + NU));
+
+  // a cross term makes the Hessian dense
+  cost.setWeightsX(w_x);
+  MatrixXd w_cross = 0.1 * MatrixXd::Random(NX, NU);
+  cost.setCrossWeight(w_cross);
+  BOOST_CHECK(cost.createData()->hess_structure_ == HessianStructure::DENSE);
+  H.topLeftCorner(NX, NX) = w_x;
+  H.topRightCorner(NX, NU) = w_cross;
+  H.bottomLeftCorner(NU, NX) = w_cross.transpose();
+  checkQuadratic(cost, H, VectorXd::Zero(NX + NU));
+}
+
+BOOST_AUTO_TEST_CASE(quadratic_state_control_costs) {
+  auto space = std::make_shared<VectorSpace>(NX);
+  VectorXd x_target = VectorXd::Random(NX);
+  VectorXd u_target = VectorXd::Random(NU);
+  VectorXd z0(NX + NU);
+  MatrixXd w_x = VectorXd::Random(NX).cwiseAbs().asDiagonal();
+  MatrixXd w_u = VectorXd::Random(NU).cwiseAbs().asDiagonal();
+
+  QuadraticStateCostTpl<T> xcost(space, NU, x_target, w_x);
+  BOOST_CHECK(xcost.hasDiagonalWeights());
+  BOOST_CHECK(xcost.createData()->hess_structure_ ==
+              HessianStructure::DIAGONAL);
+  MatrixXd H = MatrixXd::Zero(NX + NU, NX + NU);
+  H.topLeftCorner(NX, NX) = w_x;
+  z0 << x_target, VectorXd::Zero(NU);
+  checkQuadratic(xcost, H, z0);
+
+  QuadraticControlCostTpl<T> ucost(space, u_target, w_u);
+  BOOST_CHECK(ucost.createData()->hess_structure_ ==
+              HessianStructure::DIAGONAL);
+  H.setZero();
+  H.bottomRightCorner(NU, NU) = w_u;
+  z0 << VectorXd::Zero(NX), u_target;
+  checkQuadratic(ucost, H, z0);
+
+  // dense weights: only the state block is computed
+  MatrixXd A = MatrixXd::Random(NX, NX);
+  xcost.setWeights(A.transpose() * A);
+  BOOST_CHECK(!xcost.hasDiagonalWeights());
+  BOOST_CHECK(xcost.createData()->hess_structure_ ==
+              HessianStructure::BLOCK_DIAGONAL);
+  H.setZero();
+  H.topLeftCorner(NX, NX) = xcost.getWeights();
+  z0 << x_target, VectorXd::Zero(NU);
+  checkQuadratic(xcost, H, z0);
+}
+
+BOOST_AUTO_TEST_CASE(cost_stack) {
+  auto space = std::make_shared<VectorSpace>(NX);
+  VectorXd x_target = VectorXd::Random(NX);
+  VectorXd u_target = VectorXd::Random(NU);
+  MatrixXd w_x = VectorXd::Random(NX).cwiseAbs().asDiagonal();
+  MatrixXd w_u = VectorXd::Random(NU).cwiseAbs().asDiagonal();
+  auto xcost =
+      std::make_shared<QuadraticStateCostTpl<T>>(space, NU, x_target, w_x);
+  auto ucost = std::make_shared<QuadraticControlCostTpl<T>>(space, u_target,
+                                                            w_u);
+  auto ccost = std::make_shared<ConstantCostTpl<T>>(space, NU, 1.);
+
+  CostStackTpl<T> stack(space, NU, {xcost, ucost, ccost}, {2., 0.5, 1.});
+  auto data = stack.createData();
+  BOOST_CHECK(data->hess_structure_ == HessianStructure::DIAGONAL);
+  VectorXd x = VectorXd::Random(NX);
+  VectorXd u = VectorXd::Random(NU);
+  stack.evaluateWithDerivatives(x, u, *data);
+  MatrixXd H = MatrixXd::Zero(NX + NU, NX + NU);
+  H.topLeftCorner(NX, NX) = 2. * w_x;
+  H.bottomRightCorner(NU, NU) = 0.5 * w_u;
+  BOOST_CHECK(data->hess_.isApprox(H));
+  VectorXd g(NX + NU);
+  g << 2. * w_x * (x - x_target), 0.5 * w_u * (u - u_target);
+  BOOST_CHECK(data->grad_.isApprox(g));
+
+  // the stack is as structured as its least structured component
+  MatrixXd A = MatrixXd::Random(NU, NU);
+  auto dense_u = std::make_shared<QuadCost>(MatrixXd::Zero(NX, NX),
+                                            A.transpose() * A);
+  stack.addCost(dense_u, 1.);
+  data = stack.createData();
+  BOOST_CHECK(data->hess_structure_ == HessianStructure::BLOCK_DIAGONAL);
+  stack.computeGradients(x, u, *data);
+  stack.computeHessians(x, u, *data);
+  H.bottomRightCorner(NU, NU) += A.transpose() * A;
+  BOOST_CHECK(data->hess_.isApprox(H));
+
+  MatrixXd w_cross = MatrixXd::Random(NX, NU);
+  stack.addCost(std::make_shared<QuadCost>(MatrixXd::Zero(NX, NX),
+                                           MatrixXd::Zero(NU, NU), w_cross),
+                1.);
+  data = stack.createData();
+  BOOST_CHECK(data->hess_structure_ == HessianStructure::DENSE);
+  stack.computeGradients(x, u, *data);
+  stack.computeHessians(x, u, *data);
+  H.topRightCorner(NX, NU) = w_cross;
+  H.bottomLeftCorner(NU, NX) = w_cross.transpose();
+  BOOST_CHECK(data->hess_.isApprox(H));
+}
+
+BOOST_AUTO_TEST_CASE(weights_changed_after_create_data) {
+  auto space = std::make_shared<VectorSpace>(NX);
+  VectorXd x_target = VectorXd::Random(NX);
+  auto qcost = std::make_shared<QuadCost>(MatrixXd::Identity(NX, NX),
+                                          MatrixXd::Identity(NU, NU));
+  auto xcost = std::make_shared<QuadraticStateCostTpl<T>>(
+      space, NU, x_target, MatrixXd::Identity(NX, NX));
+  CostStackTpl<T> stack(space, NU, {qcost, xcost}, {1., 1.});
+  auto data = stack.createData();
+  BOOST_CHECK(data->hess_structure_ == HessianStructure::DIAGONAL);
+
+  // off-diagonal weights, set after the data was created
+  MatrixXd A = MatrixXd::Random(NX, NX);
+  MatrixXd Q = A.transpose() * A;
+  MatrixXd B = MatrixXd::Random(NU, NU);
+  MatrixXd R = B.transpose() * B;
+  qcost->setWeightsU(R);
+  xcost->setWeights(Q);
+  BOOST_CHECK(!qcost->hasDiagonalWeights());
+  BOOST_CHECK(!xcost->hasDiagonalWeights());
+
+  VectorXd x = VectorXd::Random(NX);
+  VectorXd u = VectorXd::Random(NU);
+  MatrixXd H = MatrixXd::Zero(NX + NU, NX + NU);
+  H.topLeftCorner(NX, NX) = MatrixXd::Identity(NX, NX) + Q;
+  H.bottomRightCorner(NU, NU) = R;
+  VectorXd g(NX + NU);
+  g << x + Q * (x - x_target), R * u;
+  const T value = 0.5 * (x.squaredNorm() + u.dot(R * u) +
+                         (x - x_target).dot(Q * (x - x_target)));
+  stack.evaluateWithDerivatives(x, u, *data);
+  BOOST_CHECK(data->hess_structure_ == HessianStructure::BLOCK_DIAGONAL);
+  BOOST_CHECK_CLOSE(data->value_, value, 1e-10);
+  BOOST_CHECK(data->grad_.isApprox(g));
+  BOOST_CHECK(data->hess_.isApprox(H));
+
+  // back to diagonal weights: the stale off-diagonal entries are cleared
+  qcost->setWeightsU(MatrixXd::Identity(NU, NU));
+  xcost->setWeights(MatrixXd::Identity(NX, NX));
+  stack.evaluate(x, u, *data);
+  stack.computeGradients(x, u, *data);
+  stack.computeHessians(x, u, *data);
+  BOOST_CHECK(data->hess_structure_ == HessianStructure::DIAGONAL);
+  H.setIdentity();
+  H.topLeftCorner(NX, NX) *= 2.;
+  BOOST_CHECK(data->hess_.isApprox(H));
+}
@@ -0,0 +1,133 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+
+#include "generate-problem.hpp"
+
+#include <proxsuite-nlp/modelling/constraints/equality-constraint.hpp>
+#include <proxsuite-nlp/modelling/constraints/negative-orthant.hpp>
+
+#include <atomic>
+
+using namespace aligator;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+/// r(x) = |x|^2 - c, with an exact vector-Hessian product.
+struct SquaredNormResidual : UnaryFunctionTpl<T> {
+  ALIGATOR_DYNAMIC_TYPEDEFS(T);
+  ALIGATOR_UNARY_FUNCTION_INTERFACE(T);
+  using BaseData = typename Base::Data;
+
+  T c;
+  mutable std::atomic<int> num_vhp{0};
+
+  SquaredNormResidual(int ndx, int nu, T c) : Base(ndx, nu, 1), c(c) {}
+
+  void evaluate(const ConstVectorRef &x, BaseData &data) const override {
+    data.value_(0) = x.squaredNorm() - c;
+  }
+
+  void computeJacobians(const ConstVectorRef &x,
+                        BaseData &data) const override {
+    data.Jx_ = 2. * x.transpose();
+  }
+
+  void computeVectorHessianProducts(const ConstVectorRef &,
+                                    const ConstVectorRef &lbda,
+                                    BaseData &data) const override {
+    num_vhp++;
+    data.Hxx_.setIdentity();
+    data.Hxx_ *= 2. * lbda(0);
+  }
+};
+
+struct ExactHessianFixture {
+  using EqualityConstraint = proxsuite::nlp::EqualityConstraint<T>;
+  using NegativeOrthant = proxsuite::nlp::NegativeOrthant<T>;
+  static constexpr int nx = 4;
+  static constexpr int nu = 2;
+  static constexpr std::size_t nsteps = 20;
+
+  shared_ptr<SquaredNormResidual> func;
+  shared_ptr<SquaredNormResidual> term_func;
+  TrajOptProblemTpl<T> problem;
+
+  ExactHessianFixture()
+      : func(std::make_shared<SquaredNormResidual>(nx, nu, 5.)),
+        term_func(std::make_shared<SquaredNormResidual>(nx, nu, 0.5)),
+        problem(VectorXd::Ones(nx), nu, std::make_shared<VectorSpaceTpl<T>>(nx),
+                makeLqrCost(nx, nu)) {
+    auto stage = std::make_shared<StageModelTpl<T>>(makeLqrCost(nx, nu),
+                                                    makeLqrDynamics(nx, nu));
+    // inactive at the solution
+    stage->addConstraint(func, std::make_shared<NegativeOrthant>());
+    for (std::size_t i = 0; i < nsteps; i++)
+      problem.addStage(stage);
+    problem.addTerminalConstraint(
+        {term_func, std::make_shared<EqualityConstraint>()});
+  }
+};
+
+BOOST_FIXTURE_TEST_CASE(vector_hessian_products, ExactHessianFixture) {
+  TrajOptDataTpl<T> data(problem);
+  std::vector<VectorXd> xs(nsteps + 1, VectorXd::Random(nx));
+  std::vector<VectorXd> us(nsteps, VectorXd::Random(nu));
+  // multipliers: initial condition, dynamics and constraint of each stage,
+  // terminal constraint
+  std::vector<VectorXd> lams(nsteps + 2, VectorXd::Zero(nx + 1));
+  lams[0] = VectorXd::Zero(nx);
+  for (std::size_t i = 0; i < nsteps; i++)
+    lams[i + 1](nx) = 0.5 + T(i);
+  lams[nsteps + 1] = VectorXd::Constant(1, -0.25);
+  // inactive constraint
+  lams[3].setZero();
+
+  problem.evaluate(xs, us, data);
+  BOOST_CHECK_THROW(problem.computeDerivatives(xs, us, {lams[0]}, data),
+                    std::runtime_error);
+  problem.computeDerivatives(xs, us, lams, data);
+  BOOST_CHECK_EQUAL(func->num_vhp, nsteps - 1);
+  BOOST_CHECK_EQUAL(term_func->num_vhp, 1);
+  for (std::size_t i = 0; i < nsteps; i++) {
+    const auto &cd = *data.stage_data[i]->constraint_data[1];
+    MatrixXd Hxx_ref = 2. * lams[i + 1](nx) * MatrixXd::Identity(nx, nx);
+    BOOST_CHECK(cd.Hxx_.isApprox(Hxx_ref));
+    BOOST_CHECK(cd.Huu_.isZero(0));
+  }
+  BOOST_CHECK(data.stage_data[2]->constraint_data[1]->vhp_buffer_.isZero(0));
+  BOOST_CHECK(data.term_cstr_data[0]->Hxx_.isApprox(
+      -0.5 * MatrixXd::Identity(nx, nx)));
+
+  // without multipliers, the products are not computed
+  func->num_vhp = 0;
+  problem.computeDerivatives(xs, us, data);
+  BOOST_CHECK_EQUAL(func->num_vhp, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(proxddp_exact_hessian, ExactHessianFixture) {
+  const T tol = 1e-7;
+  SolverProxDDP<T> solver(tol, 1e-2, 0., 100, VerboseLevel::QUIET,
+                          HessianApprox::EXACT);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+  BOOST_CHECK_CLOSE(solver.results_.xs[nsteps].squaredNorm(), term_func->c,
+                    1e-4);
+  BOOST_CHECK_GT(term_func->num_vhp, 0);
+  // the multipliers of the stage constraints are zero
+  BOOST_CHECK_EQUAL(func->num_vhp, 0);
+
+  // the products are computed in the parallel derivative loop
+  problem.setNumThreads(2);
+  SolverProxDDP<T> solver_mt(tol, 1e-2, 0., 100, VerboseLevel::QUIET,
+                             HessianApprox::EXACT);
+  solver_mt.setup(problem);
+  BOOST_CHECK(solver_mt.run(problem));
+  BOOST_CHECK_EQUAL(solver_mt.results_.num_iters, solver.results_.num_iters);
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(solver.results_.us[t].isApprox(solver_mt.results_.us[t]));
+  }
+  problem.setNumThreads(1);
+}
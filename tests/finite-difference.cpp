@@ -0,0 +1,136 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/modelling/autodiff/finite-difference.hpp"
+#include "aligator/modelling/autodiff/forward-diff.hpp"
+
+#include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
+
+using namespace aligator;
+using namespace aligator::autodiff;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using Scheme = FiniteDifferenceScheme;
+
+/// r(x, u, y) = (sin(x0) u0 + y1^3, exp(x1 - u1) y0)
+struct TestResidual {
+  template <typename S>
+  void operator()(const internal::VectorX<S> &x, const internal::VectorX<S> &u,
+                  const internal::VectorX<S> &y,
+                  internal::VectorX<S> &r) const {
+    using std::exp;
+    using std::sin;
+    r[0] = sin(x[0]) * u[0] + y[1] * y[1] * y[1];
+    r[1] = exp(x[1] - u[1]) * y[0];
+  }
+};
+
+/// l(x, u) = exp(x0) x1^2 + sin(u0 x1)
+struct TestCost : CostAbstractTpl<T> {
+  using VectorSpace = proxsuite::nlp::VectorSpaceTpl<T>;
+
+  TestCost() : CostAbstractTpl<T>(std::make_shared<VectorSpace>(2), 1) {}
+
+  void evaluate(const ConstVectorRef &x, const ConstVectorRef &u,
+                CostData &data) const override {
+    data.value_ = std::exp(x[0]) * x[1] * x[1] + std::sin(u[0] * x[1]);
+  }
+
+  void computeGradients(const ConstVectorRef &, const ConstVectorRef &,
+                        CostData &) const override {}
+
+  void computeHessians(const ConstVectorRef &, const ConstVectorRef &,
+                       CostData &) const override {}
+
+  static MatrixXd hessian(const VectorXd &x, const VectorXd &u) {
+    const T e = std::exp(x[0]);
+    const T s = std::sin(u[0] * x[1]);
+    const T c = std::cos(u[0] * x[1]);
+    MatrixXd H(3, 3);
+    H << e * x[1] * x[1], 2. * e * x[1], 0., //
+        2. * e * x[1], 2. * e - u[0] * u[0] * s, c - u[0] * x[1] * s, //
+        0., c - u[0] * x[1] * s, -x[1] * x[1] * s;
+    return H;
+  }
+};
+
+struct FiniteDifferenceFixture {
+  static constexpr int nx = 3;
+  static constexpr int nu = 2;
+  shared_ptr<proxsuite::nlp::VectorSpaceTpl<T>> space;
+  shared_ptr<ForwardDiffFunctionTpl<T, TestResidual>> func;
+  shared_ptr<StageFunctionDataTpl<T>> ref_data;
+  VectorXd x, u, y;
+
+  FiniteDifferenceFixture()
+      : space(std::make_shared<proxsuite::nlp::VectorSpaceTpl<T>>(nx)),
+        func(std::make_shared<ForwardDiffFunctionTpl<T, TestResidual>>(
+            nx, nu, nx, 2)),
+        ref_data(func->createData()), x(VectorXd::Random(nx)),
+        u(VectorXd::Random(nu)), y(VectorXd::Random(nx)) {
+    func->computeJacobians(x, u, y, *ref_data);
+  }
+
+  /// Largest error of the finite-difference Jacobians.
+  T jacobianError(const FiniteDifferenceHelper<T> &fd) const {
+    auto data = fd.createData();
+    fd.evaluate(x, u, y, *data);
+    fd.computeJacobians(x, u, y, *data);
+    return (data->jac_buffer_ - ref_data->jac_buffer_).cwiseAbs().maxCoeff();
+  }
+};
+
+BOOST_FIXTURE_TEST_CASE(finite_difference_schemes, FiniteDifferenceFixture) {
+  const T h = 1e-3;
+  const T err_fwd = jacobianError({space, func, h, Scheme::FORWARD});
+  const T err_central = jacobianError({space, func, h, Scheme::CENTRAL});
+  const T err_richardson = jacobianError({space, func, h, Scheme::RICHARDSON});
+  BOOST_CHECK_LT(err_fwd, 1e-2);
+  BOOST_CHECK_LT(err_central, 1e-5);
+  BOOST_CHECK_LT(err_richardson, 1e-9);
+  BOOST_CHECK_LT(err_central, err_fwd);
+  BOOST_CHECK_LT(err_richardson, err_central);
+}
+
+BOOST_FIXTURE_TEST_CASE(finite_difference_parallel, FiniteDifferenceFixture) {
+  FiniteDifferenceHelper<T> fd(space, func, 1e-5, Scheme::CENTRAL);
+  auto data = fd.createData();
+  fd.evaluate(x, u, y, *data);
+  fd.computeJacobians(x, u, y, *data);
+
+  fd.setNumThreads(3);
+  auto data_mt = fd.createData();
+  fd.evaluate(x, u, y, *data_mt);
+  fd.computeJacobians(x, u, y, *data_mt);
+  BOOST_CHECK(data_mt->jac_buffer_ == data->jac_buffer_);
+  BOOST_CHECK_LT(
+      (data_mt->jac_buffer_ - ref_data->jac_buffer_).cwiseAbs().maxCoeff(),
+      1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(cost_finite_difference_hessians) {
+  auto cost = std::make_shared<TestCost>();
+  VectorXd x = VectorXd::Random(2);
+  VectorXd u = VectorXd::Random(1);
+  const MatrixXd H = TestCost::hessian(x, u);
+
+  for (Scheme scheme : {Scheme::FORWARD, Scheme::CENTRAL, Scheme::RICHARDSON}) {
+    CostFiniteDifferenceHelper<T> fd(cost, 1e-4, scheme);
+    auto data = fd.createData();
+    fd.evaluate(x, u, *data);
+    fd.computeGradients(x, u, *data);
+    fd.computeHessians(x, u, *data);
+    BOOST_CHECK(data->hess_.isApprox(data->hess_.transpose()));
+    const T tol = scheme == Scheme::FORWARD ? 1e-3 : 1e-6;
+    BOOST_CHECK_LT((data->hess_ - H).cwiseAbs().maxCoeff(), tol);
+
+    fd.setNumThreads(2);
+    auto data_mt = fd.createData();
+    fd.evaluate(x, u, *data_mt);
+    fd.computeGradients(x, u, *data_mt);
+    fd.computeHessians(x, u, *data_mt);
+    BOOST_CHECK(data_mt->grad_ == data->grad_);
+    BOOST_CHECK(data_mt->hess_ == data->hess_);
+  }
+}
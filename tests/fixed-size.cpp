@@ -0,0 +1,112 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/fddp/solver-fddp.hpp"
+#include "aligator/modelling/linear-discrete-dynamics.hpp"
+#include "aligator/modelling/linear-discrete-dynamics-fixed.hpp"
+#include "aligator/modelling/quad-costs-fixed.hpp"
+
+using namespace aligator;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+constexpr int NX = 4;
+constexpr int NU = 2;
+
+using Dynamics = dynamics::LinearDiscreteDynamicsTpl<T>;
+using DynamicsFixed = dynamics::LinearDiscreteDynamicsFixedTpl<T, NX, NU>;
+using QuadCost = QuadraticCostTpl<T>;
+using QuadCostFixed = QuadraticCostFixedTpl<T, NX, NU>;
+
+struct lqr_fixture {
+  MatrixXd A = MatrixXd::Identity(NX, NX);
+  MatrixXd B = MatrixXd::Zero(NX, NU);
+  VectorXd c = VectorXd::Constant(NX, 0.01);
+  MatrixXd w_x = MatrixXd::Identity(NX, NX);
+  MatrixXd w_u = 1e-2 * MatrixXd::Identity(NU, NU);
+  MatrixXd w_cross = MatrixXd::Constant(NX, NU, 0.01);
+  VectorXd x0 = VectorXd::Ones(NX);
+
+  lqr_fixture() {
+    A.topRightCorner(NU, NU).diagonal().setConstant(0.1);
+    B.bottomRows(NU).setIdentity();
+  }
+
+  TrajOptProblemTpl<T> dynamicProblem(std::size_t nsteps) const {
+    auto dyn = std::make_shared<Dynamics>(A, B, c);
+    auto cost = std::make_shared<QuadCost>(w_x, w_u, w_cross);
+    auto stage = std::make_shared<StageModelTpl<T>>(cost, dyn);
+    TrajOptProblemTpl<T> problem(x0, NU, dyn->space_next_, cost);
+    for (std::size_t i = 0; i < nsteps; i++)
+      problem.addStage(stage);
+    return problem;
+  }
+
+  TrajOptProblemTpl<T> fixedProblem(std::size_t nsteps) const {
+    auto dyn = allocate_shared_eigen_aligned<DynamicsFixed>(A, B, c);
+    auto cost = allocate_shared_eigen_aligned<QuadCostFixed>(
+        w_x, w_u, w_cross, VectorXd::Zero(NX), VectorXd::Zero(NU));
+    auto stage = std::make_shared<StageModelTpl<T>>(cost, dyn);
+    TrajOptProblemTpl<T> problem(x0, NU, dyn->space_next_, cost);
+    for (std::size_t i = 0; i < nsteps; i++)
+      problem.addStage(stage);
+    return problem;
+  }
+};
+
+BOOST_FIXTURE_TEST_CASE(fixed_size_models, lqr_fixture) {
+  Dynamics dyn(A, B, c);
+  DynamicsFixed dyn_fixed(A, B, c);
+  QuadCost cost(w_x, w_u, w_cross);
+  QuadCostFixed cost_fixed(w_x, w_u, w_cross, VectorXd::Zero(NX),
+                           VectorXd::Zero(NU));
+  BOOST_CHECK(cost_fixed.hasCrossTerm());
+
+  VectorXd x = VectorXd::Random(NX);
+  VectorXd u = VectorXd::Random(NU);
+
+  auto dd = dyn.createData();
+  auto dd_fixed = dyn_fixed.createData();
+  dyn.evaluate(x, u, x, *dd);
+  dyn_fixed.evaluate(x, u, x, *dd_fixed);
+  dyn.computeJacobians(x, u, x, *dd);
+  dyn_fixed.computeJacobians(x, u, x, *dd_fixed);
+  BOOST_CHECK(dd->value_.isApprox(dd_fixed->value_));
+  BOOST_CHECK(dd->jac_buffer_.isApprox(dd_fixed->jac_buffer_));
+
+  auto cd = cost.createData();
+  auto cd_fixed = cost_fixed.createData();
+  cost.evaluate(x, u, *cd);
+  cost_fixed.evaluate(x, u, *cd_fixed);
+  cost.computeGradients(x, u, *cd);
+  cost_fixed.computeGradients(x, u, *cd_fixed);
+  BOOST_CHECK_CLOSE(cd->value_, cd_fixed->value_, 1e-10);
+  BOOST_CHECK(cd->grad_.isApprox(cd_fixed->grad_));
+  BOOST_CHECK(cd->hess_.isApprox(cd_fixed->hess_));
+}
+
+BOOST_FIXTURE_TEST_CASE(fddp_fixed_size, lqr_fixture) {
+  const std::size_t nsteps = 30;
+  const T tol = 1e-8;
+  auto problem = dynamicProblem(nsteps);
+  auto problem_fixed = fixedProblem(nsteps);
+
+  SolverFDDP<T> solver(tol);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+
+  SolverFDDP<T, NX, NU> solver_fixed(tol);
+  solver_fixed.setup(problem_fixed);
+  BOOST_CHECK(solver_fixed.run(problem_fixed));
+
+  BOOST_CHECK_EQUAL(solver.results_.num_iters, solver_fixed.results_.num_iters);
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(solver.results_.us[t].isApprox(solver_fixed.results_.us[t]));
+    BOOST_CHECK(solver.results_.xs[t + 1].isApprox(
+        solver_fixed.results_.xs[t + 1]));
+  }
+
+  // the dimensions are checked at setup
+  SolverFDDP<T, NX + 1, NU> solver_wrong(tol);
+  BOOST_CHECK_THROW(solver_wrong.setup(problem), std::runtime_error);
+}
@@ -0,0 +1,138 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/modelling/autodiff/forward-diff.hpp"
+#include "aligator/modelling/autodiff/finite-difference.hpp"
+
+#include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
+
+using namespace aligator;
+using namespace aligator::autodiff;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+/// r(x, u, y) = (sin(x0) u0 + y1^2, |x|^2 - u1 exp(y0))
+struct TestResidual {
+  template <typename S>
+  void operator()(const internal::VectorX<S> &x, const internal::VectorX<S> &u,
+                  const internal::VectorX<S> &y,
+                  internal::VectorX<S> &r) const {
+    using std::exp;
+    using std::sin;
+    r[0] = sin(x[0]) * u[0] + y[1] * y[1];
+    r[1] = x.squaredNorm() - u[1] * exp(y[0]);
+  }
+};
+
+/// r(x) = (x0 x1, 3), with a constant output
+struct TestUnaryResidual {
+  template <typename S>
+  void operator()(const internal::VectorX<S> &x,
+                  internal::VectorX<S> &r) const {
+    r[0] = x[0] * x[1];
+    r[1] = S(3.);
+  }
+};
+
+BOOST_AUTO_TEST_CASE(forward_diff_jacobians) {
+  const int nx = 3;
+  const int nu = 2;
+  using Function = ForwardDiffFunctionTpl<T, TestResidual>;
+  auto func = std::make_shared<Function>(nx, nu, nx, 2);
+  auto data = func->createData();
+
+  VectorXd x = VectorXd::Random(nx);
+  VectorXd u = VectorXd::Random(nu);
+  VectorXd y = VectorXd::Random(nx);
+  func->evaluate(x, u, y, *data);
+  VectorXd value = data->value_;
+  BOOST_CHECK_CLOSE(value[1], x.squaredNorm() - u[1] * std::exp(y[0]), 1e-12);
+
+  data->value_.setZero();
+  func->computeJacobians(x, u, y, *data);
+  BOOST_CHECK(data->value_.isApprox(value));
+
+  MatrixXd Jx = MatrixXd::Zero(2, nx);
+  Jx(0, 0) = std::cos(x[0]) * u[0];
+  Jx.row(1) = 2. * x.transpose();
+  MatrixXd Ju = MatrixXd::Zero(2, nu);
+  Ju(0, 0) = std::sin(x[0]);
+  Ju(1, 1) = -std::exp(y[0]);
+  MatrixXd Jy = MatrixXd::Zero(2, nx);
+  Jy(0, 1) = 2. * y[1];
+  Jy(1, 0) = -u[1] * std::exp(y[0]);
+  BOOST_CHECK(data->Jx_.isApprox(Jx));
+  BOOST_CHECK(data->Ju_.isApprox(Ju));
+  BOOST_CHECK(data->Jy_.isApprox(Jy));
+
+  // agrees with finite differences
+  auto space = std::make_shared<proxsuite::nlp::VectorSpaceTpl<T>>(nx);
+  FiniteDifferenceHelper<T> fd(space, func, 1e-7);
+  auto fd_data = fd.createData();
+  fd.evaluate(x, u, y, *fd_data);
+  fd.computeJacobians(x, u, y, *fd_data);
+  BOOST_CHECK(fd_data->jac_buffer_.isApprox(data->jac_buffer_, 1e-5));
+
+  // the products are only computed by second-order functions
+  VectorXd lbda = VectorXd::Random(2);
+  func->computeVectorHessianProducts(x, u, y, lbda, *data);
+  BOOST_CHECK(data->vhp_buffer_.isZero(0));
+
+  BOOST_CHECK_THROW(Function(20, 10, 20, 2), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(forward_diff_vhp) {
+  const int nx = 3;
+  const int nu = 2;
+  // no bound on the number of directions
+  using Function = ForwardDiffFunctionTpl<T, TestResidual, Eigen::Dynamic>;
+  Function func(nx, nu, nx, 2, TestResidual(), true);
+  auto data = func.createData();
+
+  VectorXd x = VectorXd::Random(nx);
+  VectorXd u = VectorXd::Random(nu);
+  VectorXd y = VectorXd::Random(nx);
+  VectorXd lbda = VectorXd::Random(2);
+  func.evaluate(x, u, y, *data);
+  func.computeJacobians(x, u, y, *data);
+  func.computeVectorHessianProducts(x, u, y, lbda, *data);
+
+  // variables: (x0, x1, x2, u0, u1, y0, y1, y2)
+  const int nvar = 2 * nx + nu;
+  MatrixXd H = MatrixXd::Zero(nvar, nvar);
+  H(0, 0) = -lbda[0] * std::sin(x[0]) * u[0];
+  H(0, 3) = H(3, 0) = lbda[0] * std::cos(x[0]);
+  H(6, 6) = 2. * lbda[0];
+  H.topLeftCorner(nx, nx).diagonal().array() += 2. * lbda[1];
+  H(4, 5) = H(5, 4) = -lbda[1] * std::exp(y[0]);
+  H(5, 5) = -lbda[1] * u[1] * std::exp(y[0]);
+  BOOST_CHECK(data->vhp_buffer_.isApprox(H));
+}
+
+BOOST_AUTO_TEST_CASE(forward_diff_unary) {
+  const int nx = 2;
+  using Function = ForwardDiffUnaryFunctionTpl<T, TestUnaryResidual>;
+  Function func(nx, 1, 2, TestUnaryResidual(), true);
+  auto data = func.createData();
+
+  VectorXd x(nx);
+  x << 2., -1.;
+  VectorXd u = VectorXd::Zero(1);
+  func.evaluate(x, u, x, *data);
+  BOOST_CHECK_EQUAL(data->value_[0], -2.);
+  BOOST_CHECK_EQUAL(data->value_[1], 3.);
+
+  func.computeJacobians(x, u, x, *data);
+  MatrixXd Jx(2, nx);
+  Jx << -1., 2., 0., 0.;
+  BOOST_CHECK(data->Jx_.isApprox(Jx));
+  BOOST_CHECK(data->Ju_.isZero(0));
+
+  VectorXd lbda(2);
+  lbda << 0.5, 4.;
+  func.computeVectorHessianProducts(x, u, x, lbda, *data);
+  MatrixXd Hxx(nx, nx);
+  Hxx << 0., 0.5, 0.5, 0.;
+  BOOST_CHECK(data->Hxx_.isApprox(Hxx));
+}
@@ -0,0 +1,76 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/modelling/multibody/frame-translation.hpp"
+
+#include <proxsuite-nlp/modelling/spaces/multibody.hpp>
+#include <pinocchio/parsers/sample-models.hpp>
+
+using namespace aligator;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using Model = pinocchio::ModelTpl<T>;
+
+/// Compare the vector-Hessian product of the residual with a central finite
+/// difference of Jx^T lambda along the configuration space. The Jacobians are
+/// taken in the tangent spaces of the perturbed configurations: on a Lie
+/// group, the difference quotient is only symmetric up to their transport, so
+/// it is compared through its symmetric part.
+static void checkVectorHessianProducts(const shared_ptr<Model> &model) {
+  using Residual = FrameTranslationResidualTpl<T>;
+  using Space = proxsuite::nlp::MultibodyConfiguration<T>;
+  const Space space(*model);
+  const int nx = space.nx();
+  const int ndx = space.ndx();
+  const int nu = 1;
+  const T eps = 1e-6;
+
+  // the last frame is at the end of a kinematic chain
+  const auto frame_id = pinocchio::FrameIndex(model->nframes - 1);
+  Residual fun(ndx, nu, model, Eigen::Vector3d::Zero(), frame_id);
+  shared_ptr<Residual::BaseData> data = fun.createData();
+  shared_ptr<Residual::BaseData> data_fd = fun.createData();
+
+  auto Jx_lambda = [&](const VectorXd &x, const VectorXd &lam) -> VectorXd {
+    fun.evaluate(x, *data_fd);
+    fun.computeJacobians(x, *data_fd);
+    return data_fd->Jx_.transpose() * lam;
+  };
+
+  VectorXd x(nx), x_plus(nx), x_minus(nx);
+  VectorXd dx(ndx);
+  MatrixXd H_fd(ndx, ndx);
+  for (int k = 0; k < 10; k++) {
+    space.integrate(space.neutral(), VectorXd::Random(ndx), x);
+    const VectorXd lam = VectorXd::Random(3);
+    fun.evaluate(x, *data);
+    fun.computeJacobians(x, *data);
+    fun.computeVectorHessianProducts(x, lam, *data);
+
+    for (int i = 0; i < ndx; i++) {
+      dx.setZero();
+      dx[i] = eps;
+      space.integrate(x, dx, x_plus);
+      space.integrate(x, -dx, x_minus);
+      H_fd.col(i) = Jx_lambda(x_plus, lam) - Jx_lambda(x_minus, lam);
+      H_fd.col(i) /= 2 * eps;
+    }
+    const MatrixXd H_sym = 0.5 * (H_fd + H_fd.transpose());
+    BOOST_CHECK(data->Hxx_.isApprox(data->Hxx_.transpose()));
+    BOOST_CHECK(data->Hxx_.isApprox(H_sym, 1e-5));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(vhp_fixed_base) {
+  auto model = std::make_shared<Model>();
+  pinocchio::buildModels::manipulator(*model);
+  checkVectorHessianProducts(model);
+}
+
+BOOST_AUTO_TEST_CASE(vhp_floating_base) {
+  auto model = std::make_shared<Model>();
+  pinocchio::buildModels::humanoidRandom(*model, true);
+  BOOST_CHECK_EQUAL(model->joints[1].nv(), 6);
+  checkVectorHessianProducts(model);
+}
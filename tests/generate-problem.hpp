@@ -1,7 +1,11 @@
 #pragma once
 #include "aligator/core/traj-opt-problem.hpp"
 #include "aligator/core/explicit-dynamics.hpp"
+#include "aligator/modelling/linear-discrete-dynamics.hpp"
+#include "aligator/modelling/quad-costs.hpp"
+#include "aligator/modelling/control-box-function.hpp"
 
+#include <proxsuite-nlp/modelling/constraints/negative-orthant.hpp>
 #include <proxsuite-nlp/modelling/spaces/pinocchio-groups.hpp>
 
 using namespace aligator;
@@ -67,3 +71,49 @@ struct MyFixture {
     problem.addStage(stage);
   }
 };
+
+/// @name Linear-quadratic regulator
+/// A discrete double integrator: the controls drive the last @p nu states,
+/// which the first ones integrate with a step of 0.1. The costs have unit
+/// weights on the state and 1e-2 on the controls.
+/// @{
+
+inline shared_ptr<dynamics::LinearDiscreteDynamicsTpl<double>>
+makeLqrDynamics(long nx = 4, long nu = 2) {
+  Eigen::MatrixXd A = Eigen::MatrixXd::Identity(nx, nx);
+  A.topRightCorner(nu, nu).diagonal().setConstant(0.1);
+  Eigen::MatrixXd B = Eigen::MatrixXd::Zero(nx, nu);
+  B.bottomRows(nu).setIdentity();
+  return std::make_shared<dynamics::LinearDiscreteDynamicsTpl<double>>(
+      A, B, Eigen::VectorXd::Zero(nx));
+}
+
+inline shared_ptr<QuadraticCostTpl<double>> makeLqrCost(long nx = 4,
+                                                        long nu = 2) {
+  return std::make_shared<QuadraticCostTpl<double>>(
+      Eigen::MatrixXd::Identity(nx, nx),
+      1e-2 * Eigen::MatrixXd::Identity(nu, nu));
+}
+
+/// @brief Problem with @p nsteps identical stages, starting from all ones and
+/// with the stage cost as terminal cost.
+/// @param box If positive, bound the controls to @f$[-box, box]@f$.
+inline TrajOptProblemTpl<double> makeLqrProblem(std::size_t nsteps,
+                                                double box = 0., long nx = 4,
+                                                long nu = 2) {
+  auto dyn = makeLqrDynamics(nx, nu);
+  auto cost = makeLqrCost(nx, nu);
+  auto stage = std::make_shared<StageModel>(cost, dyn);
+  if (box > 0.) {
+    stage->addConstraint(
+        std::make_shared<ControlBoxFunctionTpl<double>>(nx, nu, -box, box),
+        std::make_shared<proxsuite::nlp::NegativeOrthant<double>>());
+  }
+  TrajOptProblemTpl<double> problem(Eigen::VectorXd::Ones(nx), (int)nu,
+                                    dyn->space_next_, cost);
+  for (std::size_t i = 0; i < nsteps; i++)
+    problem.addStage(stage);
+  return problem;
+}
+
+/// @}
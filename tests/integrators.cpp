@@ -1,5 +1,7 @@
 #include "aligator/modelling/dynamics/integrator-euler.hpp"
 #include "aligator/modelling/dynamics/integrator-rk2.hpp"
+#include "aligator/modelling/dynamics/integrator-semi-euler.hpp"
+#include "aligator/modelling/dynamics/linear-ode.hpp"
 
 #include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
 
@@ -19,4 +21,33 @@ BOOST_AUTO_TEST_CASE(rk2) {
   Manifold space(NX);
 }
 
+BOOST_AUTO_TEST_CASE(fused_derivatives) {
+  using namespace aligator;
+  using namespace aligator::dynamics;
+  using Eigen::MatrixXd;
+  using Eigen::VectorXd;
+  constexpr int NX = 4;
+  constexpr int NU = 2;
+  auto ode = std::make_shared<LinearODETpl<double>>(
+      MatrixXd::Random(NX, NX), MatrixXd::Random(NX, NU), VectorXd::Random(NX));
+  const double dt = 0.1;
+  std::vector<shared_ptr<ExplicitDynamicsModelTpl<double>>> models{
+      std::make_shared<IntegratorEulerTpl<double>>(ode, dt),
+      std::make_shared<IntegratorSemiImplEulerTpl<double>>(ode, dt),
+      std::make_shared<IntegratorRK2Tpl<double>>(ode, dt)};
+
+  VectorXd x = VectorXd::Random(NX);
+  VectorXd u = VectorXd::Random(NU);
+  VectorXd y = VectorXd::Random(NX);
+  for (const auto &model : models) {
+    auto data = model->createData();
+    auto data_fused = model->createData();
+    model->evaluate(x, u, y, *data);
+    model->computeJacobians(x, u, y, *data);
+    model->evaluateWithJacobians(x, u, y, *data_fused);
+    BOOST_CHECK(data_fused->value_.isApprox(data->value_));
+    BOOST_CHECK(data_fused->jac_buffer_.isApprox(data->jac_buffer_));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
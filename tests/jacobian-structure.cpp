@@ -0,0 +1,168 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/modelling/linear-discrete-dynamics.hpp"
+#include "aligator/modelling/quad-costs.hpp"
+#include "aligator/modelling/control-box-function.hpp"
+#include "aligator/modelling/function-xpr-slice.hpp"
+#include "aligator/modelling/state-error.hpp"
+
+#include <proxsuite-nlp/modelling/constraints/negative-orthant.hpp>
+#include <proxsuite-nlp/modelling/constraints/equality-constraint.hpp>
+
+#include "generate-problem.hpp"
+
+using namespace aligator;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using Dynamics = dynamics::LinearDiscreteDynamicsTpl<T>;
+using QuadCost = QuadraticCostTpl<T>;
+using FunctionData = StageFunctionDataTpl<T>;
+using VectorSpace = proxsuite::nlp::VectorSpaceTpl<T>;
+using EqualityConstraint = proxsuite::nlp::EqualityConstraint<T>;
+using NegativeOrthant = proxsuite::nlp::NegativeOrthant<T>;
+
+constexpr int NX = 4;
+constexpr int NU = 2;
+
+/// Check the structured products with the Jacobian blocks of @p data against
+/// the dense products.
+void checkStructure(const FunctionData &data) {
+  VectorXd v = VectorXd::Random(data.nr);
+  const std::pair<const JacobianStructure *, const MatrixXd> blocks[] = {
+      {&data.Jx_structure_, data.Jx_},
+      {&data.Ju_structure_, data.Ju_},
+      {&data.Jy_structure_, data.Jy_}};
+  for (const auto &b : blocks) {
+    VectorXd out = VectorXd::Ones(b.second.cols());
+    VectorXd expected = out + b.second.transpose() * v;
+    addJacobianTransposeProduct<T>(*b.first, b.second, v, out);
+    BOOST_CHECK(out.isApprox(expected));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(structured_products) {
+  const int n = 5;
+  VectorXd v = VectorXd::Random(n);
+
+  MatrixXd diag = VectorXd::Random(n).asDiagonal();
+  VectorXd out = VectorXd::Zero(n);
+  addJacobianTransposeProduct<T>(JacobianStructure::DIAGONAL, diag, v, out);
+  BOOST_CHECK(out.isApprox(diag.transpose() * v));
+
+  out.setZero();
+  addJacobianTransposeProduct<T>(JacobianStructure::ZERO, diag, v, out);
+  BOOST_CHECK(out.isZero(0.));
+
+  // one nonzero per row, and a zero row
+  Eigen::VectorXi cols(n);
+  cols << 2, 0, -1, 2, 1;
+  MatrixXd sel = MatrixXd::Zero(n, 3);
+  for (int i = 0; i < n; i++) {
+    if (cols[i] >= 0)
+      sel(i, cols[i]) = v[i] + 1.;
+  }
+  out = VectorXd::Ones(3);
+  VectorXd expected = out + sel.transpose() * v;
+  addJacobianTransposeProduct<T>(JacobianStructure::selection(cols), sel, v,
+                                 out);
+  BOOST_CHECK(out.isApprox(expected));
+
+  // rows of a selection
+  JacobianStructure s = JacobianStructure::selection(cols).sliceRows({4, 0});
+  BOOST_CHECK_EQUAL(s.type, JacobianStructure::SELECTION);
+  BOOST_CHECK_EQUAL(s.cols[0], 1);
+  BOOST_CHECK_EQUAL(s.cols[1], 2);
+  s = JacobianStructure(JacobianStructure::DIAGONAL).sliceRows({3});
+  BOOST_CHECK_EQUAL(s.type, JacobianStructure::SELECTION);
+  BOOST_CHECK_EQUAL(s.cols[0], 3);
+}
+
+BOOST_AUTO_TEST_CASE(function_structures) {
+  VectorXd x = VectorXd::Random(NX);
+  VectorXd u = VectorXd::Random(NU);
+  VectorXd y = VectorXd::Random(NX);
+  auto space = std::make_shared<VectorSpace>(NX);
+
+  auto box = std::make_shared<ControlBoxFunctionTpl<T>>(NX, NU, -1., 1.);
+  auto bd = box->createData();
+  box->computeJacobians(x, u, y, *bd);
+  BOOST_CHECK(bd->Jx_structure_.isZero());
+  BOOST_CHECK_EQUAL(bd->Ju_structure_.type, JacobianStructure::SELECTION);
+  BOOST_CHECK(bd->Jy_structure_.isZero());
+  checkStructure(*bd);
+
+  FunctionSliceXprTpl<T> slice(box, std::vector<int>{3, 0});
+  auto sd = slice.createData();
+  slice.computeJacobians(x, u, y, *sd);
+  BOOST_CHECK_EQUAL(sd->Ju_structure_.type, JacobianStructure::SELECTION);
+  checkStructure(*sd);
+
+  StateErrorResidualTpl<T> state_err(space, NU, VectorXd::Zero(NX));
+  auto ed = state_err.createData();
+  state_err.computeJacobians(x, u, y, *ed);
+  BOOST_CHECK_EQUAL(ed->Jx_structure_.type, JacobianStructure::DIAGONAL);
+  BOOST_CHECK(ed->Ju_structure_.isZero());
+  BOOST_CHECK(ed->Jy_structure_.isZero());
+  checkStructure(*ed);
+
+  ControlErrorResidualTpl<T> ctrl_err(NX, NU);
+  auto cd = ctrl_err.createData();
+  ctrl_err.computeJacobians(x, u, y, *cd);
+  BOOST_CHECK(cd->Jx_structure_.isZero());
+  BOOST_CHECK_EQUAL(cd->Ju_structure_.type, JacobianStructure::DIAGONAL);
+  checkStructure(*cd);
+
+  Dynamics dyn(MatrixXd::Random(NX, NX), MatrixXd::Random(NX, NU),
+               VectorXd::Zero(NX));
+  auto dd = dyn.createData();
+  dyn.evaluate(x, u, y, *dd);
+  dyn.computeJacobians(x, u, y, *dd);
+  BOOST_CHECK_EQUAL(dd->Jx_structure_.type, JacobianStructure::DENSE);
+  BOOST_CHECK_EQUAL(dd->Jy_structure_.type, JacobianStructure::DIAGONAL);
+  checkStructure(*dd);
+}
+
+BOOST_AUTO_TEST_CASE(proxddp_structured_kernels) {
+  auto dyn = makeLqrDynamics(NX, NU);
+  auto cost = makeLqrCost(NX, NU);
+  auto stage = std::make_shared<StageModelTpl<T>>(cost, dyn);
+  auto box = std::make_shared<ControlBoxFunctionTpl<T>>(NX, NU, -0.5, 0.5);
+  stage->addConstraint(box, std::make_shared<NegativeOrthant>());
+  auto slice = std::make_shared<FunctionSliceXprTpl<T>>(
+      std::make_shared<ControlErrorResidualTpl<T>>(NX, NU), 0);
+  stage->addConstraint(slice, std::make_shared<EqualityConstraint>());
+
+  const std::size_t nsteps = 20;
+  TrajOptProblemTpl<T> problem(VectorXd::Ones(NX), NU, dyn->space_next_, cost);
+  for (std::size_t i = 0; i < nsteps; i++)
+    problem.addStage(stage);
+
+  SolverProxDDP<T> solver(1e-8, 1e-6);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+
+  // the same solve, with dense kernels only
+  SolverProxDDP<T> solver_dense(1e-8, 1e-6);
+  solver_dense.setup(problem);
+  TrajOptDataTpl<T> &pd = solver_dense.workspace_.problem_data;
+  pd.getInitData().Jx_structure_ = JacobianStructure::DENSE;
+  for (std::size_t i = 0; i < nsteps; i++) {
+    for (auto &cd : pd.getStageData(i).constraint_data) {
+      cd->Jx_structure_ = JacobianStructure::DENSE;
+      cd->Ju_structure_ = JacobianStructure::DENSE;
+      cd->Jy_structure_ = JacobianStructure::DENSE;
+    }
+  }
+  BOOST_CHECK(solver_dense.run(problem));
+
+  BOOST_CHECK_EQUAL(solver.results_.num_iters,
+                    solver_dense.results_.num_iters);
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(solver.results_.us[t].isApprox(solver_dense.results_.us[t]));
+    BOOST_CHECK(solver.results_.us[t].cwiseAbs().maxCoeff() <= 0.5 + 1e-6);
+    BOOST_CHECK_SMALL(solver.results_.us[t][0], 1e-6);
+  }
+}
@@ -0,0 +1,79 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/core/iterative-refinement.hpp"
+
+#include "generate-problem.hpp"
+
+using namespace aligator;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+BOOST_AUTO_TEST_CASE(mixed_precision_refinement) {
+  const long nprim = 8;
+  const long ndual = 5;
+  const long ntot = nprim + ndual;
+  MatrixXd K = MatrixXd::Zero(ntot, ntot);
+  MatrixXd H = MatrixXd::Random(nprim, nprim);
+  K.topLeftCorner(nprim, nprim) = H * H.transpose();
+  K.topLeftCorner(nprim, nprim).diagonal().array() += 1.;
+  MatrixXd J = MatrixXd::Random(ndual, nprim);
+  K.bottomLeftCorner(ndual, nprim) = J;
+  K.topRightCorner(nprim, ndual) = J.transpose();
+  K.bottomRightCorner(ndual, ndual).diagonal().setConstant(-1e-2);
+
+  MixedPrecisionLDLTTpl<T> ldlt(ntot, 2);
+  ldlt.compute(K);
+  BOOST_CHECK_EQUAL(ldlt.inertia()[0], nprim);
+  BOOST_CHECK_EQUAL(ldlt.inertia()[1], ndual);
+  BOOST_CHECK_EQUAL(ldlt.inertia()[2], 0);
+
+  MatrixXd rhs = MatrixXd::Random(ntot, 3);
+  MatrixXd err(ntot, 3);
+  MatrixXd sol(ntot, 3);
+
+  // a single solve is only accurate to single precision
+  IterativeRefinementVisitor<T>{K, rhs, err, sol, 1e-12, 0}(ldlt);
+  const T err_single = (K * sol + rhs).lpNorm<Eigen::Infinity>();
+  BOOST_CHECK_GT(err_single, 1e-10);
+
+  bool conv = IterativeRefinementVisitor<T>{K, rhs, err, sol, 1e-12, 10}(ldlt);
+  BOOST_CHECK(conv);
+  BOOST_CHECK_LE((K * sol + rhs).lpNorm<Eigen::Infinity>(), 1e-12);
+}
+
+BOOST_AUTO_TEST_CASE(mixed_precision_solver) {
+  const std::size_t nsteps = 20;
+  auto problem = makeLqrProblem(nsteps, 0.5);
+
+  const T tol = 1e-7;
+  SolverProxDDP<T> solver_ref(tol, 1e-4);
+  solver_ref.setup(problem);
+  BOOST_CHECK(solver_ref.run(problem));
+
+  SolverProxDDP<T> solver(tol, 1e-4);
+  solver.kkt_solver_choice = KktSolverChoice::MIXED_PRECISION;
+  solver.max_refinement_steps_ = 10;
+  solver.refinement_threshold_ = 1e-12;
+  solver.setup(problem);
+  BOOST_CHECK_EQUAL(solver.workspace_.mixed_ldlts_.size(), nsteps);
+  BOOST_CHECK(solver.run(problem));
+
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(
+        solver_ref.results_.us[t].isApprox(solver.results_.us[t], 1e-5));
+  }
+
+  // with the default (zero) refinement steps, one step is still taken
+  SolverProxDDP<T> solver_default(tol, 1e-4);
+  solver_default.kkt_solver_choice = KktSolverChoice::MIXED_PRECISION;
+  BOOST_CHECK_EQUAL(solver_default.max_refinement_steps_, 0);
+  solver_default.setup(problem);
+  BOOST_CHECK(solver_default.run(problem));
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(solver_ref.results_.us[t].isApprox(
+        solver_default.results_.us[t], 1e-5));
+  }
+}
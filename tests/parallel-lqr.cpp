@@ -1,15 +1,18 @@
 #include <boost/test/unit_test.hpp>
 
 #include "aligator/parlqr/parlqr.hpp"
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/modelling/linear-discrete-dynamics.hpp"
+#include "aligator/modelling/quad-costs.hpp"
 
 using namespace aligator;
 
 using T = double;
 
 BOOST_AUTO_TEST_CASE(lqrtree) {
-  uint nx = 2;
-  uint nu = 2;
-  uint nc = 0;
+  std::size_t nx = 2;
+  std::size_t nu = 2;
+  std::size_t nc = 0;
   LQRKnot<T> node(nx, nu, nc);
   node.C.setZero();
   node.A.setIdentity();
@@ -62,3 +65,82 @@ BOOST_AUTO_TEST_CASE(lqrtree) {
   print_parent(14);
   print_parent(15);
 }
+
+using Dynamics = dynamics::LinearDiscreteDynamicsTpl<T>;
+using QuadCost = QuadraticCostTpl<T>;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+TrajOptProblemTpl<T> makeProblem(const MatrixXd &A, const MatrixXd &B,
+                                 const MatrixXd &w_x, std::size_t nsteps) {
+  const long nx = A.rows();
+  const long nu = B.cols();
+  VectorXd c = VectorXd::Constant(nx, 0.01);
+  auto dyn = std::make_shared<Dynamics>(A, B, c);
+
+  MatrixXd w_u = 1e-2 * MatrixXd::Identity(nu, nu);
+  auto cost = std::make_shared<QuadCost>(w_x, w_u);
+  auto stage = std::make_shared<StageModelTpl<T>>(cost, dyn);
+
+  VectorXd x0 = VectorXd::Ones(nx);
+  TrajOptProblemTpl<T> problem(x0, (int)nu, dyn->space_next_, cost);
+  for (std::size_t i = 0; i < nsteps; i++)
+    problem.addStage(stage);
+  problem.setNumThreads(4);
+  return problem;
+}
+
+void checkParallelMatchesSerial(const TrajOptProblemTpl<T> &problem,
+                                const T reg_init) {
+  const std::size_t nsteps = problem.numSteps();
+  const T tol = 1e-8;
+  SolverProxDDP<T> serial(tol, 1e-8);
+  serial.reg_init = reg_init;
+  serial.setup(problem);
+  BOOST_CHECK(serial.workspace_.par_legs_.empty());
+  BOOST_CHECK(serial.run(problem));
+
+  SolverProxDDP<T> parallel(tol, 1e-8);
+  parallel.linear_solver_choice = LQSolverChoice::PARALLEL;
+  parallel.reg_init = reg_init;
+  parallel.setup(problem);
+  BOOST_CHECK_EQUAL(parallel.workspace_.par_legs_.size(), 4);
+  BOOST_CHECK(parallel.run(problem));
+  BOOST_CHECK_EQUAL(serial.results_.num_iters, parallel.results_.num_iters);
+
+  for (std::size_t t = 0; t <= nsteps; t++) {
+    BOOST_CHECK(serial.results_.xs[t].isApprox(parallel.results_.xs[t], 1e-6));
+    BOOST_CHECK(serial.workspace_.value_params[t].Vxx_.isApprox(
+        parallel.workspace_.value_params[t].Vxx_, 1e-6));
+    BOOST_CHECK(serial.workspace_.value_params[t].Vx_.isApprox(
+        parallel.workspace_.value_params[t].Vx_, 1e-6));
+  }
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(serial.results_.us[t].isApprox(parallel.results_.us[t], 1e-6));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_riccati_matches_serial) {
+  const int nx = 4;
+  const int nu = 2;
+  MatrixXd A = MatrixXd::Identity(nx, nx);
+  A.topRightCorner(nx / 2, nx / 2).setIdentity();
+  A.topRightCorner(nx / 2, nx / 2) *= 0.1;
+  MatrixXd B = MatrixXd::Zero(nx, nu);
+  B.bottomRows(nu).setIdentity();
+  MatrixXd w_x = MatrixXd::Identity(nx, nx);
+  checkParallelMatchesSerial(makeProblem(A, B, w_x, 37), 1e-9);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_riccati_singular_value_hessian) {
+  // the uncontrolled states have no cost: without regularization, the value
+  // function Hessian is singular at every leg boundary
+  const int nx = 4;
+  const int nu = 2;
+  MatrixXd A = MatrixXd::Identity(nx, nx);
+  MatrixXd B = MatrixXd::Zero(nx, nu);
+  B.topRows(nu).setIdentity();
+  MatrixXd w_x = MatrixXd::Zero(nx, nx);
+  w_x.topLeftCorner(nu, nu).setIdentity();
+  checkParallelMatchesSerial(makeProblem(A, B, w_x, 37), 0.);
+}
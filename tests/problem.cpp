@@ -1,10 +1,16 @@
 #include "aligator/core/traj-opt-problem.hpp"
 #include "aligator/solvers/proxddp/results.hpp"
 #include "aligator/solvers/proxddp/workspace.hpp"
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/solvers/fddp/solver-fddp.hpp"
 #include "aligator/utils/rollout.hpp"
+#include "aligator/modelling/linear-discrete-dynamics.hpp"
+#include "aligator/modelling/quad-costs.hpp"
+#include "aligator/modelling/linear-function.hpp"
 
 #include "generate-problem.hpp"
 #include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
+#include <proxsuite-nlp/modelling/constraints/negative-orthant.hpp>
 
 #include <boost/test/unit_test.hpp>
 
@@ -69,4 +75,195 @@ BOOST_AUTO_TEST_CASE(test_workspace) {
   ResultsTpl<double> results(f.problem);
 }
 
+BOOST_AUTO_TEST_CASE(test_parallel_evaluate) {
+  using Eigen::MatrixXd;
+  using Eigen::VectorXd;
+  const int nx = 6;
+  const int nu = 3;
+  const std::size_t nsteps = 50;
+  MatrixXd A = MatrixXd::Random(nx, nx);
+  MatrixXd B = MatrixXd::Random(nx, nu);
+  VectorXd c = VectorXd::Random(nx);
+  auto dyn =
+      std::make_shared<dynamics::LinearDiscreteDynamicsTpl<double>>(A, B, c);
+  MatrixXd w_x = MatrixXd::Identity(nx, nx);
+  MatrixXd w_u = MatrixXd::Identity(nu, nu);
+  auto cost = std::make_shared<QuadraticCostTpl<double>>(w_x, w_u);
+  auto stage = std::make_shared<StageModelTpl<double>>(cost, dyn);
+
+  TrajOptProblemTpl<double> problem(VectorXd::Zero(nx), nu, dyn->space_next_,
+                                    cost);
+  for (std::size_t i = 0; i < nsteps; i++)
+    problem.addStage(stage);
+
+  std::vector<VectorXd> xs(nsteps + 1, VectorXd::Zero(nx));
+  std::vector<VectorXd> us(nsteps, VectorXd::Zero(nu));
+  for (std::size_t i = 0; i < nsteps; i++) {
+    xs[i + 1].setRandom();
+    us[i].setRandom();
+  }
+
+  TrajOptDataTpl<double> serial_data(problem);
+  const double serial_cost = problem.evaluate(xs, us, serial_data);
+
+  problem.setNumThreads(4);
+  TrajOptDataTpl<double> par_data(problem);
+  const double par_cost = problem.evaluate(xs, us, par_data);
+
+  // the reduction is done in stage order: results must match exactly
+  BOOST_CHECK_EQUAL(serial_cost, par_cost);
+  BOOST_CHECK_EQUAL(par_cost, par_data.cost_);
+  for (std::size_t i = 0; i < nsteps; i++) {
+    BOOST_CHECK_EQUAL(serial_data.stage_data[i]->cost_data->value_,
+                      par_data.stage_data[i]->cost_data->value_);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_evaluation_cache) {
+  using Eigen::MatrixXd;
+  using Eigen::VectorXd;
+  const int nx = 3;
+  const int nu = 2;
+  MatrixXd A = MatrixXd::Random(nx, nx);
+  MatrixXd B = MatrixXd::Random(nx, nu);
+  VectorXd c = VectorXd::Random(nx);
+  auto dyn =
+      std::make_shared<dynamics::LinearDiscreteDynamicsTpl<double>>(A, B, c);
+  MatrixXd w_x = MatrixXd::Identity(nx, nx);
+  MatrixXd w_u = MatrixXd::Identity(nu, nu);
+  auto cost = std::make_shared<QuadraticCostTpl<double>>(w_x, w_u);
+  StageModelTpl<double> stage(cost, dyn);
+  auto data = stage.createData();
+
+  VectorXd x = VectorXd::Random(nx);
+  VectorXd u = VectorXd::Random(nu);
+  VectorXd y = VectorXd::Random(nx);
+  BOOST_CHECK(!data->isEvaluatedAt(x, u, y));
+  stage.evaluate(x, u, y, *data);
+  BOOST_CHECK(data->isEvaluatedAt(x, u, y));
+  const double value = data->cost_data->value_;
+
+  // derivatives at another point evaluate the stage there first
+  VectorXd u2 = 2 * u;
+  stage.computeDerivatives(x, u2, y, *data);
+  BOOST_CHECK(data->isEvaluatedAt(x, u2, y));
+  BOOST_CHECK_NE(data->cost_data->value_, value);
+  auto data2 = stage.createData();
+  stage.evaluate(x, u2, y, *data2);
+  BOOST_CHECK_EQUAL(data->cost_data->value_, data2->cost_data->value_);
+  BOOST_CHECK(data->dyn_data().value_.isApprox(data2->dyn_data().value_));
+
+  data->invalidateEvaluation();
+  BOOST_CHECK(!data->isEvaluatedAt(x, u2, y));
+}
+
+BOOST_AUTO_TEST_CASE(test_evaluate_with_derivatives) {
+  using Eigen::MatrixXd;
+  using Eigen::VectorXd;
+  const int nx = 3;
+  const int nu = 2;
+  MatrixXd A = MatrixXd::Random(nx, nx);
+  MatrixXd B = MatrixXd::Random(nx, nu);
+  VectorXd c = VectorXd::Random(nx);
+  auto dyn =
+      std::make_shared<dynamics::LinearDiscreteDynamicsTpl<double>>(A, B, c);
+  MatrixXd w_x = MatrixXd::Identity(nx, nx);
+  MatrixXd w_u = MatrixXd::Identity(nu, nu);
+  auto cost = std::make_shared<QuadraticCostTpl<double>>(w_x, w_u);
+  auto stage = std::make_shared<StageModelTpl<double>>(cost, dyn);
+
+  VectorXd x = VectorXd::Random(nx);
+  VectorXd u = VectorXd::Random(nu);
+  VectorXd y = VectorXd::Random(nx);
+  auto data = stage->createData();
+  stage->evaluate(x, u, y, *data);
+  BOOST_CHECK(!data->has_derivatives);
+  stage->computeDerivatives(x, u, y, *data);
+  BOOST_CHECK(data->has_derivatives);
+
+  auto data_fused = stage->createData();
+  stage->evaluateWithDerivatives(x, u, y, *data_fused);
+  BOOST_CHECK(data_fused->isEvaluatedAt(x, u, y));
+  BOOST_CHECK(data_fused->has_derivatives);
+  BOOST_CHECK_EQUAL(data_fused->cost_data->value_, data->cost_data->value_);
+  BOOST_CHECK(data_fused->cost_data->grad_.isApprox(data->cost_data->grad_));
+  BOOST_CHECK(data_fused->cost_data->hess_.isApprox(data->cost_data->hess_));
+  BOOST_CHECK(data_fused->dyn_data().jac_buffer_.isApprox(
+      data->dyn_data().jac_buffer_));
+
+  // a new evaluation invalidates the derivatives
+  stage->evaluate(x, u, y, *data_fused);
+  BOOST_CHECK(!data_fused->has_derivatives);
+
+  const std::size_t nsteps = 4;
+  TrajOptProblemTpl<double> problem(x, nu, dyn->space_, cost);
+  for (std::size_t i = 0; i < nsteps; i++)
+    problem.addStage(stage);
+  TrajOptDataTpl<double> prob_data(problem);
+  TrajOptDataTpl<double> prob_data2(problem);
+  std::vector<VectorXd> xs(nsteps + 1, x);
+  std::vector<VectorXd> us(nsteps, u);
+  const double cost_value = problem.evaluate(xs, us, prob_data);
+  problem.computeDerivatives(xs, us, prob_data);
+  BOOST_CHECK_EQUAL(problem.evaluateWithDerivatives(xs, us, prob_data2),
+                    cost_value);
+  problem.computeDerivatives(xs, us, prob_data2);
+  for (std::size_t i = 0; i < nsteps; i++) {
+    BOOST_CHECK(prob_data2.stage_data[i]->has_derivatives);
+    BOOST_CHECK(prob_data2.stage_data[i]->cost_data->grad_.isApprox(
+        prob_data.stage_data[i]->cost_data->grad_));
+  }
+}
+
+/// Check that the stage data is consistent with its recorded evaluation
+/// point, for a constraint which depends on the next state.
+void checkRolloutEvaluationPoint(const TrajOptProblemTpl<double> &problem,
+                                 const TrajOptDataTpl<double> &prob_data) {
+  for (std::size_t t = 0; t < problem.numSteps(); t++) {
+    const StageModelTpl<double> &stage = *problem.stages_[t];
+    const StageDataTpl<double> &data = *prob_data.stage_data[t];
+    BOOST_CHECK(data.has_eval);
+    auto data2 = stage.createData();
+    stage.evaluate(data.x_eval, data.u_eval, data.y_eval, *data2);
+    for (std::size_t j = 0; j < stage.numConstraints(); j++) {
+      BOOST_CHECK(data.constraint_data[j]->value_.isApprox(
+          data2->constraint_data[j]->value_, 1e-8));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_rollout_evaluation_point) {
+  using Eigen::MatrixXd;
+  using Eigen::VectorXd;
+  const int nx = 4;
+  const int nu = 2;
+  auto dyn = makeLqrDynamics(nx, nu);
+  auto cost = makeLqrCost(nx, nu);
+  // bound on the next state
+  MatrixXd C = MatrixXd::Zero(1, nx);
+  C(0, 0) = 1.;
+  auto next_state_bound = std::make_shared<LinearFunctionTpl<double>>(
+      MatrixXd::Zero(1, nx), MatrixXd::Zero(1, nu), C, -VectorXd::Ones(1));
+  auto stage = std::make_shared<StageModelTpl<double>>(cost, dyn);
+  stage->addConstraint(
+      next_state_bound,
+      std::make_shared<proxsuite::nlp::NegativeOrthant<double>>());
+
+  const std::size_t nsteps = 10;
+  TrajOptProblemTpl<double> problem(2. * VectorXd::Ones(nx), nu,
+                                    dyn->space_next_, cost);
+  for (std::size_t i = 0; i < nsteps; i++)
+    problem.addStage(stage);
+
+  SolverProxDDP<double> solver(1e-6, 1e-2, 0., 3);
+  solver.setup(problem);
+  solver.run(problem);
+  checkRolloutEvaluationPoint(problem, solver.workspace_.problem_data);
+
+  SolverFDDP<double> fddp(1e-6, VerboseLevel::QUIET, 1e-10, 3);
+  fddp.setup(problem);
+  fddp.run(problem);
+  checkRolloutEvaluationPoint(problem, fddp.workspace_.problem_data);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -41,6 +41,33 @@ def test_cost_stack():
         assert np.allclose(data1.Luu, R)
 
 
+
+def test_weights_changed_after_create_data():
+    nx = 3
+    nu = 2
+    space = manifolds.VectorSpace(nx)
+    rcost = QuadraticCost(np.eye(nx), np.eye(nu))
+    assert rcost.has_diagonal_weights
+    cost_stack = CostStack(space, nu)
+    cost_stack.addCost(rcost, 2.0)
+    data = cost_stack.createData()
+    assert data.hess_structure == aligator.HessianStructure.DIAGONAL
+
+    Q = np.random.randn(4, nx)
+    Q = Q.T @ Q
+    rcost.w_x = Q
+    assert not rcost.has_diagonal_weights
+    x0 = np.random.randn(nx)
+    u0 = np.random.randn(nu)
+    cost_stack.evaluate(x0, u0, data)
+    cost_stack.computeGradients(x0, u0, data)
+    cost_stack.computeHessians(x0, u0, data)
+    assert data.hess_structure == aligator.HessianStructure.BLOCK_DIAGONAL
+    assert np.isclose(data.value, x0 @ Q @ x0 + u0 @ u0)
+    assert np.allclose(data.Lx, 2 * Q @ x0)
+    assert np.allclose(data.Lxx, 2 * Q)
+
+
 def test_composite_cost():
     space = manifolds.VectorSpace(3)
     ndx = space.ndx
@@ -1,3 +1,4 @@
+import aligator
 from aligator import (
     FiniteDifferenceHelper,
     CostFiniteDifference,
@@ -7,6 +8,38 @@ from aligator import (
     manifolds,
 )
 import numpy as np
+import pytest
+
+
+class ControlResidual(aligator.StageFunction):
+    """r(x, u) = u, implemented in Python."""
+
+    def __init__(self, ndx, nu):
+        super().__init__(ndx, nu, nu)
+
+    def evaluate(self, x, u, y, data):
+        data.value[:] = u
+
+    def computeJacobians(self, x, u, y, data):
+        data.Ju[:] = np.eye(self.nu)
+
+
+class ControlCost(aligator.CostAbstract):
+    """l(x, u) = |u|^2 / 2, implemented in Python."""
+
+    def __init__(self, space, nu):
+        super().__init__(space, nu)
+
+    def evaluate(self, x, u, data):
+        data.value = 0.5 * np.dot(u, u)
+
+    def computeGradients(self, x, u, data):
+        data.Lx[:] = 0.0
+        data.Lu[:] = u
+
+    def computeHessians(self, x, u, data):
+        data.hess[:, :] = 0.0
+        data.Luu[:, :] = np.eye(self.nu)
 
 
 def test_compute_jac_vs():
@@ -79,8 +112,33 @@ def test_compute_cost_se3():
         assert np.allclose(data.Lu, data_fd.Lu, 1e-2)
 
 
+def test_python_models_threads():
+    # the threads of the helpers would call Python without holding the GIL
+    nx = 2
+    nu = 3
+    space = manifolds.VectorSpace(nx)
+    fun_fd = FiniteDifferenceHelper(space, ControlResidual(nx, nu), 1e-6)
+    with pytest.raises(RuntimeError):
+        fun_fd.setNumThreads(2)
+    fun_fd.setNumThreads(1)
+    data = fun_fd.createData()
+    x0 = np.random.randn(nx)
+    u0 = np.random.randn(nu)
+    fun_fd.evaluate(x0, u0, x0, data)
+    fun_fd.computeJacobians(x0, u0, x0, data)
+    assert np.allclose(data.Ju, np.eye(nu), 1e-5)
+
+    cost_fd = CostFiniteDifference(ControlCost(space, nu), 1e-6)
+    with pytest.raises(RuntimeError):
+        cost_fd.setNumThreads(2)
+    cost_fd.setNumThreads(1)
+
+    # models implemented in C++ can be differentiated in parallel
+    box = ControlBoxFunction(nx, -np.ones(nu), np.ones(nu))
+    FiniteDifferenceHelper(space, box, 1e-6).setNumThreads(2)
+
+
 if __name__ == "__main__":
-    import pytest
     import sys
 
     sys.exit(pytest.main(sys.argv))
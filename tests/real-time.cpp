@@ -0,0 +1,218 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/modelling/linear-discrete-dynamics.hpp"
+#include "aligator/modelling/quad-costs.hpp"
+#include "aligator/modelling/control-box-function.hpp"
+#include "aligator/modelling/state-error.hpp"
+
+#include <proxsuite-nlp/modelling/constraints/negative-orthant.hpp>
+#include <proxsuite-nlp/modelling/constraints/equality-constraint.hpp>
+
+#include "generate-problem.hpp"
+
+using namespace aligator;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using Dynamics = dynamics::LinearDiscreteDynamicsTpl<T>;
+using QuadCost = QuadraticCostTpl<T>;
+
+constexpr int nx = 4;
+constexpr int nu = 2;
+
+BOOST_AUTO_TEST_CASE(time_budget) {
+  const std::size_t nsteps = 50;
+  auto problem = makeLqrProblem(nsteps);
+
+  SolverProxDDP<T> solver(1e-10, 1e-6);
+  solver.time_budget = 1e-9;
+  solver.setup(problem);
+  BOOST_CHECK(!solver.run(problem));
+  BOOST_CHECK(solver.results_.timed_out);
+  BOOST_CHECK_EQUAL(solver.results_.num_iters, 0);
+
+  // no limit
+  solver.time_budget = 0.;
+  BOOST_CHECK(solver.run(problem));
+  BOOST_CHECK(!solver.results_.timed_out);
+}
+
+BOOST_AUTO_TEST_CASE(real_time_iteration) {
+  const std::size_t nsteps = 20;
+  auto problem = makeLqrProblem(nsteps);
+  const VectorXd x0_old = problem.getInitState();
+  const VectorXd x0_new = 0.5 * VectorXd::Ones(nx);
+
+  SolverProxDDP<T> solver_ref(1e-10, 1e-6);
+  solver_ref.setup(problem);
+  BOOST_CHECK(solver_ref.run(problem));
+
+  for (RolloutType rollout : {RolloutType::LINEAR, RolloutType::NONLINEAR}) {
+    for (bool force_x0 : {true, false}) {
+      auto make_solver = [&]() {
+        SolverProxDDP<T> solver(1e-10, 1e-6);
+        solver.rollout_type_ = rollout;
+        solver.force_initial_condition_ = force_x0;
+        solver.setup(problem);
+        // warm-start from the solution for the previous initial state
+        solver.results_.xs = solver_ref.results_.xs;
+        solver.results_.us = solver_ref.results_.us;
+        solver.results_.lams = solver_ref.results_.lams;
+        return solver;
+      };
+
+      // the new state arrives after the preparation phase
+      problem.setInitState(x0_old);
+      SolverProxDDP<T> solver = make_solver();
+      BOOST_CHECK(solver.prepareRTI(problem));
+      problem.setInitState(x0_new);
+      solver.feedbackRTI(problem);
+      BOOST_CHECK_EQUAL(solver.results_.num_iters, 1);
+
+      // same iteration, with the new state known in the preparation phase
+      SolverProxDDP<T> solver_known = make_solver();
+      BOOST_CHECK(solver_known.prepareRTI(problem));
+      solver_known.feedbackRTI(problem);
+      for (std::size_t t = 0; t <= nsteps; t++) {
+        BOOST_CHECK(solver.results_.xs[t].isApprox(
+            solver_known.results_.xs[t], 1e-10));
+        BOOST_CHECK(solver.results_.lams[t].isApprox(
+            solver_known.results_.lams[t], 1e-10));
+      }
+      // unforced, the initial condition converges with the multipliers
+      if (!force_x0)
+        continue;
+      BOOST_CHECK(solver.results_.xs[0].isApprox(x0_new));
+
+      // the problem is an LQR: a few iterations reach the new solution
+      for (int i = 0; i < 4; i++) {
+        BOOST_CHECK(solver.prepareRTI(problem));
+        solver.feedbackRTI(problem);
+      }
+      SolverProxDDP<T> solver_new(1e-10, 1e-6);
+      solver_new.setup(problem);
+      BOOST_CHECK(solver_new.run(problem));
+      for (std::size_t t = 0; t < nsteps; t++) {
+        BOOST_CHECK(
+            solver.results_.us[t].isApprox(solver_new.results_.us[t], 1e-6));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(cycle_problem) {
+  using StageModel = StageModelTpl<T>;
+  using BoxFunction = ControlBoxFunctionTpl<T>;
+  using NegativeOrthant = proxsuite::nlp::NegativeOrthant<T>;
+  using EqualityConstraint = proxsuite::nlp::EqualityConstraint<T>;
+  const std::size_t nsteps = 12;
+
+  MatrixXd A = MatrixXd::Identity(nx, nx);
+  A.topRightCorner(nu, nu).diagonal().setConstant(0.5);
+  MatrixXd B = MatrixXd::Zero(nx, nu);
+  B.bottomRows(nu).setIdentity();
+  auto dyn = std::make_shared<Dynamics>(A, B, VectorXd::Zero(nx));
+  auto box = std::make_shared<BoxFunction>(nx, nu, -1., 1.);
+  // two phases with the same dimensions
+  std::shared_ptr<StageModel> stages[2];
+  for (int k = 0; k < 2; k++) {
+    auto cost = std::make_shared<QuadCost>((1. + k) * MatrixXd::Identity(nx, nx),
+                                           1e-2 * MatrixXd::Identity(nu, nu));
+    stages[k] = std::make_shared<StageModel>(cost, dyn);
+    stages[k]->addConstraint(box, std::make_shared<NegativeOrthant>());
+  }
+  auto term_cost = std::make_shared<QuadCost>(MatrixXd::Identity(nx, nx),
+                                              MatrixXd::Zero(nu, nu));
+  auto term_res = std::make_shared<StateErrorResidualTpl<T>>(
+      dyn->space_next_, nu, VectorXd::Zero(nx));
+
+  auto make_problem = [&](int first) {
+    TrajOptProblemTpl<T> problem(VectorXd::Ones(nx), nu, dyn->space_next_,
+                                 term_cost);
+    for (std::size_t i = 0; i < nsteps; i++)
+      problem.addStage(stages[(first + i) % 2]);
+    problem.addTerminalConstraint(
+        {term_res, std::make_shared<EqualityConstraint>()});
+    return problem;
+  };
+
+  const T tol = 1e-8;
+  SolverProxDDP<T> solver_ref(tol, 1e-4);
+  auto problem_ref = make_problem(1);
+  solver_ref.setup(problem_ref);
+  BOOST_CHECK(solver_ref.run(problem_ref));
+
+  // the appended stage: the dropped model, a new model with the same
+  // functions, and a new model with new (but identical) functions
+  auto same_functions = std::make_shared<StageModel>(stages[0]->cost_, dyn);
+  same_functions->addConstraint(box, std::make_shared<NegativeOrthant>());
+  auto new_functions = std::make_shared<StageModel>(
+      std::make_shared<QuadCost>(MatrixXd::Identity(nx, nx),
+                                 1e-2 * MatrixXd::Identity(nu, nu)),
+      std::make_shared<Dynamics>(A, B, VectorXd::Zero(nx)));
+  new_functions->addConstraint(std::make_shared<BoxFunction>(nx, nu, -1., 1.),
+                               std::make_shared<NegativeOrthant>());
+  const std::shared_ptr<StageModel> appended[3] = {stages[0], same_functions,
+                                                   new_functions};
+
+  for (int config = 0; config < 12; config++) {
+    const auto &stage = appended[config / 4];
+    auto problem = make_problem(0);
+    SolverProxDDP<T> solver(tol, 1e-4);
+    if (config % 4 == 1) {
+      solver.kkt_solver_choice = KktSolverChoice::SCHUR;
+    } else if (config % 4 == 2) {
+      solver.kkt_solver_choice = KktSolverChoice::MIXED_PRECISION;
+      solver.max_refinement_steps_ = 10;
+      solver.refinement_threshold_ = 1e-12;
+    } else if (config % 4 == 3) {
+      problem.setNumThreads(2);
+      solver.linear_solver_choice = LQSolverChoice::PARALLEL;
+    }
+    solver.setup(problem);
+    BOOST_CHECK(solver.run(problem));
+
+    const std::vector<VectorXd> us_prev = solver.results_.us;
+    const auto dropped_data = solver.workspace_.problem_data.stage_data[0];
+    AllocationReport report;
+    {
+      ScopedAllocationAudit audit(report);
+      solver.cycleProblem(problem, stage);
+    }
+    BOOST_CHECK(problem.stages_[0] == stages[1]);
+    BOOST_CHECK(problem.stages_.back() == stage);
+    // the data of the dropped stage is reused if it is valid for the new one
+    const bool reused =
+        solver.workspace_.problem_data.stage_data.back() == dropped_data;
+    BOOST_CHECK_EQUAL(reused, stage != new_functions);
+    if (reused)
+      BOOST_CHECK(report.allocationFree());
+    else if (AllocationAudit::enabled)
+      BOOST_CHECK(!report.allocationFree());
+    for (std::size_t t = 0; t + 1 < nsteps; t++) {
+      BOOST_CHECK(solver.results_.us[t].isApprox(us_prev[t + 1]));
+    }
+    BOOST_CHECK(solver.results_.us.back().isApprox(us_prev.back()));
+
+    // the cycled solver solves the new problem like a fresh one
+    solver.results_.xs[0] = problem.getInitState();
+    BOOST_CHECK(solver.run(problem, solver.results_.xs, solver.results_.us,
+                           solver.results_.lams));
+    for (std::size_t t = 0; t < nsteps; t++) {
+      BOOST_CHECK(
+          solver.results_.us[t].isApprox(solver_ref.results_.us[t], 1e-5));
+    }
+  }
+
+  // the dimensions of the appended stage are checked
+  auto problem = make_problem(0);
+  SolverProxDDP<T> solver(tol, 1e-4);
+  solver.setup(problem);
+  auto other = std::make_shared<StageModel>(
+      std::make_shared<QuadCost>(MatrixXd::Identity(nx, nx),
+                                 MatrixXd::Identity(nu, nu)),
+      dyn);
+  BOOST_CHECK_THROW(solver.cycleProblem(problem, other), std::runtime_error);
+}
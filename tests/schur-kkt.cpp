@@ -0,0 +1,88 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+
+#include "generate-problem.hpp"
+
+using namespace aligator;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+
+/// Assemble a random stage KKT matrix (u, y, lam_d, lam_c).
+MatrixXd random_kkt(long nu, long ndx, long nc, bool jac_neg_id,
+                    bool couple_y) {
+  const long nprim = nu + ndx;
+  const long ndual = ndx + nc;
+  const long ntot = nprim + ndual;
+  MatrixXd K = MatrixXd::Zero(ntot, ntot);
+  MatrixXd H = MatrixXd::Random(nprim, nprim);
+  K.topLeftCorner(nprim, nprim) = H * H.transpose();
+  MatrixXd J = MatrixXd::Random(ndual, nprim);
+  if (jac_neg_id)
+    J.block(0, nu, ndx, ndx) = -MatrixXd::Identity(ndx, ndx);
+  if (!couple_y)
+    J.bottomRightCorner(nc, ndx).setZero();
+  K.bottomLeftCorner(ndual, nprim) = J;
+  K.topRightCorner(nprim, ndual) = J.transpose();
+  K.bottomRightCorner(ndual, ndual).diagonal().head(ndx).setConstant(-1e-5);
+  K.bottomRightCorner(ndual, ndual).diagonal().tail(nc).setConstant(-1e-2);
+  return K;
+}
+
+BOOST_AUTO_TEST_CASE(schur_kkt_solve) {
+  const long nu = 3;
+  const long ndx = 5;
+  const long nc = 4;
+  const long ntot = nu + 2 * ndx + nc;
+
+  for (bool neg_id : {true, false}) {
+    for (bool couple : {true, false}) {
+      MatrixXd K = random_kkt(nu, ndx, nc, neg_id, couple);
+      SchurKktSolverTpl<T> solver(nu, ndx, ndx + nc, 2);
+      solver.compute(K);
+      BOOST_CHECK_EQUAL(solver.inertia()[0], nu + ndx);
+      BOOST_CHECK_EQUAL(solver.inertia()[1], ndx + nc);
+      BOOST_CHECK_EQUAL(solver.inertia()[2], 0);
+
+      // more columns than preallocated
+      MatrixXd rhs = MatrixXd::Random(ntot, 5);
+      MatrixXd sol = rhs;
+      solver.solveInPlace(sol);
+      BOOST_CHECK((K * sol).isApprox(rhs, 1e-8));
+    }
+  }
+
+  // wrong inertia: negative curvature in the controls
+  MatrixXd K = random_kkt(nu, ndx, nc, true, false);
+  K.topLeftCorner(nu, nu).diagonal().array() -= 1e3;
+  SchurKktSolverTpl<T> solver(nu, ndx, ndx + nc, 1);
+  solver.compute(K);
+  BOOST_CHECK_EQUAL(solver.inertia()[0] + solver.inertia()[1], ntot);
+  BOOST_CHECK_NE(solver.inertia()[1], ndx + nc);
+}
+
+BOOST_AUTO_TEST_CASE(schur_kkt_solver_matches_ldlt) {
+  const std::size_t nsteps = 20;
+  auto problem = makeLqrProblem(nsteps, 0.5);
+
+  const T tol = 1e-7;
+  SolverProxDDP<T> solver_ldlt(tol, 1e-4);
+  solver_ldlt.setup(problem);
+  BOOST_CHECK(solver_ldlt.workspace_.schur_kkts_.empty());
+  BOOST_CHECK(solver_ldlt.run(problem));
+
+  SolverProxDDP<T> solver_schur(tol, 1e-4);
+  solver_schur.kkt_solver_choice = KktSolverChoice::SCHUR;
+  solver_schur.setup(problem);
+  BOOST_CHECK_EQUAL(solver_schur.workspace_.schur_kkts_.size(), nsteps);
+  BOOST_CHECK(solver_schur.run(problem));
+
+  BOOST_CHECK_EQUAL(solver_ldlt.results_.num_iters,
+                    solver_schur.results_.num_iters);
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(solver_ldlt.results_.us[t].isApprox(solver_schur.results_.us[t],
+                                                    1e-5));
+  }
+}
@@ -0,0 +1,158 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/core/shared-data.hpp"
+#include "aligator/core/traj-opt-problem.hpp"
+#include "aligator/modelling/autodiff/finite-difference.hpp"
+#include "aligator/modelling/linear-discrete-dynamics.hpp"
+
+#include <proxsuite-nlp/modelling/constraints/equality-constraint.hpp>
+
+using namespace aligator;
+
+using T = double;
+using Eigen::MatrixXd;
+using Eigen::VectorXd;
+using VectorSpace = proxsuite::nlp::VectorSpaceTpl<T>;
+using EqualityConstraint = proxsuite::nlp::EqualityConstraint<T>;
+
+constexpr int NX = 2;
+constexpr int NU = 1;
+
+/// Object shared by the data of functions with equal keys.
+struct Counter {
+  int evaluations = 0;
+};
+
+inline shared_ptr<Counter> sharedCounter(const int &key) {
+  return SharedDataScope::get<Counter>(
+      key, [] { return std::make_shared<Counter>(); });
+}
+
+/// r(x) = x, counting its evaluations in the shared counter.
+struct CountingFunction : UnaryFunctionTpl<T> {
+  struct CountingData : Data {
+    shared_ptr<Counter> counter;
+    CountingData(const CountingFunction &f)
+        : Data(f.ndx1, f.nu, f.ndx2, f.nr),
+          counter(sharedCounter(f.key)) {}
+  };
+
+  int key;
+
+  CountingFunction(int key) : UnaryFunctionTpl<T>(NX, NU, NX), key(key) {}
+
+  void evaluate(const ConstVectorRef &x, Data &data) const override {
+    static_cast<CountingData &>(data).counter->evaluations++;
+    data.value_ = x;
+  }
+
+  void computeJacobians(const ConstVectorRef &, Data &data) const override {
+    data.Jx_.setIdentity();
+  }
+
+  shared_ptr<Data> createData() const override {
+    return std::make_shared<CountingData>(*this);
+  }
+};
+
+/// l(x, u) = 0, with a shared counter.
+struct CountingCost : CostAbstractTpl<T> {
+  struct CountingData : CostData {
+    shared_ptr<Counter> counter;
+    CountingData(const CountingCost &c)
+        : CostData(c.ndx(), c.nu), counter(sharedCounter(c.key)) {}
+  };
+
+  int key;
+
+  CountingCost(int key)
+      : CostAbstractTpl<T>(std::make_shared<VectorSpace>(NX), NU), key(key) {}
+
+  void evaluate(const ConstVectorRef &, const ConstVectorRef &,
+                CostData &data) const override {
+    data.value_ = 0.;
+  }
+  void computeGradients(const ConstVectorRef &, const ConstVectorRef &,
+                        CostData &data) const override {
+    data.grad_.setZero();
+  }
+  void computeHessians(const ConstVectorRef &, const ConstVectorRef &,
+                       CostData &data) const override {
+    data.hess_.setZero();
+  }
+
+  shared_ptr<CostData> createData() const override {
+    return std::make_shared<CountingData>(*this);
+  }
+};
+
+template <typename D, typename Ptr> const shared_ptr<Counter> &counter(Ptr p) {
+  return std::static_pointer_cast<typename D::CountingData>(p)->counter;
+}
+
+BOOST_AUTO_TEST_CASE(shared_data_scope) {
+  const int key = 0, equal_key = 0, other_key = 1;
+  BOOST_CHECK(sharedCounter(key) != sharedCounter(key));
+
+  SharedDataScope scope;
+  auto c = sharedCounter(key);
+  BOOST_CHECK(sharedCounter(key) == c);
+  BOOST_CHECK(sharedCounter(equal_key) == c);
+  BOOST_CHECK(sharedCounter(other_key) != c);
+  {
+    SharedDataScope inner;
+    BOOST_CHECK(sharedCounter(key) != c);
+  }
+  BOOST_CHECK(sharedCounter(key) == c);
+}
+
+BOOST_AUTO_TEST_CASE(shared_data_stage) {
+  auto cost = std::make_shared<CountingCost>(0);
+  auto func = std::make_shared<CountingFunction>(0);
+  auto other = std::make_shared<CountingFunction>(1);
+  auto dyn = std::make_shared<dynamics::LinearDiscreteDynamicsTpl<T>>(
+      MatrixXd::Identity(NX, NX), MatrixXd::Ones(NX, NU), VectorXd::Zero(NX));
+  auto stage = std::make_shared<StageModelTpl<T>>(cost, dyn);
+  stage->addConstraint(func, std::make_shared<EqualityConstraint>());
+  stage->addConstraint(other, std::make_shared<EqualityConstraint>());
+
+  // functions of a stage share, different stage datas do not
+  auto data = stage->createData();
+  auto c = counter<CountingCost>(data->cost_data);
+  BOOST_CHECK(counter<CountingFunction>(data->constraint_data[1]) == c);
+  BOOST_CHECK(counter<CountingFunction>(data->constraint_data[2]) != c);
+  auto data2 = stage->createData();
+  BOOST_CHECK(counter<CountingCost>(data2->cost_data) != c);
+
+  TrajOptProblemTpl<T> problem(VectorXd::Zero(NX), NU,
+                               std::make_shared<VectorSpace>(NX), cost);
+  problem.addStage(stage);
+  problem.addTerminalConstraint({func, std::make_shared<EqualityConstraint>()});
+  TrajOptDataTpl<T> prob_data(problem);
+  auto tc = counter<CountingCost>(prob_data.term_cost_data);
+  BOOST_CHECK(counter<CountingFunction>(prob_data.term_cstr_data[0]) == tc);
+  BOOST_CHECK(counter<CountingCost>(prob_data.stage_data[0]->cost_data) != tc);
+
+  VectorXd x = VectorXd::Random(NX);
+  func->evaluate(x, *prob_data.term_cstr_data[0]);
+  BOOST_CHECK_EQUAL(tc->evaluations, 1);
+}
+
+BOOST_AUTO_TEST_CASE(shared_data_finite_difference) {
+  auto space = std::make_shared<VectorSpace>(NX);
+  auto func = std::make_shared<CountingFunction>(0);
+  autodiff::FiniteDifferenceHelper<T> fd(space, func, 1e-6);
+  fd.setNumThreads(2);
+
+  SharedDataScope scope;
+  auto data = std::static_pointer_cast<
+      autodiff::FiniteDifferenceHelper<T>::Data>(fd.createData());
+  auto c0 = counter<CountingFunction>(data->data_0);
+  BOOST_CHECK(c0 == sharedCounter(0));
+  // the workspaces of the threads do not share with anything else
+  auto &ws = data->workspaces;
+  BOOST_CHECK_EQUAL(ws.size(), 2);
+  BOOST_CHECK(counter<CountingFunction>(ws[0].data_p) != c0);
+  BOOST_CHECK(counter<CountingFunction>(ws[0].data_p) !=
+              counter<CountingFunction>(ws[1].data_p));
+}
@@ -0,0 +1,118 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/utils/thread-pool.hpp"
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/solvers/fddp/solver-fddp.hpp"
+
+#include "generate-problem.hpp"
+
+#include <stdexcept>
+
+using namespace aligator;
+
+using T = double;
+
+BOOST_AUTO_TEST_CASE(parallel_for_covers_range) {
+  ThreadPool pool(4);
+  BOOST_CHECK_EQUAL(pool.size(), 4);
+  for (std::size_t n : {0, 1, 3, 17, 1000}) {
+    for (std::size_t grain : {0, 1, 7}) {
+      std::vector<std::atomic<int>> hits(n + 5);
+      pool.parallelFor(5, n + 5, [&](std::size_t i) { hits[i]++; }, grain);
+      for (std::size_t i = 0; i < n + 5; i++)
+        BOOST_CHECK_EQUAL(hits[i], i < 5 ? 0 : 1);
+    }
+  }
+
+  // a pool of size one runs the loops on the calling thread
+  ThreadPool single(1);
+  const auto id = std::this_thread::get_id();
+  single.parallelFor(0, 10, [&](std::size_t) {
+    BOOST_CHECK(std::this_thread::get_id() == id);
+  });
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_nested) {
+  ThreadPool pool(4, true);
+  const std::size_t n_outer = 8;
+  const std::size_t n_inner = 100;
+  std::vector<std::atomic<int>> sums(n_outer);
+  pool.parallelFor(0, n_outer, [&](std::size_t i) {
+    pool.parallelFor(0, n_inner, [&](std::size_t j) { sums[i] += (int)j; });
+  });
+  for (std::size_t i = 0; i < n_outer; i++)
+    BOOST_CHECK_EQUAL(sums[i], (int)(n_inner * (n_inner - 1) / 2));
+
+  // used from several threads at once
+  std::atomic<int> count{0};
+  std::vector<std::thread> users;
+  for (int k = 0; k < 3; k++) {
+    users.emplace_back(
+        [&] { pool.parallelFor(0, 200, [&](std::size_t) { count++; }); });
+  }
+  for (std::thread &u : users)
+    u.join();
+  BOOST_CHECK_EQUAL(count, 600);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_for_exception) {
+  ThreadPool pool(3);
+  std::atomic<int> count{0};
+  BOOST_CHECK_THROW(pool.parallelFor(0, 100,
+                                     [&](std::size_t i) {
+                                       count++;
+                                       if (i == 42)
+                                         throw std::runtime_error("42");
+                                     },
+                                     1),
+                    std::runtime_error);
+  // the other iterations still ran
+  BOOST_CHECK_EQUAL(count, 100);
+
+  // the pool is still usable
+  count = 0;
+  pool.parallelFor(0, 100, [&](std::size_t) { count++; });
+  BOOST_CHECK_EQUAL(count, 100);
+}
+
+struct lqr_fixture {
+  const std::size_t nsteps = 40;
+  TrajOptProblemTpl<T> problem;
+
+  lqr_fixture() : problem(makeLqrProblem(nsteps, 0.5)) {}
+};
+
+BOOST_FIXTURE_TEST_CASE(solvers_thread_pool, lqr_fixture) {
+  const T tol = 1e-8;
+  auto pool = std::make_shared<ThreadPool>(4);
+
+  SolverProxDDP<T> solver_ref(tol, 1e-4);
+  solver_ref.setup(problem);
+  BOOST_CHECK(solver_ref.run(problem));
+
+  SolverProxDDP<T> solver(tol, 1e-4);
+  solver.linear_solver_choice = LQSolverChoice::PARALLEL;
+  solver.setThreadPool(pool);
+  problem.setNumThreads(4);
+  solver.setup(problem);
+  BOOST_CHECK_EQUAL(solver.getThreadPool(), pool.get());
+  BOOST_CHECK_EQUAL(solver.workspace_.problem_data.thread_pool, pool.get());
+  BOOST_CHECK(solver.run(problem));
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(solver_ref.results_.us[t].isApprox(solver.results_.us[t], 1e-6));
+  }
+
+  auto problem_unc = makeLqrProblem(nsteps);
+  SolverFDDP<T> fddp_ref(tol);
+  fddp_ref.setup(problem_unc);
+  BOOST_CHECK(fddp_ref.run(problem_unc));
+
+  SolverFDDP<T> fddp(tol);
+  fddp.setThreadPool(pool);
+  fddp.setup(problem_unc);
+  BOOST_CHECK(fddp.run(problem_unc));
+  BOOST_CHECK_EQUAL(fddp_ref.results_.num_iters, fddp.results_.num_iters);
+  for (std::size_t t = 0; t < nsteps; t++) {
+    BOOST_CHECK(fddp_ref.results_.us[t].isApprox(fddp.results_.us[t]));
+  }
+}
@@ -0,0 +1,80 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/solvers/fddp/solver-fddp.hpp"
+
+#include "generate-problem.hpp"
+
+using namespace aligator;
+
+using T = double;
+
+/// Check the per-iteration timings add up to at most the totals.
+static void checkTimings(const ResultsBaseTpl<T> &results) {
+  if (!PhaseTimer::enabled) {
+    BOOST_CHECK(results.iter_timings.empty());
+    for (std::size_t k = 0; k < NUM_SOLVER_PHASES; k++)
+      BOOST_CHECK_EQUAL(results.timings.calls[k], 0);
+    return;
+  }
+  BOOST_CHECK_EQUAL(results.iter_timings.size(), results.num_iters);
+  PhaseTimings sum;
+  for (const PhaseTimings &it : results.iter_timings)
+    sum += it;
+  for (std::size_t k = 0; k < NUM_SOLVER_PHASES; k++) {
+    BOOST_CHECK_LE(sum.calls[k], results.timings.calls[k]);
+    BOOST_CHECK_LE(sum.seconds[k], results.timings.seconds[k] + 1e-12);
+  }
+  BOOST_CHECK_GT(results.timings.numCalls(SolverPhase::EVALUATE), 0);
+  BOOST_CHECK_GT(results.timings.numCalls(SolverPhase::DERIVATIVES), 0);
+  BOOST_CHECK_GT(results.timings.numCalls(SolverPhase::BACKWARD_PASS), 0);
+  BOOST_CHECK_GT(results.timings.numCalls(SolverPhase::LINESEARCH_TRIAL), 0);
+}
+
+BOOST_AUTO_TEST_CASE(scoped_phase) {
+  PhaseTimer timer;
+  {
+    ScopedPhase a(timer, SolverPhase::EVALUATE);
+    ScopedPhase b(timer, SolverPhase::CALLBACKS);
+    b.dismiss();
+  }
+  PhaseTimings out;
+  timer.collect(out);
+  BOOST_CHECK_EQUAL(out.numCalls(SolverPhase::EVALUATE),
+                    PhaseTimer::enabled ? 1 : 0);
+  BOOST_CHECK_EQUAL(out.numCalls(SolverPhase::CALLBACKS), 0);
+
+  // collect() resets the timer
+  timer.collect(out);
+  BOOST_CHECK_EQUAL(out.numCalls(SolverPhase::EVALUATE), 0);
+}
+
+BOOST_AUTO_TEST_CASE(proxddp_timings) {
+  auto problem = makeLqrProblem(20, 0.5);
+  SolverProxDDP<T> solver(1e-7, 1e-4);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+  checkTimings(solver.results_);
+  if (PhaseTimer::enabled) {
+    const PhaseTimings &t = solver.results_.timings;
+    BOOST_CHECK_GT(t.numCalls(SolverPhase::MULTIPLIERS), 0);
+    BOOST_CHECK_GT(t.numCalls(SolverPhase::LAGRANGIAN_DERIVATIVES), 0);
+    // one assembly and one factorization per stage and backward pass
+    BOOST_CHECK_EQUAL(t.numCalls(SolverPhase::KKT_ASSEMBLY),
+                      t.numCalls(SolverPhase::FACTORIZATION));
+    BOOST_CHECK_GE(t.numCalls(SolverPhase::KKT_ASSEMBLY),
+                   20 * t.numCalls(SolverPhase::BACKWARD_PASS));
+  }
+
+  // a second run starts from zero
+  BOOST_CHECK(solver.run(problem));
+  checkTimings(solver.results_);
+}
+
+BOOST_AUTO_TEST_CASE(fddp_timings) {
+  auto problem = makeLqrProblem(20);
+  SolverFDDP<T> solver(1e-8);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+  checkTimings(solver.results_);
+}
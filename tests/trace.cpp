@@ -0,0 +1,116 @@
+#include <boost/test/unit_test.hpp>
+
+#include "aligator/helpers/trace-callback.hpp"
+#include "aligator/solvers/proxddp/solver-proxddp.hpp"
+#include "aligator/solvers/fddp/solver-fddp.hpp"
+
+#include "generate-problem.hpp"
+
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+using namespace aligator;
+
+using T = double;
+
+static std::size_t countEvents(const TraceBuffer &buffer, const char *name) {
+  std::size_t n = 0;
+  for (const TraceEvent &e : buffer.events())
+    n += std::strcmp(e.name, name) == 0;
+  return n;
+}
+
+BOOST_AUTO_TEST_CASE(trace_buffer) {
+  TraceBuffer buffer(8);
+  for (std::size_t i = 0; i < 5; i++)
+    ScopedTrace span(&buffer, "a", i);
+  BOOST_CHECK_EQUAL(buffer.size(), 5);
+  BOOST_CHECK_EQUAL(buffer.numDropped(), 0);
+
+  // recording from several threads
+  std::vector<std::thread> threads;
+  for (int k = 0; k < 2; k++) {
+    threads.emplace_back([&] {
+      for (std::size_t i = 0; i < 4; i++)
+        ScopedTrace span(&buffer, "b", i);
+    });
+  }
+  for (std::thread &t : threads)
+    t.join();
+  // the oldest events were overwritten
+  BOOST_CHECK_EQUAL(buffer.size(), 8);
+  BOOST_CHECK_EQUAL(buffer.numDropped(), 5);
+  BOOST_CHECK_EQUAL(countEvents(buffer, "a"), 0);
+  BOOST_CHECK_EQUAL(countEvents(buffer, "b"), 8);
+  for (const TraceEvent &e : buffer.events()) {
+    BOOST_CHECK_NE(e.thread, current_thread_index());
+    BOOST_CHECK_GE(e.duration_ns, 0);
+  }
+
+  std::ostringstream oss;
+  buffer.writeChromeTrace(oss);
+  const std::string json = oss.str();
+  BOOST_CHECK_EQUAL(json.find("{\"displayTimeUnit\""), 0);
+  BOOST_CHECK_NE(json.find("\"ph\": \"X\""), std::string::npos);
+
+  buffer.clear();
+  BOOST_CHECK_EQUAL(buffer.size(), 0);
+  // a null buffer records nothing
+  ScopedTrace span(nullptr, "c");
+}
+
+BOOST_AUTO_TEST_CASE(proxddp_trace) {
+  const std::size_t nsteps = 10;
+  auto problem = makeLqrProblem(nsteps);
+  SolverProxDDP<T> solver(1e-7, 1e-4);
+  auto cb = std::make_shared<TraceCallbackTpl<T>>("");
+  solver.registerCallback("trace", cb);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+  // the buffer is only attached during the run
+  BOOST_CHECK(solver.workspace_.problem_data.trace == nullptr);
+
+  const std::size_t num_evals = countEvents(cb->buffer, "evaluate");
+  BOOST_CHECK_GE(num_evals, nsteps);
+  BOOST_CHECK_EQUAL(num_evals % nsteps, 0);
+  BOOST_CHECK_GE(countEvents(cb->buffer, "derivatives"), nsteps);
+  BOOST_CHECK_GE(countEvents(cb->buffer, "backward_pass"), nsteps);
+  BOOST_CHECK_GT(countEvents(cb->buffer, "linesearch_trial"), 0);
+
+  // the knots of the parallel backward pass are traced too
+  SolverProxDDP<T> solver_par(1e-7, 1e-4);
+  solver_par.linear_solver_choice = LQSolverChoice::PARALLEL;
+  solver_par.registerCallback("trace", cb);
+  problem.setNumThreads(2);
+  solver_par.setup(problem);
+  BOOST_CHECK(solver_par.run(problem));
+  BOOST_CHECK_GE(countEvents(cb->buffer, "backward_pass"), nsteps);
+  problem.setNumThreads(1);
+
+  // without the callback, nothing is recorded
+  solver.removeCallback("trace");
+  cb->buffer.clear();
+  BOOST_CHECK(solver.run(problem));
+  BOOST_CHECK_EQUAL(cb->buffer.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(fddp_trace) {
+  const std::size_t nsteps = 10;
+  auto problem = makeLqrProblem(nsteps);
+  SolverFDDP<T> solver(1e-8);
+  auto cb = std::make_shared<TraceCallbackTpl<T>>("fddp_trace.json");
+  solver.registerCallback("trace", cb);
+  solver.setup(problem);
+  BOOST_CHECK(solver.run(problem));
+  BOOST_CHECK_GE(countEvents(cb->buffer, "evaluate"), nsteps);
+  BOOST_CHECK_GE(countEvents(cb->buffer, "backward_pass"), nsteps);
+  BOOST_CHECK_GT(countEvents(cb->buffer, "linesearch_trial"), 0);
+
+  std::ifstream ifs("fddp_trace.json");
+  BOOST_CHECK(ifs.good());
+  std::stringstream json;
+  json << ifs.rdbuf();
+  BOOST_CHECK_NE(json.str().find("\"name\": \"backward_pass\""),
+                 std::string::npos);
+}
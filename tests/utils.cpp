@@ -1,4 +1,5 @@
 #include "aligator/utils/newton-raphson.hpp"
+#include "aligator/utils/matrix-arena.hpp"
 
 #include <proxsuite-nlp/modelling/spaces/vector-space.hpp>
 
@@ -51,4 +52,64 @@ BOOST_AUTO_TEST_CASE(newton_raphson) {
   BOOST_TEST_CHECK(xout.isApprox(xans, eps));
 }
 
+BOOST_AUTO_TEST_CASE(matrix_arena) {
+  using Arena = MatrixArenaTpl<Scalar>;
+  Arena arena({{3, 3}, {5, 2}, {0, 4}, {1, 1}});
+  BOOST_CHECK_EQUAL(arena.size(), 4);
+
+  for (std::size_t i = 0; i < arena.size(); i++) {
+    BOOST_CHECK(arena[i].isZero());
+    BOOST_CHECK_EQUAL(std::uintptr_t(arena[i].data()) % EIGEN_MAX_ALIGN_BYTES,
+                      0);
+    arena[i].setConstant(Scalar(i));
+  }
+  BOOST_CHECK_EQUAL(arena[1].rows(), 5);
+  BOOST_CHECK_EQUAL(arena[1].cols(), 2);
+  BOOST_CHECK_EQUAL(arena[2].size(), 0);
+  // writing through a view does not spill into the neighbours
+  BOOST_CHECK(arena[0].isConstant(0.));
+  BOOST_CHECK(arena[1].isConstant(1.));
+  BOOST_CHECK(arena.back().isConstant(3.));
+
+  // deep copy
+  Arena copy = arena;
+  copy[0].setConstant(-1.);
+  BOOST_CHECK(arena[0].isConstant(0.));
+
+  // rotate elements 1..2 (keep the head and the last element in place)
+  arena.rotateLeft(1, 1);
+  BOOST_CHECK(arena[0].isConstant(0.));
+  BOOST_CHECK_EQUAL(arena[1].size(), 0);
+  BOOST_CHECK_EQUAL(arena[2].rows(), 5);
+  BOOST_CHECK(arena[2].isConstant(1.));
+  BOOST_CHECK(arena[3].isConstant(3.));
+
+  std::vector<MatrixXs> mats = arena.toVector();
+  BOOST_CHECK_EQUAL(mats.size(), 4);
+  BOOST_CHECK(mats[2].isApprox(arena[2]));
+
+  // swap exchanges the buffers: the data does not move
+  Arena other({{2, 2}});
+  const Scalar *data0 = arena[0].data();
+  swap(arena, other);
+  BOOST_CHECK_EQUAL(arena.size(), 1);
+  BOOST_CHECK_EQUAL(other.size(), 4);
+  BOOST_CHECK_EQUAL(other[0].data(), data0);
+  BOOST_CHECK(other[3].isConstant(3.));
+}
+
+BOOST_AUTO_TEST_CASE(vector_arena) {
+  using Arena = VectorArenaTpl<Scalar>;
+  Arena arena(std::vector<long>{4, 0, 3});
+  BOOST_CHECK_EQUAL(arena.size(), 3);
+  BOOST_CHECK_EQUAL(arena[0].size(), 4);
+  BOOST_CHECK_EQUAL(arena[2].size(), 3);
+
+  arena[2].setOnes();
+  BOOST_CHECK_EQUAL(arena[2].dot(arena[2]), 3.);
+  BOOST_CHECK(arena[0].isZero());
+  std::vector<VectorXs> vecs = arena.toVector();
+  BOOST_CHECK(vecs[2].isOnes());
+}
+
 BOOST_AUTO_TEST_SUITE_END()